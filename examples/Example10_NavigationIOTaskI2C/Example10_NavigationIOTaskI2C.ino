@@ -0,0 +1,330 @@
+
+/*
+ * ---------------------------------------------------------------------------------
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ * ---------------------------------------------------------------------------------
+ */
+
+/*
+ * Example using the SparkFun FPC2534 Fingerprint sensor library to demonstrate the I/O task mode of the
+ * library. This example uses the I2C interface to communicate with the sensor and is for ESP32 boards.
+ *
+ * Example Setup:
+ *   - Connect the SparkFun Qwiic FPC2534 Fingerprint sensor to your ESP32 board using a qwiic cable.
+ *  - Connect the RST pin on the sensor to a digital pin on your microcontroller. This is used by the
+ *    example to "reset the sensor" on startup.
+ *  - Connect the IRQ pin on the sensor to a digital pin on your microcontroller. The sensor triggers
+ *    an interrupt on this pin when it has data to send.
+ *  - Update the IRQ_PIN and RST_PIN defines below to match the pins you are using.
+ *
+ * Operation:
+ *  - This example operates the same as Example01_NavigationI2C, but uses the library I/O task.
+ *  - The I/O task is a FreeRTOS task the library creates. When the sensor raises the IRQ pin, the interrupt
+ *    handler wakes the I/O task, which immediately reads the message from the sensor and queues it.
+ *  - The loop() waits on the queue - the callback functions are still called from loop(), but the response
+ *    latency is set by the IRQ, not by the loop period (there is no delay() in loop()).
+ *  - The core and priority of the I/O task are set in setup().
+ *  - Every 30 seconds, the I/O task statistics are printed.
+ *
+  *---------------------------------------------------------------------------------
+ */
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "SparkFun_FPC2534.h"
+
+#if !defined(ESP32)
+#error "This example requires an ESP32 board"
+#endif
+
+//----------------------------------------------------------------------------
+// User Config -
+//----------------------------------------------------------------------------
+// UPDATE THESE DEFINES TO MATCH YOUR HARDWARE SETUP
+//
+// These are the pins the IRQ and RST pins of the sensor are connected to the microcontroller.
+//
+// NOTE: The IRQ pin must be an interrupt-capable pin on your microcontroller
+//
+// Example pins tested for various SparkFun boards:
+
+// ESP32 thing plus
+// #define IRQ_PIN 16
+// #define RST_PIN 21
+// #define I2C_BUS 0
+
+// ESP32 thing plus C
+// #define IRQ_PIN 32
+// #define RST_PIN 14
+// #define I2C_BUS 0
+
+// ESP32 IoT RedBoard
+#define IRQ_PIN 26
+#define RST_PIN 27
+#define I2C_BUS 0
+
+// State flags to manage sensor startup/state
+bool startNavigation = true;
+
+// Used to track LED state
+bool ledState = false;
+
+// Declare our sensor object. Note the I2C version of the sensor class is used.
+SfeFPC2534I2C mySensor;
+
+// The library I/O task - reads messages from the sensor as soon as the IRQ pin signals
+sfDevFPC2534IOTask myIOTask;
+
+// Used to print out the I/O task statistics
+uint32_t lastStatsTime = 0;
+
+//------------------------------------------------------------------------------------
+// Callback functions the library calls
+//------------------------------------------------------------------------------------
+// Unlike a majority of Arduino Sensor libraries, the FPC2534 library is event/callback driven.
+// The library calls functions you define when events occur. This allows your code to respond
+// to messages from the sensor. In I/O task mode, messages are read by the I/O task, and the callbacks
+// are called when processNextResponse() is called in your main loop.
+//----------------------------------------------------------------------------
+// on_error()
+//
+// Call if the sensor library detects/encounters an error
+//
+static void on_error(uint16_t error)
+{
+    // Just print the error code
+    Serial.print("[ERROR] code:\t");
+    Serial.println(error);
+}
+
+//----------------------------------------------------------------------------
+// on_is_ready_change()
+//
+// Call when the device ready state changes
+//
+static void on_is_ready_change(bool isReady)
+{
+    // On startup the device isn't immediately ready. A message is sent when it is.
+    // The Library will call this function when that happens
+
+    if (isReady)
+    {
+        Serial.println("[STARTUP]\tFPC2534 Device is ready");
+
+        // do we need to start navigation mode?
+        if (mySensor.currentMode() != STATE_NAVIGATION && startNavigation)
+        {
+            // Place the sensor in Navigation mode and print out a menue.
+            startNavigation = false;
+            fpc_result_t rc = mySensor.startNavigationMode(0);
+
+            // error?
+            if (rc != FPC_RESULT_OK)
+            {
+                Serial.print("[ERROR]\tFailed to start navigation mode - error:");
+                Serial.println(rc);
+                return;
+            }
+
+            Serial.println("[SETUP]\tSensor In Navigation mode.");
+            Serial.println();
+            Serial.println("\t- Swipe Up, Down, Left, Right to see events.");
+            Serial.println("\t- Press to toggle LED on/off.");
+            Serial.println("\t- Long Press to get firmware version.");
+            Serial.println();
+        }
+        else
+            Serial.println("[STATUS] \tFPC2534 Device is NOT ready");
+    }
+}
+
+//----------------------------------------------------------------------------
+// on_version()
+//
+// Call when the sensor sends a version string
+//
+static void on_version(char *version)
+{
+    // just print the version string
+    Serial.print("\t\t");
+    Serial.println(version);
+}
+
+//----------------------------------------------------------------------------
+// on_navigation()
+//
+// Call when the sensor sends a navigation event
+//
+static void on_navigation(uint16_t gesture)
+{
+    Serial.print("[NAVIGATION]\t");
+    switch (gesture)
+    {
+    case CMD_NAV_EVENT_NONE:
+        Serial.println("NONE");
+        break;
+    case CMD_NAV_EVENT_UP:
+        Serial.println("UP");
+        break;
+    case CMD_NAV_EVENT_DOWN:
+        Serial.println("DOWN");
+        break;
+    case CMD_NAV_EVENT_RIGHT:
+        Serial.println("RIGHT");
+        break;
+    case CMD_NAV_EVENT_LEFT:
+        Serial.println("LEFT");
+        break;
+    case CMD_NAV_EVENT_PRESS:
+        // Toggle the on-board  LED
+        Serial.print("PRESS -> {LED ");
+        Serial.print(ledState ? "OFF" : "ON");
+        Serial.println("}");
+        ledState = !ledState;
+        mySensor.setLED(ledState);
+        break;
+
+    case CMD_NAV_EVENT_LONG_PRESS:
+        // Request the firmware version from the sensor. The sensor will respond
+        // with a version event that will call our on_version() function above.
+        Serial.println("LONG PRESS -> {Get Version}");
+        mySensor.requestVersion();
+        break;
+    default:
+        Serial.println("UNKNOWN");
+        break;
+    }
+}
+
+// ------------------------------------------------------------------------------------
+// Fill in the library callback structure with  our callback functions
+//
+// This is passed to the library so it knows what functions to call when events occur.
+static sfDevFPC2534Callbacks_t cmd_cb = {0};
+
+//------------------------------------------------------------------------------------
+// reset_sensor()
+//
+// Simple function to toggle the reset pin of the sensor
+//
+void reset_sensor(void)
+{
+    // Reset the sensor by toggling the reset pin
+    pinMode(RST_PIN, OUTPUT);
+    digitalWrite(RST_PIN, LOW);  // Set reset pin low
+    delay(10);                   // Wait for 10 ms
+    digitalWrite(RST_PIN, HIGH); // Set reset pin high
+    delay(250);                  // Wait for sensor to initialize
+}
+
+//------------------------------------------------------------------------------------
+// setup()
+//
+void setup()
+{
+    delay(2000);
+
+    // Set up serial communication for debugging
+    Serial.begin(115200); // Set baud rate to 115200
+    while (!Serial)
+    {
+        ; // Wait for serial port to connect. Needed for native USB port only
+    }
+    Serial.println();
+    Serial.println("----------------------------------------------------------------");
+    Serial.println(" SparkFun FPC2534 Navigation Example - I2C - I/O Task");
+    Serial.println("----------------------------------------------------------------");
+    Serial.println();
+
+    // Initialize the I2C communication
+    Wire.begin();
+
+    // Reset the sensor to ensure it's in a known state - by default this also triggers the
+    // sensor to send a status message
+    reset_sensor();
+
+    // Is the sensor there - on the I2C bus?
+    Wire.beginTransmission(kFPC2534DefaultAddress);
+    if (Wire.endTransmission() != 0)
+    {
+        Serial.println("[ERROR]\tTouch Sensor FPC2534 not found on I2C bus. HALT");
+        while (1)
+        {
+            delay(1000); // Wait indefinitely if device is not found
+        }
+    }
+    else
+        Serial.println("[STARTUP]\tTouch Sensor FPC2534 found on I2C bus");
+
+    // The sensor is available - Initialize the sensor library
+    if (!mySensor.begin(kFPC2534DefaultAddress, Wire, I2C_BUS, IRQ_PIN))
+    {
+        Serial.println("[ERROR]\tFPC2534 not found. Check wiring. HALT.");
+        while (1)
+            delay(1000);
+    }
+    Serial.println("[STARTUP]\tFPC2534 initialized.");
+
+    // Setup our callback functions structure
+    cmd_cb.on_error = on_error;
+    cmd_cb.on_version = on_version;
+    cmd_cb.on_navigation = on_navigation;
+    cmd_cb.on_is_ready_change = on_is_ready_change;
+
+    // set the callbacks for the sensor library to call
+    mySensor.setCallbacks(cmd_cb);
+
+    // Start the I/O task. Run it on core 0 (Arduino loop() runs on core 1) at a priority above loop().
+    sfDevFPC2534IOTaskConfig_t ioConfig = kFPC2534IOTaskDefaultConfig;
+    ioConfig.core = 0;
+    ioConfig.priority = 5;
+    if (!myIOTask.start(mySensor, ioConfig))
+    {
+        Serial.println("[ERROR]\tUnable to start the I/O task. HALT.");
+        while (1)
+            delay(1000);
+    }
+    Serial.println("[STARTUP]\tI/O task started.");
+
+    // One last reset of the sensor = observation shows that this is needed after the above device ping...
+    reset_sensor();
+
+    // Ready to go!
+    Serial.println("[STARTUP]\tFingerprint system initialized.");
+}
+
+//------------------------------------------------------------------------------------
+// print_stats()
+//
+// Print out the I/O task statistics
+//
+static void print_stats(void)
+{
+    sfDevFPC2534IOTaskStats_t stats;
+    myIOTask.getStats(stats);
+
+    Serial.printf("[STATS]\tframes: %u, stalls: %u, errors: %u, max read: %u us, max queue wait: %u us\n\r",
+                  (unsigned)stats.frames, (unsigned)stats.stalls, (unsigned)stats.errors,
+                  (unsigned)stats.maxReadUs, (unsigned)stats.maxDispatchUs);
+}
+
+//------------------------------------------------------------------------------------
+void loop()
+{
+    // Wait for the I/O task to queue a message from the sensor, then process it. The library will call our
+    // above callback functions. No delay is needed - this blocks (up to 1 second) until a message arrives.
+    fpc_result_t rc = myIOTask.dispatch(1000);
+    if (rc != FPC_RESULT_OK && rc != FPC_PENDING_OPERATION)
+    {
+        Serial.print("[ERROR] Sensor Processing Error: ");
+        Serial.println(rc);
+    }
+
+    if (millis() - lastStatsTime > 30000)
+    {
+        lastStatsTime = millis();
+        print_stats();
+    }
+}
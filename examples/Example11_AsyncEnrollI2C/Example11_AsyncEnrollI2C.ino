@@ -0,0 +1,284 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Example using the coroutine (awaitable) API of the SparkFun FPC2534 Fingerprint sensor library.
+ *
+ * Example02_EnrollI2C implements enrollment and identification as a state machine spread across the callback
+ * functions. This example implements the same sequence - list templates, enroll a finger, identify
+ * fingers - as one sequential function, using C++20 coroutines. The function suspends at each co_await
+ * until the sensor responds, while loop() keeps running.
+ *
+ * NOTE: C++20 coroutine support is required - ESP32 boards with the Arduino ESP32 core 3.x.
+ *
+ * Example Setup:
+ *   - Connect the SparkFun Qwiic FPC2534 Fingerprint sensor to your ESP32 board using a qwiic cable.
+ *  - Connect the RST pin on the sensor to a digital pin on your microcontroller. This is used by the
+ *    example to "reset the sensor" on startup.
+ *  - Connect the IRQ pin on the sensor to a digital pin on your microcontroller. The sensor triggers
+ *    an interrupt on this pin when it has data to send.
+ *  - Update the IRQ_PIN and RST_PIN defines below to match the pins you are using.
+ *
+ * Operation:
+ *  - Once the sensor is ready, the fingerprint session coroutine is started:
+ *      - The enrolled templates are listed
+ *      - A new fingerprint is enrolled - the number of samples remaining is printed after each touch
+ *      - Fingerprints are identified, until 5 identify attempts are made
+ *      - The on-board LED of the sensor is turned on if the last attempt matched
+ *  - loop() pumps the sensor via the async object, and blinks the board LED (if the board has one) to show
+ *    it is not blocked.
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "SparkFun_FPC2534.h"
+
+#if !defined(SFE_FPC2534_HAS_COROUTINES)
+#error "This example requires C++20 coroutine support (Arduino ESP32 core 3.x)"
+#endif
+
+//----------------------------------------------------------------------------
+// User Config -
+//----------------------------------------------------------------------------
+// UPDATE THESE DEFINES TO MATCH YOUR HARDWARE SETUP
+//
+// These are the pins the IRQ and RST pins of the sensor are connected to the microcontroller.
+//
+// NOTE: The IRQ pin must be an interrupt-capable pin on your microcontroller
+//
+// Example pins tested for various SparkFun boards:
+
+// ESP32 thing plus
+// #define IRQ_PIN 16
+// #define RST_PIN 21
+// #define I2C_BUS 0
+
+// ESP32 thing plus C
+// #define IRQ_PIN 32
+// #define RST_PIN 14
+// #define I2C_BUS 0
+
+// ESP32 IoT RedBoard
+#define IRQ_PIN 26
+#define RST_PIN 27
+#define I2C_BUS 0
+
+// Declare our sensor object. Note the I2C version of the sensor class is used.
+SfeFPC2534I2C mySensor;
+
+// The async API object for the sensor
+sfDevFPC2534Async myAsync(mySensor);
+
+// Has the session been started?
+bool sessionStarted = false;
+
+// For the blinking LED in loop()
+uint32_t lastBlink = 0;
+bool blinkState = false;
+
+//------------------------------------------------------------------------------------
+// The fingerprint session - each co_await suspends this function until the sensor responds.
+//
+static sfDevFPC2534Task fingerprintSession(sfDevFPC2534Async &sensor)
+{
+    // List the templates on the sensor
+    uint16_t ids[10];
+    sfDevFPC2534ListResult_t list = co_await sensor.listTemplates(ids, 10);
+    if (list.rc != FPC_RESULT_OK)
+        co_return list.rc;
+
+    Serial.print("[INFO]\tNumber of templates on the sensor: ");
+    Serial.println(list.count);
+
+    // Enroll a new finger - each co_await returns after a sample is taken
+    Serial.print("[ENROLL]\tPlace and lift your finger on the sensor until enrolled ");
+    sfDevFPC2534EnrollOp enroll = sensor.enroll();
+    while (co_await enroll)
+    {
+        Serial.print(enroll.samplesRemaining());
+        Serial.print(".");
+    }
+    if (enroll.result() != FPC_RESULT_OK)
+    {
+        Serial.println();
+        Serial.print("[ERROR]\tEnroll failed - error: ");
+        Serial.println(enroll.result());
+        co_return enroll.result();
+    }
+    Serial.print(".done! Template ID: ");
+    Serial.println(enroll.id());
+
+    // Now identify fingers
+    bool matched = false;
+    for (uint16_t tag = 1; tag <= 5; tag++)
+    {
+        Serial.print("[IDENTIFY]\tPlace a finger on the sensor: ");
+        sfDevFPC2534IdentifyResult_t result = co_await sensor.identify({ID_TYPE_ALL, 0}, tag);
+        if (result.rc != FPC_RESULT_OK)
+            co_return result.rc;
+
+        matched = result.match;
+        if (matched)
+        {
+            Serial.print("MATCH {Template ID: ");
+            Serial.print(result.id);
+            Serial.println("}");
+        }
+        else
+            Serial.println("NO MATCH");
+    }
+
+    sensor.device().setLED(matched);
+    Serial.println("[DONE]\tSession complete");
+    co_return FPC_RESULT_OK;
+}
+
+//------------------------------------------------------------------------------------
+// Callback functions the library calls
+//------------------------------------------------------------------------------------
+static void on_error(uint16_t error)
+{
+    // Just print the error code
+    Serial.print("[ERROR] code:\t");
+    Serial.println(error);
+}
+
+//----------------------------------------------------------------------------
+// on_is_ready_change()
+//
+// Call when the device ready state changes - start the session when the sensor is ready
+//
+static void on_is_ready_change(bool isReady)
+{
+    if (!isReady || sessionStarted)
+        return;
+
+    Serial.println("[STARTUP]\tFPC2534 Device is ready");
+    sessionStarted = true;
+
+    // Start the session. It runs until its first co_await, and is then resumed by myAsync.poll()
+    if (!fingerprintSession(myAsync).start())
+        Serial.println("[ERROR]\tUnable to start the session - increase SFE_FPC2534_CO_FRAME_SIZE");
+}
+
+// Define our command callbacks structure - callback methods are assigned in setup
+static sfDevFPC2534Callbacks_t cmd_cb = {0};
+
+//------------------------------------------------------------------------------------
+// reset_sensor()
+//
+// Simple function to toggle the reset pin of the sensor
+//
+void reset_sensor(void)
+{
+    // Reset the sensor by toggling the reset pin.
+    //
+    // clear out our data buffer
+    mySensor.clearData();
+    pinMode(RST_PIN, OUTPUT);
+    digitalWrite(RST_PIN, LOW); // Set reset pin low
+    delay(10);                  // Wait for 10 ms
+
+    digitalWrite(RST_PIN, HIGH); // Set reset pin high
+    delay(250);                  // Wait for sensor to initialize
+}
+
+//------------------------------------------------------------------------------------
+// setup()
+//
+void setup()
+{
+    delay(2000);
+
+    // Set up serial communication for debugging
+    Serial.begin(115200); // Set baud rate to 115200
+    while (!Serial)
+    {
+        ; // Wait for serial port to connect. Needed for native USB port only
+    }
+    Serial.println();
+    Serial.println("----------------------------------------------------------------");
+    Serial.println(" SparkFun FPC2534 Async (Coroutine) Enrollment Example");
+    Serial.println("----------------------------------------------------------------");
+    Serial.println();
+
+#if defined(LED_BUILTIN)
+    pinMode(LED_BUILTIN, OUTPUT);
+#endif
+
+    // Initialize the I2C communication
+    Wire.begin();
+
+    // Reset the sensor to ensure it's in a known state - by default this also triggers the
+    // sensor to send a status message
+    reset_sensor();
+
+    // Is the sensor there - on the I2C bus?
+    Wire.beginTransmission(kFPC2534DefaultAddress);
+    if (Wire.endTransmission() != 0)
+    {
+        Serial.println("[ERROR]\tTouch Sensor FPC2534 not found on I2C bus. HALT");
+        while (1)
+        {
+            delay(1000); // Wait indefinitely if device is not found
+        }
+    }
+    else
+        Serial.println("[STARTUP]\tTouch Sensor FPC2534 found on I2C bus");
+
+    // Initialize the sensor library
+    if (!mySensor.begin(kFPC2534DefaultAddress, Wire, I2C_BUS, IRQ_PIN))
+    {
+        Serial.println("[ERROR]\tFPC2534 not found. Check wiring. HALT.");
+        while (1)
+            delay(1000);
+    }
+    Serial.println("[STARTUP]\tFPC2534 initialized.");
+
+    // setup our callback functions structure
+    cmd_cb.on_error = on_error;
+    cmd_cb.on_is_ready_change = on_is_ready_change;
+
+    // set the callbacks for the sensor library to call
+    mySensor.setCallbacks(cmd_cb);
+
+    // One last reset of the sensor = observation shows that this is needed after the above device ping...
+    reset_sensor();
+
+    // Ready to go!
+    Serial.println("[STARTUP]\tFingerprint system initialized.");
+}
+
+//------------------------------------------------------------------------------------
+void loop()
+{
+    // Pump the sensor - process the next message and resume the session when its operation completes
+    fpc_result_t rc = myAsync.poll();
+    if (rc != FPC_RESULT_OK && rc != FPC_PENDING_OPERATION)
+    {
+        Serial.print("[ERROR] Processing Error: ");
+        Serial.println(rc);
+    }
+
+    // The application is not blocked by the session - blink the LED
+    if (millis() - lastBlink > 500)
+    {
+        lastBlink = millis();
+        blinkState = !blinkState;
+#if defined(LED_BUILTIN)
+        digitalWrite(LED_BUILTIN, blinkState ? HIGH : LOW);
+#endif
+    }
+
+    delay(10);
+}
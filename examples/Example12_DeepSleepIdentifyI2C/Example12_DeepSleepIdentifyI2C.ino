@@ -0,0 +1,249 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Example of a fast wake-and-identify path with the SparkFun FPC2534 Fingerprint sensor library - the ESP32
+ * stays in deep sleep until a finger touches the sensor.
+ *
+ * Before deep sleep, an identify operation is started on the sensor and the library state is saved to RTC
+ * memory. The sensor stays powered and waits for a finger. When a finger is placed, the sensor raises the IRQ
+ * pin with the result, which wakes the ESP32. On wake, the library state is restored - no sensor reset and no
+ * startup wait - and the pending identify result is read right away.
+ *
+ * NOTE: ESP32 only - the IRQ pin must be an RTC GPIO (ext0 wakeup).
+ *
+ * Example Setup:
+ *  - Connect the SparkFun Qwiic FPC2534 Fingerprint sensor to your ESP32 board using a qwiic cable.
+ *  - Connect the RST pin on the sensor to a digital pin on your microcontroller. This is used by the
+ *    example to "reset the sensor" on the first startup.
+ *  - Connect the IRQ pin on the sensor to an RTC GPIO pin on your microcontroller.
+ *  - Update the IRQ_PIN and RST_PIN defines below to match the pins you are using.
+ *  - Enroll a fingerprint first - see Example02_EnrollI2C.
+ *
+ * Operation:
+ *  - On the first startup, the sensor is reset and the example waits for it to be ready
+ *  - An identify operation is started and the ESP32 enters deep sleep
+ *  - Place a finger on the sensor - the ESP32 wakes, prints the result and the wake to result time, and goes
+ *    back to sleep
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <esp_sleep.h>
+
+#include "SparkFun_FPC2534.h"
+
+#if !defined(ESP32)
+#error "This example requires an ESP32 board"
+#endif
+
+//----------------------------------------------------------------------------
+// User Config -
+//----------------------------------------------------------------------------
+// UPDATE THESE DEFINES TO MATCH YOUR HARDWARE SETUP
+//
+// These are the pins the IRQ and RST pins of the sensor are connected to the microcontroller.
+//
+// NOTE: The IRQ pin must be an RTC GPIO pin - it wakes the ESP32 from deep sleep
+//
+// Example pins tested for various SparkFun boards:
+
+// ESP32 thing plus
+// #define IRQ_PIN 32
+// #define RST_PIN 21
+// #define I2C_BUS 0
+
+// ESP32 IoT RedBoard
+#define IRQ_PIN 26
+#define RST_PIN 27
+#define I2C_BUS 0
+
+// Declare our sensor object. Note the I2C version of the sensor class is used.
+SfeFPC2534I2C mySensor;
+
+// The library state - kept in RTC memory across deep sleep
+SFE_FPC2534_RETAINED sfDevFPC2534State_t savedState;
+
+// The number of wakes - also kept across deep sleep
+SFE_FPC2534_RETAINED uint32_t wakeCount = 0;
+
+// Max time awake waiting for the identify result after a wake
+const uint32_t kWakeTimeoutMs = 10000;
+
+// Max time to wait for the sensor to boot
+const uint32_t kBootTimeoutMs = 2000;
+
+// Set by the callbacks
+bool identifyDone = false;
+
+//------------------------------------------------------------------------------------
+// Callback functions the library calls
+//------------------------------------------------------------------------------------
+static void on_error(uint16_t error)
+{
+    // Just print the error code
+    Serial.print("[ERROR] code:\t");
+    Serial.println(error);
+
+    // No templates enrolled, or another failure - go back to sleep and try again on the next touch
+    identifyDone = true;
+}
+
+//----------------------------------------------------------------------------
+static void on_identify(bool is_match, uint16_t id)
+{
+    if (is_match)
+    {
+        Serial.print("[IDENTIFY]\tMATCH {Template ID: ");
+        Serial.print(id);
+        Serial.println("}");
+    }
+    else
+        Serial.println("[IDENTIFY]\tNO MATCH");
+
+    identifyDone = true;
+}
+
+// Define our command callbacks structure - callback methods are assigned in setup
+static sfDevFPC2534Callbacks_t cmd_cb = {0};
+
+//------------------------------------------------------------------------------------
+// reset_sensor()
+//
+// Simple function to toggle the reset pin of the sensor
+//
+void reset_sensor(void)
+{
+    mySensor.clearData();
+    pinMode(RST_PIN, OUTPUT);
+    digitalWrite(RST_PIN, LOW); // Set reset pin low
+    delay(10);                  // Wait for 10 ms
+
+    digitalWrite(RST_PIN, HIGH); // Set reset pin high - waitForBoot() waits for the sensor to initialize
+}
+
+//------------------------------------------------------------------------------------
+// sleep_until_touch()
+//
+// Start an identify operation, save the library state and enter deep sleep until the sensor raises the IRQ pin
+//
+void sleep_until_touch(void)
+{
+    fpc_id_type_t id = {ID_TYPE_ALL, 0};
+    fpc_result_t rc = mySensor.requestIdentify(id, (uint16_t)wakeCount);
+    if (rc != FPC_RESULT_OK)
+    {
+        Serial.print("[ERROR]\tIdentify request failed - error: ");
+        Serial.println(rc);
+    }
+
+    // Process the response to the request - the sensor is then waiting for a finger, with the IRQ pin low
+    for (uint32_t start = millis(); millis() - start < 500;)
+    {
+        mySensor.waitForEvent(50);
+        if (mySensor.currentMode() == STATE_IDENTIFY && !mySensor.isDataAvailable())
+            break;
+    }
+
+    mySensor.saveState(savedState);
+
+    Serial.println("[SLEEP]\t\tPlace a finger on the sensor to wake up");
+    Serial.flush();
+
+    esp_sleep_enable_ext0_wakeup((gpio_num_t)IRQ_PIN, 1);
+    esp_deep_sleep_start();
+}
+
+//------------------------------------------------------------------------------------
+// setup()
+//
+void setup()
+{
+    Serial.begin(115200);
+
+    bool touchWake = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0;
+
+    cmd_cb.on_error = on_error;
+    cmd_cb.on_identify = on_identify;
+    mySensor.setCallbacks(cmd_cb);
+
+    // Initialize the I2C communication and the sensor library
+    Wire.begin();
+    if (!mySensor.begin(kFPC2534DefaultAddress, Wire, I2C_BUS, IRQ_PIN))
+    {
+        Serial.println("[ERROR]\tFPC2534 not found. Check wiring. HALT.");
+        while (1)
+            delay(1000);
+    }
+
+    // Woken by the sensor? Restore the library state - the result is waiting to be read.
+    if (touchWake && mySensor.restoreState(savedState))
+    {
+        wakeCount++;
+        return;
+    }
+
+    // First startup - reset the sensor and wait for it to report ready (the boot handshake)
+    delay(2000);
+    Serial.println();
+    Serial.println("----------------------------------------------------------------");
+    Serial.println(" SparkFun FPC2534 Deep Sleep Identify Example - I2C");
+    Serial.println("----------------------------------------------------------------");
+    Serial.println();
+
+    reset_sensor();
+    if (mySensor.waitForBoot(kBootTimeoutMs, true) != FPC_RESULT_OK)
+    {
+        Serial.println("[ERROR]\tFPC2534 not ready. HALT.");
+        while (1)
+            delay(1000);
+    }
+    Serial.print("[STARTUP]\tFPC2534 Device is ready - after ");
+    Serial.print(mySensor.bootTimeMs());
+    Serial.println(" ms");
+
+    sleep_until_touch();
+}
+
+//------------------------------------------------------------------------------------
+void loop()
+{
+    // Read the frames the sensor has waiting - ending with the identify result
+    fpc_result_t rc = mySensor.waitForEvent(100);
+    if (rc != FPC_RESULT_OK)
+    {
+        Serial.print("[ERROR] Processing Error: ");
+        Serial.println(rc);
+    }
+
+    // Woken, but no result? Go back to sleep
+    if (!identifyDone && millis() > kWakeTimeoutMs)
+    {
+        Serial.println("[ERROR]\tNo identify result");
+        sleep_until_touch();
+    }
+
+    if (identifyDone)
+    {
+        // millis() started at the wake - the ESP32 boots from deep sleep
+        Serial.print("[TIMING]\tWake #");
+        Serial.print(wakeCount);
+        Serial.print(": ");
+        Serial.print(millis());
+        Serial.print(" ms from wake to result, ");
+        Serial.print(mySensor.wakeToResultUs());
+        Serial.println(" us of it after the state restore");
+
+        identifyDone = false;
+        sleep_until_touch();
+    }
+}
@@ -0,0 +1,213 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Example of several SparkFun FPC2534 Fingerprint sensors run from one loop with the multi-sensor manager of the
+ * library.
+ *
+ * Two sensors share the Wire bus - each at its own I2C address (the i2c_address setting of the sensor system
+ * configuration) - and a third sensor is on the Wire1 bus. All three run continuous identify. The manager pumps
+ * the sensors with data from their IRQ pins, one frame each in turn, and serializes the access to each bus. The
+ * identify results are printed with the sensor they came from.
+ *
+ * NOTE: ESP32 or RP2 boards only - each sensor needs its own IRQ pin, with its own interrupt handler.
+ *
+ * Example Setup:
+ *  - Set the I2C address of the second sensor to 0x25 (see Example07_ConfigI2C), then connect both sensors to
+ *    the Wire bus of your board with qwiic cables.
+ *  - Connect the third sensor to the Wire1 bus, and update the SDA1_PIN and SCL1_PIN defines below.
+ *  - Connect the IRQ pin of each sensor to a digital pin on your microcontroller, and update the IRQ_PIN defines.
+ *  - Enroll a fingerprint on each sensor first - see Example02_EnrollI2C.
+ *
+ * Operation:
+ *  - The sensors are started, and continuous identify is started on each
+ *  - Place a finger on any sensor - the result is printed with the sensor number
+ *  - Every 30 seconds, the frames, errors and latency of each sensor are printed
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "SparkFun_FPC2534.h"
+
+#if !defined(ESP32) && !defined(ARDUINO_ARCH_RP2040)
+#error "This example requires an ESP32 or RP2 board"
+#endif
+
+//----------------------------------------------------------------------------
+// User Config -
+//----------------------------------------------------------------------------
+// UPDATE THESE DEFINES TO MATCH YOUR HARDWARE SETUP
+//
+// The IRQ pins of the sensors, the I2C address of the second sensor and the pins of the second bus.
+
+#define IRQ_PIN_0 26
+#define IRQ_PIN_1 25
+#define IRQ_PIN_2 33
+
+#define SENSOR_1_ADDRESS 0x25
+
+#define SDA1_PIN 16
+#define SCL1_PIN 17
+
+// The number of sensors
+#define NUM_SENSORS 3
+
+// Declare our sensor objects, and the manager that runs them
+SfeFPC2534I2C mySensors[NUM_SENSORS];
+sfDevFPC2534Manager myManager;
+
+// Time between statistics printouts
+const uint32_t kStatsIntervalMs = 30000;
+uint32_t lastStatsMs = 0;
+
+// Max time to wait for each sensor to boot
+const uint32_t kBootTimeoutMs = 2000;
+
+//------------------------------------------------------------------------------------
+// Callback functions the library calls - the same callbacks are used by all the sensors, the manager tells
+// which sensor they are called for.
+//------------------------------------------------------------------------------------
+static void on_error(uint16_t error)
+{
+    Serial.print("[ERROR]\t\tSensor ");
+    Serial.print(myManager.currentSensor());
+    Serial.print(" code: ");
+    Serial.println(error);
+}
+
+//----------------------------------------------------------------------------
+static void on_identify(bool is_match, uint16_t id)
+{
+    Serial.print("[IDENTIFY]\tSensor ");
+    Serial.print(myManager.currentSensor());
+    if (is_match)
+    {
+        Serial.print(": MATCH {Template ID: ");
+        Serial.print(id);
+        Serial.println("}");
+    }
+    else
+        Serial.println(": NO MATCH");
+}
+
+// Define our command callbacks structure - callback methods are assigned in setup
+static sfDevFPC2534Callbacks_t cmd_cb = {0};
+
+//------------------------------------------------------------------------------------
+// print_stats()
+//
+// Print the statistics the manager keeps for each sensor
+//
+void print_stats(void)
+{
+    for (uint8_t i = 0; i < myManager.sensorCount(); i++)
+    {
+        sfDevFPC2534ManagerStats_t stats;
+        myManager.getStats(i, stats);
+
+        Serial.print("[STATS]\t\tSensor ");
+        Serial.print(i);
+        Serial.print(": ");
+        Serial.print(stats.frames);
+        Serial.print(" frames, ");
+        Serial.print(stats.errors);
+        Serial.print(" errors, ");
+        Serial.print(stats.deferrals);
+        Serial.print(" bus deferrals, latency avg ");
+        Serial.print(stats.frames > 0 ? stats.totalLatencyUs / stats.frames : 0);
+        Serial.print(" us, max ");
+        Serial.print(stats.maxLatencyUs);
+        Serial.println(" us");
+    }
+}
+
+//------------------------------------------------------------------------------------
+// setup()
+//
+void setup()
+{
+    delay(2000);
+    Serial.begin(115200);
+    Serial.println();
+    Serial.println("----------------------------------------------------------------");
+    Serial.println(" SparkFun FPC2534 Multi-Sensor Example - I2C");
+    Serial.println("----------------------------------------------------------------");
+    Serial.println();
+
+    cmd_cb.on_error = on_error;
+    cmd_cb.on_identify = on_identify;
+
+    // Start both buses
+    Wire.begin();
+#if defined(ESP32)
+    Wire1.begin(SDA1_PIN, SCL1_PIN);
+#else
+    Wire1.setSDA(SDA1_PIN);
+    Wire1.setSCL(SCL1_PIN);
+    Wire1.begin();
+#endif
+
+    // The address, Wire port, bus number and IRQ pin of each sensor
+    const uint8_t addresses[NUM_SENSORS] = {kFPC2534DefaultAddress, SENSOR_1_ADDRESS, kFPC2534DefaultAddress};
+    TwoWire *ports[NUM_SENSORS] = {&Wire, &Wire, &Wire1};
+    const uint8_t buses[NUM_SENSORS] = {0, 0, 1};
+    const uint32_t irqPins[NUM_SENSORS] = {IRQ_PIN_0, IRQ_PIN_1, IRQ_PIN_2};
+
+    for (uint8_t i = 0; i < NUM_SENSORS; i++)
+    {
+        // Set the callbacks before begin() - the boot handshake runs in begin()
+        mySensors[i].setCallbacks(cmd_cb);
+        if (!mySensors[i].begin(addresses[i], *ports[i], buses[i], irqPins[i], kBootTimeoutMs))
+        {
+            Serial.print("[ERROR]\tSensor ");
+            Serial.print(i);
+            Serial.println(" not found or not ready. Check wiring. HALT.");
+            while (1)
+                delay(1000);
+        }
+
+        // Add the sensor to the manager - on its bus
+        myManager.addSensor(mySensors[i], buses[i]);
+
+        fpc_id_type_t id = {ID_TYPE_ALL, 0};
+        fpc_result_t rc = mySensors[i].startContinuousIdentify(id);
+        if (rc != FPC_RESULT_OK)
+        {
+            Serial.print("[ERROR]\tSensor ");
+            Serial.print(i);
+            Serial.print(" failed to start identify - error: ");
+            Serial.println(rc);
+        }
+    }
+
+    Serial.println("[STARTUP]\tPlace a finger on any sensor");
+    lastStatsMs = millis();
+}
+
+//------------------------------------------------------------------------------------
+void loop()
+{
+    // One loop for all the sensors - wait for any of them to have data, then service them in turn
+    fpc_result_t rc = myManager.waitForEvent(100);
+    if (rc != FPC_RESULT_OK)
+    {
+        Serial.print("[ERROR] Processing Error: ");
+        Serial.println(rc);
+    }
+
+    if (millis() - lastStatsMs >= kStatsIntervalMs)
+    {
+        print_stats();
+        lastStatsMs = millis();
+    }
+}
@@ -0,0 +1,233 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Example of backing up the fingerprint templates of a SparkFun FPC2534 Fingerprint sensor to a file on the
+ * LittleFS file system of the board, and restoring them - to the same sensor, or to a replacement sensor.
+ *
+ * The templates are read from the sensor and written to the file in chunks, compressed, with a CRC for each
+ * template. A restore reads the file in one pass, and sends each template to the sensor as it is read - a template
+ * is only stored on the sensor if its CRC is good.
+ *
+ * NOTE: ESP32 or RP2 boards only - with a LittleFS partition (RP2: set a file system size in the Flash Size menu).
+ *
+ * Example Setup:
+ *  - Connect the sensor to the Wire bus of your board with a qwiic cable
+ *  - Connect the IRQ pin of the sensor to a digital pin on your microcontroller, and update the IRQ_PIN define
+ *  - Enroll a fingerprint or two first - see Example02_EnrollI2C
+ *
+ * Operation:
+ *  - Press 1 to back up the templates of the sensor to /templates.fpcb
+ *  - Press 2 to restore /templates.fpcb to the sensor
+ *  - Press 3 to delete the templates on the sensor (to try a restore)
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <Wire.h>
+
+#include "SparkFun_FPC2534.h"
+
+#if !defined(ESP32) && !defined(ARDUINO_ARCH_RP2040)
+#error "This example requires an ESP32 or RP2 board"
+#endif
+
+//----------------------------------------------------------------------------
+// User Config -
+//----------------------------------------------------------------------------
+// UPDATE THIS DEFINE TO MATCH YOUR HARDWARE SETUP
+#define IRQ_PIN 26
+
+// The backup file
+const char *kBackupFile = "/templates.fpcb";
+
+// Declare our sensor object, and the backup object
+SfeFPC2534I2C mySensor;
+sfDevFPC2534TemplateBackup myBackup;
+
+// Max time to wait for the sensor to boot
+const uint32_t kBootTimeoutMs = 2000;
+
+//------------------------------------------------------------------------------------
+// Callback functions the library calls
+//------------------------------------------------------------------------------------
+static void on_error(uint16_t error)
+{
+    Serial.print("[ERROR]\tSensor Error Code: ");
+    Serial.println(error);
+}
+
+// Define our command callbacks structure - callback methods are assigned in setup
+static sfDevFPC2534Callbacks_t cmd_cb = {0};
+
+//------------------------------------------------------------------------------------
+// print_result()
+//
+// Print the result and statistics of a backup or restore
+//
+static void print_result(const char *what, fpc_result_t rc)
+{
+    sfDevFPC2534BackupStats_t stats;
+    myBackup.getStats(stats);
+
+    if (rc != FPC_RESULT_OK)
+    {
+        Serial.print("[ERROR]\t");
+        Serial.print(what);
+        Serial.print(" failed - error: ");
+        Serial.println(rc);
+    }
+    Serial.print("[");
+    Serial.print(what);
+    Serial.print("]\t");
+    Serial.print(stats.templates);
+    Serial.print(" templates, ");
+    Serial.print(stats.bytes);
+    Serial.print(" bytes, ");
+    Serial.print(stats.stored);
+    Serial.print(" bytes in the file, ");
+    Serial.print(stats.elapsedMs);
+    Serial.println(" ms");
+}
+
+//------------------------------------------------------------------------------------
+// Back up the templates of the sensor to the file
+//
+static void backup_templates(void)
+{
+    File file = LittleFS.open(kBackupFile, "w");
+    if (!file)
+    {
+        Serial.println("[ERROR]\tUnable to create the backup file");
+        return;
+    }
+
+    sfDevFPC2534BackupStream storage(file);
+    fpc_result_t rc = myBackup.backup(mySensor, storage);
+    file.close();
+
+    // Don't keep a partial backup
+    if (rc != FPC_RESULT_OK)
+        LittleFS.remove(kBackupFile);
+
+    print_result("BACKUP", rc);
+}
+
+//------------------------------------------------------------------------------------
+// Restore the file to the sensor
+//
+static void restore_templates(void)
+{
+    File file = LittleFS.open(kBackupFile, "r");
+    if (!file)
+    {
+        Serial.println("[ERROR]\tNo backup file - make a backup first");
+        return;
+    }
+
+    sfDevFPC2534BackupStream storage(file);
+    fpc_result_t rc = myBackup.restore(mySensor, storage);
+    file.close();
+
+    print_result("RESTORE", rc);
+}
+
+//------------------------------------------------------------------------------------
+static void draw_menu(void)
+{
+    Serial.println();
+    Serial.println(" Select an option (press the menu number):");
+    Serial.println("\t1)  Back up the templates of the sensor");
+    Serial.println("\t2)  Restore the backup to the sensor");
+    Serial.println("\t3)  Delete the templates on the sensor");
+    Serial.print("> ");
+}
+
+//------------------------------------------------------------------------------------
+// setup()
+//
+void setup()
+{
+    delay(2000);
+    Serial.begin(115200);
+    Serial.println();
+    Serial.println("----------------------------------------------------------------");
+    Serial.println(" SparkFun FPC2534 Template Backup Example - I2C");
+    Serial.println("----------------------------------------------------------------");
+    Serial.println();
+
+    // Mount the file system - format it on first use (RP2 LittleFS formats by default)
+#if defined(ESP32)
+    bool mounted = LittleFS.begin(true);
+#else
+    bool mounted = LittleFS.begin();
+#endif
+    if (!mounted)
+    {
+        Serial.println("[ERROR]\tUnable to mount LittleFS. HALT.");
+        while (1)
+            delay(1000);
+    }
+
+    cmd_cb.on_error = on_error;
+
+    Wire.begin();
+
+    // Set the callbacks before begin() - the boot handshake runs in begin()
+    mySensor.setCallbacks(cmd_cb);
+    if (!mySensor.begin(kFPC2534DefaultAddress, Wire, 0, IRQ_PIN, kBootTimeoutMs))
+    {
+        Serial.println("[ERROR]\tSensor not found or not ready. Check wiring. HALT.");
+        while (1)
+            delay(1000);
+    }
+
+    draw_menu();
+}
+
+//------------------------------------------------------------------------------------
+void loop()
+{
+    // Keep the library going - responses and the watchdog
+    mySensor.processNextResponse();
+
+    if (Serial.available() == 0)
+    {
+        delay(10);
+        return;
+    }
+
+    char chIn = Serial.read();
+    if (chIn != '1' && chIn != '2' && chIn != '3')
+        return;
+
+    Serial.println(chIn);
+
+    if (chIn == '1')
+        backup_templates();
+    else if (chIn == '2')
+        restore_templates();
+    else
+    {
+        fpc_id_type_t id = {ID_TYPE_ALL, 0};
+        fpc_result_t rc = mySensor.requestDeleteTemplate(id);
+        if (rc != FPC_RESULT_OK)
+        {
+            Serial.print("[ERROR]\tFailed to delete templates - error: ");
+            Serial.println(rc);
+        }
+        else
+            Serial.println("[DELETE]\tTemplates deleted");
+    }
+
+    draw_menu();
+}
@@ -0,0 +1,265 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Example of checking the quality of a fingerprint image captured by a SparkFun FPC2534 Fingerprint sensor.
+ *
+ * The raw image is analyzed as it is read from the sensor - only one row of the image is held in memory. The
+ * contrast, clarity (how sharp the ridges are) and coverage (how much of the sensor the finger covers) of the
+ * image are printed, with a map of the clarity of the image. With early reject set, the read stops as soon as the
+ * finger can no longer cover enough of the sensor.
+ *
+ * The analysis speed of the board (megapixels per second) can be measured with a generated image - no sensor
+ * needed.
+ *
+ * Example Setup:
+ *  - Connect the sensor to the Wire bus of your board with a qwiic cable
+ *  - Connect the IRQ pin of the sensor to a digital pin on your microcontroller, and update the IRQ_PIN define
+ *
+ * Operation:
+ *  - Press 1, then place a finger on the sensor - the image is captured and analyzed
+ *  - Press 2 to measure the analysis speed
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "SparkFun_FPC2534.h"
+
+//----------------------------------------------------------------------------
+// User Config -
+//----------------------------------------------------------------------------
+// UPDATE THIS DEFINE TO MATCH YOUR HARDWARE SETUP
+#define IRQ_PIN 26
+
+// Declare our sensor object, and the image analyzer
+SfeFPC2534I2C mySensor;
+sfDevFPC2534ImageAnalyzer myAnalyzer;
+
+// Max time to wait for the sensor to boot
+const uint32_t kBootTimeoutMs = 2000;
+
+// Set when a capture was requested, when the image is ready, and while it is read
+static bool capturing = false;
+static bool imageReady = false;
+static bool reading = false;
+
+//------------------------------------------------------------------------------------
+// Callback functions the library calls
+//------------------------------------------------------------------------------------
+static void on_error(uint16_t error)
+{
+    Serial.print("[ERROR]\tSensor Error Code: ");
+    Serial.println(error);
+}
+
+static void on_status(uint16_t event, uint16_t state)
+{
+    if (event == EVENT_IMAGE_READY && capturing)
+        imageReady = true;
+}
+
+// Define our command callbacks structure - callback methods are assigned in setup
+static sfDevFPC2534Callbacks_t cmd_cb = {0};
+
+//------------------------------------------------------------------------------------
+// print_quality()
+//
+// Print the quality of the image, and the clarity map - one character for each 8 x 8 block
+//
+static void print_quality(void)
+{
+    sfDevFPC2534ImageQuality_t quality;
+    myAnalyzer.getQuality(quality);
+
+    Serial.print("[QUALITY]\tContrast: ");
+    Serial.print(quality.contrast);
+    Serial.print(", clarity: ");
+    Serial.print(quality.clarity);
+    Serial.print(", coverage: ");
+    Serial.print(quality.coverage);
+    Serial.print("%, mean: ");
+    Serial.print(quality.mean);
+    Serial.print(" - ");
+    if (myAnalyzer.isRejected())
+        Serial.println("rejected while read");
+    else
+        Serial.println(myAnalyzer.isAcceptable() ? "acceptable" : "poor");
+
+    // blank for background, then lighter to darker with clarity
+    static const char kShades[] = " .:-=+*#";
+    const uint8_t *map = myAnalyzer.clarityMap();
+    uint16_t rows = (uint16_t)(quality.pixels / myAnalyzer.mapWidth() / kFPC2534QualityBlock / kFPC2534QualityBlock);
+    for (uint16_t row = 0; row < rows && row < myAnalyzer.mapHeight(); row++)
+    {
+        Serial.print("\t\t");
+        for (uint16_t col = 0; col < myAnalyzer.mapWidth(); col++)
+        {
+            uint8_t clarity = map[row * myAnalyzer.mapWidth() + col];
+            Serial.print(clarity < kFPC2534ForegroundThreshold ? ' ' : kShades[1 + (clarity > 69 ? 6 : clarity / 10)]);
+        }
+        Serial.println();
+    }
+}
+
+//------------------------------------------------------------------------------------
+// measure_speed()
+//
+// Analyze a generated 160 x 160 image, row by row, with the scalar kernel and the vector kernel of the board
+//
+static void measure_speed(void)
+{
+    const uint16_t kSize = 160;
+    const uint16_t kFrames = 50;
+
+    // a row of ridges - every row of the image is the same, shifted
+    static uint8_t ridges[kSize * 2];
+    for (uint16_t i = 0; i < sizeof(ridges); i++)
+        ridges[i] = (i % 9) < 4 ? 40 : 210;
+
+    const sfDevFPC2534QualityKernel_t kernels[] = {kFPC2534QualityScalar, kFPC2534QualityAuto};
+    for (sfDevFPC2534QualityKernel_t kernel : kernels)
+    {
+        myAnalyzer.setKernel(kernel);
+        if (kernel == kFPC2534QualityAuto && myAnalyzer.kernel() == kFPC2534QualityScalar)
+            break;
+
+        uint32_t start = micros();
+        for (uint16_t frame = 0; frame < kFrames; frame++)
+        {
+            myAnalyzer.begin(kSize, kSize);
+            for (uint16_t row = 0; row < kSize; row++)
+                myAnalyzer.add(ridges + row % kSize, kSize);
+        }
+        uint32_t elapsed = micros() - start;
+
+        Serial.print("[SPEED]\t\t");
+        Serial.print(myAnalyzer.kernel() == kFPC2534QualityScalar ? "Scalar" : "Vector");
+        Serial.print(" kernel: ");
+        Serial.print((float)kFrames * kSize * kSize / elapsed, 2);
+        Serial.print(" MP/s, ");
+        Serial.print(elapsed / kFrames);
+        Serial.println(" us per image");
+    }
+    myAnalyzer.setKernel(kFPC2534QualityAuto);
+}
+
+//------------------------------------------------------------------------------------
+static void draw_menu(void)
+{
+    Serial.println();
+    Serial.println(" Select an option (press the menu number):");
+    Serial.println("\t1)  Capture an image, and check its quality");
+    Serial.println("\t2)  Measure the analysis speed");
+    Serial.print("> ");
+}
+
+//------------------------------------------------------------------------------------
+// setup()
+//
+void setup()
+{
+    delay(2000);
+    Serial.begin(115200);
+    Serial.println();
+    Serial.println("----------------------------------------------------------------");
+    Serial.println(" SparkFun FPC2534 Image Quality Example - I2C");
+    Serial.println("----------------------------------------------------------------");
+    Serial.println();
+
+    cmd_cb.on_error = on_error;
+    cmd_cb.on_status = on_status;
+
+    Wire.begin();
+
+    // Set the callbacks before begin() - the boot handshake runs in begin()
+    mySensor.setCallbacks(cmd_cb);
+    if (!mySensor.begin(kFPC2534DefaultAddress, Wire, 0, IRQ_PIN, kBootTimeoutMs))
+        Serial.println("[ERROR]\tSensor not found or not ready. Check wiring - only the speed test is available.");
+
+    // Stop reading an image that can't cover enough of the sensor
+    myAnalyzer.setLimits(kFPC2534DefaultQualityLimits, true);
+
+    draw_menu();
+}
+
+//------------------------------------------------------------------------------------
+void loop()
+{
+    // Keep the library going - responses, the image transfer and the watchdog
+    mySensor.processNextResponse();
+
+    // The image is ready - read and analyze it
+    if (imageReady)
+    {
+        imageReady = false;
+        capturing = false;
+        fpc_result_t rc = myAnalyzer.requestImage(mySensor);
+        if (rc != FPC_RESULT_OK)
+        {
+            Serial.print("[ERROR]\tFailed to read the image - error: ");
+            Serial.println(rc);
+            draw_menu();
+        }
+        else
+            reading = true;
+        return;
+    }
+
+    // The image was read - or rejected part way
+    if (reading && !mySensor.isTransferActive())
+    {
+        reading = false;
+        if (myAnalyzer.isRejected())
+            mySensor.requestAbort();
+
+        if (myAnalyzer.isRejected() || mySensor.transferResult() == FPC_RESULT_OK)
+            print_quality();
+        else
+        {
+            Serial.print("[ERROR]\tFailed to read the image - error: ");
+            Serial.println(mySensor.transferResult());
+        }
+        draw_menu();
+        return;
+    }
+
+    if (Serial.available() == 0)
+    {
+        delay(1);
+        return;
+    }
+
+    char chIn = Serial.read();
+    if (chIn != '1' && chIn != '2')
+        return;
+
+    Serial.println(chIn);
+
+    if (chIn == '1')
+    {
+        fpc_result_t rc = mySensor.requestCapture();
+        if (rc != FPC_RESULT_OK)
+        {
+            Serial.print("[ERROR]\tFailed to start the capture - error: ");
+            Serial.println(rc);
+            draw_menu();
+            return;
+        }
+        Serial.println("[CAPTURE]\tPlace a finger on the sensor");
+        capturing = true;
+        return;
+    }
+
+    measure_speed();
+    draw_menu();
+}
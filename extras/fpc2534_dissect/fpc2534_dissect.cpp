@@ -0,0 +1,956 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * fpc2534_dissect - host side frame dissector for the FPC2534 fingerprint sensor.
+ *
+ * Decodes the FPC2534 frame protocol (see fpc_api.h) from a captured trace or a live
+ * serial port and prints each frame in a human readable form. At the end of a run, per
+ * command timing statistics (request to response latency), inter-frame gaps, resync
+ * events and host retransmits are reported.
+ *
+ * Input sources:
+ *
+ *   Text trace  (-f file)    One record per line:  <time> <TX|RX> <hex bytes ...>
+ *                            <time> is in microseconds, or seconds if it contains a '.'
+ *                            TX = host to sensor, RX = sensor to host. Lines starting with
+ *                            '#' are ignored. A frame may span several lines.
+ *
+ *   Raw capture (-r file)    Raw sensor to host byte stream (no timing information).
+ *
+ *   Live port   (-t tty)     Sensor to host stream from a serial port/tap. Use -T to add a
+ *                            second tap on the host to sensor line. Stop with Ctrl-C.
+ *
+ * Build (Linux/macOS):
+ *
+ *   g++ -std=c++17 -O2 -o fpc2534_dissect fpc2534_dissect.cpp
+ */
+
+#include "../../src/sfTk/fpc_api.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------
+// Name tables
+//--------------------------------------------------------------------------------------------
+static const char *cmdName(uint16_t cmd)
+{
+    switch (cmd)
+    {
+    case CMD_STATUS:
+        return "STATUS";
+    case CMD_VERSION:
+        return "VERSION";
+    case CMD_BIST:
+        return "BIST";
+    case CMD_CAPTURE:
+        return "CAPTURE";
+    case CMD_ABORT:
+        return "ABORT";
+    case CMD_IMAGE_DATA:
+        return "IMAGE_DATA";
+    case CMD_ENROLL:
+        return "ENROLL";
+    case CMD_IDENTIFY:
+        return "IDENTIFY";
+    case CMD_LIST_TEMPLATES:
+        return "LIST_TEMPLATES";
+    case CMD_DELETE_TEMPLATE:
+        return "DELETE_TEMPLATE";
+    case CMD_GET_TEMPLATE_DATA:
+        return "GET_TEMPLATE_DATA";
+    case CMD_PUT_TEMPLATE_DATA:
+        return "PUT_TEMPLATE_DATA";
+    case CMD_GET_SYSTEM_CONFIG:
+        return "GET_SYSTEM_CONFIG";
+    case CMD_SET_SYSTEM_CONFIG:
+        return "SET_SYSTEM_CONFIG";
+    case CMD_RESET:
+        return "RESET";
+    case CMD_SET_CRYPTO_KEY:
+        return "SET_CRYPTO_KEY";
+    case CMD_SET_DBG_LOG_LEVEL:
+        return "SET_DBG_LOG_LEVEL";
+    case CMD_FACTORY_RESET:
+        return "FACTORY_RESET";
+    case CMD_DATA_GET:
+        return "DATA_GET";
+    case CMD_DATA_PUT:
+        return "DATA_PUT";
+    case CMD_NAVIGATION:
+        return "NAVIGATION";
+    case CMD_NAVIGATION_PS:
+        return "NAVIGATION_PS";
+    case CMD_GPIO_CONTROL:
+        return "GPIO_CONTROL";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+static const char *frameTypeName(uint16_t type)
+{
+    switch (type)
+    {
+    case FPC_FRAME_TYPE_CMD_REQUEST:
+        return "REQ";
+    case FPC_FRAME_TYPE_CMD_RESPONSE:
+        return "RSP";
+    case FPC_FRAME_TYPE_CMD_EVENT:
+        return "EVT";
+    default:
+        return "???";
+    }
+}
+
+static const char *eventName(uint16_t event)
+{
+    switch (event)
+    {
+    case EVENT_NONE:
+        return "NONE";
+    case EVENT_IDLE:
+        return "IDLE";
+    case EVENT_FINGER_DETECT:
+        return "FINGER_DETECT";
+    case EVENT_FINGER_LOST:
+        return "FINGER_LOST";
+    case EVENT_IMAGE_READY:
+        return "IMAGE_READY";
+    case EVENT_CMD_FAILED:
+        return "CMD_FAILED";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+static const char *enrollFeedbackName(uint8_t feedback)
+{
+    switch (feedback)
+    {
+    case ENROLL_FEEDBACK_DONE:
+        return "DONE";
+    case ENROLL_FEEDBACK_PROGRESS:
+        return "PROGRESS";
+    case ENROLL_FEEDBACK_REJECT_LOW_QUALITY:
+        return "REJECT_LOW_QUALITY";
+    case ENROLL_FEEDBACK_REJECT_LOW_COVERAGE:
+        return "REJECT_LOW_COVERAGE";
+    case ENROLL_FEEDBACK_REJECT_LOW_MOBILITY:
+        return "REJECT_LOW_MOBILITY";
+    case ENROLL_FEEDBACK_REJECT_OTHER:
+        return "REJECT_OTHER";
+    case ENROLL_FEEDBACK_PROGRESS_IMMOBILE:
+        return "PROGRESS_IMMOBILE";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+static const char *gestureName(uint16_t gesture)
+{
+    switch (gesture)
+    {
+    case CMD_NAV_EVENT_NONE:
+        return "NONE";
+    case CMD_NAV_EVENT_UP:
+        return "UP";
+    case CMD_NAV_EVENT_DOWN:
+        return "DOWN";
+    case CMD_NAV_EVENT_RIGHT:
+        return "RIGHT";
+    case CMD_NAV_EVENT_LEFT:
+        return "LEFT";
+    case CMD_NAV_EVENT_PRESS:
+        return "PRESS";
+    case CMD_NAV_EVENT_LONG_PRESS:
+        return "LONG_PRESS";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+static const char *idTypeName(uint16_t type)
+{
+    switch (type)
+    {
+    case ID_TYPE_NONE:
+        return "NONE";
+    case ID_TYPE_ALL:
+        return "ALL";
+    case ID_TYPE_SPECIFIED:
+        return "SPECIFIED";
+    case ID_TYPE_GENERATE_NEW:
+        return "GENERATE_NEW";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+static std::string stateBits(uint16_t state)
+{
+    static const struct
+    {
+        uint16_t bit;
+        const char *name;
+    } kBits[] = {{STATE_APP_FW_READY, "APP_FW_READY"},   {STATE_SECURE_INTERFACE, "SECURE_INTERFACE"},
+                 {STATE_CAPTURE, "CAPTURE"},             {STATE_IMAGE_AVAILABLE, "IMAGE_AVAILABLE"},
+                 {STATE_DATA_TRANSFER, "DATA_TRANSFER"}, {STATE_FINGER_DOWN, "FINGER_DOWN"},
+                 {STATE_SYS_ERROR, "SYS_ERROR"},         {STATE_ENROLL, "ENROLL"},
+                 {STATE_IDENTIFY, "IDENTIFY"},           {STATE_NAVIGATION, "NAVIGATION"}};
+
+    std::string out;
+    uint16_t known = 0;
+    for (const auto &b : kBits)
+    {
+        known |= b.bit;
+        if (state & b.bit)
+        {
+            if (!out.empty())
+                out += "|";
+            out += b.name;
+        }
+    }
+    if (state & ~known)
+    {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "0x%04X", state & ~known);
+        if (!out.empty())
+            out += "|";
+        out += buf;
+    }
+    return out.empty() ? "-" : out;
+}
+
+//--------------------------------------------------------------------------------------------
+// Payload decoder - prints a one line summary of the command payload
+//--------------------------------------------------------------------------------------------
+template <typename T> static const T *asCmd(const uint8_t *payload, size_t size)
+{
+    return size >= sizeof(T) ? (const T *)payload : nullptr;
+}
+
+static void decodePayload(const fpc_frame_hdr_t &frame, const uint8_t *payload, size_t size)
+{
+    if (size < sizeof(fpc_cmd_hdr_t))
+    {
+        printf("  <short payload: %zu bytes>", size);
+        return;
+    }
+    const fpc_cmd_hdr_t *cmd = (const fpc_cmd_hdr_t *)payload;
+    bool isRequest = frame.type == FPC_FRAME_TYPE_CMD_REQUEST;
+
+    printf("  %-17s", cmdName(cmd->cmd_id));
+
+    switch (cmd->cmd_id)
+    {
+    case CMD_STATUS:
+        if (auto s = asCmd<fpc_cmd_status_response_t>(payload, size))
+        {
+            printf(" event=%s state=%s", eventName(s->event), stateBits(s->state).c_str());
+            if (s->app_fail_code)
+                printf(" app_fail=%u", s->app_fail_code);
+        }
+        break;
+
+    case CMD_VERSION:
+        if (auto v = asCmd<fpc_cmd_version_response_t>(payload, size))
+        {
+            size_t len = std::min<size_t>(v->version_str_len, size - sizeof(fpc_cmd_version_response_t));
+            printf(" fw_id=%u fuse=%u uid=%08X%08X%08X \"%.*s\"", v->fw_id, v->fw_fuse_level, v->mcu_unique_id[0],
+                   v->mcu_unique_id[1], v->mcu_unique_id[2], (int)strnlen(v->version_str, len), v->version_str);
+        }
+        break;
+
+    case CMD_ENROLL:
+        if (isRequest)
+        {
+            if (auto r = asCmd<fpc_cmd_enroll_request_t>(payload, size))
+                printf(" id=%s:%u", idTypeName(r->tpl_id.type), r->tpl_id.id);
+        }
+        else if (auto e = asCmd<fpc_cmd_enroll_status_response_t>(payload, size))
+            printf(" id=%u feedback=%s remaining=%u", e->id, enrollFeedbackName(e->feedback), e->samples_remaining);
+        break;
+
+    case CMD_IDENTIFY:
+        if (isRequest)
+        {
+            if (auto r = asCmd<fpc_cmd_identify_request_t>(payload, size))
+                printf(" id=%s:%u tag=%u", idTypeName(r->tpl_id.type), r->tpl_id.id, r->tag);
+        }
+        else if (auto i = asCmd<fpc_cmd_identify_status_response_t>(payload, size))
+            printf(" %s id=%s:%u tag=%u",
+                   i->match == IDENTIFY_RESULT_MATCH      ? "MATCH"
+                   : i->match == IDENTIFY_RESULT_NO_MATCH ? "NO_MATCH"
+                                                          : "?",
+                   idTypeName(i->tpl_id.type), i->tpl_id.id, i->tag);
+        break;
+
+    case CMD_DELETE_TEMPLATE:
+        if (auto r = asCmd<fpc_cmd_template_delete_request_t>(payload, size))
+            printf(" id=%s:%u", idTypeName(r->tpl_id.type), r->tpl_id.id);
+        break;
+
+    case CMD_LIST_TEMPLATES:
+        if (!isRequest)
+        {
+            if (auto l = asCmd<fpc_cmd_template_info_response_t>(payload, size))
+            {
+                size_t n = std::min<size_t>(l->number_of_templates,
+                                            (size - sizeof(fpc_cmd_template_info_response_t)) / sizeof(uint16_t));
+                printf(" count=%u ids=[", l->number_of_templates);
+                for (size_t i = 0; i < n; i++)
+                    printf(i ? ",%u" : "%u", l->template_id_list[i]);
+                printf("]");
+            }
+        }
+        break;
+
+    case CMD_GET_TEMPLATE_DATA:
+    case CMD_PUT_TEMPLATE_DATA:
+        if (isRequest)
+        {
+            if (auto r = asCmd<fpc_cmd_template_data_request_t>(payload, size))
+                printf(" id=%u total=%u", r->id, r->total_size);
+        }
+        else if (auto r = asCmd<fpc_cmd_template_data_response_t>(payload, size))
+            printf(" id=%u max_chunk=%u total=%u", r->id, r->max_chunk_size, r->total_size);
+        break;
+
+    case CMD_IMAGE_DATA:
+        if (isRequest)
+        {
+            if (auto r = asCmd<fpc_cmd_image_request_t>(payload, size))
+                printf(" type=%u total=%u", r->type, r->total_size);
+        }
+        else if (auto r = asCmd<fpc_cmd_image_response_t>(payload, size))
+            printf(" type=%u %ux%u size=%u max_chunk=%u", r->type, r->image_width, r->image_height, r->image_size,
+                   r->max_chunk_size);
+        break;
+
+    case CMD_DATA_GET:
+        if (isRequest)
+        {
+            if (auto r = asCmd<fpc_cmd_data_get_request_t>(payload, size))
+                printf(" request=%u", r->request_size);
+        }
+        else if (auto r = asCmd<fpc_cmd_data_get_response_t>(payload, size))
+            printf(" data=%u remaining=%u", r->data_size, r->remaining_size);
+        break;
+
+    case CMD_DATA_PUT:
+        if (isRequest)
+        {
+            if (auto r = asCmd<fpc_cmd_data_put_request_t>(payload, size))
+                printf(" data=%u remaining=%u", r->data_size, r->remaining_size);
+        }
+        else if (auto r = asCmd<fpc_cmd_data_put_response_t>(payload, size))
+            printf(" total_received=%u", r->total_received);
+        break;
+
+    case CMD_NAVIGATION:
+        if (isRequest)
+        {
+            if (auto r = asCmd<fpc_cmd_navigation_request_t>(payload, size))
+                printf(" orientation=%u%s", (r->config & CMD_NAV_CFG_ORIENTATION_MASK) * 90,
+                       (r->config & CMD_NAV_CFG_SKIP_FINGER_STABLE) ? " skip_stable" : "");
+        }
+        else if (auto n = asCmd<fpc_cmd_navigation_status_event_t>(payload, size))
+            printf(" gesture=%s samples=%u", gestureName(n->gesture), n->n_samples);
+        break;
+
+    case CMD_NAVIGATION_PS:
+        if (auto n = asCmd<fpc_cmd_navigation_ps_status_event_t>(payload, size))
+            printf(" v=%d h=%d coverage=%u gesture=%s", n->v_impulse, n->h_impulse, n->c_coverage,
+                   gestureName(n->gesture));
+        break;
+
+    case CMD_GPIO_CONTROL:
+        if (isRequest)
+        {
+            if (auto r = asCmd<fpc_cmd_pinctrl_gpio_request_t>(payload, size))
+                printf(" %s pin=%u mode=%u state=%u", r->sub_cmd == GPIO_CONTROL_SUB_CMD_SET ? "SET" : "GET", r->pin,
+                       r->mode, r->state);
+        }
+        else if (auto r = asCmd<fpc_cmd_pinctrl_gpio_response_t>(payload, size))
+            printf(" state=%u", r->state);
+        break;
+
+    case CMD_GET_SYSTEM_CONFIG:
+    case CMD_SET_SYSTEM_CONFIG: {
+        const fpc_system_config_t *cfg = nullptr;
+        if (cmd->cmd_id == CMD_GET_SYSTEM_CONFIG && isRequest)
+        {
+            if (auto r = asCmd<fpc_cmd_get_config_request_t>(payload, size))
+                printf(" type=%s", r->config_type == FPC_SYS_CFG_TYPE_CUSTOM ? "CUSTOM" : "DEFAULT");
+        }
+        else if (cmd->cmd_id == CMD_GET_SYSTEM_CONFIG)
+        {
+            if (auto r = asCmd<fpc_cmd_get_config_response_t>(payload, size))
+                cfg = &r->cfg;
+        }
+        else if (auto r = asCmd<fpc_cmd_set_config_request_t>(payload, size))
+            cfg = &r->cfg;
+
+        if (cfg)
+            printf(" ver=%u scan=%ums flags=0x%08X uart_irq_delay=%ums baud=%u max_fails=%u lockout=%us idle=%ums "
+                   "touches=%u immobile=%u i2c=0x%02X",
+                   cfg->version, cfg->finger_scan_interval_ms, cfg->sys_flags, cfg->uart_delay_before_irq_ms,
+                   cfg->uart_baudrate, cfg->idfy_max_consecutive_fails, cfg->idfy_lockout_time_s,
+                   cfg->idle_time_before_sleep_ms, cfg->enroll_touches, cfg->enroll_immobile_touches,
+                   cfg->i2c_address);
+        break;
+    }
+
+    case CMD_BIST:
+        if (!isRequest)
+        {
+            if (auto b = asCmd<fpc_cmd_bist_response_t>(payload, size))
+                printf(" sensor_test=%u verdict=%u", b->sensor_test_result, b->test_verdict);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// Statistics
+//--------------------------------------------------------------------------------------------
+struct LatencyStats
+{
+    uint32_t count = 0;
+    double sum = 0;
+    double sumSq = 0;
+    double min = 1e300;
+    double max = 0;
+    std::vector<double> samples;
+
+    void add(double us)
+    {
+        count++;
+        sum += us;
+        sumSq += us * us;
+        min = std::min(min, us);
+        max = std::max(max, us);
+        samples.push_back(us);
+    }
+    double percentile(double p)
+    {
+        if (samples.empty())
+            return 0;
+        std::sort(samples.begin(), samples.end());
+        size_t idx = (size_t)std::min<double>(samples.size() - 1, std::ceil(p * samples.size()) - 1);
+        return samples[idx];
+    }
+};
+
+struct PendingRequest
+{
+    uint16_t cmdId;
+    double timeUs;
+    std::vector<uint8_t> bytes;
+};
+
+//--------------------------------------------------------------------------------------------
+// The dissector - one byte stream per direction, frames are reassembled and decoded.
+//--------------------------------------------------------------------------------------------
+class Dissector
+{
+  public:
+    enum Dir
+    {
+        kTX = 0, // host -> sensor
+        kRX = 1  // sensor -> host
+    };
+
+    Dissector(bool showHex, double gapWarnUs) : _showHex{showHex}, _gapWarnUs{gapWarnUs}
+    {
+    }
+
+    void feed(Dir dir, const uint8_t *data, size_t len, double timeUs)
+    {
+        Stream &s = _streams[dir];
+        for (size_t i = 0; i < len; i++)
+        {
+            if (s.buffer.empty())
+                s.startUs = timeUs;
+            s.buffer.push_back(data[i]);
+            s.lastUs = timeUs;
+            drain(dir);
+        }
+    }
+
+    void report(void);
+
+  private:
+    struct Stream
+    {
+        std::vector<uint8_t> buffer;
+        double startUs = 0;
+        double lastUs = 0;
+        double lastFrameEndUs = -1;
+        uint32_t frames = 0;
+        uint32_t resyncs = 0;
+        uint64_t skippedBytes = 0;
+        LatencyStats gaps;
+    };
+
+    static bool headerValid(const fpc_frame_hdr_t &hdr, Dir dir)
+    {
+        if (hdr.version != FPC_FRAME_PROTOCOL_VERSION)
+            return false;
+        if (hdr.type < FPC_FRAME_TYPE_CMD_REQUEST || hdr.type > FPC_FRAME_TYPE_CMD_EVENT)
+            return false;
+        if (hdr.payload_size < sizeof(fpc_cmd_hdr_t) || hdr.payload_size > MAX_HOST_PACKET_SIZE_DEFAULT)
+            return false;
+        uint16_t sender = dir == kTX ? FPC_FRAME_FLAG_SENDER_HOST
+                                     : (FPC_FRAME_FLAG_SENDER_FW_APP | FPC_FRAME_FLAG_SENDER_FW_BL);
+        return (hdr.flags & sender) != 0;
+    }
+
+    void drain(Dir dir);
+    void onFrame(Dir dir, const fpc_frame_hdr_t &hdr, const uint8_t *payload, double startUs, double endUs);
+
+    Stream _streams[2];
+    bool _showHex;
+    double _gapWarnUs;
+    double _firstUs = -1;
+
+    std::vector<PendingRequest> _pending;
+    std::map<uint16_t, LatencyStats> _latency;
+    std::map<uint16_t, uint32_t> _frameCount;
+    uint32_t _retransmits = 0;
+    uint32_t _unanswered = 0;
+};
+
+//--------------------------------------------------------------------------------------------
+void Dissector::drain(Dir dir)
+{
+    Stream &s = _streams[dir];
+
+    while (s.buffer.size() >= sizeof(fpc_frame_hdr_t))
+    {
+        fpc_frame_hdr_t hdr;
+        memcpy(&hdr, s.buffer.data(), sizeof(hdr));
+
+        if (!headerValid(hdr, dir))
+        {
+            // out of sync - drop a byte and look again
+            s.buffer.erase(s.buffer.begin());
+            s.skippedBytes++;
+            s.startUs = s.lastUs;
+            continue;
+        }
+        size_t total = sizeof(fpc_frame_hdr_t) + hdr.payload_size;
+        if (s.buffer.size() < total)
+            return;
+
+        if (s.skippedBytes)
+        {
+            printf("%12.3f ms %s  -- resync: skipped %llu byte(s)\n", (s.startUs - std::max(0.0, _firstUs)) / 1000.,
+                   dir == kTX ? "TX" : "RX", (unsigned long long)s.skippedBytes);
+            s.resyncs++;
+            s.skippedBytes = 0;
+        }
+        onFrame(dir, hdr, s.buffer.data() + sizeof(fpc_frame_hdr_t), s.startUs, s.lastUs);
+        s.buffer.erase(s.buffer.begin(), s.buffer.begin() + total);
+        s.startUs = s.lastUs;
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+void Dissector::onFrame(Dir dir, const fpc_frame_hdr_t &hdr, const uint8_t *payload, double startUs, double endUs)
+{
+    Stream &s = _streams[dir];
+    if (_firstUs < 0)
+        _firstUs = startUs;
+
+    const fpc_cmd_hdr_t *cmd = (const fpc_cmd_hdr_t *)payload;
+    s.frames++;
+    _frameCount[cmd->cmd_id]++;
+
+    // inter-frame gap on this direction
+    double gap = -1;
+    if (s.lastFrameEndUs >= 0)
+    {
+        gap = startUs - s.lastFrameEndUs;
+        s.gaps.add(gap);
+    }
+    s.lastFrameEndUs = endUs;
+
+    printf("%12.3f ms %s %s", (startUs - _firstUs) / 1000., dir == kTX ? "TX" : "RX", frameTypeName(hdr.type));
+    if (hdr.flags & FPC_FRAME_FLAG_SECURE)
+        printf(" [secure]");
+    decodePayload(hdr, payload, hdr.payload_size);
+
+    // request / response matching
+    if (dir == kTX && hdr.type == FPC_FRAME_TYPE_CMD_REQUEST)
+    {
+        std::vector<uint8_t> bytes(payload, payload + hdr.payload_size);
+        for (auto &p : _pending)
+        {
+            if (p.bytes == bytes)
+            {
+                _retransmits++;
+                printf("  <RETRANSMIT +%.3f ms>", (startUs - p.timeUs) / 1000.);
+                p.timeUs = startUs;
+                bytes.clear();
+                break;
+            }
+        }
+        if (!bytes.empty())
+            _pending.push_back({cmd->cmd_id, startUs, std::move(bytes)});
+    }
+    else if (dir == kRX && hdr.type == FPC_FRAME_TYPE_CMD_RESPONSE && !_pending.empty())
+    {
+        // Match the same command id, otherwise a STATUS response answers the oldest request
+        auto it = std::find_if(_pending.begin(), _pending.end(),
+                               [&](const PendingRequest &p) { return p.cmdId == cmd->cmd_id; });
+        if (it == _pending.end() && cmd->cmd_id == CMD_STATUS)
+            it = _pending.begin();
+
+        if (it != _pending.end())
+        {
+            double latency = endUs - it->timeUs;
+            _latency[it->cmdId].add(latency);
+            printf("  <%s %.3f ms>", cmdName(it->cmdId), latency / 1000.);
+            _pending.erase(it);
+        }
+    }
+
+    if (gap > _gapWarnUs && _gapWarnUs > 0)
+        printf("  <GAP %.3f ms>", gap / 1000.);
+    printf("\n");
+
+    if (_showHex)
+    {
+        for (size_t i = 0; i < hdr.payload_size; i++)
+        {
+            if (i % 16 == 0)
+                printf("%s%20s%04zx:", i ? "\n" : "", "", i);
+            printf(" %02X", payload[i]);
+        }
+        printf("\n");
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+void Dissector::report(void)
+{
+    printf("\n---------------------------------------------------------------------------\n");
+    printf(" Summary\n");
+    printf("---------------------------------------------------------------------------\n");
+
+    for (int d = 0; d < 2; d++)
+    {
+        Stream &s = _streams[d];
+        printf(" %s: %u frame(s), %u resync(s), %zu byte(s) unparsed", d == kTX ? "TX" : "RX", s.frames, s.resyncs,
+               s.buffer.size() + (size_t)s.skippedBytes);
+        if (s.gaps.count)
+            printf(", gap min/avg/max %.3f/%.3f/%.3f ms", s.gaps.min / 1000., s.gaps.sum / s.gaps.count / 1000.,
+                   s.gaps.max / 1000.);
+        printf("\n");
+    }
+    _unanswered = (uint32_t)_pending.size();
+    printf(" Retransmits: %u   Unanswered requests: %u\n\n", _retransmits, _unanswered);
+
+    printf(" Frames by command:\n");
+    for (auto &f : _frameCount)
+        printf("   %-18s %u\n", cmdName(f.first), f.second);
+
+    if (_latency.empty())
+        return;
+
+    printf("\n Request -> response latency (ms):\n");
+    printf("   %-18s %6s %9s %9s %9s %9s %9s\n", "command", "n", "min", "avg", "p95", "max", "stddev");
+    for (auto &l : _latency)
+    {
+        LatencyStats &st = l.second;
+        double avg = st.sum / st.count;
+        double var = std::max(0.0, st.sumSq / st.count - avg * avg);
+        printf("   %-18s %6u %9.3f %9.3f %9.3f %9.3f %9.3f\n", cmdName(l.first), st.count, st.min / 1000., avg / 1000.,
+               st.percentile(0.95) / 1000., st.max / 1000., std::sqrt(var) / 1000.);
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// Input handling
+//--------------------------------------------------------------------------------------------
+static volatile sig_atomic_t gStop = 0;
+
+static void onSignal(int)
+{
+    gStop = 1;
+}
+
+static double nowUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static bool readTextTrace(const char *path, Dissector &dis)
+{
+    FILE *fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (fp == nullptr)
+    {
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    char line[8192];
+    unsigned lineNo = 0;
+    while (fgets(line, sizeof(line), fp))
+    {
+        lineNo++;
+        char *p = line;
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (*p == '#' || *p == '\n' || *p == '\0')
+            continue;
+
+        char timeStr[64], dirStr[8];
+        int consumed = 0;
+        if (sscanf(p, "%63s %7s %n", timeStr, dirStr, &consumed) < 2)
+        {
+            fprintf(stderr, "line %u: malformed record\n", lineNo);
+            continue;
+        }
+        double t = strtod(timeStr, nullptr);
+        if (strchr(timeStr, '.'))
+            t *= 1e6;
+
+        Dissector::Dir dir;
+        if (strcasecmp(dirStr, "TX") == 0)
+            dir = Dissector::kTX;
+        else if (strcasecmp(dirStr, "RX") == 0)
+            dir = Dissector::kRX;
+        else
+        {
+            fprintf(stderr, "line %u: unknown direction '%s'\n", lineNo, dirStr);
+            continue;
+        }
+
+        std::vector<uint8_t> bytes;
+        p += consumed;
+        while (*p)
+        {
+            char *end;
+            unsigned long v = strtoul(p, &end, 16);
+            if (end == p)
+                break;
+            bytes.push_back((uint8_t)v);
+            p = end;
+        }
+        dis.feed(dir, bytes.data(), bytes.size(), t);
+    }
+    if (fp != stdin)
+        fclose(fp);
+    return true;
+}
+
+static bool readRawCapture(const char *path, Dissector &dis)
+{
+    FILE *fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    if (fp == nullptr)
+    {
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        dis.feed(Dissector::kRX, buffer, n, 0);
+
+    if (fp != stdin)
+        fclose(fp);
+    return true;
+}
+
+static speed_t baudToSpeed(long baud)
+{
+    switch (baud)
+    {
+    case 9600:
+        return B9600;
+    case 19200:
+        return B19200;
+    case 57600:
+        return B57600;
+    case 115200:
+        return B115200;
+#ifdef B921600
+    case 921600:
+        return B921600;
+#endif
+    default:
+        return 0;
+    }
+}
+
+static int openTTY(const char *path, long baud)
+{
+    int fd = open(path, O_RDONLY | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        speed_t speed = baudToSpeed(baud);
+        if (speed == 0)
+        {
+            fprintf(stderr, "Unsupported baud rate %ld\n", baud);
+            close(fd);
+            return -1;
+        }
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+static bool readLive(const char *rxPath, const char *txPath, long baud, Dissector &dis)
+{
+    struct pollfd fds[2];
+    int nfds = 0;
+
+    fds[nfds].fd = openTTY(rxPath, baud);
+    fds[nfds++].events = POLLIN;
+    if (fds[0].fd < 0)
+        return false;
+
+    if (txPath)
+    {
+        fds[nfds].fd = openTTY(txPath, baud);
+        fds[nfds++].events = POLLIN;
+        if (fds[1].fd < 0)
+            return false;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    uint8_t buffer[4096];
+    while (!gStop)
+    {
+        if (poll(fds, nfds, 250) <= 0)
+            continue;
+        for (int i = 0; i < nfds; i++)
+        {
+            if (!(fds[i].revents & POLLIN))
+                continue;
+            ssize_t n = read(fds[i].fd, buffer, sizeof(buffer));
+            if (n > 0)
+                dis.feed(i == 0 ? Dissector::kRX : Dissector::kTX, buffer, (size_t)n, nowUs());
+        }
+        fflush(stdout);
+    }
+    for (int i = 0; i < nfds; i++)
+        close(fds[i].fd);
+    return true;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options] (-f trace.txt | -r capture.bin | -t /dev/ttyX)\n"
+            "  -f file   text trace: <time> <TX|RX> <hex bytes...>  ('-' = stdin)\n"
+            "  -r file   raw sensor->host byte capture ('-' = stdin)\n"
+            "  -t tty    live sensor->host serial port\n"
+            "  -T tty    live host->sensor serial tap (with -t)\n"
+            "  -b baud   live port baud rate (default 921600)\n"
+            "  -g ms     flag inter-frame gaps longer than ms (default 0 = off)\n"
+            "  -x        hex dump each payload\n",
+            name);
+}
+
+int main(int argc, char **argv)
+{
+    const char *tracePath = nullptr, *rawPath = nullptr, *rxTTY = nullptr, *txTTY = nullptr;
+    long baud = 921600;
+    double gapMs = 0;
+    bool showHex = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "f:r:t:T:b:g:xh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'f':
+            tracePath = optarg;
+            break;
+        case 'r':
+            rawPath = optarg;
+            break;
+        case 't':
+            rxTTY = optarg;
+            break;
+        case 'T':
+            txTTY = optarg;
+            break;
+        case 'b':
+            baud = strtol(optarg, nullptr, 10);
+            break;
+        case 'g':
+            gapMs = strtod(optarg, nullptr);
+            break;
+        case 'x':
+            showHex = true;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!tracePath && !rawPath && !rxTTY)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Dissector dis(showHex, gapMs * 1000.);
+    bool ok;
+    if (tracePath)
+        ok = readTextTrace(tracePath, dis);
+    else if (rawPath)
+        ok = readRawCapture(rawPath, dis);
+    else
+        ok = readLive(rxTTY, txTTY, baud, dis);
+
+    if (!ok)
+        return 1;
+
+    dis.report();
+    return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Example of the coroutine (awaitable) API of the SparkFun FPC2534 library on a Linux host.
+ *
+ * The sensor operations - list templates, get config, enroll, identify - are written as one sequential
+ * coroutine, instead of a state machine spread across callback functions. The main loop pumps the sensor
+ * and does "application work" (counts loop iterations) while the coroutine waits on the sensor.
+ *
+ *   fpc2534_async_example [-t] device
+ *
+ * With -t, the library I/O task reads the sensor on its own thread.
+ *
+ * Build (C++20 required):
+ *
+ *   g++ -std=gnu++20 -O2 -Isrc/sfTk -o fpc2534_async_example extras/linux/fpc2534_async_example.cpp \
+ *       src/sfTk/sfDevFPC2534.cpp src/sfTk/sfDevFPC2534IComm.cpp src/sfTk/sfDevFPC2534Linux.cpp \
+ *       src/sfTk/sfDevFPC2534IOTask.cpp src/sfTk/sfDevFPC2534Async.cpp src/sfTk/sfDevFPC2534Power.cpp \
+ *       -lpthread
+ *
+ * Run against the simulator:
+ *
+ *   ./fpc2534_sim -l /tmp/fpc2534 &
+ *   ./fpc2534_async_example /tmp/fpc2534
+ */
+
+#include "sfDevFPC2534.h"
+#include "sfDevFPC2534Async.h"
+#include "sfDevFPC2534IOTask.h"
+#include "sfDevFPC2534Linux.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static sfDevFPC2534 mySensor;
+static sfDevFPC2534Async myAsync(mySensor);
+static sfDevFPC2534IOTask myIOTask;
+
+static bool gDone = false;
+static bool gReady = false;
+
+static void on_is_ready_change(bool isReady)
+{
+    gReady = isReady;
+}
+
+//------------------------------------------------------------------------------------
+// The sensor session - sequential code, each co_await suspends until the sensor responds
+//
+static sfDevFPC2534Task session(sfDevFPC2534Async &sensor)
+{
+    uint16_t ids[16];
+    sfDevFPC2534ListResult_t list = co_await sensor.listTemplates(ids, 16);
+    if (list.rc != FPC_RESULT_OK)
+        co_return list.rc;
+    printf("[LIST]\t\t%u template(s)\n", list.count);
+
+    sfDevFPC2534ConfigResult_t config = co_await sensor.getConfig();
+    if (config.rc != FPC_RESULT_OK)
+        co_return config.rc;
+    printf("[CONFIG]\tversion %u, finger scan interval %u ms, uart baud setting %u\n", config.cfg.version,
+           config.cfg.finger_scan_interval_ms, config.cfg.uart_baudrate);
+
+    // enroll - one update per sample
+    printf("[ENROLL]\tPlace finger on the sensor ");
+    fflush(stdout);
+    sfDevFPC2534EnrollOp enroll = sensor.enroll();
+    while (co_await enroll)
+    {
+        printf("%u..", enroll.samplesRemaining());
+        fflush(stdout);
+    }
+    if (enroll.result() != FPC_RESULT_OK)
+        co_return enroll.result();
+    printf("done - template %u\n", enroll.id());
+
+    for (int i = 0; i < 3; i++)
+    {
+        sfDevFPC2534IdentifyResult_t result = co_await sensor.identify({ID_TYPE_ALL, 0}, (uint16_t)(i + 1));
+        if (result.rc != FPC_RESULT_OK)
+            co_return result.rc;
+        if (result.match)
+            printf("[IDENTIFY]\tMATCH {Template ID: %u, tag %u}\n", result.id, result.tag);
+        else
+            printf("[IDENTIFY]\tNO MATCH {tag %u}\n", result.tag);
+    }
+
+    mySensor.setLED(true);
+    co_return FPC_RESULT_OK;
+}
+
+static sfDevFPC2534Task run(sfDevFPC2534Async &sensor)
+{
+    fpc_result_t rc = co_await session(sensor);
+    printf("[DONE]\t\tSession result: %u\n", rc);
+    gDone = true;
+    co_return rc;
+}
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    bool useIOTask = argc > 2 && strcmp(argv[1], "-t") == 0;
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s [-t] device\n", argv[0]);
+        return 1;
+    }
+    const char *device = argv[argc - 1];
+
+    static sfDevFPC2534LinuxUART comm;
+    if (!comm.initialize(device))
+    {
+        fprintf(stderr, "[ERROR]\tUnable to open %s\n", device);
+        return 1;
+    }
+    mySensor.initialize(comm);
+
+    sfDevFPC2534Callbacks_t callbacks = {0};
+    callbacks.on_is_ready_change = on_is_ready_change;
+    mySensor.setCallbacks(callbacks);
+
+    if (useIOTask && !myIOTask.start(mySensor))
+    {
+        fprintf(stderr, "[ERROR]\tUnable to start the I/O task\n");
+        return 1;
+    }
+
+    myAsync.setTimeout(10000);
+    mySensor.requestStatus();
+
+    bool started = false;
+    unsigned long loops = 0;
+    while (!gDone)
+    {
+        // sleep until the sensor signals (or 10 ms), then pump the sensor and resume the session
+        if (useIOTask)
+            myIOTask.dispatch(10);
+        else
+            comm.waitForData(10);
+        myAsync.poll();
+
+        if (gReady && !started)
+        {
+            started = true;
+            if (!run(myAsync).start())
+            {
+                fprintf(stderr, "[ERROR]\tCoroutine arena exhausted\n");
+                return 1;
+            }
+        }
+
+        // the application work
+        loops++;
+    }
+    printf("[STATS]\t\t%lu loop iterations, coroutine frames: high water %u, largest %u bytes\n", loops,
+           sfDevFPC2534CoArena::highWater(), (unsigned)sfDevFPC2534CoArena::largestFrame());
+    myIOTask.stop();
+    return 0;
+}
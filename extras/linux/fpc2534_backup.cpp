@@ -0,0 +1,165 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Template backup and restore for the SparkFun FPC2534 library on a Linux host.
+ *
+ * Backs up the templates of a sensor to a file, restores a backup file to a sensor, or checks a backup file -
+ * with sfDevFPC2534TemplateBackup, in the library backup format (see sfDevFPC2534Backup.h).
+ *
+ *   fpc2534_backup [-u] backup uart device file   - back up all the templates of the sensor to file
+ *   fpc2534_backup restore uart device file       - restore file to the sensor
+ *   fpc2534_backup check file                     - read file, check each template CRC, list the templates
+ *
+ *   -u  Don't compress the templates
+ *
+ * Use the fpc2534_sim tool to back up a simulated sensor with templates, and restore to another:
+ *
+ *   fpc2534_sim -n 8 -l /tmp/fpc2534_a &
+ *   fpc2534_sim -l /tmp/fpc2534_b &
+ *   fpc2534_backup backup uart /tmp/fpc2534_a /tmp/templates.fpcb
+ *   fpc2534_backup restore uart /tmp/fpc2534_b /tmp/templates.fpcb
+ *
+ * Build:
+ *
+ *   g++ -std=gnu++17 -O2 -Isrc/sfTk -o fpc2534_backup extras/linux/fpc2534_backup.cpp \
+ *       src/sfTk/sfDevFPC2534.cpp src/sfTk/sfDevFPC2534IComm.cpp src/sfTk/sfDevFPC2534Linux.cpp \
+ *       src/sfTk/sfDevFPC2534IOTask.cpp src/sfTk/sfDevFPC2534Power.cpp src/sfTk/sfDevFPC2534Backup.cpp -lpthread
+ */
+
+#include "sfDevFPC2534.h"
+#include "sfDevFPC2534Backup.h"
+#include "sfDevFPC2534Linux.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static sfDevFPC2534 mySensor;
+static sfDevFPC2534LinuxUART myComm;
+static sfDevFPC2534TemplateBackup myBackup;
+
+//------------------------------------------------------------------------------------
+// Read a backup file - each template is read to its end, which checks its CRC
+//
+static int checkBackup(FILE *file)
+{
+    sfDevFPC2534BackupFile storage(file);
+    sfDevFPC2534BackupReader reader;
+
+    fpc_result_t rc = reader.begin(storage);
+    if (rc != FPC_RESULT_OK)
+    {
+        fprintf(stderr, "[ERROR]\tNot a valid backup: %u\n", rc);
+        return 1;
+    }
+
+    printf("[BACKUP]\t%u templates\n", reader.count());
+    uint32_t total = 0;
+    for (uint16_t i = 0; i < reader.count(); i++)
+    {
+        uint16_t id, size;
+        rc = reader.nextTemplate(id, size);
+
+        uint8_t chunk[128];
+        for (uint16_t left = size; rc == FPC_RESULT_OK && left > 0;)
+        {
+            uint16_t len = left < sizeof(chunk) ? left : sizeof(chunk);
+            if (reader.read(chunk, len) != len)
+                rc = reader.lastError();
+            left -= len;
+        }
+        if (rc != FPC_RESULT_OK)
+        {
+            fprintf(stderr, "[ERROR]\tTemplate %u is corrupt: %u\n", i, rc);
+            return 1;
+        }
+
+        printf("\t\tID %u, %u bytes\n", id, size);
+        total += size;
+    }
+
+    printf("[RESULT]\t%u template bytes in %u backup bytes\n", total, reader.bytesIn());
+    return 0;
+}
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    const char *prog = argv[0];
+    bool compress = true;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "u")) != -1)
+    {
+        if (opt == 'u')
+            compress = false;
+        else
+            argc = 0;
+    }
+
+    int args = argc - optind;
+    const char *command = args > 0 ? argv[optind] : "";
+    bool check = strcmp(command, "check") == 0 && args == 2;
+    bool backup = strcmp(command, "backup") == 0 && args == 4;
+    bool restore = strcmp(command, "restore") == 0 && args == 4;
+    if (!check && !backup && !restore)
+    {
+        fprintf(stderr, "Usage: %s [-u] (backup|restore) uart device file\n       %s check file\n", prog, prog);
+        return 1;
+    }
+    const char *path = argv[argc - 1];
+
+    FILE *file = fopen(path, backup ? "wb" : "rb");
+    if (file == nullptr)
+    {
+        perror(path);
+        return 1;
+    }
+
+    if (check)
+    {
+        int result = checkBackup(file);
+        fclose(file);
+        return result;
+    }
+
+    if (strcmp(argv[optind + 1], "uart") != 0 || !myComm.initialize(argv[optind + 2]))
+    {
+        fprintf(stderr, "[ERROR]\tUnable to open %s on %s\n", argv[optind + 1], argv[optind + 2]);
+        return 1;
+    }
+    mySensor.initialize(myComm);
+
+    fpc_result_t rc = mySensor.waitForBoot(2000);
+    if (rc != FPC_RESULT_OK)
+    {
+        fprintf(stderr, "[ERROR]\tThe sensor is not ready: %u\n", rc);
+        return 1;
+    }
+
+    sfDevFPC2534BackupFile storage(file);
+    rc = backup ? myBackup.backup(mySensor, storage, nullptr, 0, compress) : myBackup.restore(mySensor, storage);
+    fclose(file);
+
+    sfDevFPC2534BackupStats_t stats;
+    myBackup.getStats(stats);
+    printf("[%s]\t%u templates, %u template bytes, %u backup bytes (%u%%), %u ms\n", backup ? "BACKUP" : "RESTORE",
+           stats.templates, stats.bytes, stats.stored, stats.bytes > 0 ? stats.stored * 100 / stats.bytes : 0,
+           stats.elapsedMs);
+
+    if (rc != FPC_RESULT_OK)
+    {
+        fprintf(stderr, "[ERROR]\t%s failed: %u\n", backup ? "Backup" : "Restore", rc);
+        return 1;
+    }
+    return 0;
+}
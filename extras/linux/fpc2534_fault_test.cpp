@@ -0,0 +1,220 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Fault injection soak test for the SparkFun FPC2534 library on a Linux host.
+ *
+ * The library runs continuous identify mode over a transport wrapped in sfDevFPC2534FaultComm, which injects
+ * faults into the traffic - dropped bytes, bit flips, truncated frames, delayed and spurious IRQs, NACKs and
+ * split reads. The transport retries and the liveness watchdog are enabled, and a bad frame is resynced by
+ * dropping the buffered data. On exit, the faults injected and the time the library took to be healthy again
+ * (the next frame parsed after a fault) are reported.
+ *
+ *   fpc2534_fault_test [-s seed] [-r rate] [-d seconds] (uart|i2c|spi) device [gpiochip line]
+ *
+ *   -s seed     Seed of the fault sequence (default 1) - the same seed gives the same faults
+ *   -r rate     Rate of each fault, per 10000 opportunities (default 20)
+ *   -d seconds  Test duration (default 30)
+ *
+ * Use the fpc2534_sim tool to run it against a simulated sensor on a pseudo terminal:
+ *
+ *   fpc2534_sim -t 5 -l /tmp/fpc2534 &
+ *   fpc2534_fault_test -r 50 uart /tmp/fpc2534
+ *
+ * Build:
+ *
+ *   g++ -std=gnu++17 -O2 -Isrc/sfTk -o fpc2534_fault_test extras/linux/fpc2534_fault_test.cpp \
+ *       src/sfTk/sfDevFPC2534.cpp src/sfTk/sfDevFPC2534IComm.cpp src/sfTk/sfDevFPC2534Linux.cpp \
+ *       src/sfTk/sfDevFPC2534IOTask.cpp src/sfTk/sfDevFPC2534Power.cpp src/sfTk/sfDevFPC2534Fault.cpp -lpthread
+ */
+
+#include "sfDevFPC2534.h"
+#include "sfDevFPC2534Fault.h"
+#include "sfDevFPC2534Linux.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static sfDevFPC2534 mySensor;
+static volatile sig_atomic_t gStop = 0;
+static uint32_t gIdentifyResults = 0;
+static uint32_t gErrors = 0;
+
+static const char *kFaultNames[kFPC2534FaultCount] = {"dropped byte", "bit flip",    "truncated",   "delayed IRQ",
+                                                      "spurious IRQ", "NACK",        "split read"};
+
+static void onSignal(int)
+{
+    gStop = 1;
+}
+
+//------------------------------------------------------------------------------------
+// Callback functions the library calls
+//------------------------------------------------------------------------------------
+static void on_error(uint16_t error)
+{
+    (void)error;
+    gErrors++;
+}
+
+static void on_identify(bool is_match, uint16_t id)
+{
+    (void)is_match;
+    (void)id;
+    gIdentifyResults++;
+}
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    const char *prog = argv[0];
+    sfDevFPC2534FaultConfig_t config = {0};
+    config.seed = 1;
+    config.delayIRQMs = 20;
+    uint16_t rate = 20;
+    uint32_t durationSec = 30;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:r:d:")) != -1)
+    {
+        if (opt == 's')
+            config.seed = (uint32_t)strtoul(optarg, nullptr, 0);
+        else if (opt == 'r')
+            rate = (uint16_t)strtoul(optarg, nullptr, 0);
+        else if (opt == 'd')
+            durationSec = (uint32_t)strtoul(optarg, nullptr, 0);
+        else
+            argc = 0;
+    }
+    if (argc - optind < 2)
+    {
+        fprintf(stderr, "Usage: %s [-s seed] [-r rate] [-d seconds] (uart|i2c|spi) device [gpiochip line]\n", prog);
+        return 1;
+    }
+    const char *bus = argv[optind];
+    const char *device = argv[optind + 1];
+    const char *gpioChip = argc - optind > 3 ? argv[optind + 2] : nullptr;
+    uint32_t irqLine = argc - optind > 3 ? (uint32_t)strtoul(argv[optind + 3], nullptr, 10) : 0;
+
+    static sfDevFPC2534LinuxUART commUART;
+    static sfDevFPC2534LinuxI2C commI2C;
+    static sfDevFPC2534LinuxSPI commSPI;
+    sfDevFPC2534LinuxComm *comm = nullptr;
+    bool ok = false;
+
+    if (strcmp(bus, "uart") == 0)
+    {
+        ok = commUART.initialize(device);
+        comm = &commUART;
+    }
+    else if (strcmp(bus, "i2c") == 0)
+    {
+        ok = commI2C.initialize(device, 0x24);
+        comm = &commI2C;
+    }
+    else if (strcmp(bus, "spi") == 0)
+    {
+        ok = commSPI.initialize(device);
+        comm = &commSPI;
+    }
+
+    if (!ok)
+    {
+        fprintf(stderr, "[ERROR]\tUnable to open %s on %s\n", bus, device);
+        return 1;
+    }
+    if (gpioChip && !comm->attachIRQ(gpioChip, irqLine))
+    {
+        fprintf(stderr, "[ERROR]\tUnable to attach IRQ line %u on %s\n", irqLine, gpioChip);
+        return 1;
+    }
+
+    // The library talks to the sensor through the fault injector - disabled until the sensor is running
+    static sfDevFPC2534FaultComm faultComm(*comm);
+    for (int i = 0; i < kFPC2534FaultCount; i++)
+        config.rate[i] = rate;
+    faultComm.setConfig(config);
+    faultComm.setEnabled(false);
+
+    mySensor.initialize(faultComm);
+    faultComm.attach(mySensor);
+
+    sfDevFPC2534Callbacks_t callbacks = {0};
+    callbacks.on_error = on_error;
+    callbacks.on_identify = on_identify;
+    mySensor.setCallbacks(callbacks);
+
+    fpc_result_t rc = mySensor.waitForBoot(2000);
+    if (rc != FPC_RESULT_OK)
+    {
+        fprintf(stderr, "[ERROR]\tThe sensor is not ready: %u\n", rc);
+        return 1;
+    }
+
+    fpc_id_type_t id = {ID_TYPE_ALL, 0};
+    rc = mySensor.startContinuousIdentify(id);
+    if (rc != FPC_RESULT_OK)
+    {
+        fprintf(stderr, "[ERROR]\tFailed to start identify - error: %u\n", rc);
+        return 1;
+    }
+    // A short heartbeat - a lost identify result is found (and re-armed) at the next heartbeat
+    mySensor.enableWatchdog(250, 250);
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    printf("[START]\tseed %u, rate %u/%u per fault, %u s\n", config.seed, rate, kFPC2534FaultRateScale, durationSec);
+    faultComm.resetStats();
+    faultComm.setEnabled(true);
+
+    uint32_t resyncs = 0;
+    uint32_t start = millis();
+    while (!gStop && millis() - start < durationSec * 1000)
+    {
+        // A bad frame header - the stream is out of sync. Drop what is buffered, the watchdog restarts the
+        // sensor if a response was lost.
+        if (mySensor.waitForEvent(100) == FPC_RESULT_IO_BAD_DATA)
+        {
+            mySensor.clearData();
+            resyncs++;
+        }
+    }
+    faultComm.setEnabled(false);
+
+    sfDevFPC2534FaultStats_t stats;
+    faultComm.getStats(stats);
+    printf("[FAULTS]\treads %u, writes %u\n", stats.reads, stats.writes);
+    for (int i = 0; i < kFPC2534FaultCount; i++)
+        printf("\t\t%-14s %u\n", kFaultNames[i], stats.injected[i]);
+
+    printf("[RECOVERY]\t%u recoveries, last %u us, max %u us, avg %u us%s\n", stats.recoveries,
+           stats.lastRecoveryUs, stats.maxRecoveryUs, stats.recoveries ? stats.totalRecoveryUs / stats.recoveries : 0,
+           faultComm.isHealthy() ? "" : " (faulted at exit)");
+
+    sfDevFPC2534RetryStats_t retry;
+    mySensor.getRetryStats(retry);
+    printf("[RETRY]\t\twrites %u, reads %u, recovered %u, exhausted %u, fatal %u, backoff %u us\n",
+           retry.writeRetries, retry.readRetries, retry.recovered, retry.exhausted, retry.fatal, retry.backoffUs);
+
+    sfDevFPC2534WatchdogStats_t watchdog;
+    mySensor.getWatchdogStats(watchdog);
+    printf("[WATCHDOG]\ttimeouts %u, aborts %u, resets %u, reinits %u, recoveries %u, identify re-arms %u, max "
+           "downtime %u ms\n",
+           watchdog.timeouts, watchdog.aborts, watchdog.resets, watchdog.reinits, watchdog.recoveries,
+           watchdog.rearms, watchdog.maxDowntimeMs);
+
+    printf("[RESULT]\t%u identify results, %u frames parsed, %u errors, %u resyncs\n", gIdentifyResults,
+           stats.framesParsed, gErrors, resyncs);
+    return 0;
+}
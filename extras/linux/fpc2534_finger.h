@@ -0,0 +1,95 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Synthetic fingerprint images - for the fpc2534_sim and fpc2534_match tools.
+ *
+ * A finger is a ridge pattern: the phase of a set of elliptical rings (the pattern around a core), plus spiral
+ * phase points - each spiral point ends or splits a ridge, so it is a minutia. Each capture of a finger moves and
+ * rotates it on the sensor, and changes the pressure (contrast) and noise, so two captures of a finger have most
+ * of their minutiae in common, and captures of different fingers do not.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+// Size of the images (the FPC2534 sensor area, at 508 dpi)
+const uint16_t kFingerImageWidth = 160;
+const uint16_t kFingerImageHeight = 160;
+
+//--------------------------------------------------------------------------------------------
+static inline uint32_t fingerRandom(uint32_t &x)
+{
+    x = x * 1103515245 + 12345;
+    return x >> 8;
+}
+
+// A random value in [lo, hi)
+static inline float fingerUniform(uint32_t &x, float lo, float hi)
+{
+    return lo + (hi - lo) * (float)(fingerRandom(x) & 0xFFFF) / 65536.0f;
+}
+
+//--------------------------------------------------------------------------------------------
+// Render capture number capture of finger number finger - 8 bit gray scale, dark ridges, row by row
+//
+static inline void renderFinger(uint32_t finger, uint32_t capture, uint8_t *image, uint16_t width = kFingerImageWidth,
+                                uint16_t height = kFingerImageHeight)
+{
+    const int kSpirals = 80;
+    const float kPi = 3.14159265f;
+
+    // The finger - core, ridge period, and the spiral points (over more than the sensor area)
+    uint32_t x = finger * 2654435761u + 1;
+    fingerRandom(x);
+    float coreX = fingerUniform(x, -25, 25);
+    float coreY = fingerUniform(x, -25, 25);
+    float period = fingerUniform(x, 8.0f, 9.5f);
+    float squash = fingerUniform(x, 0.6f, 1.0f);
+
+    float spiralX[kSpirals], spiralY[kSpirals], spiralP[kSpirals];
+    for (int i = 0; i < kSpirals; i++)
+    {
+        spiralX[i] = fingerUniform(x, -110, 110);
+        spiralY[i] = fingerUniform(x, -110, 110);
+        spiralP[i] = (fingerRandom(x) & 1) ? 1.0f : -1.0f;
+    }
+
+    // The capture - position, rotation, pressure, noise
+    uint32_t c = (finger * 7919 + capture) * 2246822519u + 7;
+    fingerRandom(c);
+    float angle = capture == 0 ? 0 : fingerUniform(c, -0.2f, 0.2f);
+    float shiftX = capture == 0 ? 0 : fingerUniform(c, -8, 8);
+    float shiftY = capture == 0 ? 0 : fingerUniform(c, -8, 8);
+    float contrast = fingerUniform(c, 60, 100);
+    float cosA = cosf(angle), sinA = sinf(angle);
+
+    for (uint16_t row = 0; row < height; row++)
+    {
+        for (uint16_t col = 0; col < width; col++)
+        {
+            // sensor to finger coordinates
+            float sx = col - width / 2.0f - shiftX;
+            float sy = row - height / 2.0f - shiftY;
+            float u = cosA * sx + sinA * sy;
+            float v = -sinA * sx + cosA * sy;
+
+            float du = u - coreX, dv = (v - coreY) * squash;
+            float phase = 2 * kPi * sqrtf(du * du + dv * dv) / period;
+            for (int i = 0; i < kSpirals; i++)
+                phase += spiralP[i] * atan2f(v - spiralY[i], u - spiralX[i]);
+
+            int value = 128 + (int)(contrast * cosf(phase)) + (int)(fingerRandom(c) % 41) - 20;
+            image[row * width + col] = value < 0 ? 0 : (value > 255 ? 255 : value);
+        }
+    }
+}
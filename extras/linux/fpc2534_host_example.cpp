@@ -0,0 +1,228 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Example using the SparkFun FPC2534 library on an embedded Linux host.
+ *
+ * The library core (sfDevFPC2534) is used with one of the Linux userspace transports:
+ *
+ *   fpc2534_host_example uart /dev/ttyAMA0 [gpiochip line]
+ *   fpc2534_host_example i2c  /dev/i2c-1    gpiochip line
+ *   fpc2534_host_example spi  /dev/spidev0.0 gpiochip line
+ *
+ * With -t as the first argument, the library I/O task (sfDevFPC2534IOTask) reads the sensor on its own
+ * thread, and the main loop just dispatches the queued frames. I/O task statistics are printed on exit.
+ *
+ * On UART, the baud rate is negotiated with the sensor first - the link is raised to 921600 baud (or the
+ * fastest rate that works).
+ *
+ * The IRQ pin of the sensor is given as a GPIO chip and line offset (e.g. /dev/gpiochip0 17).
+ * It is required for I2C and SPI. The pump sleeps in the kernel (epoll) until the sensor has data.
+ *
+ * On startup, the example requests the version and template list, then runs continuous identify mode
+ * (identify operations back to back, re-armed by the library), printing the results. The re-arm timing
+ * is printed on exit. Use the fpc2534_sim tool to run it against a simulated
+ * sensor on a pseudo terminal.
+ *
+ * Build:
+ *
+ *   g++ -std=gnu++17 -O2 -Isrc/sfTk -o fpc2534_host_example extras/linux/fpc2534_host_example.cpp \
+ *       src/sfTk/sfDevFPC2534.cpp src/sfTk/sfDevFPC2534IComm.cpp src/sfTk/sfDevFPC2534Linux.cpp \
+ *       src/sfTk/sfDevFPC2534IOTask.cpp src/sfTk/sfDevFPC2534Power.cpp -lpthread
+ */
+
+#include "sfDevFPC2534.h"
+#include "sfDevFPC2534IOTask.h"
+#include "sfDevFPC2534Linux.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static sfDevFPC2534 mySensor;
+static sfDevFPC2534IOTask myIOTask;
+static volatile sig_atomic_t gStop = 0;
+
+static void onSignal(int)
+{
+    gStop = 1;
+}
+
+//------------------------------------------------------------------------------------
+// Callback functions the library calls
+//------------------------------------------------------------------------------------
+static void startIdentify(void)
+{
+    fpc_id_type_t id = {ID_TYPE_ALL, 0};
+    fpc_result_t rc = mySensor.startContinuousIdentify(id);
+    if (rc != FPC_RESULT_OK)
+        printf("[ERROR]\tFailed to start identify - error: %u\n", rc);
+}
+
+static void on_error(uint16_t error)
+{
+    printf("[ERROR]\tSensor Error Code: %u\n", error);
+}
+
+static void on_version(char *version)
+{
+    printf("[INFO]\tFirmware version: %s\n", version);
+}
+
+static void on_list_templates(uint16_t num_templates, uint16_t *template_ids)
+{
+    printf("[INFO]\t%u template(s) enrolled:", num_templates);
+    for (uint16_t i = 0; i < num_templates; i++)
+        printf(" %u", template_ids[i]);
+    printf("\n");
+
+    startIdentify();
+}
+
+static void on_identify(bool is_match, uint16_t id)
+{
+    if (is_match)
+        printf("[IDENTIFY]\tMATCH  {Template ID: %u}\n", id);
+    else
+        printf("[IDENTIFY]\tNO MATCH\n");
+}
+
+static void on_is_ready_change(bool isReady)
+{
+    if (!isReady)
+        return;
+
+    printf("[STARTUP]\tFPC2534 Device is ready\n");
+    mySensor.requestVersion();
+    mySensor.requestListTemplates();
+}
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    const char *prog = argv[0];
+    bool useIOTask = argc > 1 && strcmp(argv[1], "-t") == 0;
+    if (useIOTask)
+    {
+        argc--;
+        argv++;
+    }
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s [-t] (uart|i2c|spi) device [gpiochip line]\n", prog);
+        return 1;
+    }
+    const char *bus = argv[1];
+    const char *device = argv[2];
+    const char *gpioChip = argc > 4 ? argv[3] : nullptr;
+    uint32_t irqLine = argc > 4 ? (uint32_t)strtoul(argv[4], nullptr, 10) : 0;
+
+    static sfDevFPC2534LinuxUART commUART;
+    static sfDevFPC2534LinuxI2C commI2C;
+    static sfDevFPC2534LinuxSPI commSPI;
+    sfDevFPC2534LinuxComm *comm = nullptr;
+    bool ok = false;
+
+    if (strcmp(bus, "uart") == 0)
+    {
+        ok = commUART.initialize(device);
+        comm = &commUART;
+    }
+    else if (strcmp(bus, "i2c") == 0)
+    {
+        ok = commI2C.initialize(device, 0x24);
+        comm = &commI2C;
+    }
+    else if (strcmp(bus, "spi") == 0)
+    {
+        ok = commSPI.initialize(device);
+        comm = &commSPI;
+    }
+
+    if (!ok)
+    {
+        fprintf(stderr, "[ERROR]\tUnable to open %s on %s\n", bus, device);
+        return 1;
+    }
+    if (gpioChip && !comm->attachIRQ(gpioChip, irqLine))
+    {
+        fprintf(stderr, "[ERROR]\tUnable to attach IRQ line %u on %s\n", irqLine, gpioChip);
+        return 1;
+    }
+
+    mySensor.initialize(*comm);
+
+    // Run the UART link at the fastest rate that works. Done before the callbacks are set, so the status
+    // responses of the probes don't start the application.
+    if (comm == &commUART)
+    {
+        fpc_result_t rc = mySensor.negotiateUARTBaudRate(CFG_UART_BAUDRATE_921600);
+        if (rc == FPC_RESULT_OK)
+            printf("[STARTUP]	UART link at %u baud\n", mySensor.getUARTBaudRate());
+        else
+            printf("[ERROR]	UART baud rate negotiation failed: %u\n", rc);
+    }
+
+    sfDevFPC2534Callbacks_t callbacks = {0};
+    callbacks.on_error = on_error;
+    callbacks.on_version = on_version;
+    callbacks.on_list_templates = on_list_templates;
+    callbacks.on_identify = on_identify;
+    callbacks.on_is_ready_change = on_is_ready_change;
+    mySensor.setCallbacks(callbacks);
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    if (useIOTask && !myIOTask.start(mySensor))
+    {
+        fprintf(stderr, "[ERROR]\tUnable to start the I/O task\n");
+        return 1;
+    }
+
+    // Wait for the sensor to report ready - its boot status, or the response to a status request if it already
+    // booted. The application starts from on_is_ready_change().
+    fpc_result_t rc = mySensor.waitForBoot(2000);
+    if (rc != FPC_RESULT_OK)
+    {
+        fprintf(stderr, "[ERROR]\tThe sensor is not ready: %u\n", rc);
+        return 1;
+    }
+    printf("[STARTUP]\tReady after %u ms\n", mySensor.bootTimeMs());
+
+    while (!gStop)
+    {
+        // sleep until the sensor signals data (in I/O task mode, until the I/O task queues a frame) - then
+        // parse it here
+        fpc_result_t rc = mySensor.waitForEvent(1000);
+        if (rc != FPC_RESULT_OK)
+            printf("[ERROR]\tProcessing Error: %u\n", rc);
+    }
+
+    sfDevFPC2534IdentifyTiming_t timing;
+    mySensor.getIdentifyTiming(timing);
+    printf("[TIMING]\t%u identify cycles, %u stale, last arm to result %u us, re-arm last %u us, max %u us, "
+           "avg %u us\n",
+           timing.cycles, timing.staleDropped, timing.lastArmToResultUs, timing.lastRearmUs, timing.maxRearmUs,
+           timing.cycles ? timing.totalRearmUs / timing.cycles : 0);
+
+    if (useIOTask)
+    {
+        sfDevFPC2534IOTaskStats_t stats;
+        myIOTask.getStats(stats);
+        myIOTask.stop();
+        printf("[STATS]\tframes %u, dispatched %u, stalls %u, dropped %u, errors %u, max read %u us, max queue wait "
+               "%u us, queue high water %u\n",
+               stats.frames, stats.dispatched, stats.stalls, stats.dropped, stats.errors, stats.maxReadUs,
+               stats.maxDispatchUs, stats.queueHighWater);
+    }
+    return 0;
+}
@@ -0,0 +1,342 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Host-side fingerprint matching for the SparkFun FPC2534 library on a Linux host.
+ *
+ * Images are captured on the sensor and read with image GET transfers, their minutiae extracted on the host
+ * (sfDevFPC2534MinutiaeExtractor), and identified against a gallery held on the host (sfDevFPC2534Gallery) - for
+ * more identities than the template storage of a sensor.
+ *
+ *   fpc2534_match bench [fingers]                     - accuracy over synthetic fingers (the first capture of each
+ *                                                       enrolled, the second identified), and the identification
+ *                                                       rate for each scoring kernel and gallery size
+ *   fpc2534_match capture uart device [fingers] [n]   - enroll synthetic fingers, then capture n images on the
+ *                                                       device and identify them
+ *
+ * The capture command is for the fpc2534_sim tool, which captures the same synthetic fingers (capture n is of
+ * finger n % fingers):
+ *
+ *   fpc2534_sim -f 20 -t 50 -l /tmp/fpc2534 &
+ *   fpc2534_match capture uart /tmp/fpc2534 20 40
+ *
+ * Build:
+ *
+ *   g++ -std=gnu++17 -O2 -Isrc/sfTk -o fpc2534_match extras/linux/fpc2534_match.cpp \
+ *       src/sfTk/sfDevFPC2534.cpp src/sfTk/sfDevFPC2534IComm.cpp src/sfTk/sfDevFPC2534Linux.cpp \
+ *       src/sfTk/sfDevFPC2534IOTask.cpp src/sfTk/sfDevFPC2534Power.cpp src/sfTk/sfDevFPC2534Matcher.cpp -lpthread
+ */
+
+#include "sfDevFPC2534.h"
+#include "sfDevFPC2534Linux.h"
+#include "sfDevFPC2534Matcher.h"
+
+#include "fpc2534_finger.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+static sfDevFPC2534 mySensor;
+static sfDevFPC2534LinuxUART myComm;
+static sfDevFPC2534MinutiaeExtractor myExtractor;
+static sfDevFPC2534Gallery myGallery;
+
+// Max time for a capture, or a transfer with no progress
+static const uint32_t kTimeoutMs = 2000;
+
+// The image read from the sensor
+static std::vector<uint8_t> myImage;
+static bool imageReady = false;
+
+//------------------------------------------------------------------------------------
+static uint64_t nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static const char *kernelName(sfDevFPC2534MatchKernel_t kernel)
+{
+    return kernel == kFPC2534MatchAVX2 ? "AVX2" : (kernel == kFPC2534MatchSSE2 ? "SSE2" : "scalar");
+}
+
+//------------------------------------------------------------------------------------
+// Enroll the first capture of each finger
+//
+static fpc_result_t enrollFingers(uint32_t fingers)
+{
+    std::vector<uint8_t> image(kFingerImageWidth * kFingerImageHeight);
+    sfDevFPC2534Minutiae_t minutiae;
+
+    myGallery.clear();
+    for (uint32_t finger = 0; finger < fingers; finger++)
+    {
+        renderFinger(finger, 0, image.data());
+        fpc_result_t rc = myExtractor.extract(image.data(), kFingerImageWidth, kFingerImageHeight, minutiae);
+        if (rc != FPC_RESULT_OK)
+            return rc;
+        myGallery.add(finger, minutiae);
+    }
+    return FPC_RESULT_OK;
+}
+
+//------------------------------------------------------------------------------------
+// Accuracy over the synthetic fingers, then the identification rate for each kernel and gallery size
+//
+static fpc_result_t bench(uint32_t fingers)
+{
+    std::vector<uint8_t> image(kFingerImageWidth * kFingerImageHeight);
+    sfDevFPC2534Minutiae_t minutiae;
+
+    fpc_result_t rc = enrollFingers(fingers);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    // Identify the second capture of each finger - the genuine score, and the best impostor score
+    uint32_t correct = 0, accepted = 0, falseAccepts = 0, minutiaeSum = 0;
+    uint32_t genuineSum = 0, impostorMax = 0, genuineMin = 0xFFFF;
+    uint64_t extractNs = 0;
+    for (uint32_t finger = 0; finger < fingers; finger++)
+    {
+        renderFinger(finger, 1, image.data());
+        uint64_t start = nowNs();
+        myExtractor.extract(image.data(), kFingerImageWidth, kFingerImageHeight, minutiae);
+        extractNs += nowNs() - start;
+        minutiaeSum += minutiae.count;
+
+        sfDevFPC2534MatchResult_t result;
+        bool match = myGallery.identify(minutiae, result);
+        correct += result.id == finger;
+        accepted += match && result.id == finger;
+        falseAccepts += match && result.id != finger;
+
+        uint16_t genuine = myGallery.score(minutiae, finger);
+        genuineSum += genuine;
+        genuineMin = genuine < genuineMin ? genuine : genuineMin;
+        for (uint32_t other = 0; other < fingers; other++)
+        {
+            uint16_t score = other == finger ? 0 : myGallery.score(minutiae, other);
+            impostorMax = score > impostorMax ? score : impostorMax;
+        }
+    }
+
+    printf("[BENCH]\t%u fingers, %u minutiae per image, %llu us per extraction\n", fingers, minutiaeSum / fingers,
+           (unsigned long long)(extractNs / fingers / 1000));
+    printf("[BENCH]\tRank 1: %u of %u, accepted (score >= %u): %u, false accepts: %u\n", correct, fingers,
+           kFPC2534DefaultMatchScore, accepted, falseAccepts);
+    printf("[BENCH]\tGenuine score: mean %u, min %u - best impostor score: %u\n", genuineSum / fingers, genuineMin,
+           impostorMax);
+
+    // Identification rate - galleries of random minutiae, probed with the last capture
+    static const uint32_t kSizes[] = {1000, 10000, 100000};
+    static const sfDevFPC2534MatchKernel_t kKernels[] = {kFPC2534MatchScalar, kFPC2534MatchSSE2, kFPC2534MatchAVX2};
+
+    uint32_t x = 0x2534;
+    for (uint32_t size : kSizes)
+    {
+        myGallery.clear();
+        for (uint32_t id = 0; id < size; id++)
+        {
+            sfDevFPC2534Minutiae_t random;
+            random.count = 30 + fingerRandom(x) % 21;
+            for (uint16_t i = 0; i < random.count; i++)
+            {
+                random.minutiae[i] = {(uint16_t)(10 + fingerRandom(x) % 140), (uint16_t)(10 + fingerRandom(x) % 140),
+                                      (uint8_t)fingerRandom(x), (uint8_t)(fingerRandom(x) & 1 ? 1 : 3)};
+            }
+            myGallery.add(id, random);
+        }
+
+        for (sfDevFPC2534MatchKernel_t kernel : kKernels)
+        {
+            myGallery.setKernel(kernel);
+            if (myGallery.kernel() != kernel)
+                continue;
+
+            for (uint16_t threads : {(uint16_t)1, (uint16_t)0})
+            {
+                myGallery.setThreads(threads);
+
+                // at least 0.2 seconds
+                uint32_t identified = 0;
+                uint64_t start = nowNs();
+                uint64_t elapsed;
+                do
+                {
+                    sfDevFPC2534MatchResult_t result;
+                    myGallery.identify(minutiae, result);
+                    identified++;
+                    elapsed = nowNs() - start;
+                } while (elapsed < 200000000);
+
+                printf("[BENCH]\t%6u entries, %-6s %s: %8.1f identifications/s, %6.1f M entries/s\n", size,
+                       kernelName(kernel), threads == 1 ? "1 thread  " : "all cores ",
+                       identified * 1e9 / elapsed, (double)identified * size * 1e3 / elapsed);
+            }
+        }
+    }
+    myGallery.setKernel(kFPC2534MatchAuto);
+    myGallery.setThreads(0);
+    return FPC_RESULT_OK;
+}
+
+//------------------------------------------------------------------------------------
+// Status events - the captured image is ready
+//
+static void onStatus(uint16_t event, uint16_t state)
+{
+    if (event == EVENT_IMAGE_READY)
+        imageReady = true;
+}
+
+//------------------------------------------------------------------------------------
+// Writer of an image GET transfer
+//
+static uint16_t imageChunk(void *arg, uint32_t offset, const uint8_t *data, uint16_t len)
+{
+    if (offset + len > myImage.size())
+        myImage.resize(offset + len);
+    memcpy(myImage.data() + offset, data, len);
+    return len;
+}
+
+//------------------------------------------------------------------------------------
+// Capture an image, and read it
+//
+static fpc_result_t captureImage(void)
+{
+    imageReady = false;
+    fpc_result_t rc = mySensor.requestCapture();
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    uint32_t startMs = millis();
+    while (!imageReady)
+    {
+        if (millis() - startMs >= kTimeoutMs)
+            return FPC_RESULT_TIMEOUT;
+        mySensor.waitForEvent(50);
+    }
+
+    myImage.clear();
+    rc = mySensor.requestGetImageData(CMD_IMAGE_REQUEST_TYPE_GET_FMI, imageChunk, nullptr);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    uint32_t progress = mySensor.transferProgress();
+    uint32_t lastMs = millis();
+    while (mySensor.isTransferActive())
+    {
+        mySensor.waitForEvent(50);
+
+        if (mySensor.transferProgress() != progress)
+        {
+            progress = mySensor.transferProgress();
+            lastMs = millis();
+        }
+        else if (millis() - lastMs >= kTimeoutMs)
+        {
+            mySensor.abortTransfer();
+            return FPC_RESULT_TIMEOUT;
+        }
+    }
+    return mySensor.transferResult();
+}
+
+//------------------------------------------------------------------------------------
+// Enroll the synthetic fingers, then capture images on the sensor and identify them
+//
+static fpc_result_t capture(const char *device, uint32_t fingers, uint32_t count)
+{
+    if (!myComm.initialize(device))
+    {
+        fprintf(stderr, "[ERROR]\tUnable to open %s\n", device);
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+    }
+    mySensor.initialize(myComm);
+
+    sfDevFPC2534Callbacks_t callbacks = {0};
+    callbacks.on_status = onStatus;
+    mySensor.setCallbacks(callbacks);
+
+    fpc_result_t rc = mySensor.waitForBoot(2000);
+    if (rc == FPC_RESULT_OK)
+        rc = enrollFingers(fingers);
+
+    uint32_t correct = 0;
+    for (uint32_t n = 0; n < count && rc == FPC_RESULT_OK; n++)
+    {
+        rc = captureImage();
+        if (rc != FPC_RESULT_OK)
+            break;
+
+        uint64_t start = nowNs();
+        sfDevFPC2534Minutiae_t minutiae;
+        rc = myExtractor.extract(myImage.data(), mySensor.imageWidth(), mySensor.imageHeight(), minutiae);
+        if (rc != FPC_RESULT_OK || myImage.size() != (size_t)mySensor.imageWidth() * mySensor.imageHeight())
+        {
+            rc = rc != FPC_RESULT_OK ? rc : FPC_RESULT_INVALID_PARAM;
+            break;
+        }
+
+        sfDevFPC2534MatchResult_t result;
+        bool match = myGallery.identify(minutiae, result);
+        uint64_t matchNs = nowNs() - start;
+
+        correct += match && result.id == n % fingers;
+        printf("[CAPTURE]\t%ux%u image, %u minutiae - %s finger %u (score %u), %llu us\n", mySensor.imageWidth(),
+               mySensor.imageHeight(), minutiae.count, match ? "matched" : "no match - best", result.id,
+               result.score, (unsigned long long)(matchNs / 1000));
+    }
+
+    if (rc == FPC_RESULT_OK)
+        printf("[CAPTURE]\t%u of %u identified\n", correct, count);
+    return rc;
+}
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    const char *command = argc > 1 ? argv[1] : "";
+    bool benchCommand = strcmp(command, "bench") == 0 && argc <= 3;
+    bool captureCommand = strcmp(command, "capture") == 0 && argc >= 4 && argc <= 6 && strcmp(argv[2], "uart") == 0;
+    if (!benchCommand && !captureCommand)
+    {
+        fprintf(stderr, "Usage: %s bench [fingers]\n       %s capture uart device [fingers] [n]\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    printf("[MATCH]\tScoring kernel: %s\n", kernelName(myGallery.kernel()));
+
+    fpc_result_t rc;
+    if (benchCommand)
+    {
+        uint32_t fingers = argc == 3 ? (uint32_t)strtoul(argv[2], nullptr, 0) : 200;
+        rc = fingers > 0 ? bench(fingers) : FPC_RESULT_INVALID_PARAM;
+    }
+    else
+    {
+        uint32_t fingers = argc >= 5 ? (uint32_t)strtoul(argv[4], nullptr, 0) : 10;
+        uint32_t count = argc == 6 ? (uint32_t)strtoul(argv[5], nullptr, 0) : fingers;
+        rc = fingers > 0 ? capture(argv[3], fingers, count) : FPC_RESULT_INVALID_PARAM;
+    }
+
+    if (rc != FPC_RESULT_OK)
+    {
+        fprintf(stderr, "[ERROR]\t%s failed: %u\n", command, rc);
+        return 1;
+    }
+    return 0;
+}
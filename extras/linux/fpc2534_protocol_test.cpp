@@ -0,0 +1,260 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Protocol checks of the SparkFun FPC2534 library on a Linux host.
+ *
+ * Runs request sequences that depend on the library matching each response to its request, and checks the state
+ * the library keeps. Each check prints PASS or FAIL - the exit code is the number of failed checks.
+ *
+ *   fpc2534_protocol_test uart device
+ *
+ *   reset-delete   - a delete sent after a reset (which is not answered) is confirmed by its own response
+ *   config-verify  - a verified commit fails when the sensor adjusts the configuration written
+ *   iotask-get     - a template GET through the I/O task completes with the default frame size, and fails (not
+ *                    hangs) when its chunks are too large for a frame slot
+ *   async-fail     - an awaited operation is not ended by a failure answering a request sent before it (C++20)
+ *
+ * Run it against the fpc2534_sim tool, started with templates 1 to 8 and a finger scan interval of 500 ms or less:
+ *
+ *   fpc2534_sim -n 8 -c 500 -l /tmp/fpc2534 &
+ *   fpc2534_protocol_test uart /tmp/fpc2534
+ *
+ * Build (the async checks need C++20):
+ *
+ *   g++ -std=gnu++20 -O2 -Isrc/sfTk -o fpc2534_protocol_test extras/linux/fpc2534_protocol_test.cpp \
+ *       src/sfTk/sfDevFPC2534.cpp src/sfTk/sfDevFPC2534IComm.cpp src/sfTk/sfDevFPC2534Linux.cpp \
+ *       src/sfTk/sfDevFPC2534IOTask.cpp src/sfTk/sfDevFPC2534Async.cpp src/sfTk/sfDevFPC2534Power.cpp -lpthread
+ */
+
+#include "sfDevFPC2534.h"
+#include "sfDevFPC2534Async.h"
+#include "sfDevFPC2534IOTask.h"
+#include "sfDevFPC2534Linux.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static sfDevFPC2534 mySensor;
+static sfDevFPC2534LinuxUART myComm;
+static sfDevFPC2534IOTask myIOTask;
+#if defined(SFE_FPC2534_HAS_COROUTINES)
+static sfDevFPC2534Async myAsync(mySensor);
+#endif
+
+static int gFailed = 0;
+
+//------------------------------------------------------------------------------------
+static void check(const char *test, const char *what, bool passed)
+{
+    printf("[%s]\t%-14s %s\n", passed ? "PASS" : "FAIL", test, what);
+    if (!passed)
+        gFailed++;
+}
+
+// Process the responses for a while
+static void pump(uint32_t ms)
+{
+    uint32_t start = millis();
+    while (millis() - start < ms)
+        mySensor.waitForEvent(10);
+}
+
+// Read the template list - the template index is valid after
+static bool loadTemplateIndex(void)
+{
+    if (mySensor.requestListTemplates() != FPC_RESULT_OK)
+        return false;
+    pump(200);
+    return mySensor.templateIndexValid();
+}
+
+//------------------------------------------------------------------------------------
+// A reset is not answered - a delete sent after it must not wait for a response to the reset
+//
+static void testResetDelete(void)
+{
+    const char *test = "reset-delete";
+    check(test, "template index loaded", loadTemplateIndex() && mySensor.hasTemplate(2));
+    uint16_t count = mySensor.templateCount();
+
+    // the boot status of the reset arrives - not through waitForBoot()
+    check(test, "reset sent", mySensor.sendReset() == FPC_RESULT_OK);
+    pump(200);
+
+    fpc_id_type_t id = {ID_TYPE_SPECIFIED, 2};
+    check(test, "delete sent", mySensor.requestDeleteTemplate(id) == FPC_RESULT_OK);
+    pump(200);
+    check(test, "delete confirmed by its response", !mySensor.hasTemplate(2) && mySensor.templateCount() == count - 1);
+
+    // a later response does not touch the index
+    mySensor.requestStatus();
+    pump(200);
+    check(test, "index unchanged by a later status", !mySensor.hasTemplate(2) && mySensor.templateCount() == count - 1);
+}
+
+//------------------------------------------------------------------------------------
+// The sensor clamps the finger scan interval to 500 ms - the read back of a verified commit is checked against the
+// configuration written, not the cached copy
+//
+static fpc_result_t commitAndWait(bool verify)
+{
+    fpc_result_t rc = mySensor.commitConfig(verify);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+    pump(200);
+    return verify ? mySensor.configVerifyResult() : FPC_RESULT_OK;
+}
+
+static void testConfigVerify(void)
+{
+    const char *test = "config-verify";
+    fpc_system_config_t cfg;
+
+    mySensor.requestGetSystemConfig(FPC_SYS_CFG_TYPE_CUSTOM);
+    pump(200);
+    check(test, "configuration cached", mySensor.isConfigCached());
+
+    mySensor.setFingerScanInterval(300);
+    check(test, "accepted write verifies", commitAndWait(true) == FPC_RESULT_OK);
+
+    mySensor.setFingerScanInterval(800);
+    check(test, "adjusted write fails", commitAndWait(true) == FPC_RESULT_FAILURE);
+    check(test, "cache holds the read back",
+          mySensor.getCachedConfig(cfg) == FPC_RESULT_OK && cfg.finger_scan_interval_ms == 500 &&
+              !mySensor.isConfigDirty());
+
+    // a change made while the read back is on its way is not part of the write
+    mySensor.setFingerScanInterval(200);
+    check(test, "commit sent", mySensor.commitConfig(true) == FPC_RESULT_OK);
+    mySensor.setFingerScanInterval(250);
+    pump(200);
+    check(test, "later change not checked", mySensor.configVerifyResult() == FPC_RESULT_OK);
+    check(test, "later change kept",
+          mySensor.isConfigDirty() && mySensor.getCachedConfig(cfg) == FPC_RESULT_OK &&
+              cfg.finger_scan_interval_ms == 250);
+    mySensor.discardConfigChanges();
+}
+
+//------------------------------------------------------------------------------------
+// Each chunk of a template GET is a CMD_DATA_GET response of a header and up to SFE_FPC2534_XFER_CHUNK_SIZE bytes
+//
+static fpc_result_t getTemplateWithIOTask(const sfDevFPC2534IOTaskConfig_t &config, uint32_t &dropped)
+{
+    static uint8_t buffer[4096];
+
+    dropped = 0;
+    if (!myIOTask.start(mySensor, config))
+        return FPC_RESULT_WRONG_STATE;
+
+    fpc_result_t rc = mySensor.requestGetTemplateData(1, buffer, sizeof(buffer));
+    if (rc == FPC_RESULT_OK)
+    {
+        uint32_t start = millis();
+        while (mySensor.isTransferActive() && millis() - start < 2000)
+            mySensor.waitForEvent(10);
+        rc = mySensor.isTransferActive() ? FPC_RESULT_TIMEOUT : mySensor.transferResult();
+    }
+
+    // any frames still on their way
+    pump(200);
+
+    sfDevFPC2534IOTaskStats_t stats;
+    myIOTask.getStats(stats);
+    dropped = stats.dropped;
+    myIOTask.stop();
+    return rc;
+}
+
+static void testIOTaskGet(void)
+{
+    const char *test = "iotask-get";
+    uint32_t dropped;
+
+    fpc_result_t rc = getTemplateWithIOTask(kFPC2534IOTaskDefaultConfig, dropped);
+    check(test, "default frame size completes", rc == FPC_RESULT_OK && dropped == 0);
+
+    sfDevFPC2534IOTaskConfig_t config = kFPC2534IOTaskDefaultConfig;
+    config.frameSize = 128;
+    rc = getTemplateWithIOTask(config, dropped);
+    check(test, "dropped chunk fails the transfer", rc == FPC_RESULT_OUT_OF_MEMORY && dropped > 0);
+}
+
+#if defined(SFE_FPC2534_HAS_COROUTINES)
+//------------------------------------------------------------------------------------
+// A request that fails is answered before the awaited operation - the failure is not the operation's
+//
+static bool gAsyncDone;
+static sfDevFPC2534ConfigResult_t gAsyncConfig;
+
+static sfDevFPC2534Task getConfigAfterFailure(sfDevFPC2534Async &sensor)
+{
+    static uint8_t buffer[4096];
+
+    // no template 200 - answered with a failure status
+    mySensor.requestGetTemplateData(200, buffer, sizeof(buffer));
+
+    gAsyncConfig = co_await sensor.getConfig();
+    gAsyncDone = true;
+    co_return gAsyncConfig.rc;
+}
+
+static void testAsyncFail(void)
+{
+    const char *test = "async-fail";
+
+    gAsyncDone = false;
+    myAsync.setTimeout(1000);
+    check(test, "operation started", getConfigAfterFailure(myAsync).start());
+
+    uint32_t start = millis();
+    while (!gAsyncDone && millis() - start < 2000)
+    {
+        mySensor.waitForEvent(10);
+        myAsync.resume();
+    }
+    check(test, "operation completed by its response", gAsyncDone && gAsyncConfig.rc == FPC_RESULT_OK);
+    check(test, "the earlier request failed", mySensor.transferResult() == FPC_RESULT_USER_ID_NOT_FOUND);
+}
+#endif
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 3 || strcmp(argv[1], "uart") != 0)
+    {
+        fprintf(stderr, "Usage: %s uart device\n", argv[0]);
+        return 1;
+    }
+
+    if (!myComm.initialize(argv[2]))
+    {
+        fprintf(stderr, "[ERROR]\tUnable to open %s\n", argv[2]);
+        return 1;
+    }
+    mySensor.initialize(myComm);
+
+    fpc_result_t rc = mySensor.waitForBoot(2000);
+    if (rc != FPC_RESULT_OK)
+    {
+        fprintf(stderr, "[ERROR]\tThe sensor is not ready: %u\n", rc);
+        return 1;
+    }
+
+    testResetDelete();
+    testConfigVerify();
+    testIOTaskGet();
+#if defined(SFE_FPC2534_HAS_COROUTINES)
+    testAsyncFail();
+#endif
+
+    printf("[RESULT]\t%d checks failed\n", gFailed);
+    return gFailed;
+}
@@ -0,0 +1,193 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Bulk template provisioning for the SparkFun FPC2534 library on a Linux host.
+ *
+ * A set of templates is pushed to several sensors at once with sfDevFPC2534Provision - the sensors are run by a
+ * multi-sensor manager, each on its own UART. The templates are generated (pseudo random data), so the tool can
+ * be used to measure the provisioning throughput, and - with fault injection on each link - how the pipeline
+ * recovers: a failed transfer is restarted for that sensor only.
+ *
+ *   fpc2534_provision [-n templates] [-z size] [-r rate] [-s seed] device [device ...]
+ *
+ *   -n templates  Number of templates, IDs 1 to n (default 10)
+ *   -z size       Size of each template, in bytes (default 4096)
+ *   -r rate       Fault injection rate, per 10000 opportunities (default 0 - no faults)
+ *   -s seed       Seed of the fault sequence (default 1)
+ *
+ * Use the fpc2534_sim tool to run it against simulated sensors on pseudo terminals:
+ *
+ *   fpc2534_sim -l /tmp/fpc2534_0 &
+ *   fpc2534_sim -l /tmp/fpc2534_1 &
+ *   fpc2534_sim -l /tmp/fpc2534_2 &
+ *   fpc2534_provision -n 20 /tmp/fpc2534_0 /tmp/fpc2534_1 /tmp/fpc2534_2
+ *
+ * Build:
+ *
+ *   g++ -std=gnu++17 -O2 -Isrc/sfTk -o fpc2534_provision extras/linux/fpc2534_provision.cpp \
+ *       src/sfTk/sfDevFPC2534.cpp src/sfTk/sfDevFPC2534IComm.cpp src/sfTk/sfDevFPC2534Linux.cpp \
+ *       src/sfTk/sfDevFPC2534IOTask.cpp src/sfTk/sfDevFPC2534Power.cpp src/sfTk/sfDevFPC2534Fault.cpp \
+ *       src/sfTk/sfDevFPC2534Manager.cpp src/sfTk/sfDevFPC2534Provision.cpp -lpthread
+ */
+
+#include "sfDevFPC2534.h"
+#include "sfDevFPC2534Fault.h"
+#include "sfDevFPC2534Linux.h"
+#include "sfDevFPC2534Manager.h"
+#include "sfDevFPC2534Provision.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <vector>
+
+static sfDevFPC2534 mySensors[kFPC2534MaxSensors];
+static sfDevFPC2534LinuxUART myComms[kFPC2534MaxSensors];
+static sfDevFPC2534FaultComm *myFaults[kFPC2534MaxSensors];
+static sfDevFPC2534Manager myManager;
+static sfDevFPC2534Provision myProvision;
+
+static const char *kStateNames[] = {"idle", "listing", "sending", "verifying", "done", "failed"};
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    const char *prog = argv[0];
+    uint16_t count = 10;
+    uint32_t size = 4096;
+    uint16_t rate = 0;
+    uint32_t seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:z:r:s:")) != -1)
+    {
+        if (opt == 'n')
+            count = (uint16_t)strtoul(optarg, nullptr, 0);
+        else if (opt == 'z')
+            size = (uint32_t)strtoul(optarg, nullptr, 0);
+        else if (opt == 'r')
+            rate = (uint16_t)strtoul(optarg, nullptr, 0);
+        else if (opt == 's')
+            seed = (uint32_t)strtoul(optarg, nullptr, 0);
+        else
+            argc = 0;
+    }
+    int sensors = argc - optind;
+    if (sensors < 1 || sensors > kFPC2534MaxSensors || count == 0 || count > SFE_FPC2534_MAX_TEMPLATE_ID ||
+        size == 0 || size > 0xFFFF)
+    {
+        fprintf(stderr, "Usage: %s [-n templates] [-z size] [-r rate] [-s seed] device [device ...]\n", prog);
+        return 1;
+    }
+
+    // The templates - pseudo random data, IDs 1 to count
+    std::vector<uint8_t> data((size_t)count * size);
+    uint32_t x = 0x2534;
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        x = x * 1103515245 + 12345;
+        data[i] = (uint8_t)(x >> 16);
+    }
+
+    std::vector<sfDevFPC2534Template_t> templates(count);
+    for (uint16_t i = 0; i < count; i++)
+        templates[i] = {(uint16_t)(i + 1), &data[(size_t)i * size], size};
+
+    static sfDevFPC2534MemoryTemplates source(templates.data(), count);
+
+    // The sensors - each on its own link, with a fault injector when a rate is given
+    for (int i = 0; i < sensors; i++)
+    {
+        const char *device = argv[optind + i];
+        if (!myComms[i].initialize(device))
+        {
+            fprintf(stderr, "[ERROR]\tUnable to open %s\n", device);
+            return 1;
+        }
+
+        sfDevFPC2534IComm *comm = &myComms[i];
+        if (rate > 0)
+        {
+            sfDevFPC2534FaultConfig_t config = {0};
+            config.seed = seed + i;
+            config.delayIRQMs = 20;
+            for (int f = 0; f < kFPC2534FaultCount; f++)
+                config.rate[f] = rate;
+
+            myFaults[i] = new sfDevFPC2534FaultComm(myComms[i]);
+            myFaults[i]->setConfig(config);
+            myFaults[i]->setEnabled(false);
+            comm = myFaults[i];
+        }
+
+        mySensors[i].initialize(*comm);
+        fpc_result_t rc = mySensors[i].waitForBoot(2000);
+        if (rc != FPC_RESULT_OK)
+        {
+            fprintf(stderr, "[ERROR]\tThe sensor on %s is not ready: %u\n", device, rc);
+            return 1;
+        }
+        myManager.addSensor(mySensors[i], i);
+
+        if (myFaults[i] != nullptr)
+            myFaults[i]->setEnabled(true);
+    }
+
+    printf("[START]\t%d sensors, %u templates of %u bytes, fault rate %u/%u\n", sensors, count, size, rate,
+           kFPC2534FaultRateScale);
+
+    if (!myProvision.begin(myManager, source))
+    {
+        fprintf(stderr, "[ERROR]\tUnable to start provisioning\n");
+        return 1;
+    }
+
+    uint32_t resyncs = 0;
+    uint32_t start = millis();
+    while (!myProvision.isDone() && millis() - start < 120000)
+    {
+        myManager.waitForEvent(10);
+
+        // A bad frame header - the stream of that sensor is out of sync, drop what is buffered
+        for (int i = 0; i < sensors; i++)
+        {
+            if (myManager.lastResult(i) == FPC_RESULT_IO_BAD_DATA)
+            {
+                mySensors[i].clearData();
+                resyncs++;
+            }
+        }
+        myProvision.poll();
+    }
+
+    for (int i = 0; i < sensors; i++)
+    {
+        if (myFaults[i] != nullptr)
+            myFaults[i]->setEnabled(false);
+
+        sfDevFPC2534ProvisionSensorStats_t stats;
+        myProvision.getSensorStats(i, stats);
+        printf("[SENSOR %d]\t%-9s %u sent, %u skipped, %u retries, %u bytes in %u ms, last error %u\n", i,
+               kStateNames[stats.state], stats.templatesSent, stats.templatesSkipped, stats.retries, stats.bytes,
+               stats.elapsedMs, stats.lastError);
+    }
+
+    sfDevFPC2534ProvisionStats_t stats;
+    myProvision.getStats(stats);
+    printf("[RESULT]\t%u done, %u failed, %u templates, %u retries, %u resyncs, %u bytes in %u ms - %u bytes/s\n",
+           stats.done, stats.failed, stats.templatesSent, stats.retries, resyncs, stats.bytes, stats.elapsedMs,
+           stats.throughput);
+
+    myProvision.end();
+    return stats.failed == 0 && stats.done == stats.sensors ? 0 : 1;
+}
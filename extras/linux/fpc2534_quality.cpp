@@ -0,0 +1,263 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Image quality for the SparkFun FPC2534 library on a Linux host.
+ *
+ * Raw images are analyzed as they are read from the sensor (sfDevFPC2534ImageAnalyzer) - contrast, clarity and
+ * coverage - so a poor capture is rejected before it is matched.
+ *
+ *   fpc2534_quality bench [frames]             - the quality of good and poor synthetic images, and the
+ *                                                throughput of each kernel (megapixels per second), with the
+ *                                                images streamed in transfer sized chunks
+ *   fpc2534_quality capture uart device [n]    - capture n images on the device, and analyze them as they are
+ *                                                read (with early reject)
+ *
+ * The capture command is for the fpc2534_sim tool - every third capture a partial finger:
+ *
+ *   fpc2534_sim -t 50 -p 3 -l /tmp/fpc2534 &
+ *   fpc2534_quality capture uart /tmp/fpc2534 5
+ *
+ * Build:
+ *
+ *   g++ -std=gnu++17 -O2 -Isrc/sfTk -o fpc2534_quality extras/linux/fpc2534_quality.cpp \
+ *       src/sfTk/sfDevFPC2534.cpp src/sfTk/sfDevFPC2534IComm.cpp src/sfTk/sfDevFPC2534Linux.cpp \
+ *       src/sfTk/sfDevFPC2534IOTask.cpp src/sfTk/sfDevFPC2534Power.cpp src/sfTk/sfDevFPC2534Quality.cpp -lpthread
+ */
+
+#include "sfDevFPC2534.h"
+#include "sfDevFPC2534Linux.h"
+#include "sfDevFPC2534Quality.h"
+
+#include "fpc2534_finger.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+static sfDevFPC2534 mySensor;
+static sfDevFPC2534LinuxUART myComm;
+static sfDevFPC2534ImageAnalyzer myAnalyzer;
+
+// Max time for a capture, or a transfer with no progress
+static const uint32_t kTimeoutMs = 2000;
+
+// Chunk size of the streamed images - the transfer chunk size
+static const uint16_t kChunk = SFE_FPC2534_XFER_CHUNK_SIZE;
+
+static bool imageReady = false;
+
+//------------------------------------------------------------------------------------
+static uint64_t nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static const char *kernelName(sfDevFPC2534QualityKernel_t kernel)
+{
+    return kernel == kFPC2534QualitySSE2 ? "SSE2" : (kernel == kFPC2534QualityNEON ? "NEON" : "scalar");
+}
+
+//------------------------------------------------------------------------------------
+static void printQuality(const char *what)
+{
+    sfDevFPC2534ImageQuality_t quality;
+    myAnalyzer.getQuality(quality);
+
+    printf("[QUALITY]\t%-14s contrast %3u (%3u-%3u), clarity %3u, coverage %3u%%, mean %3u - %s\n", what,
+           quality.contrast, quality.low, quality.high, quality.clarity, quality.coverage, quality.mean,
+           myAnalyzer.isRejected() ? "rejected early" : (myAnalyzer.isAcceptable() ? "acceptable" : "poor"));
+}
+
+//------------------------------------------------------------------------------------
+// Stream an image through the analyzer, in chunks
+//
+static fpc_result_t analyze(const uint8_t *image, uint16_t width, uint16_t height)
+{
+    fpc_result_t rc = myAnalyzer.begin(width, height);
+    for (uint32_t offset = 0; offset < (uint32_t)width * height && rc == FPC_RESULT_OK; offset += kChunk)
+    {
+        uint32_t len = (uint32_t)width * height - offset;
+        rc = myAnalyzer.add(image + offset, len < kChunk ? len : kChunk);
+    }
+    return rc;
+}
+
+//------------------------------------------------------------------------------------
+// The quality of good and poor synthetic images, then the throughput of each kernel
+//
+static fpc_result_t bench(uint32_t frames)
+{
+    const uint32_t pixels = kFingerImageWidth * kFingerImageHeight;
+    std::vector<uint8_t> good(pixels), faint(pixels), partial(pixels), blank(pixels);
+
+    renderFinger(1, 1, good.data());
+    for (uint32_t i = 0; i < pixels; i++)
+    {
+        // a light press, and a finger on the top third of the sensor
+        faint[i] = (uint8_t)(160 + (good[i] - 128) / 5);
+        partial[i] = i < pixels / 3 ? good[i] : (uint8_t)(200 + i % 7);
+        blank[i] = (uint8_t)(200 + (i * 7919) % 9);
+    }
+
+    struct
+    {
+        const char *name;
+        const uint8_t *image;
+    } samples[] = {{"finger", good.data()}, {"light press", faint.data()}, {"partial", partial.data()},
+                   {"no finger", blank.data()}};
+
+    for (auto &sample : samples)
+    {
+        fpc_result_t rc = analyze(sample.image, kFingerImageWidth, kFingerImageHeight);
+        if (rc != FPC_RESULT_OK)
+            return rc;
+        printQuality(sample.name);
+    }
+
+    // Throughput - each kernel over the same frames, and the results must agree
+    static const sfDevFPC2534QualityKernel_t kKernels[] = {kFPC2534QualityScalar, kFPC2534QualitySSE2,
+                                                           kFPC2534QualityNEON};
+    sfDevFPC2534ImageQuality_t reference = {0};
+    std::vector<uint8_t> referenceMap;
+    for (sfDevFPC2534QualityKernel_t kernel : kKernels)
+    {
+        myAnalyzer.setKernel(kernel);
+        if (myAnalyzer.kernel() != kernel)
+            continue;
+
+        uint64_t start = nowNs();
+        for (uint32_t frame = 0; frame < frames; frame++)
+            analyze(good.data(), kFingerImageWidth, kFingerImageHeight);
+        uint64_t elapsed = nowNs() - start;
+
+        sfDevFPC2534ImageQuality_t quality;
+        myAnalyzer.getQuality(quality);
+        std::vector<uint8_t> map(myAnalyzer.clarityMap(),
+                                 myAnalyzer.clarityMap() + myAnalyzer.mapWidth() * myAnalyzer.mapHeight());
+        if (kernel == kFPC2534QualityScalar)
+        {
+            reference = quality;
+            referenceMap = map;
+        }
+        bool same = memcmp(&quality, &reference, sizeof(quality)) == 0 && map == referenceMap;
+
+        printf("[BENCH]\t%-6s %u frames of %ux%u: %6.1f MP/s, %5.2f us per frame%s\n", kernelName(kernel), frames,
+               kFingerImageWidth, kFingerImageHeight, (double)frames * pixels * 1e3 / elapsed,
+               elapsed / 1e3 / frames, same ? "" : " - RESULTS DIFFER");
+        if (!same)
+            return FPC_RESULT_FAILURE;
+    }
+    myAnalyzer.setKernel(kFPC2534QualityAuto);
+    return FPC_RESULT_OK;
+}
+
+//------------------------------------------------------------------------------------
+// Status events - the captured image is ready
+//
+static void onStatus(uint16_t event, uint16_t state)
+{
+    if (event == EVENT_IMAGE_READY)
+        imageReady = true;
+}
+
+//------------------------------------------------------------------------------------
+// Capture images, and analyze them as they are read
+//
+static fpc_result_t capture(const char *device, uint32_t count)
+{
+    if (!myComm.initialize(device))
+    {
+        fprintf(stderr, "[ERROR]\tUnable to open %s\n", device);
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+    }
+    mySensor.initialize(myComm);
+
+    sfDevFPC2534Callbacks_t callbacks = {0};
+    callbacks.on_status = onStatus;
+    mySensor.setCallbacks(callbacks);
+
+    fpc_result_t rc = mySensor.waitForBoot(2000);
+    myAnalyzer.setLimits(kFPC2534DefaultQualityLimits, true);
+
+    for (uint32_t n = 0; n < count && rc == FPC_RESULT_OK; n++)
+    {
+        imageReady = false;
+        rc = mySensor.requestCapture();
+
+        uint32_t startMs = millis();
+        while (rc == FPC_RESULT_OK && !imageReady)
+        {
+            if (millis() - startMs >= kTimeoutMs)
+                rc = FPC_RESULT_TIMEOUT;
+            mySensor.waitForEvent(50);
+        }
+        if (rc == FPC_RESULT_OK)
+            rc = myAnalyzer.requestImage(mySensor);
+        if (rc != FPC_RESULT_OK)
+            break;
+
+        uint64_t start = nowNs();
+        while (mySensor.isTransferActive() && millis() - startMs < 10 * kTimeoutMs)
+            mySensor.waitForEvent(50);
+        uint64_t elapsed = nowNs() - start;
+
+        if (myAnalyzer.isRejected())
+            mySensor.requestAbort();
+        else if (mySensor.transferResult() != FPC_RESULT_OK)
+        {
+            rc = mySensor.transferResult();
+            break;
+        }
+
+        char what[32];
+        snprintf(what, sizeof(what), "capture %u", n);
+        printQuality(what);
+        printf("[CAPTURE]\t%ux%u image read and analyzed in %llu ms\n", mySensor.imageWidth(),
+               mySensor.imageHeight(), (unsigned long long)(elapsed / 1000000));
+    }
+    return rc;
+}
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    const char *command = argc > 1 ? argv[1] : "";
+    bool benchCommand = strcmp(command, "bench") == 0 && argc <= 3;
+    bool captureCommand = strcmp(command, "capture") == 0 && (argc == 4 || argc == 5) && strcmp(argv[2], "uart") == 0;
+    if (!benchCommand && !captureCommand)
+    {
+        fprintf(stderr, "Usage: %s bench [frames]\n       %s capture uart device [n]\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    printf("[QUALITY]\tKernel: %s\n", kernelName(myAnalyzer.kernel()));
+
+    fpc_result_t rc;
+    if (benchCommand)
+    {
+        uint32_t frames = argc == 3 ? (uint32_t)strtoul(argv[2], nullptr, 0) : 20000;
+        rc = frames > 0 ? bench(frames) : FPC_RESULT_INVALID_PARAM;
+    }
+    else
+        rc = capture(argv[3], argc == 5 ? (uint32_t)strtoul(argv[4], nullptr, 0) : 1);
+
+    if (rc != FPC_RESULT_OK)
+    {
+        fprintf(stderr, "[ERROR]\t%s failed: %u\n", command, rc);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,611 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * fpc2534_sim - a small FPC2534 UART simulator for Linux.
+ *
+ * Creates a pseudo terminal pair and answers the FPC2534 frame protocol on it, so the Linux UART
+ * transport (sfDevFPC2534LinuxUART) and the library core can be exercised without hardware.
+ * The name of the pty to open is printed on startup.
+ *
+ * Simulated behavior:
+ *   - STATUS event with APP_FW_READY at start and after CMD_RESET
+ *   - STATUS, VERSION, LIST_TEMPLATES, DELETE_TEMPLATE, GET/SET_SYSTEM_CONFIG, GPIO_CONTROL, ABORT
+ *   - ENROLL  - a sequence of enroll progress events, one every "touch" period
+ *   - IDENTIFY - a match against the first enrolled template after one "touch" period
+ *   - PUT_TEMPLATE_DATA + DATA_PUT - a template transfer to the sensor, in chunks of up to 256 bytes
+ *   - GET_TEMPLATE_DATA + DATA_GET - a template transfer from the sensor - the data put, or generated data for
+ *     an enrolled template
+ *   - CAPTURE - an image of a synthetic finger after one "touch" period (IMAGE_READY), cycling through the
+ *     fingers: capture n is of finger n % fingers (see fpc2534_finger.h), optionally with every nth capture
+ *     a partial finger (the top third of the sensor)
+ *   - IMAGE_DATA + DATA_GET - an image transfer from the sensor - 8 bit gray scale, 160 x 160. The same pixels
+ *     are sent for a RAW and an FMI request.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -o fpc2534_sim extras/linux/fpc2534_sim.cpp
+ *
+ * Usage:
+ *   fpc2534_sim [-t touch_ms] [-d response_delay_ms] [-n templates] [-f fingers] [-p n] [-c max_scan_ms]
+ *               [-l link_path]
+ *
+ *   -n templates  Start with templates enrolled, IDs 1 to n
+ *   -f fingers    Number of fingers captured (default 10)
+ *   -p n          Every nth capture is a partial finger
+ *   -c max_scan_ms  Clamp the finger scan interval of a written configuration - a sensor that adjusts a
+ *                   configuration it accepts
+ */
+
+#include "../../src/sfTk/fpc_api.h"
+#include "fpc2534_finger.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+static volatile sig_atomic_t gStop = 0;
+
+static void onSignal(int)
+{
+    gStop = 1;
+}
+
+static uint64_t nowMs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+//--------------------------------------------------------------------------------------------
+class Simulator
+{
+  public:
+    Simulator(int fd, uint32_t touchMs, uint32_t delayMs) : _fd{fd}, _touchMs{touchMs}, _delayMs{delayMs}
+    {
+        _config = {CFG_VERSION, 34, CFG_SYS_FLAG_STATUS_EVT_AT_BOOT, 1, CFG_UART_BAUDRATE_921600, 5, 15, 0, 12, 0,
+                   0x24};
+    }
+
+    // Start with templates enrolled, IDs 1 to count
+    void enrollTemplates(uint16_t count)
+    {
+        for (uint16_t id = 1; id <= count; id++)
+            _templates.push_back(id);
+    }
+
+    // Number of fingers captured
+    void setFingers(uint32_t fingers, uint32_t partialEvery)
+    {
+        _fingers = fingers > 0 ? fingers : 1;
+        _partialEvery = partialEvery;
+    }
+
+    // Largest finger scan interval accepted - 0 for any
+    void setMaxScanInterval(uint32_t maxScanMs)
+    {
+        _maxScanMs = maxScanMs;
+    }
+
+    void boot(void)
+    {
+        _state = STATE_APP_FW_READY;
+        _mode = 0;
+        sendStatus(FPC_FRAME_TYPE_CMD_EVENT, EVENT_IDLE);
+    }
+
+    void feed(const uint8_t *data, size_t len)
+    {
+        _rx.insert(_rx.end(), data, data + len);
+
+        while (_rx.size() >= sizeof(fpc_frame_hdr_t))
+        {
+            fpc_frame_hdr_t hdr;
+            memcpy(&hdr, _rx.data(), sizeof(hdr));
+            if (hdr.version != FPC_FRAME_PROTOCOL_VERSION || hdr.type != FPC_FRAME_TYPE_CMD_REQUEST ||
+                hdr.payload_size > MAX_HOST_PACKET_SIZE_DEFAULT)
+            {
+                _rx.erase(_rx.begin());
+                continue;
+            }
+            if (_rx.size() < sizeof(hdr) + hdr.payload_size)
+                return;
+
+            std::vector<uint8_t> payload(_rx.begin() + sizeof(hdr), _rx.begin() + sizeof(hdr) + hdr.payload_size);
+            _rx.erase(_rx.begin(), _rx.begin() + sizeof(hdr) + hdr.payload_size);
+
+            if (_delayMs)
+                usleep(_delayMs * 1000);
+            handle(payload);
+        }
+    }
+
+    // timed "finger touches" for enroll and identify
+    void tick(void)
+    {
+        if (_mode == 0 || nowMs() < _nextTouchMs)
+            return;
+
+        if (_mode == STATE_ENROLL)
+        {
+            _samplesRemaining--;
+            sendStatus(FPC_FRAME_TYPE_CMD_EVENT, EVENT_FINGER_DETECT);
+            fpc_cmd_enroll_status_response_t rsp = {{CMD_ENROLL, FPC_FRAME_TYPE_CMD_EVENT},
+                                                    _enrollId,
+                                                    (uint8_t)(_samplesRemaining ? ENROLL_FEEDBACK_PROGRESS
+                                                                                : ENROLL_FEEDBACK_DONE),
+                                                    _samplesRemaining};
+            if (_samplesRemaining == 0)
+            {
+                _templates.push_back(_enrollId);
+                _mode = 0;
+            }
+            send(FPC_FRAME_TYPE_CMD_EVENT, &rsp, sizeof(rsp));
+            sendStatus(FPC_FRAME_TYPE_CMD_EVENT, EVENT_FINGER_LOST);
+        }
+        else if (_mode == STATE_IDENTIFY)
+        {
+            _mode = 0;
+            sendStatus(FPC_FRAME_TYPE_CMD_EVENT, EVENT_FINGER_DETECT);
+            bool match = !_templates.empty();
+            fpc_cmd_identify_status_response_t rsp = {
+                {CMD_IDENTIFY, FPC_FRAME_TYPE_CMD_EVENT},
+                (uint16_t)(match ? IDENTIFY_RESULT_MATCH : IDENTIFY_RESULT_NO_MATCH),
+                {(uint16_t)(match ? ID_TYPE_SPECIFIED : ID_TYPE_NONE), (uint16_t)(match ? _templates.front() : 0)},
+                _tag};
+            send(FPC_FRAME_TYPE_CMD_EVENT, &rsp, sizeof(rsp));
+            sendStatus(FPC_FRAME_TYPE_CMD_EVENT, EVENT_FINGER_LOST);
+        }
+        else if (_mode == STATE_CAPTURE)
+        {
+            // the next finger - its first capture (0) is left for enrollment
+            _mode = 0;
+            sendStatus(FPC_FRAME_TYPE_CMD_EVENT, EVENT_FINGER_DETECT);
+            _image.resize(kFingerImageWidth * kFingerImageHeight);
+            renderFinger(_captures % _fingers, 1 + _captures / _fingers, _image.data());
+            bool partial = _partialEvery > 0 && _captures % _partialEvery == _partialEvery - 1;
+            if (partial)
+                memset(&_image[_image.size() / 3], 200, _image.size() - _image.size() / 3);
+            printf("   capture %u - finger %u%s\n", _captures, _captures % _fingers, partial ? " (partial)" : "");
+            fflush(stdout);
+            _captures++;
+            _state |= STATE_IMAGE_AVAILABLE;
+            sendStatus(FPC_FRAME_TYPE_CMD_EVENT, EVENT_IMAGE_READY);
+            sendStatus(FPC_FRAME_TYPE_CMD_EVENT, EVENT_FINGER_LOST);
+        }
+        _nextTouchMs = nowMs() + _touchMs;
+    }
+
+  private:
+    void send(uint16_t type, const void *payload, size_t size)
+    {
+        fpc_frame_hdr_t hdr = {FPC_FRAME_PROTOCOL_VERSION, type, FPC_FRAME_FLAG_SENDER_FW_APP, (uint16_t)size};
+        std::vector<uint8_t> out((uint8_t *)&hdr, (uint8_t *)&hdr + sizeof(hdr));
+        out.insert(out.end(), (const uint8_t *)payload, (const uint8_t *)payload + size);
+
+        size_t off = 0;
+        while (off < out.size())
+        {
+            ssize_t n = write(_fd, out.data() + off, out.size() - off);
+            if (n < 0 && errno != EAGAIN && errno != EINTR)
+                return;
+            off += n > 0 ? (size_t)n : 0;
+        }
+    }
+
+    void sendStatus(uint16_t type, uint16_t event, uint16_t failCode = 0)
+    {
+        fpc_cmd_status_response_t rsp = {
+            {CMD_STATUS, type}, event, (uint16_t)(_state | _mode), failCode, 0};
+        send(type, &rsp, sizeof(rsp));
+    }
+
+    void handle(const std::vector<uint8_t> &payload)
+    {
+        if (payload.size() < sizeof(fpc_cmd_hdr_t))
+            return;
+        const fpc_cmd_hdr_t *cmd = (const fpc_cmd_hdr_t *)payload.data();
+
+        printf("<- cmd 0x%04X (%zu bytes)\n", cmd->cmd_id, payload.size());
+        fflush(stdout);
+
+        switch (cmd->cmd_id)
+        {
+        case CMD_STATUS:
+            sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_NONE);
+            break;
+
+        case CMD_VERSION: {
+            static const char kVersion[] = "fpc2534-sim 1.0";
+            uint8_t buffer[sizeof(fpc_cmd_version_response_t) + sizeof(kVersion)] = {0};
+            fpc_cmd_version_response_t *rsp = (fpc_cmd_version_response_t *)buffer;
+            rsp->cmd = {CMD_VERSION, FPC_FRAME_TYPE_CMD_RESPONSE};
+            rsp->mcu_unique_id[0] = 0x53494D00;
+            rsp->fw_id = 1;
+            rsp->version_str_len = sizeof(kVersion);
+            memcpy(rsp->version_str, kVersion, sizeof(kVersion));
+            send(FPC_FRAME_TYPE_CMD_RESPONSE, buffer, sizeof(buffer));
+            break;
+        }
+
+        case CMD_LIST_TEMPLATES: {
+            std::vector<uint8_t> buffer(sizeof(fpc_cmd_template_info_response_t) +
+                                        _templates.size() * sizeof(uint16_t));
+            fpc_cmd_template_info_response_t *rsp = (fpc_cmd_template_info_response_t *)buffer.data();
+            rsp->cmd = {CMD_LIST_TEMPLATES, FPC_FRAME_TYPE_CMD_RESPONSE};
+            rsp->number_of_templates = (uint16_t)_templates.size();
+            memcpy(rsp->template_id_list, _templates.data(), _templates.size() * sizeof(uint16_t));
+            send(FPC_FRAME_TYPE_CMD_RESPONSE, buffer.data(), buffer.size());
+            break;
+        }
+
+        case CMD_ENROLL: {
+            const fpc_cmd_enroll_request_t *req = (const fpc_cmd_enroll_request_t *)cmd;
+            if (payload.size() < sizeof(*req))
+                return sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_CMD_FAILED, FPC_RESULT_INVALID_PARAM);
+            if (req->tpl_id.type == ID_TYPE_SPECIFIED)
+                _enrollId = req->tpl_id.id;
+            else
+            {
+                _enrollId = 1;
+                while (std::find(_templates.begin(), _templates.end(), _enrollId) != _templates.end())
+                    _enrollId++;
+            }
+            _mode = STATE_ENROLL;
+            _samplesRemaining = _config.enroll_touches;
+            _nextTouchMs = nowMs() + _touchMs;
+            sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_NONE);
+            break;
+        }
+
+        case CMD_IDENTIFY: {
+            const fpc_cmd_identify_request_t *req = (const fpc_cmd_identify_request_t *)cmd;
+            if (payload.size() < sizeof(*req))
+                return sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_CMD_FAILED, FPC_RESULT_INVALID_PARAM);
+            _tag = req->tag;
+            _mode = STATE_IDENTIFY;
+            _nextTouchMs = nowMs() + _touchMs;
+            sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_NONE);
+            break;
+        }
+
+        case CMD_DELETE_TEMPLATE: {
+            const fpc_cmd_template_delete_request_t *req = (const fpc_cmd_template_delete_request_t *)cmd;
+            if (payload.size() >= sizeof(*req) && req->tpl_id.type == ID_TYPE_ALL)
+            {
+                _templates.clear();
+                _templateData.clear();
+            }
+            else if (payload.size() >= sizeof(*req))
+            {
+                _templates.erase(std::remove(_templates.begin(), _templates.end(), req->tpl_id.id), _templates.end());
+                _templateData.erase(req->tpl_id.id);
+            }
+            sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_NONE);
+            break;
+        }
+
+        case CMD_GET_SYSTEM_CONFIG: {
+            fpc_cmd_get_config_response_t rsp = {{CMD_GET_SYSTEM_CONFIG, FPC_FRAME_TYPE_CMD_RESPONSE},
+                                                 FPC_SYS_CFG_TYPE_CUSTOM, _config};
+            send(FPC_FRAME_TYPE_CMD_RESPONSE, &rsp, sizeof(rsp));
+            break;
+        }
+
+        case CMD_SET_SYSTEM_CONFIG: {
+            const fpc_cmd_set_config_request_t *req = (const fpc_cmd_set_config_request_t *)cmd;
+            if (payload.size() >= sizeof(*req))
+            {
+                _config = req->cfg;
+                if (_maxScanMs > 0 && _config.finger_scan_interval_ms > _maxScanMs)
+                    _config.finger_scan_interval_ms = (uint16_t)_maxScanMs;
+            }
+            sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_NONE);
+            break;
+        }
+
+        case CMD_GPIO_CONTROL: {
+            const fpc_cmd_pinctrl_gpio_request_t *req = (const fpc_cmd_pinctrl_gpio_request_t *)cmd;
+            if (payload.size() >= sizeof(*req) && req->sub_cmd == GPIO_CONTROL_SUB_CMD_GET)
+            {
+                fpc_cmd_pinctrl_gpio_response_t rsp = {{CMD_GPIO_CONTROL, FPC_FRAME_TYPE_CMD_RESPONSE}, _gpioState};
+                send(FPC_FRAME_TYPE_CMD_RESPONSE, &rsp, sizeof(rsp));
+            }
+            else
+            {
+                if (payload.size() >= sizeof(*req))
+                    _gpioState = req->state;
+                sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_NONE);
+            }
+            break;
+        }
+
+        case CMD_PUT_TEMPLATE_DATA: {
+            const fpc_cmd_template_data_request_t *req = (const fpc_cmd_template_data_request_t *)cmd;
+            if (payload.size() < sizeof(*req) || req->total_size == 0 || req->id == 0)
+                return sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_CMD_FAILED, FPC_RESULT_INVALID_PARAM);
+            _xferId = req->id;
+            _xferSize = req->total_size;
+            _xferData.clear();
+            _mode = STATE_DATA_TRANSFER;
+            fpc_cmd_template_data_response_t rsp = {{CMD_PUT_TEMPLATE_DATA, FPC_FRAME_TYPE_CMD_RESPONSE}, _xferId,
+                                                    kMaxChunk, 0};
+            send(FPC_FRAME_TYPE_CMD_RESPONSE, &rsp, sizeof(rsp));
+            break;
+        }
+
+        case CMD_DATA_PUT: {
+            const fpc_cmd_data_put_request_t *req = (const fpc_cmd_data_put_request_t *)cmd;
+            if (_mode != STATE_DATA_TRANSFER || payload.size() < sizeof(*req) ||
+                payload.size() != sizeof(*req) + req->data_size || req->data_size > kMaxChunk ||
+                _xferData.size() + req->data_size + req->remaining_size != _xferSize)
+            {
+                _mode = 0;
+                return sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_CMD_FAILED, FPC_RESULT_INVALID_PARAM);
+            }
+            _xferData.insert(_xferData.end(), req->data, req->data + req->data_size);
+            if (req->remaining_size == 0)
+            {
+                _mode = 0;
+                if (std::find(_templates.begin(), _templates.end(), _xferId) == _templates.end())
+                    _templates.push_back(_xferId);
+                _templateData[_xferId] = _xferData;
+            }
+            fpc_cmd_data_put_response_t rsp = {{CMD_DATA_PUT, FPC_FRAME_TYPE_CMD_RESPONSE},
+                                               (uint32_t)_xferData.size()};
+            send(FPC_FRAME_TYPE_CMD_RESPONSE, &rsp, sizeof(rsp));
+            break;
+        }
+
+        case CMD_GET_TEMPLATE_DATA: {
+            const fpc_cmd_template_data_request_t *req = (const fpc_cmd_template_data_request_t *)cmd;
+            if (payload.size() < sizeof(*req))
+                return sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_CMD_FAILED, FPC_RESULT_INVALID_PARAM);
+            if (std::find(_templates.begin(), _templates.end(), req->id) == _templates.end())
+                return sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_CMD_FAILED, FPC_RESULT_USER_ID_NOT_FOUND);
+            _xferId = req->id;
+            _xferData = templateData(req->id);
+            _xferSize = _xferData.size();
+            _xferSent = 0;
+            _mode = STATE_DATA_TRANSFER;
+            fpc_cmd_template_data_response_t rsp = {{CMD_GET_TEMPLATE_DATA, FPC_FRAME_TYPE_CMD_RESPONSE}, _xferId,
+                                                    kMaxChunk, (uint16_t)_xferSize};
+            send(FPC_FRAME_TYPE_CMD_RESPONSE, &rsp, sizeof(rsp));
+            break;
+        }
+
+        case CMD_CAPTURE:
+            _state &= ~STATE_IMAGE_AVAILABLE;
+            _mode = STATE_CAPTURE;
+            _nextTouchMs = nowMs() + _touchMs;
+            sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_NONE);
+            break;
+
+        case CMD_IMAGE_DATA: {
+            const fpc_cmd_image_request_t *req = (const fpc_cmd_image_request_t *)cmd;
+            if (payload.size() < sizeof(*req) ||
+                (req->type != CMD_IMAGE_REQUEST_TYPE_GET_RAW && req->type != CMD_IMAGE_REQUEST_TYPE_GET_FMI))
+                return sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_CMD_FAILED, FPC_RESULT_INVALID_PARAM);
+            if (!(_state & STATE_IMAGE_AVAILABLE))
+                return sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_CMD_FAILED, FPC_RESULT_NO_IMAGE);
+            _xferData = _image;
+            _xferSize = 0;
+            _xferSent = 0;
+            _mode = STATE_DATA_TRANSFER;
+            fpc_cmd_image_response_t rsp = {{CMD_IMAGE_DATA, FPC_FRAME_TYPE_CMD_RESPONSE},
+                                            (uint32_t)_image.size(),
+                                            kFingerImageWidth,
+                                            kFingerImageHeight,
+                                            req->type,
+                                            kMaxChunk};
+            send(FPC_FRAME_TYPE_CMD_RESPONSE, &rsp, sizeof(rsp));
+            break;
+        }
+
+        case CMD_DATA_GET: {
+            const fpc_cmd_data_get_request_t *req = (const fpc_cmd_data_get_request_t *)cmd;
+            if (_mode != STATE_DATA_TRANSFER || payload.size() < sizeof(*req) || req->request_size == 0 ||
+                req->request_size > kMaxChunk || _xferSent >= _xferData.size())
+            {
+                _mode = 0;
+                return sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_CMD_FAILED, FPC_RESULT_INVALID_PARAM);
+            }
+            uint32_t len = std::min<uint32_t>(req->request_size, _xferData.size() - _xferSent);
+            std::vector<uint8_t> rsp(sizeof(fpc_cmd_data_get_response_t) + len);
+            fpc_cmd_data_get_response_t *hdr = (fpc_cmd_data_get_response_t *)rsp.data();
+            hdr->cmd = {CMD_DATA_GET, FPC_FRAME_TYPE_CMD_RESPONSE};
+            hdr->remaining_size = _xferData.size() - _xferSent - len;
+            hdr->data_size = len;
+            memcpy(hdr->data, _xferData.data() + _xferSent, len);
+            _xferSent += len;
+            if (_xferSent == _xferData.size())
+                _mode = 0;
+            send(FPC_FRAME_TYPE_CMD_RESPONSE, rsp.data(), rsp.size());
+            break;
+        }
+
+        case CMD_ABORT:
+            _mode = 0;
+            sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_NONE);
+            break;
+
+        case CMD_RESET:
+            usleep(20000);
+            boot();
+            break;
+
+        case CMD_FACTORY_RESET:
+            _templates.clear();
+            _templateData.clear();
+            usleep(20000);
+            boot();
+            break;
+
+        default:
+            sendStatus(FPC_FRAME_TYPE_CMD_RESPONSE, EVENT_CMD_FAILED, FPC_RESULT_CMD_ID_NOT_SUPPORTED);
+            break;
+        }
+    }
+
+    // The data of a template - put, or generated for an enrolled template (a feature table, with repeats)
+    std::vector<uint8_t> templateData(uint16_t id)
+    {
+        auto it = _templateData.find(id);
+        if (it != _templateData.end())
+            return it->second;
+
+        std::vector<uint8_t> data(1024 + (id % 16) * 64);
+        uint32_t x = id * 2654435761u;
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            x = x * 1103515245 + 12345;
+            data[i] = (i % 8) < 4 ? (uint8_t)(i / 8) : (uint8_t)((x >> 16) & 0x3F);
+        }
+        return data;
+    }
+
+    int _fd;
+    uint32_t _touchMs;
+    uint32_t _delayMs;
+    std::vector<uint8_t> _rx;
+
+    uint16_t _state = 0;
+    uint16_t _mode = 0;
+    uint64_t _nextTouchMs = 0;
+    uint16_t _enrollId = 0;
+    uint8_t _samplesRemaining = 0;
+    uint16_t _tag = 0;
+    uint8_t _gpioState = 0;
+    std::vector<uint16_t> _templates;
+    fpc_system_config_t _config;
+
+    // Template data - transferred with PUT_TEMPLATE_DATA and GET_TEMPLATE_DATA
+    static constexpr uint16_t kMaxChunk = 256;
+    std::map<uint16_t, std::vector<uint8_t>> _templateData;
+    uint16_t _xferId = 0;
+    uint16_t _xferSize = 0;
+    uint32_t _xferSent = 0; // GET - bytes sent
+    std::vector<uint8_t> _xferData;
+
+    // Captures - the last image
+    uint32_t _fingers = 10;
+    uint32_t _partialEvery = 0;
+    uint32_t _captures = 0;
+    std::vector<uint8_t> _image;
+
+    uint32_t _maxScanMs = 0;
+};
+
+//--------------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    uint32_t touchMs = 300, delayMs = 0;
+    uint16_t templates = 0;
+    uint32_t fingers = 10, partialEvery = 0, maxScanMs = 0;
+    const char *linkPath = nullptr;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:d:n:f:p:c:l:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            touchMs = (uint32_t)strtoul(optarg, nullptr, 10);
+            break;
+        case 'd':
+            delayMs = (uint32_t)strtoul(optarg, nullptr, 10);
+            break;
+        case 'n':
+            templates = (uint16_t)strtoul(optarg, nullptr, 10);
+            break;
+        case 'f':
+            fingers = (uint32_t)strtoul(optarg, nullptr, 10);
+            break;
+        case 'p':
+            partialEvery = (uint32_t)strtoul(optarg, nullptr, 10);
+            break;
+        case 'c':
+            maxScanMs = (uint32_t)strtoul(optarg, nullptr, 10);
+            break;
+        case 'l':
+            linkPath = optarg;
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-t touch_ms] [-d response_delay_ms] [-n templates] [-f fingers] [-p n] "
+                    "[-c max_scan_ms] [-l link_path]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0)
+    {
+        perror("posix_openpt");
+        return 1;
+    }
+    struct termios tio;
+    tcgetattr(fd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+
+    const char *slave = ptsname(fd);
+    if (linkPath)
+    {
+        unlink(linkPath);
+        if (symlink(slave, linkPath) != 0)
+            perror("symlink");
+    }
+    printf("FPC2534 simulator on %s\n", linkPath ? linkPath : slave);
+    fflush(stdout);
+
+    // hold the slave open, so the master doesn't see a hangup before the host connects
+    int slaveFd = open(slave, O_RDWR | O_NOCTTY);
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    Simulator sim(fd, touchMs, delayMs);
+    sim.enrollTemplates(templates);
+    sim.setFingers(fingers, partialEvery);
+    sim.setMaxScanInterval(maxScanMs);
+    sim.boot();
+
+    struct pollfd pfd = {fd, POLLIN, 0};
+    uint8_t buffer[1024];
+    while (!gStop)
+    {
+        if (poll(&pfd, 1, 10) > 0 && (pfd.revents & POLLIN))
+        {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n > 0)
+                sim.feed(buffer, (size_t)n);
+        }
+        sim.tick();
+    }
+
+    if (linkPath)
+        unlink(linkPath);
+    close(slaveFd);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,368 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * Host template store for the SparkFun FPC2534 library on a Linux host.
+ *
+ * Keeps copies of the templates of many sensors in one store file (sfDevFPC2534TemplateStore) - pulled from a
+ * sensor with template GET transfers, written straight into the store, and pushed back to a sensor (the same
+ * sensor, or its replacement) with the provisioning pipeline.
+ *
+ *   fpc2534_store pull store sensor uart device   - replace the templates of sensor in the store with the
+ *                                                   templates on the device
+ *   fpc2534_store push store sensor uart device   - send the templates of sensor in the store to the device
+ *                                                   (the templates the device already has are skipped)
+ *   fpc2534_store list store [sensor]             - the store statistics, and the templates of a sensor
+ *   fpc2534_store compact store                   - reclaim the space of replaced and deleted templates
+ *   fpc2534_store bench store templates size      - fill the store with generated templates (100 per sensor),
+ *                                                   and time lookups
+ *
+ * The sensor is a number that names the sensor in the store. Use the fpc2534_sim tool to pull the templates of a
+ * simulated sensor, and push them to another:
+ *
+ *   fpc2534_sim -n 8 -l /tmp/fpc2534_a &
+ *   fpc2534_sim -l /tmp/fpc2534_b &
+ *   fpc2534_store pull /tmp/templates.fpcs 1 uart /tmp/fpc2534_a
+ *   fpc2534_store push /tmp/templates.fpcs 1 uart /tmp/fpc2534_b
+ *
+ * Build:
+ *
+ *   g++ -std=gnu++17 -O2 -Isrc/sfTk -o fpc2534_store extras/linux/fpc2534_store.cpp \
+ *       src/sfTk/sfDevFPC2534.cpp src/sfTk/sfDevFPC2534IComm.cpp src/sfTk/sfDevFPC2534Linux.cpp \
+ *       src/sfTk/sfDevFPC2534IOTask.cpp src/sfTk/sfDevFPC2534Power.cpp src/sfTk/sfDevFPC2534Manager.cpp \
+ *       src/sfTk/sfDevFPC2534Provision.cpp src/sfTk/sfDevFPC2534Backup.cpp src/sfTk/sfDevFPC2534Store.cpp -lpthread
+ */
+
+#include "sfDevFPC2534.h"
+#include "sfDevFPC2534Linux.h"
+#include "sfDevFPC2534Manager.h"
+#include "sfDevFPC2534Provision.h"
+#include "sfDevFPC2534Store.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+static sfDevFPC2534 mySensor;
+static sfDevFPC2534LinuxUART myComm;
+static sfDevFPC2534TemplateStore myStore;
+
+// Max time for a transfer (or the template list) with no progress
+static const uint32_t kTimeoutMs = 2000;
+
+// The template being pulled
+static uint32_t pullSensor;
+static uint16_t pullId;
+
+//------------------------------------------------------------------------------------
+// The template list response - flagged by a hook
+//
+static bool listed = false;
+
+static void listHook(void *arg, fpc_cmd_hdr_t *cmd, size_t size)
+{
+    if (cmd->cmd_id == CMD_LIST_TEMPLATES)
+        listed = true;
+}
+
+static sfDevFPC2534Hook_t myHook = {listHook, nullptr, nullptr};
+
+//------------------------------------------------------------------------------------
+// Writer of a template GET transfer - into the store, as the chunks arrive
+//
+static uint16_t storeChunk(void *arg, uint32_t offset, const uint8_t *data, uint16_t len)
+{
+    if (offset == 0 && myStore.beginAppend(pullSensor, pullId) != FPC_RESULT_OK)
+        return 0;
+
+    if (myStore.append(data, len) != FPC_RESULT_OK)
+        return 0;
+
+    if (offset + len == mySensor.transferSize() && myStore.endAppend() != FPC_RESULT_OK)
+        return 0;
+
+    return len;
+}
+
+//------------------------------------------------------------------------------------
+// Run the transfer until it is done - the timeout restarts each time the transfer moves along
+//
+static fpc_result_t waitForTransfer(void)
+{
+    uint32_t progress = mySensor.transferProgress();
+    uint32_t lastMs = millis();
+
+    while (mySensor.isTransferActive())
+    {
+        mySensor.waitForEvent(50);
+
+        if (mySensor.transferProgress() != progress)
+        {
+            progress = mySensor.transferProgress();
+            lastMs = millis();
+        }
+        else if (millis() - lastMs >= kTimeoutMs)
+        {
+            mySensor.abortTransfer();
+            return FPC_RESULT_TIMEOUT;
+        }
+    }
+    return mySensor.transferResult();
+}
+
+//------------------------------------------------------------------------------------
+// Replace the templates of the sensor in the store with the templates on the device - in one batch, so the
+// store has the old set or the new set after a crash, never a mix.
+//
+static fpc_result_t pull(uint32_t sensor)
+{
+    listed = false;
+    mySensor.addHook(myHook);
+    fpc_result_t rc = mySensor.requestListTemplates();
+
+    uint32_t start = millis();
+    while (rc == FPC_RESULT_OK && !listed)
+    {
+        if (millis() - start >= kTimeoutMs)
+            rc = FPC_RESULT_TIMEOUT;
+        else
+            mySensor.waitForEvent(50);
+    }
+    mySensor.removeHook(myHook);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    // The templates no longer on the sensor are deleted, the others are replaced
+    std::vector<uint16_t> stored(myStore.list(sensor, nullptr, 0));
+    myStore.list(sensor, stored.data(), stored.size());
+
+    myStore.beginBatch();
+    for (size_t i = 0; i < stored.size() && rc == FPC_RESULT_OK; i++)
+    {
+        if (!mySensor.hasTemplate(stored[i]))
+            rc = myStore.remove(sensor, stored[i]);
+    }
+
+    uint32_t bytes = 0;
+    pullSensor = sensor;
+    for (uint16_t id = 0; id <= SFE_FPC2534_MAX_TEMPLATE_ID && rc == FPC_RESULT_OK; id++)
+    {
+        if (!mySensor.hasTemplate(id))
+            continue;
+
+        pullId = id;
+        rc = mySensor.requestGetTemplateData(id, storeChunk, nullptr);
+        if (rc == FPC_RESULT_OK)
+            rc = waitForTransfer();
+
+        if (rc == FPC_RESULT_OK)
+            bytes += mySensor.transferSize();
+    }
+
+    // On a failure, the batch is dropped - the store keeps the templates it had
+    if (rc != FPC_RESULT_OK)
+    {
+        myStore.rollback();
+        return rc;
+    }
+
+    rc = myStore.commit();
+    printf("[PULL]\t%u templates, %u bytes in %u ms\n", mySensor.templateCount(), bytes,
+           (uint32_t)(millis() - start));
+    return rc;
+}
+
+//------------------------------------------------------------------------------------
+// Send the templates of the sensor in the store to the device
+//
+static fpc_result_t push(uint32_t sensor)
+{
+    static sfDevFPC2534Manager manager;
+    static sfDevFPC2534Provision provision;
+
+    sfDevFPC2534StoreTemplates source(myStore, sensor);
+    if (source.templateCount() == 0)
+        return FPC_RESULT_USER_ID_NOT_FOUND;
+
+    manager.addSensor(mySensor, 0);
+    if (!provision.begin(manager, source))
+        return FPC_RESULT_INVALID_PARAM;
+
+    uint32_t start = millis();
+    while (!provision.isDone() && millis() - start < 60000)
+    {
+        manager.waitForEvent(10);
+        provision.poll();
+    }
+
+    sfDevFPC2534ProvisionSensorStats_t stats;
+    provision.getSensorStats(0, stats);
+    provision.end();
+
+    printf("[PUSH]\t%u sent, %u skipped, %u retries, %u bytes in %u ms\n", stats.templatesSent,
+           stats.templatesSkipped, stats.retries, stats.bytes, stats.elapsedMs);
+
+    if (stats.state != kFPC2534ProvisionDone)
+        return stats.lastError != FPC_RESULT_OK ? stats.lastError : FPC_RESULT_TIMEOUT;
+    return FPC_RESULT_OK;
+}
+
+//------------------------------------------------------------------------------------
+static void list(bool withSensor, uint32_t sensor)
+{
+    sfDevFPC2534StoreStats_t stats;
+    myStore.getStats(stats);
+    printf("[STORE]\t%u templates, %u index slots, %llu live bytes, %llu dead bytes, %llu file bytes, %u rebuilds\n",
+           stats.templates, stats.slots, (unsigned long long)stats.liveBytes, (unsigned long long)stats.deadBytes,
+           (unsigned long long)stats.fileSize, stats.rebuilds);
+
+    if (!withSensor)
+        return;
+
+    std::vector<uint16_t> ids(myStore.list(sensor, nullptr, 0));
+    myStore.list(sensor, ids.data(), ids.size());
+    printf("[SENSOR %u]\t%u templates\n", sensor, (unsigned)ids.size());
+
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        uint32_t size;
+        myStore.get(sensor, ids[i], size);
+        printf("\t\tID %u, %u bytes%s\n", ids[i], size,
+               myStore.verify(sensor, ids[i]) == FPC_RESULT_OK ? "" : " - CRC MISMATCH");
+    }
+}
+
+//------------------------------------------------------------------------------------
+static uint64_t nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+//------------------------------------------------------------------------------------
+// Fill the store with generated templates - 100 per sensor - and time random lookups
+//
+static fpc_result_t bench(uint32_t count, uint32_t size)
+{
+    std::vector<uint8_t> data(size);
+    uint32_t x = 0x2534;
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        x = x * 1103515245 + 12345;
+        data[i] = (uint8_t)(x >> 16);
+    }
+
+    uint64_t start = nowNs();
+    myStore.beginBatch();
+    fpc_result_t rc = FPC_RESULT_OK;
+    for (uint32_t i = 0; i < count && rc == FPC_RESULT_OK; i++)
+        rc = myStore.put(i / 100, i % 100, data.data(), size);
+    if (rc == FPC_RESULT_OK)
+        rc = myStore.commit();
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    uint64_t putNs = nowNs() - start;
+
+    const uint32_t lookups = 1000000;
+    uint64_t sum = 0;
+    start = nowNs();
+    for (uint32_t i = 0; i < lookups; i++)
+    {
+        x = x * 1103515245 + 12345;
+        uint32_t n = (x >> 8) % count;
+
+        uint32_t len;
+        const uint8_t *tmpl = myStore.get(n / 100, n % 100, len);
+        if (tmpl == nullptr)
+            return FPC_RESULT_USER_ID_NOT_FOUND;
+        sum += tmpl[len - 1];
+    }
+    uint64_t getNs = nowNs() - start;
+
+    printf("[BENCH]\t%u templates of %u bytes written in %llu ms (one commit)\n", count, size,
+           (unsigned long long)(putNs / 1000000));
+    printf("[BENCH]\t%u lookups in %llu ms - %llu ns per lookup (%llu)\n", lookups,
+           (unsigned long long)(getNs / 1000000), (unsigned long long)(getNs / lookups), (unsigned long long)sum);
+    return FPC_RESULT_OK;
+}
+
+//------------------------------------------------------------------------------------
+// Open the UART, and wait for the sensor
+//
+static fpc_result_t openSensor(const char *type, const char *device)
+{
+    if (strcmp(type, "uart") != 0 || !myComm.initialize(device))
+    {
+        fprintf(stderr, "[ERROR]\tUnable to open %s on %s\n", type, device);
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+    }
+    mySensor.initialize(myComm);
+    return mySensor.waitForBoot(2000);
+}
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    const char *command = argc > 2 ? argv[1] : "";
+    bool sensorCommand = (strcmp(command, "pull") == 0 || strcmp(command, "push") == 0) && argc == 6;
+    bool listCommand = strcmp(command, "list") == 0 && (argc == 3 || argc == 4);
+    bool compactCommand = strcmp(command, "compact") == 0 && argc == 3;
+    bool benchCommand = strcmp(command, "bench") == 0 && argc == 5;
+    if (!sensorCommand && !listCommand && !compactCommand && !benchCommand)
+    {
+        fprintf(stderr,
+                "Usage: %s (pull|push) store sensor uart device\n       %s list store [sensor]\n"
+                "       %s compact store\n       %s bench store templates size\n",
+                argv[0], argv[0], argv[0], argv[0]);
+        return 1;
+    }
+
+    fpc_result_t rc = myStore.open(argv[2]);
+    if (rc != FPC_RESULT_OK)
+    {
+        fprintf(stderr, "[ERROR]\tUnable to open the store %s: %u\n", argv[2], rc);
+        return 1;
+    }
+
+    if (sensorCommand)
+    {
+        uint32_t sensor = (uint32_t)strtoul(argv[3], nullptr, 0);
+        rc = openSensor(argv[4], argv[5]);
+        if (rc == FPC_RESULT_OK)
+            rc = strcmp(command, "pull") == 0 ? pull(sensor) : push(sensor);
+    }
+    else if (listCommand)
+        list(argc == 4, argc == 4 ? (uint32_t)strtoul(argv[3], nullptr, 0) : 0);
+    else if (compactCommand)
+    {
+        rc = myStore.compact();
+        list(false, 0);
+    }
+    else
+    {
+        uint32_t count = (uint32_t)strtoul(argv[3], nullptr, 0);
+        uint32_t size = (uint32_t)strtoul(argv[4], nullptr, 0);
+        rc = count > 0 && size > 0 ? bench(count, size) : FPC_RESULT_INVALID_PARAM;
+        list(false, 0);
+    }
+
+    myStore.close();
+    if (rc != FPC_RESULT_OK)
+    {
+        fprintf(stderr, "[ERROR]\t%s failed: %u\n", command, rc);
+        return 1;
+    }
+    return 0;
+}
@@ -20,7 +20,14 @@
 #pragma once
 
 #include "sfTk/sfDevFPC2534.h"
+#include "sfTk/sfDevFPC2534Async.h"
+#include "sfTk/sfDevFPC2534Backup.h"
 #include "sfTk/sfDevFPC2534I2C.h"
+#include "sfTk/sfDevFPC2534IOTask.h"
+#include "sfTk/sfDevFPC2534Manager.h"
+#include "sfTk/sfDevFPC2534Power.h"
+#include "sfTk/sfDevFPC2534Provision.h"
+#include "sfTk/sfDevFPC2534Quality.h"
 #include "sfTk/sfDevFPC2534SPI.h"
 #include "sfTk/sfDevFPC2534UART.h"
 #include <Arduino.h>
@@ -28,6 +35,31 @@
 // Make a Arduino friendly Address define
 #define SFE_FPC2534_I2C_ADDRESS kFPC2534DefaultAddress
 
+// Reset pin value for "no reset pin connected"
+const uint32_t kFPC2534NoResetPin = 255;
+
+// Width of the reset pulse for the boot handshake of begin()
+const uint32_t kFPC2534ResetPulseMs = 10;
+
+//--------------------------------------------------------------------------------------------
+// Boot handshake of begin() - reset the sensor (if a reset pin is given) and wait for it to be ready
+//
+static inline bool sfeFPC2534Boot(sfDevFPC2534 &device, uint32_t bootTimeoutMs, uint32_t resetPin)
+{
+    if (bootTimeoutMs == 0)
+        return true;
+
+    if (resetPin != kFPC2534NoResetPin)
+    {
+        device.clearData();
+        pinMode(resetPin, OUTPUT);
+        digitalWrite(resetPin, LOW);
+        delay(kFPC2534ResetPulseMs);
+        digitalWrite(resetPin, HIGH);
+    }
+    return device.waitForBoot(bootTimeoutMs, true) == FPC_RESULT_OK;
+}
+
 //--------------------------------------------------------------------------------------------
 // I2C version of the FPC2534 class
 //
@@ -46,11 +78,14 @@ class SfeFPC2534I2C : public sfDevFPC2534
      * @param wirePort Reference to the TwoWire object to use (default is Wire)
      * @param i2cBusNumber I2C bus number (default is 0) This should match the bus number used in the Wire object
      * @param interruptPin Pin number for the interrupt (default is 255, meaning no interrupt)
+     * @param bootTimeoutMs If not 0, run the boot handshake - wait up to this long for the sensor to be ready,
+     * and load its version and configuration (see waitForBoot()). Set the callbacks before begin().
+     * @param resetPin Pin connected to the sensor RST pin - if given, the sensor is reset before the handshake
      * @return true if initialization was successful, false otherwise
      */
 
     bool begin(const uint8_t address = kFPC2534DefaultAddress, TwoWire &wirePort = Wire, const uint8_t i2cBusNumber = 0,
-               const uint32_t interruptPin = 255)
+               const uint32_t interruptPin = 255, uint32_t bootTimeoutMs = 0, uint32_t resetPin = kFPC2534NoResetPin)
     {
 
         // Setup the I2C communication
@@ -59,7 +94,59 @@ class SfeFPC2534I2C : public sfDevFPC2534
 
         // Okay, the bus is a go, lets initialize the base class
 
-        return sfDevFPC2534::initialize(_commI2CBus);
+        if (!sfDevFPC2534::initialize(_commI2CBus))
+            return false;
+
+        return sfeFPC2534Boot(*this, bootTimeoutMs, resetPin);
+    }
+
+    /**
+     * @brief Get the I2C read statistics - packets, bytes and the time the reads took
+     *
+     * @param stats Set to the statistics
+     */
+    void getI2CStats(sfDevFPC2534I2CStats_t &stats) const
+    {
+        _commI2CBus.getStats(stats);
+    }
+
+    /**
+     * @brief Reset the I2C read statistics
+     */
+    void resetI2CStats(void)
+    {
+        _commI2CBus.resetStats();
+    }
+
+    /**
+     * @brief The effective I2C read throughput, in payload bytes per second
+     */
+    uint32_t getI2CThroughput(void) const
+    {
+        return _commI2CBus.throughput();
+    }
+
+    /**
+     * @brief Set the SDA and SCL pins - used to recover a stuck bus (see recoverI2CBus())
+     *
+     * @param sdaPin The SDA pin
+     * @param sclPin The SCL pin
+     * @param clockHz The bus clock to restart Wire at after a recovery - 0 for the Wire default
+     */
+    void setI2CBusPins(uint32_t sdaPin, uint32_t sclPin, uint32_t clockHz = 0)
+    {
+        _commI2CBus.setBusPins(sdaPin, sclPin, clockHz);
+    }
+
+    /**
+     * @brief Free a stuck I2C bus - 9 clocks and a STOP, then the read helper is reinitialized. This is run
+     * automatically on transfer timeouts and lost arbitration - the counts are in the I2C statistics.
+     *
+     * @return true if the bus lines are released
+     */
+    bool recoverI2CBus(void)
+    {
+        return _commI2CBus.recoverBus();
     }
 
   private:
@@ -79,17 +166,39 @@ class SfeFPC2534UART : public sfDevFPC2534
      * @brief Initialize the sensor using UART communication
      *
      * @param theUART Reference to the HardwareSerial object to use
+     * @param baudRate The baud rate theUART was started at - needed by negotiateUARTBaudRate() to probe the
+     * current rate first. 0 if not known.
+     * @param interruptPin Pin connected to the sensor IRQ - optional. With the CFG_SYS_FLAG_UART_IRQ_BEFORE_TX
+     * system flag set on the sensor, waitForEvent() sleeps the host until the IRQ.
+     * @param bootTimeoutMs If not 0, run the boot handshake - wait up to this long for the sensor to be ready,
+     * and load its version and configuration (see waitForBoot()). Set the callbacks before begin().
+     * @param resetPin Pin connected to the sensor RST pin - if given, the sensor is reset before the handshake
      * @return true if initialization was successful, false otherwise
      */
-    bool begin(HardwareSerial &theUART)
+    bool begin(HardwareSerial &theUART, uint32_t baudRate = 0, uint32_t interruptPin = kFPC2534NoIRQPin,
+               uint32_t bootTimeoutMs = 0, uint32_t resetPin = kFPC2534NoResetPin)
     {
 
-        if (!_commUART.initialize(theUART))
+        if (!_commUART.initialize(theUART, baudRate, interruptPin))
             return false;
 
         // Okay, the bus is a go, lets initialize the base class
 
-        return sfDevFPC2534::initialize(_commUART);
+        if (!sfDevFPC2534::initialize(_commUART))
+            return false;
+
+        return sfeFPC2534Boot(*this, bootTimeoutMs, resetPin);
+    }
+
+    /**
+     * @brief Set the pin connected to the wake-up pin (CS) of the sensor. Needed by the power manager
+     * (sfDevFPC2534Power) to wake the sensor from stop mode.
+     *
+     * @param wakePin The pin number
+     */
+    void setWakePin(uint32_t wakePin)
+    {
+        _commUART.setWakePin(wakePin);
     }
 
   private:
@@ -114,11 +223,14 @@ class SfeFPC2534SPI : public sfDevFPC2534
      * @param csPin Chip select pin number
      * @param interruptPin Pin number for the interrupt)
      * @param bInit Whether to initialize the SPI bus (default is false)
+     * @param bootTimeoutMs If not 0, run the boot handshake - wait up to this long for the sensor to be ready,
+     * and load its version and configuration (see waitForBoot()). Set the callbacks before begin().
+     * @param resetPin Pin connected to the sensor RST pin - if given, the sensor is reset before the handshake
      * @return true if initialization was successful, false otherwise
      */
 
     bool begin(SPIClass &spiPort, SPISettings &busSPISettings, const uint8_t csPin, const uint32_t interruptPin,
-               bool bInit = false)
+               bool bInit = false, uint32_t bootTimeoutMs = 0, uint32_t resetPin = kFPC2534NoResetPin)
     {
 
         // Setup the SPI communication
@@ -127,7 +239,10 @@ class SfeFPC2534SPI : public sfDevFPC2534
 
         // Okay, the bus is a go, lets initialize the base class
 
-        return sfDevFPC2534::initialize(_commSPIBus);
+        if (!sfDevFPC2534::initialize(_commSPIBus))
+            return false;
+
+        return sfeFPC2534Boot(*this, bootTimeoutMs, resetPin);
     }
 
     /**
@@ -136,9 +251,12 @@ class SfeFPC2534SPI : public sfDevFPC2534
      * @param csPin Chip select pin number
      * @param interruptPin Pin number for the interrupt (default is 255, meaning no interrupt)
      * @param bInit Whether to initialize the SPI bus (default is false)
+     * @param bootTimeoutMs If not 0, run the boot handshake (see above)
+     * @param resetPin Pin connected to the sensor RST pin - if given, the sensor is reset before the handshake
      * @return true if initialization was successful, false otherwise
      */
-    bool begin(const uint8_t csPin, const uint32_t interruptPin, bool bInit = false)
+    bool begin(const uint8_t csPin, const uint32_t interruptPin, bool bInit = false, uint32_t bootTimeoutMs = 0,
+               uint32_t resetPin = kFPC2534NoResetPin)
     {
 
         // Setup the SPI communication
@@ -147,7 +265,10 @@ class SfeFPC2534SPI : public sfDevFPC2534
 
         // Okay, the bus is a go, lets initialize the base class
 
-        return sfDevFPC2534::initialize(_commSPIBus);
+        if (!sfDevFPC2534::initialize(_commSPIBus))
+            return false;
+
+        return sfeFPC2534Boot(*this, bootTimeoutMs, resetPin);
     }
 
   private:
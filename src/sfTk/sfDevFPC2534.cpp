@@ -10,10 +10,17 @@
 // Implementation file for the main class of the library.
 
 #include "sfDevFPC2534.h"
+#include "sfDevFPC2534Power.h"
+
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+#include "sfDevFPC2534IOTask.h"
+#endif
 
 //--------------------------------------------------------------------------------------------
 // Constructor (ctor)
-sfDevFPC2534::sfDevFPC2534() : _comm{nullptr}, _callbacks{0}, _current_state{0}, _finger_present{false}
+sfDevFPC2534::sfDevFPC2534()
+    : _comm{nullptr}, _callbacks{0}, _current_state{0}, _finger_present{false}, _hooks{nullptr}, _ioTask{nullptr},
+      _power{nullptr}
 {
 }
 
@@ -31,14 +38,46 @@ fpc_result_t sfDevFPC2534::sendCommand(fpc_cmd_hdr_t &cmd, size_t size)
     frameHeader.flags = FPC_FRAME_FLAG_SENDER_HOST;
     frameHeader.payload_size = (uint16_t)size;
 
+    // A sensor in stop mode must be woken first, or the command is lost
+    if (_power != nullptr)
+        _power->beforeCommand();
+
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+    // the I/O task could be reading the bus
+    if (_ioTask != nullptr)
+        _ioTask->lockBus();
+#endif
+
     // send message header, then payload
     _comm->beginWrite();
-    fpc_result_t rc = _comm->write((uint8_t *)&frameHeader, sizeof(fpc_frame_hdr_t));
+    fpc_result_t rc = writeWithRetry((uint8_t *)&frameHeader, sizeof(fpc_frame_hdr_t));
 
     if (rc == FPC_RESULT_OK)
-        rc = _comm->write((uint8_t *)&cmd, size);
+        rc = writeWithRetry((uint8_t *)&cmd, size);
 
     _comm->endWrite();
+
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+    if (_ioTask != nullptr)
+        _ioTask->unlockBus();
+#endif
+
+    // A reset is not answered (the boot status follows), and drops the requests outstanding
+    if (rc == FPC_RESULT_OK && (cmd.cmd_id == CMD_RESET || cmd.cmd_id == CMD_FACTORY_RESET))
+        clearResponsesPending();
+    else if (rc == FPC_RESULT_OK && _rspPending < 0xFF)
+        _rspPending++;
+
+    // The sensor responds to every command - a failed write is caught by the response timeout too
+    if (_wdEnabled)
+    {
+        _wdLastTrafficMs = millis();
+        if (!_wdExpecting)
+        {
+            _wdExpecting = true;
+            _wdExpectSince = _wdLastTrafficMs;
+        }
+    }
     return rc;
 }
 //--------------------------------------------------------------------------------------------
@@ -83,9 +122,45 @@ fpc_result_t sfDevFPC2534::requestIdentify(fpc_id_type_t &id, uint16_t tag)
     return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_identify_request_t));
 }
 
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::startContinuousIdentify(fpc_id_type_t &id)
+{
+    if (id.type != ID_TYPE_SPECIFIED && id.type != ID_TYPE_ALL)
+        return FPC_RESULT_INVALID_PARAM;
+
+    _contIdId = id;
+    memset(&_contIdTiming, 0, sizeof(_contIdTiming));
+
+    fpc_result_t rc = armContinuousIdentify();
+    _contIdActive = rc == FPC_RESULT_OK;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::stopContinuousIdentify(void)
+{
+    if (!_contIdActive)
+        return FPC_RESULT_OK;
+
+    // the abort ends the mode
+    return requestAbort();
+}
+
+//--------------------------------------------------------------------------------------------
+// Send the next identify request of continuous identify mode - with a new tag
+fpc_result_t sfDevFPC2534::armContinuousIdentify(void)
+{
+    _contIdTag++;
+    _contIdArmedAt = micros();
+    return requestIdentify(_contIdId, _contIdTag);
+}
+
 //--------------------------------------------------------------------------------------------
 fpc_result_t sfDevFPC2534::requestAbort(void)
 {
+    // No more re-arming
+    _contIdActive = false;
+
     /* Abort Command Request has no payload */
     fpc_cmd_hdr_t cmd = {.cmd_id = CMD_ABORT, .type = FPC_FRAME_TYPE_CMD_REQUEST};
 
@@ -116,7 +191,234 @@ fpc_result_t sfDevFPC2534::requestDeleteTemplate(fpc_id_type_t &id)
     fpc_cmd_enroll_request_t cmd = {.cmd = {.cmd_id = CMD_DELETE_TEMPLATE, .type = FPC_FRAME_TYPE_CMD_REQUEST},
                                     .tpl_id = id};
 
-    return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_enroll_request_t));
+    // responses to the requests still outstanding come first
+    uint8_t ahead = _rspPending;
+    fpc_result_t rc = sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_enroll_request_t));
+
+    // the template index is updated when the sensor confirms the delete
+    _tplDeletePending = rc == FPC_RESULT_OK;
+    _tplDeleteAhead = ahead;
+    _tplDeleteId = id;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// Template transfers (PUT and GET)
+//--------------------------------------------------------------------------------------------
+// Reader for a template in memory - arg is the data
+static uint16_t readFromMemory(void *arg, uint32_t offset, uint8_t *data, uint16_t len)
+{
+    memcpy(data, (const uint8_t *)arg + offset, len);
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::requestPutTemplateData(uint16_t id, const uint8_t *data, size_t size)
+{
+    if (data == nullptr)
+        return FPC_RESULT_INVALID_PARAM;
+
+    return requestPutTemplateData(id, size, readFromMemory, (void *)data);
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::requestPutTemplateData(uint16_t id, size_t size, sfDevFPC2534DataReader_t reader, void *arg)
+{
+    // the size field of the request is 16 bits
+    if (reader == nullptr || size == 0 || size > 0xFFFF)
+        return FPC_RESULT_INVALID_PARAM;
+
+    if (_xferActive)
+        return FPC_RESULT_WRONG_STATE;
+
+    fpc_cmd_template_data_request_t cmd = {.cmd = {.cmd_id = CMD_PUT_TEMPLATE_DATA, .type = FPC_FRAME_TYPE_CMD_REQUEST},
+                                           .id = id,
+                                           .total_size = (uint16_t)size};
+
+    _xferGet = false;
+    _xferImage = false;
+    _xferId = id;
+    _xferSize = size;
+    _xferSent = 0;
+    _xferAcked = 0;
+    _xferChunk = 0;
+    _xferReader = reader;
+    _xferBuffer = nullptr;
+    _xferArg = arg;
+
+    fpc_result_t rc = sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_template_data_request_t));
+
+    // the response gives the chunk size - the data follows from processNextResponse()
+    _xferActive = rc == FPC_RESULT_OK;
+    _xferResult = rc == FPC_RESULT_OK ? FPC_RESULT_IO_BUSY : rc;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// Writer for a template read into memory - arg is the buffer
+static uint16_t writeToMemory(void *arg, uint32_t offset, const uint8_t *data, uint16_t len)
+{
+    memcpy((uint8_t *)arg + offset, data, len);
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::requestGetTemplateData(uint16_t id, uint8_t *buffer, size_t bufferSize)
+{
+    if (buffer == nullptr || bufferSize == 0)
+        return FPC_RESULT_INVALID_PARAM;
+
+    // the size of the template is checked against the buffer when the sensor gives it
+    return startGetTemplateData(id, writeToMemory, buffer, bufferSize < 0xFFFF ? bufferSize : 0xFFFF, buffer);
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::requestGetTemplateData(uint16_t id, sfDevFPC2534DataWriter_t writer, void *arg)
+{
+    if (writer == nullptr)
+        return FPC_RESULT_INVALID_PARAM;
+
+    return startGetTemplateData(id, writer, arg, 0xFFFF, nullptr);
+}
+
+//--------------------------------------------------------------------------------------------
+// Start a template GET - the transfer state is only touched when no transfer is running
+//
+fpc_result_t sfDevFPC2534::startGetTemplateData(uint16_t id, sfDevFPC2534DataWriter_t writer, void *arg,
+                                                uint32_t limit, uint8_t *buffer)
+{
+    if (_xferActive)
+        return FPC_RESULT_WRONG_STATE;
+
+    // total_size is only used for PUT
+    fpc_cmd_template_data_request_t cmd = {.cmd = {.cmd_id = CMD_GET_TEMPLATE_DATA, .type = FPC_FRAME_TYPE_CMD_REQUEST},
+                                           .id = id,
+                                           .total_size = 0};
+
+    _xferGet = true;
+    _xferImage = false;
+    _xferId = id;
+    _xferSize = 0;
+    _xferLimit = limit;
+    _xferSent = 0;
+    _xferAcked = 0;
+    _xferChunk = 0;
+    _xferWriter = writer;
+    _xferBuffer = buffer;
+    _xferArg = arg;
+
+    fpc_result_t rc = sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_template_data_request_t));
+
+    // the response gives the template size and chunk size - the data follows from processNextResponse()
+    _xferActive = rc == FPC_RESULT_OK;
+    _xferResult = rc == FPC_RESULT_OK ? FPC_RESULT_IO_BUSY : rc;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::requestCapture(void)
+{
+    fpc_cmd_capture_request_t cmd = {.cmd = {.cmd_id = CMD_CAPTURE, .type = FPC_FRAME_TYPE_CMD_REQUEST}};
+
+    return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_capture_request_t));
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::requestGetImageData(uint16_t type, sfDevFPC2534DataWriter_t writer, void *arg)
+{
+    if (writer == nullptr || (type != CMD_IMAGE_REQUEST_TYPE_GET_RAW && type != CMD_IMAGE_REQUEST_TYPE_GET_FMI))
+        return FPC_RESULT_INVALID_PARAM;
+
+    if (_xferActive)
+        return FPC_RESULT_WRONG_STATE;
+
+    // total_size is only used for PUT
+    fpc_cmd_image_request_t cmd = {.cmd = {.cmd_id = CMD_IMAGE_DATA, .type = FPC_FRAME_TYPE_CMD_REQUEST},
+                                   .type = type,
+                                   .total_size = 0};
+
+    _xferGet = true;
+    _xferImage = true;
+    _xferId = type;
+    _xferSize = 0;
+    _xferLimit = 0xFFFFFFFF;
+    _xferSent = 0;
+    _xferAcked = 0;
+    _xferChunk = 0;
+    _xferWriter = writer;
+    _xferBuffer = nullptr;
+    _xferArg = arg;
+    _imageWidth = 0;
+    _imageHeight = 0;
+
+    fpc_result_t rc = sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_image_request_t));
+
+    // the response gives the image size and chunk size - the data follows from processNextResponse()
+    _xferActive = rc == FPC_RESULT_OK;
+    _xferResult = rc == FPC_RESULT_OK ? FPC_RESULT_IO_BUSY : rc;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::abortTransfer(void)
+{
+    if (!_xferActive)
+        return FPC_RESULT_OK;
+
+    endTransfer(FPC_RESULT_FAILURE);
+    return requestAbort();
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534::endTransfer(fpc_result_t rc)
+{
+    _xferActive = false;
+    _xferResult = rc;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534::failTransfer(fpc_result_t rc)
+{
+    endTransfer(rc);
+    if (_callbacks.on_error)
+        _callbacks.on_error(rc);
+}
+
+//--------------------------------------------------------------------------------------------
+// Send the next chunk of the template - read from the reader into the request
+//
+fpc_result_t sfDevFPC2534::sendDataPutChunk(void)
+{
+    uint16_t len = _xferSize - _xferSent < _xferChunk ? (uint16_t)(_xferSize - _xferSent) : _xferChunk;
+
+    uint8_t buffer[sizeof(fpc_cmd_data_put_request_t) + len];
+    fpc_cmd_data_put_request_t *cmd = (fpc_cmd_data_put_request_t *)buffer;
+
+    if (_xferReader(_xferArg, _xferSent, cmd->data, len) != len)
+        return FPC_RESULT_IO_BAD_DATA;
+
+    cmd->cmd = {.cmd_id = CMD_DATA_PUT, .type = FPC_FRAME_TYPE_CMD_REQUEST};
+    cmd->remaining_size = _xferSize - _xferSent - len;
+    cmd->data_size = len;
+
+    fpc_result_t rc = sendCommand(cmd->cmd, sizeof(buffer));
+    if (rc == FPC_RESULT_OK)
+        _xferSent += len;
+
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// Request the next chunk of the template
+//
+fpc_result_t sfDevFPC2534::sendDataGetRequest(void)
+{
+    uint32_t remaining = _xferSize - _xferAcked;
+
+    fpc_cmd_data_get_request_t cmd = {.cmd = {.cmd_id = CMD_DATA_GET, .type = FPC_FRAME_TYPE_CMD_REQUEST},
+                                      .request_size = remaining < _xferChunk ? remaining : _xferChunk};
+
+    return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_data_get_request_t));
 }
 //--------------------------------------------------------------------------------------------
 fpc_result_t sfDevFPC2534::sendReset(void)
@@ -124,6 +426,10 @@ fpc_result_t sfDevFPC2534::sendReset(void)
     /* Reset Command Request has no payload */
     fpc_cmd_hdr_t cmd = {.cmd_id = CMD_RESET, .type = FPC_FRAME_TYPE_CMD_REQUEST};
 
+    // the sensor drops a template transfer
+    if (_xferActive)
+        endTransfer(FPC_RESULT_FAILURE);
+
     return sendCommand(cmd, sizeof(fpc_cmd_hdr_t));
 }
 //--------------------------------------------------------------------------------------------
@@ -135,6 +441,9 @@ fpc_result_t sfDevFPC2534::startNavigationMode(uint8_t orientation)
     fpc_cmd_navigation_request_t cmd = {.cmd = {.cmd_id = CMD_NAVIGATION, .type = FPC_FRAME_TYPE_CMD_REQUEST},
                                         .config = orientation};
 
+    // for the watchdog to restart the mode
+    _navOrientation = orientation;
+
     return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_navigation_request_t));
 }
 //--------------------------------------------------------------------------------------------
@@ -157,48 +466,915 @@ fpc_result_t sfDevFPC2534::requestSetGPIO(uint8_t pin, uint8_t mode, uint8_t sta
                                           .mode = mode,
                                           .state = state};
 
-    return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_pinctrl_gpio_request_t));
+    return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_pinctrl_gpio_request_t));
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::requestGetGPIO(uint8_t pin)
+{
+    fpc_cmd_pinctrl_gpio_request_t cmd = {.cmd = {.cmd_id = CMD_GPIO_CONTROL, .type = FPC_FRAME_TYPE_CMD_REQUEST},
+                                          .sub_cmd = GPIO_CONTROL_SUB_CMD_GET,
+                                          .pin = pin,
+                                          .mode = 0,
+                                          .state = 0};
+
+    return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_pinctrl_gpio_request_t));
+}
+//--------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::setSystemConfig(fpc_system_config_t *cfg)
+{
+    if (cfg == nullptr)
+        return FPC_RESULT_INVALID_PARAM;
+
+    fpc_cmd_set_config_request_t cmd = {.cmd = {.cmd_id = CMD_SET_SYSTEM_CONFIG, .type = FPC_FRAME_TYPE_CMD_REQUEST},
+                                        .cfg = *cfg};
+
+    uint8_t ahead = _rspPending;
+    fpc_result_t rc = sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_set_config_request_t));
+
+    // The sensor configuration once the sensor accepts it - the cached configuration is updated by the response.
+    // Changes made before this write are replaced by it.
+    if (rc == FPC_RESULT_OK)
+    {
+        _cfgWritten = *cfg;
+        _cfgPending = *cfg;
+        _cfgSetPending = true;
+        _cfgSetAhead = ahead;
+    }
+    return rc;
+}
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::requestGetSystemConfig(uint8_t type)
+{
+    if (type > FPC_SYS_CFG_TYPE_CUSTOM)
+        return FPC_RESULT_INVALID_PARAM;
+
+    fpc_cmd_get_config_request_t cmd = {.cmd = {.cmd_id = CMD_GET_SYSTEM_CONFIG, .type = FPC_FRAME_TYPE_CMD_REQUEST},
+                                        .config_type = type};
+    return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_get_config_request_t));
+}
+
+//--------------------------------------------------------------------------------------------
+// Cached system configuration
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::getCachedConfig(fpc_system_config_t &cfg) const
+{
+    if (!_cfgCached)
+        return FPC_RESULT_WRONG_STATE;
+
+    cfg = _cfgPending;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::setFingerScanInterval(uint16_t intervalMs)
+{
+    if (intervalMs > 1020)
+        return FPC_RESULT_INVALID_PARAM;
+
+    fpc_result_t rc = checkConfigCached();
+    if (rc == FPC_RESULT_OK)
+        _cfgPending.finger_scan_interval_ms = intervalMs;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::setIdleTimeBeforeSleep(uint16_t idleMs)
+{
+    fpc_result_t rc = checkConfigCached();
+    if (rc == FPC_RESULT_OK)
+        _cfgPending.idle_time_before_sleep_ms = idleMs;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::setSystemFlags(uint32_t flags)
+{
+    fpc_result_t rc = checkConfigCached();
+    if (rc == FPC_RESULT_OK)
+        _cfgPending.sys_flags = flags;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::setUARTConfig(uint8_t baudRate, uint8_t delayBeforeIRQMs)
+{
+    if (baudRate < CFG_UART_BAUDRATE_9600 || baudRate > CFG_UART_BAUDRATE_921600)
+        return FPC_RESULT_INVALID_PARAM;
+
+    fpc_result_t rc = checkConfigCached();
+    if (rc == FPC_RESULT_OK)
+    {
+        _cfgPending.uart_baudrate = baudRate;
+        _cfgPending.uart_delay_before_irq_ms = delayBeforeIRQMs;
+    }
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::setIdentifyLockout(uint8_t maxConsecutiveFails, uint8_t lockoutTimeSecs)
+{
+    fpc_result_t rc = checkConfigCached();
+    if (rc == FPC_RESULT_OK)
+    {
+        _cfgPending.idfy_max_consecutive_fails = maxConsecutiveFails;
+        _cfgPending.idfy_lockout_time_s = lockoutTimeSecs;
+    }
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::setEnrollTouches(uint8_t touches, uint8_t immobileTouches)
+{
+    if (touches < 12 || touches > 20 || immobileTouches > 6 || immobileTouches > touches)
+        return FPC_RESULT_INVALID_PARAM;
+
+    fpc_result_t rc = checkConfigCached();
+    if (rc == FPC_RESULT_OK)
+    {
+        _cfgPending.enroll_touches = touches;
+        _cfgPending.enroll_immobile_touches = immobileTouches;
+    }
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::commitConfig(bool verify)
+{
+    fpc_result_t rc = checkConfigCached();
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    // Nothing changed - nothing to write (saves a flash write on the sensor)
+    if (!isConfigDirty())
+        return FPC_RESULT_OK;
+
+    fpc_system_config_t cfg = _cfgPending;
+    rc = setSystemConfig(&cfg);
+    if (rc != FPC_RESULT_OK || !verify)
+        return rc;
+
+    // read it back - checked when the response arrives
+    rc = requestGetSystemConfig(FPC_SYS_CFG_TYPE_CUSTOM);
+    if (rc == FPC_RESULT_OK)
+    {
+        _cfgVerifyPending = true;
+        _cfgVerifyResult = FPC_PENDING_OPERATION;
+    }
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// UART baud rate negotiation
+//--------------------------------------------------------------------------------------------
+uint32_t sfDevFPC2534::uartBaudRateToBps(uint8_t baudRate)
+{
+    switch (baudRate)
+    {
+    case CFG_UART_BAUDRATE_9600:
+        return 9600;
+    case CFG_UART_BAUDRATE_19200:
+        return 19200;
+    case CFG_UART_BAUDRATE_57600:
+        return 57600;
+    case CFG_UART_BAUDRATE_115200:
+        return 115200;
+    case CFG_UART_BAUDRATE_921600:
+        return 921600;
+    default:
+        return 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// State of a blocking wait for a response - set by the hook below
+typedef struct
+{
+    uint16_t cmdId;
+    bool received;
+} sfDevFPC2534Wait_t;
+
+static void waitForResponseHook(void *arg, fpc_cmd_hdr_t *cmd, size_t size)
+{
+    (void)size;
+    sfDevFPC2534Wait_t *wait = (sfDevFPC2534Wait_t *)arg;
+    if (cmd->cmd_id == wait->cmdId)
+        wait->received = true;
+}
+
+//--------------------------------------------------------------------------------------------
+// Process responses until a response with the given command ID is received, or the timeout expires
+//
+fpc_result_t sfDevFPC2534::waitForResponse(uint16_t cmdId, uint32_t timeoutMs)
+{
+    sfDevFPC2534Wait_t wait = {cmdId, false};
+    sfDevFPC2534Hook_t hook = {waitForResponseHook, &wait, nullptr};
+    addHook(hook);
+
+    // the wait has its own timeout - hold off the watchdog
+    bool wdBusy = _wdBusy;
+    _wdBusy = true;
+
+    uint32_t start = millis();
+    while (!wait.received && millis() - start < timeoutMs)
+    {
+        // Bad data (e.g. received at the wrong baud rate) is expected here - drop it and keep waiting
+        if (processNextResponse() == FPC_RESULT_IO_BAD_DATA)
+            _comm->clearData();
+
+        if (!wait.received)
+            _comm->waitForData(1);
+    }
+    removeHook(hook);
+    _wdBusy = wdBusy;
+
+    return wait.received ? FPC_RESULT_OK : FPC_RESULT_TIMEOUT;
+}
+
+//--------------------------------------------------------------------------------------------
+// Switch the host UART to the given rate and check the sensor responds to a status request
+//
+bool sfDevFPC2534::probeUARTBaudRate(uint32_t bps)
+{
+    if (!_comm->setBaudRate(bps))
+        return false;
+
+    _comm->clearData();
+
+    // Two tries - the first request can be lost while the sensor wakes up
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        if (requestStatus() == FPC_RESULT_OK && waitForResponse(CMD_STATUS, kFPC2534BaudProbeTimeoutMs) == FPC_RESULT_OK)
+            return true;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------
+// Find the sensor - the current host rate first, then the fastest to slowest. Returns the CFG_UART_BAUDRATE_*
+// value of the rate found, or 0 if the sensor did not respond.
+//
+uint8_t sfDevFPC2534::findUARTBaudRate(void)
+{
+    uint32_t current = _comm->getBaudRate();
+    for (uint8_t rate = CFG_UART_BAUDRATE_921600; rate >= CFG_UART_BAUDRATE_9600; rate--)
+    {
+        if (uartBaudRateToBps(rate) == current && probeUARTBaudRate(current))
+            return rate;
+    }
+    for (uint8_t rate = CFG_UART_BAUDRATE_921600; rate >= CFG_UART_BAUDRATE_9600; rate--)
+    {
+        if (uartBaudRateToBps(rate) != current && probeUARTBaudRate(uartBaudRateToBps(rate)))
+            return rate;
+    }
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------
+// Make sure the system configuration is cached - it's written back with a new baud rate
+//
+fpc_result_t sfDevFPC2534::loadSystemConfig(void)
+{
+    if (_cfgCached)
+        return FPC_RESULT_OK;
+
+    fpc_result_t rc = requestGetSystemConfig(FPC_SYS_CFG_TYPE_CUSTOM);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    rc = waitForResponse(CMD_GET_SYSTEM_CONFIG, kFPC2534BaudProbeTimeoutMs * 5);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    return _cfgCached ? FPC_RESULT_OK : FPC_RESULT_FAILURE;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::negotiateUARTBaudRate(uint8_t baudRate)
+{
+    if (_comm == nullptr)
+        return FPC_RESULT_WRONG_STATE;
+
+    if (uartBaudRateToBps(baudRate) == 0)
+        return FPC_RESULT_INVALID_PARAM;
+
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+    // the I/O task would be reading the bus while the rate changes
+    if (_ioTask != nullptr)
+        return FPC_RESULT_WRONG_STATE;
+#endif
+
+    // Only UART transports can change the rate - and the current rate is needed to restore on failure
+    if (!_comm->setBaudRate(_comm->getBaudRate() != 0 ? _comm->getBaudRate() : uartBaudRateToBps(baudRate)))
+        return FPC_RESULT_NOT_SUPPORTED;
+
+    uint8_t current = findUARTBaudRate();
+    if (current == 0)
+        return FPC_RESULT_TIMEOUT;
+
+    fpc_result_t rc = loadSystemConfig();
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    // Step down from the target rate until a rate works, or the current rate is reached
+    for (uint8_t rate = baudRate; rate > current; rate--)
+    {
+        fpc_system_config_t cfg = _cfgActive;
+        cfg.uart_baudrate = rate;
+        rc = setSystemConfig(&cfg);
+        if (rc != FPC_RESULT_OK)
+            return rc;
+
+        // The response to the set is sent at the old rate - the sensor switches after it
+        waitForResponse(CMD_STATUS, kFPC2534BaudProbeTimeoutMs);
+
+        if (probeUARTBaudRate(uartBaudRateToBps(rate)))
+            return FPC_RESULT_OK;
+
+        // No round trip at the new rate - find the sensor again and restore its configuration to the rate
+        // that works, so it comes up at that rate after the next reset.
+        current = findUARTBaudRate();
+        if (current == 0)
+            return FPC_RESULT_TIMEOUT;
+
+        cfg.uart_baudrate = current;
+        rc = setSystemConfig(&cfg);
+        if (rc != FPC_RESULT_OK)
+            return rc;
+        waitForResponse(CMD_STATUS, kFPC2534BaudProbeTimeoutMs);
+
+        // Make sure the link is still up at the restored rate
+        if (!probeUARTBaudRate(uartBaudRateToBps(current)))
+            return FPC_RESULT_TIMEOUT;
+    }
+
+    // Already at (or above) the target rate, or fell back to the rate the sensor was found at
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Transport retries
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534::isTransientError(fpc_result_t rc)
+{
+    return rc == FPC_RESULT_IO_BUSY || rc == FPC_RESULT_IO_NO_DATA || rc == FPC_RESULT_IO_RUNTIME_FAILURE ||
+           rc == FPC_RESULT_FAILURE;
+}
+
+//--------------------------------------------------------------------------------------------
+// A transport call failed - wait, and return true if it should be retried
+//
+bool sfDevFPC2534::retryBackoff(fpc_result_t rc, uint8_t &attempt)
+{
+    bool transient = _retryPolicy.isTransient != nullptr ? _retryPolicy.isTransient(rc) : isTransientError(rc);
+    if (!transient)
+    {
+        _retryStats.fatal++;
+        return false;
+    }
+    if (attempt >= _retryPolicy.maxRetries)
+    {
+        if (attempt > 0)
+            _retryStats.exhausted++;
+        return false;
+    }
+
+    // exponential backoff - base, 2 x base, 4 x base ... up to the limit
+    uint32_t delayUs = _retryPolicy.baseDelayUs;
+    for (uint8_t i = 0; i < attempt && delayUs < _retryPolicy.maxDelayUs; i++)
+        delayUs <<= 1;
+    if (delayUs > _retryPolicy.maxDelayUs)
+        delayUs = _retryPolicy.maxDelayUs;
+
+    // jitter - xorshift, seeded from the clock
+    uint8_t jitterPercent = _retryPolicy.jitterPercent > 100 ? 100 : _retryPolicy.jitterPercent;
+    uint32_t jitterUs = (uint32_t)((uint64_t)delayUs * jitterPercent / 100);
+    if (jitterUs > 0)
+    {
+        if (_retrySeed == 0)
+            _retrySeed = micros() | 1;
+        _retrySeed ^= _retrySeed << 13;
+        _retrySeed ^= _retrySeed >> 17;
+        _retrySeed ^= _retrySeed << 5;
+        delayUs -= _retrySeed % (jitterUs + 1);
+    }
+
+    if (delayUs >= 1000)
+        delay(delayUs / 1000);
+    delayMicroseconds(delayUs % 1000);
+
+    _retryStats.backoffUs += delayUs;
+    attempt++;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534::retryDone(fpc_result_t rc, uint8_t attempt)
+{
+    if (rc == FPC_RESULT_OK && attempt > 0)
+        _retryStats.recovered++;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::writeWithRetry(const uint8_t *data, size_t len)
+{
+    uint8_t attempt = 0;
+    fpc_result_t rc;
+    while ((rc = _comm->write(data, len)) != FPC_RESULT_OK && retryBackoff(rc, attempt))
+        _retryStats.writeRetries++;
+
+    retryDone(rc, attempt);
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// At the start of a frame, no data is not an error - the frame has not arrived (or is still being transferred in
+// the background). Within a frame, the rest of the frame is needed now.
+//
+fpc_result_t sfDevFPC2534::readWithRetry(uint8_t *data, size_t len, bool frameStart)
+{
+    uint8_t attempt = 0;
+    fpc_result_t rc;
+    while ((rc = _comm->read(data, len)) != FPC_RESULT_OK && !(frameStart && rc == FPC_RESULT_IO_NO_DATA) &&
+           retryBackoff(rc, attempt))
+        _retryStats.readRetries++;
+
+    retryDone(rc, attempt);
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// Liveness watchdog
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534::enableWatchdog(uint32_t responseTimeoutMs, uint32_t heartbeatMs)
+{
+    _wdResponseMs = responseTimeoutMs;
+    _wdHeartbeatMs = heartbeatMs;
+    _wdExpecting = false;
+    _wdSysError = false;
+    _wdRecovered = false;
+    _wdLevel = kWatchdogIdle;
+    _wdLastMode = currentMode() & STATE_NAVIGATION;
+    _wdLastTrafficMs = millis();
+    _wdEnabled = true;
+}
+
+//--------------------------------------------------------------------------------------------
+// A frame was received from the sensor - called for every frame, before it is parsed (or dropped). Commands
+// are not sent from here (parsing can be nested in a wait) - checkWatchdog() acts on what is seen.
+//
+void sfDevFPC2534::noteFrame(uint8_t *payload, size_t size)
+{
+    if (size < sizeof(fpc_cmd_hdr_t))
+        return;
+
+    if (((fpc_cmd_hdr_t *)payload)->type == FPC_FRAME_TYPE_CMD_RESPONSE)
+        noteResponse(payload, size);
+    else if (isBootStatus(payload, size))
+        clearResponsesPending(); // the sensor restarted - requests sent before are not answered
+
+    if (!_wdEnabled)
+        return;
+
+    _wdLastTrafficMs = millis();
+    _wdExpecting = false;
+
+    fpc_cmd_hdr_t *cmd = (fpc_cmd_hdr_t *)payload;
+    bool isStatus = cmd->cmd_id == CMD_STATUS && size == sizeof(fpc_cmd_status_response_t);
+    uint16_t state = isStatus ? ((fpc_cmd_status_response_t *)payload)->state : 0;
+
+    if (isStatus && (state & STATE_SYS_ERROR) != 0)
+    {
+        _wdSysError = true;
+        return;
+    }
+    if (isStatus && _wdLevel == kWatchdogIdle)
+        _wdLastMode = state & (STATE_NAVIGATION | STATE_IDENTIFY);
+
+    // Recovering? A ready status - or any response to the abort - means the sensor is back
+    if (_wdLevel != kWatchdogIdle &&
+        ((isStatus && (state & STATE_APP_FW_READY) != 0) || (!isStatus && _wdLevel == kWatchdogAbort)))
+        _wdRecovered = true;
+}
+
+//--------------------------------------------------------------------------------------------
+// A response was received - it answers the oldest request outstanding. Only the response to a delete request
+// updates the template index - not a response to a request sent before it (a status request of the watchdog,
+// say). Called for NONE events dropped by flushNoneEvent() too - a successful delete is answered by one.
+//
+void sfDevFPC2534::noteResponse(uint8_t *payload, size_t size)
+{
+    _rspReceived++;
+    if (_rspPending > 0)
+        _rspPending--;
+
+    fpc_cmd_status_response_t *status = (fpc_cmd_status_response_t *)payload;
+    bool success = status->cmd.cmd_id == CMD_STATUS && size == sizeof(fpc_cmd_status_response_t) &&
+                   status->app_fail_code == 0;
+
+    if (isAnswerTo(_tplDeletePending, _tplDeleteAhead) && success)
+    {
+        if (_tplDeleteId.type == ID_TYPE_ALL)
+            clearTemplateIndex(_tplIndexValid);
+        else
+            setTemplateBit(_tplDeleteId.id, false);
+    }
+
+    // the configuration written is now the sensor configuration - a read back has the final say
+    if (isAnswerTo(_cfgSetPending, _cfgSetAhead) && success)
+    {
+        _cfgActive = _cfgWritten;
+        _cfgCached = true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// Does this response answer the request waiting for it? Counts down the responses due before it.
+//
+bool sfDevFPC2534::isAnswerTo(bool &pending, uint8_t &ahead)
+{
+    if (!pending)
+        return false;
+
+    if (ahead > 0)
+    {
+        ahead--;
+        return false;
+    }
+    pending = false;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+// No responses are due - the sensor was reset, or the responses were lost
+//
+void sfDevFPC2534::clearResponsesPending(void)
+{
+    _rspPending = 0;
+    _tplDeletePending = false;
+    _tplDeleteAhead = 0;
+    _cfgSetPending = false;
+    _cfgSetAhead = 0;
+}
+
+//--------------------------------------------------------------------------------------------
+// The status event of a sensor that just booted - ready, in no mode
+//
+bool sfDevFPC2534::isBootStatus(uint8_t *payload, size_t size)
+{
+    fpc_cmd_status_response_t *status = (fpc_cmd_status_response_t *)payload;
+
+    return size == sizeof(fpc_cmd_status_response_t) && status->cmd.cmd_id == CMD_STATUS &&
+           status->cmd.type == FPC_FRAME_TYPE_CMD_EVENT && status->event == EVENT_IDLE &&
+           status->state == STATE_APP_FW_READY;
+}
+
+//--------------------------------------------------------------------------------------------
+// Run the watchdog - called from processNextResponse() and waitForEvent()
+//
+void sfDevFPC2534::checkWatchdog(void)
+{
+    if (!_wdEnabled || _wdBusy)
+        return;
+
+    // the commands sent below can nest a response wait
+    _wdBusy = true;
+
+    uint32_t now = millis();
+    if (_wdRecovered)
+        watchdogRecovered();
+    else if (_wdSysError)
+    {
+        _wdSysError = false;
+        _wdStats.sysErrors++;
+        if (_wdLevel == kWatchdogIdle)
+            watchdogFault();
+        else if (_wdLevel == kWatchdogAbort)
+            watchdogEscalate(); // an abort does not clear a system error - reset now
+    }
+    else if (_wdLevel != kWatchdogIdle)
+    {
+        // A reset needs time to boot
+        uint32_t timeoutMs = _wdLevel == kWatchdogAbort || _wdResponseMs > kFPC2534WatchdogBootTimeoutMs
+                                 ? _wdResponseMs
+                                 : kFPC2534WatchdogBootTimeoutMs;
+        if (now - _wdLevelSince >= timeoutMs)
+            watchdogEscalate();
+    }
+    else if (_wdExpecting && now - _wdExpectSince >= _wdResponseMs)
+    {
+        _wdStats.timeouts++;
+
+        // the responses outstanding are lost
+        clearResponsesPending();
+        watchdogFault();
+    }
+    else if (_wdHeartbeatMs > 0 && !_wdExpecting && now - _wdLastTrafficMs >= _wdHeartbeatMs)
+    {
+        // Continuous identify, but the sensor was idle at the last status - and nothing since: the result was
+        // lost (a corrupted frame). Re-arm, instead of the heartbeat.
+        if (_contIdActive && (_wdLastMode & STATE_IDENTIFY) == 0)
+        {
+            _wdStats.rearms++;
+            _wdLastMode |= STATE_IDENTIFY;
+            armContinuousIdentify();
+        }
+        else
+            requestStatus();
+    }
+
+    _wdBusy = false;
+}
+
+//--------------------------------------------------------------------------------------------
+// A fault was detected - note what to restore, and start the escalation
+//
+void sfDevFPC2534::watchdogFault(void)
+{
+    _wdFaultSince = millis();
+    _wdRestoreMode = _wdLastMode;
+    _wdRestoreContId = _contIdActive;
+    _contIdActive = false;
+
+    // a template transfer does not survive the recovery
+    if (_xferActive)
+        endTransfer(FPC_RESULT_TIMEOUT);
+
+    if (_callbacks.on_error)
+        _callbacks.on_error(FPC_RESULT_TIMEOUT);
+
+    watchdogEscalate();
+}
+
+//--------------------------------------------------------------------------------------------
+// Take the next recovery step - abort, reset, then reinitialize the bus (repeated until the sensor responds)
+//
+void sfDevFPC2534::watchdogEscalate(void)
+{
+    if (_wdLevel == kWatchdogIdle)
+    {
+        _wdLevel = kWatchdogAbort;
+        _wdStats.aborts++;
+
+        // not requestAbort() - the response is the recovery signal, it must not be flushed
+        fpc_cmd_hdr_t cmd = {.cmd_id = CMD_ABORT, .type = FPC_FRAME_TYPE_CMD_REQUEST};
+        sendCommand(cmd, sizeof(fpc_cmd_hdr_t));
+    }
+    else
+    {
+        if (_wdLevel == kWatchdogAbort)
+        {
+            _wdLevel = kWatchdogReset;
+            _wdStats.resets++;
+        }
+        else
+        {
+            _wdLevel = kWatchdogReinit;
+            _wdStats.reinits++;
+
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+            if (_ioTask != nullptr)
+                _ioTask->lockBus();
+#endif
+            _comm->reinitialize();
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+            if (_ioTask != nullptr)
+                _ioTask->unlockBus();
+#endif
+        }
+
+        // ready comes from the boot status
+        _current_state = 0;
+        sendReset();
+    }
+    _wdLevelSince = millis();
+}
+
+//--------------------------------------------------------------------------------------------
+// The sensor is back - restart the mode it was in
+//
+void sfDevFPC2534::watchdogRecovered(void)
+{
+    _wdRecovered = false;
+    _wdLevel = kWatchdogIdle;
+    _wdExpecting = false;
+
+    uint32_t downtimeMs = millis() - _wdFaultSince;
+    _wdStats.recoveries++;
+    _wdStats.lastDowntimeMs = downtimeMs;
+    if (downtimeMs > _wdStats.maxDowntimeMs)
+        _wdStats.maxDowntimeMs = downtimeMs;
+
+    if (_wdRestoreContId)
+        _contIdActive = armContinuousIdentify() == FPC_RESULT_OK;
+    else if ((_wdRestoreMode & STATE_NAVIGATION) != 0)
+        startNavigationMode(_navOrientation);
+}
+
+//--------------------------------------------------------------------------------------------
+// Boot handshake
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::waitForBoot(uint32_t timeoutMs, bool loadInfo)
+{
+    if (_comm == nullptr)
+        return FPC_RESULT_WRONG_STATE;
+
+    // The ready state must come from the sensor - not from before a reset
+    _current_state = 0;
+
+    uint32_t start = millis();
+    uint32_t lastRequest = 0;
+    bool requested = false;
+    while (!isReady())
+    {
+        uint32_t elapsed = millis() - start;
+        if (elapsed >= timeoutMs)
+            return FPC_RESULT_TIMEOUT;
+
+        // No boot status (the sensor was already running, or the flag is off) - ask. Requests sent while the
+        // sensor boots are lost, so keep asking.
+        if (!requested || millis() - lastRequest >= kFPC2534BootPollMs)
+        {
+            requestStatus();
+            lastRequest = millis();
+            requested = true;
+        }
+
+        uint32_t remaining = timeoutMs - elapsed;
+        if (waitForEvent(remaining < kFPC2534BootPollMs ? remaining : kFPC2534BootPollMs) == FPC_RESULT_IO_BAD_DATA)
+            clearData(); // a partial frame from the boot
+    }
+    _bootTimeMs = millis() - start;
+
+    // Requests sent before (or while) the sensor booted are not answered
+    clearResponsesPending();
+
+    if (!loadInfo)
+        return FPC_RESULT_OK;
+
+    uint32_t elapsed = millis() - start;
+    return loadBootInfo(elapsed < timeoutMs ? timeoutMs - elapsed : 0);
+}
+
+//--------------------------------------------------------------------------------------------
+// Load the version and configuration - both requests are sent before waiting on the responses - then enable the
+// boot status.
+//
+fpc_result_t sfDevFPC2534::loadBootInfo(uint32_t timeoutMs)
+{
+    fpc_result_t rc = requestVersion();
+    if (rc == FPC_RESULT_OK && !_cfgCached)
+        rc = requestGetSystemConfig(FPC_SYS_CFG_TYPE_CUSTOM);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    uint32_t start = millis();
+    rc = waitForResponse(CMD_VERSION, timeoutMs);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    // the configuration response is processed by now, or follows the version
+    uint32_t elapsed = millis() - start;
+    if (!_cfgCached)
+        waitForResponse(CMD_GET_SYSTEM_CONFIG, elapsed < timeoutMs ? timeoutMs - elapsed : 0);
+    if (!_cfgCached)
+        return FPC_RESULT_TIMEOUT;
+
+    if ((_cfgActive.sys_flags & CFG_SYS_FLAG_STATUS_EVT_AT_BOOT) != 0)
+        return FPC_RESULT_OK;
+
+    fpc_system_config_t cfg = _cfgActive;
+    cfg.sys_flags |= CFG_SYS_FLAG_STATUS_EVT_AT_BOOT;
+    rc = setSystemConfig(&cfg);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    elapsed = millis() - start;
+    return waitForResponse(CMD_STATUS, elapsed < timeoutMs ? timeoutMs - elapsed : 0);
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::factoryReset(void)
+{
+    /* Factory Reset Command Request has no payload */
+    fpc_cmd_hdr_t cmd = {.cmd_id = CMD_FACTORY_RESET, .type = FPC_FRAME_TYPE_CMD_REQUEST};
+
+    // all templates are gone - but only a list response makes the index valid again
+    clearTemplateIndex(false);
+
+    // the configuration is back to the defaults - reload it before changing it
+    _cfgCached = false;
+    _cfgVerifyPending = false;
+    return sendCommand(cmd, sizeof(fpc_cmd_hdr_t));
+}
+
+//--------------------------------------------------------------------------------------------
+// Saved state
+//--------------------------------------------------------------------------------------------
+// FNV-1a over the state, up to the checksum
+uint32_t sfDevFPC2534::stateChecksum(const sfDevFPC2534State_t &state)
+{
+    const uint8_t *data = (const uint8_t *)&state;
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < offsetof(sfDevFPC2534State_t, checksum); i++)
+        hash = (hash ^ data[i]) * 16777619UL;
+    return hash;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534::saveState(sfDevFPC2534State_t &state) const
+{
+    // zero the padding too - it is part of the checksum
+    memset(&state, 0, sizeof(sfDevFPC2534State_t));
+
+    state.magic = kFPC2534StateMagic;
+    state.currentState = _current_state;
+    state.fingerPresent = _finger_present;
+    state.cfgCached = _cfgCached;
+    state.cfg = _cfgActive;
+    state.tplIndexValid = _tplIndexValid;
+    state.tplCount = _tplCount;
+    memcpy(state.tplBitmap, _tplBitmap, sizeof(state.tplBitmap));
+    state.checksum = stateChecksum(state);
 }
 
 //--------------------------------------------------------------------------------------------
-fpc_result_t sfDevFPC2534::requestGetGPIO(uint8_t pin)
+bool sfDevFPC2534::restoreState(const sfDevFPC2534State_t &state)
 {
-    fpc_cmd_pinctrl_gpio_request_t cmd = {.cmd = {.cmd_id = CMD_GPIO_CONTROL, .type = FPC_FRAME_TYPE_CMD_REQUEST},
-                                          .sub_cmd = GPIO_CONTROL_SUB_CMD_GET,
-                                          .pin = pin,
-                                          .mode = 0,
-                                          .state = 0};
+    if (state.magic != kFPC2534StateMagic || state.checksum != stateChecksum(state))
+        return false;
 
-    return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_pinctrl_gpio_request_t));
+    _current_state = state.currentState;
+    _finger_present = state.fingerPresent;
+    _cfgCached = state.cfgCached;
+    _cfgActive = state.cfg;
+    _cfgPending = state.cfg;
+    _cfgVerifyPending = false;
+    _tplIndexValid = state.tplIndexValid;
+    _tplCount = state.tplCount;
+    memcpy(_tplBitmap, state.tplBitmap, sizeof(_tplBitmap));
+
+    _restoredAtUs = micros();
+    _wakeTimingPending = true;
+    _wakeToResultUs = 0;
+    return true;
 }
-//--------------------------------------------------------------------------------
-fpc_result_t sfDevFPC2534::setSystemConfig(fpc_system_config_t *cfg)
-{
-    if (cfg == nullptr)
-        return FPC_RESULT_INVALID_PARAM;
 
-    fpc_cmd_set_config_request_t cmd = {.cmd = {.cmd_id = CMD_SET_SYSTEM_CONFIG, .type = FPC_FRAME_TYPE_CMD_REQUEST},
-                                        .cfg = *cfg};
+//--------------------------------------------------------------------------------------------
+// Template ID index
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534::setTemplateBit(uint16_t id, bool present)
+{
+    if (id > SFE_FPC2534_MAX_TEMPLATE_ID)
+        return;
 
-    return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_set_config_request_t));
+    uint32_t mask = 1UL << (id & 31);
+    uint32_t &word = _tplBitmap[id >> 5];
+    if (present && (word & mask) == 0)
+    {
+        word |= mask;
+        _tplCount++;
+    }
+    else if (!present && (word & mask) != 0)
+    {
+        word &= ~mask;
+        _tplCount--;
+    }
 }
+
 //--------------------------------------------------------------------------------------------
-fpc_result_t sfDevFPC2534::requestGetSystemConfig(uint8_t type)
+void sfDevFPC2534::clearTemplateIndex(bool valid)
 {
-    if (type > FPC_SYS_CFG_TYPE_CUSTOM)
-        return FPC_RESULT_INVALID_PARAM;
-
-    fpc_cmd_get_config_request_t cmd = {.cmd = {.cmd_id = CMD_GET_SYSTEM_CONFIG, .type = FPC_FRAME_TYPE_CMD_REQUEST},
-                                        .config_type = type};
-    return sendCommand((fpc_cmd_hdr_t &)cmd, sizeof(fpc_cmd_get_config_request_t));
+    memset(_tplBitmap, 0, sizeof(_tplBitmap));
+    _tplCount = 0;
+    _tplIndexValid = valid;
+    _tplDeletePending = false;
 }
 
 //--------------------------------------------------------------------------------------------
-fpc_result_t sfDevFPC2534::factoryReset(void)
+uint16_t sfDevFPC2534::nextFreeTemplateId(uint16_t start) const
 {
-    /* Factory Reset Command Request has no payload */
-    fpc_cmd_hdr_t cmd = {.cmd_id = CMD_FACTORY_RESET, .type = FPC_FRAME_TYPE_CMD_REQUEST};
-    return sendCommand(cmd, sizeof(fpc_cmd_hdr_t));
+    if (!_tplIndexValid || start > SFE_FPC2534_MAX_TEMPLATE_ID)
+        return 0;
+
+    // ID 0 is not a valid template ID
+    if (start == 0)
+        start = 1;
+
+    // scan a word at a time, starting with the word that contains start
+    uint16_t word = start >> 5;
+    uint32_t used = _tplBitmap[word] | ((1UL << (start & 31)) - 1);
+    while (true)
+    {
+        if (used != 0xFFFFFFFFUL)
+        {
+            uint16_t id = (uint16_t)(word * 32 + __builtin_ctzl(~used));
+            return id <= SFE_FPC2534_MAX_TEMPLATE_ID ? id : 0;
+        }
+        if (++word >= kTemplateBitmapWords)
+            return 0;
+        used = _tplBitmap[word];
+    }
 }
 
 //--------------------------------------------------------------------------------------------
@@ -236,6 +1412,13 @@ fpc_result_t sfDevFPC2534::parseStatusCommand(fpc_cmd_hdr_t *cmd_hdr, size_t siz
     // if we have an error code, just call the error callback and exit
     if (status->app_fail_code != 0)
     {
+        // Don't re-arm into the same error
+        _contIdActive = false;
+
+        // a template transfer is refused
+        if (_xferActive)
+            endTransfer((fpc_result_t)status->app_fail_code);
+
         if (_callbacks.on_error)
             _callbacks.on_error(status->app_fail_code);
         return FPC_RESULT_OK;
@@ -304,6 +1487,10 @@ fpc_result_t sfDevFPC2534::parseEnrollStatusCommand(fpc_cmd_hdr_t *cmd_hdr, size
 
     fpc_cmd_enroll_status_response_t *status = (fpc_cmd_enroll_status_response_t *)cmd_hdr;
 
+    // enrollment done - the template is now on the sensor
+    if (status->samples_remaining == 0)
+        setTemplateBit(status->id, true);
+
     if (_callbacks.on_enroll)
         _callbacks.on_enroll(status->feedback, status->samples_remaining);
 
@@ -318,6 +1505,38 @@ fpc_result_t sfDevFPC2534::parseIdentifyCommand(fpc_cmd_hdr_t *cmd_hdr, size_t s
 
     fpc_cmd_identify_status_response_t *id_res = (fpc_cmd_identify_status_response_t *)cmd_hdr;
 
+    // In continuous mode, re-arm right away - before the application sees the result
+    if (_contIdActive)
+    {
+        uint32_t resultAt = micros();
+
+        // result of an earlier identify request? Drop it
+        if (id_res->tag != _contIdTag)
+        {
+            _contIdTiming.staleDropped++;
+            return FPC_RESULT_OK;
+        }
+        _contIdTiming.lastArmToResultUs = resultAt - _contIdArmedAt;
+
+        fpc_result_t rc = armContinuousIdentify();
+        if (rc != FPC_RESULT_OK)
+            _contIdActive = false;
+
+        uint32_t rearmUs = micros() - resultAt;
+        _contIdTiming.cycles++;
+        _contIdTiming.lastRearmUs = rearmUs;
+        _contIdTiming.totalRearmUs += rearmUs;
+        if (rearmUs > _contIdTiming.maxRearmUs)
+            _contIdTiming.maxRearmUs = rearmUs;
+    }
+
+    // first result after a restore from deep sleep?
+    if (_wakeTimingPending)
+    {
+        _wakeTimingPending = false;
+        _wakeToResultUs = micros() - _restoredAtUs;
+    }
+
     if (_callbacks.on_identify)
         _callbacks.on_identify(id_res->match == IDENTIFY_RESULT_MATCH, id_res->tpl_id.id);
 
@@ -332,6 +1551,11 @@ fpc_result_t sfDevFPC2534::parseListTemplatesCommand(fpc_cmd_hdr_t *cmd_hdr, siz
     if (size != sizeof(fpc_cmd_template_info_response_t) + (sizeof(uint16_t) * list->number_of_templates))
         return FPC_RESULT_INVALID_PARAM;
 
+    // rebuild the template index
+    clearTemplateIndex(true);
+    for (uint16_t i = 0; i < list->number_of_templates; i++)
+        setTemplateBit(list->template_id_list[i], true);
+
     if (_callbacks.on_list_templates)
         _callbacks.on_list_templates(list->number_of_templates, list->template_id_list);
 
@@ -374,6 +1598,30 @@ fpc_result_t sfDevFPC2534::parseGetSystemConfigCommand(fpc_cmd_hdr_t *cmd_hdr, s
 
     fpc_cmd_get_config_response_t *cmd_cfg = (fpc_cmd_get_config_response_t *)cmd_hdr;
 
+    // Cache the active configuration - keep any uncommitted changes
+    if (cmd_cfg->config_type == FPC_SYS_CFG_TYPE_CUSTOM)
+    {
+        bool dirty = isConfigDirty();
+        _cfgActive = cmd_cfg->cfg;
+        if (!dirty)
+            _cfgPending = cmd_cfg->cfg;
+        _cfgCached = true;
+
+        // read back of a verified commit? The sensor may have rejected or adjusted the configuration written
+        if (_cfgVerifyPending)
+        {
+            _cfgVerifyPending = false;
+            if (memcmp(&_cfgActive, &_cfgWritten, sizeof(fpc_system_config_t)) == 0)
+                _cfgVerifyResult = FPC_RESULT_OK;
+            else
+            {
+                _cfgVerifyResult = FPC_RESULT_FAILURE;
+                if (_callbacks.on_error)
+                    _callbacks.on_error(FPC_RESULT_FAILURE);
+            }
+        }
+    }
+
     if (_callbacks.on_system_config_get)
         _callbacks.on_system_config_get(&cmd_cfg->cfg);
 
@@ -394,147 +1642,176 @@ fpc_result_t sfDevFPC2534::parseBISTCommand(fpc_cmd_hdr_t *cmd_hdr, size_t size)
     return FPC_RESULT_OK;
 }
 
-// --------------------------------------------------------------------------------------------
-// TOOD: Implement data transfer commands. These allow data to be recorded from one device and then
-//       sent to another device for enrollment or identification.
+//--------------------------------------------------------------------------------------------
+// Response to CMD_PUT_TEMPLATE_DATA - the sensor is ready for the data, in chunks up to its max chunk size
+//
+fpc_result_t sfDevFPC2534::parsePutTemplateDataCommand(fpc_cmd_hdr_t *cmd_hdr, size_t size)
+{
+    if (size < sizeof(fpc_cmd_template_data_response_t))
+        return FPC_RESULT_INVALID_PARAM;
+
+    fpc_cmd_template_data_response_t *cmd_rsp = (fpc_cmd_template_data_response_t *)cmd_hdr;
+
+    if (!_xferActive || _xferGet || _xferSent != 0 || cmd_rsp->id != _xferId || cmd_rsp->max_chunk_size == 0)
+        return FPC_RESULT_WRONG_STATE;
+
+    _xferChunk = cmd_rsp->max_chunk_size < SFE_FPC2534_XFER_CHUNK_SIZE ? cmd_rsp->max_chunk_size
+                                                                       : SFE_FPC2534_XFER_CHUNK_SIZE;
+    fpc_result_t rc = sendDataPutChunk();
+    if (rc != FPC_RESULT_OK)
+        failTransfer(rc);
+
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Response to CMD_DATA_PUT - the sensor confirms the data received so far. Send the next chunk, or done.
+//
+fpc_result_t sfDevFPC2534::parseDataPutCommand(fpc_cmd_hdr_t *cmd_hdr, size_t size)
+{
+    if (size < sizeof(fpc_cmd_data_put_response_t))
+        return FPC_RESULT_INVALID_PARAM;
+
+    fpc_cmd_data_put_response_t *cmd_rsp = (fpc_cmd_data_put_response_t *)cmd_hdr;
+
+    if (!_xferActive || _xferGet)
+        return FPC_RESULT_WRONG_STATE;
+
+    // The sensor lost data - the transfer can't continue
+    fpc_result_t rc = FPC_RESULT_OK;
+    if (cmd_rsp->total_received != _xferSent)
+        rc = FPC_RESULT_IO_BAD_DATA;
+    else
+    {
+        _xferAcked = cmd_rsp->total_received;
+        if (_xferSent == _xferSize)
+        {
+            endTransfer(FPC_RESULT_OK);
+            setTemplateBit(_xferId, true);
+
+            if (_callbacks.on_data_transfer_done)
+                _callbacks.on_data_transfer_done(nullptr, 0);
+            return FPC_RESULT_OK;
+        }
+        rc = sendDataPutChunk();
+    }
+
+    if (rc != FPC_RESULT_OK)
+        failTransfer(rc);
+
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Response to CMD_GET_TEMPLATE_DATA - the size of the template, and the max chunk size of the sensor
+//
+fpc_result_t sfDevFPC2534::parseGetTemplateDataCommand(fpc_cmd_hdr_t *cmd_hdr, size_t size)
+{
+    if (size < sizeof(fpc_cmd_template_data_response_t))
+        return FPC_RESULT_INVALID_PARAM;
+
+    fpc_cmd_template_data_response_t *cmd_rsp = (fpc_cmd_template_data_response_t *)cmd_hdr;
+
+    if (!_xferActive || !_xferGet || _xferImage || _xferSize != 0 || cmd_rsp->id != _xferId ||
+        cmd_rsp->max_chunk_size == 0)
+        return FPC_RESULT_WRONG_STATE;
+
+    fpc_result_t rc = FPC_RESULT_OK;
+    if (cmd_rsp->total_size == 0)
+        rc = FPC_RESULT_IO_BAD_DATA;
+    else if (cmd_rsp->total_size > _xferLimit)
+        rc = FPC_RESULT_OUT_OF_MEMORY;
+    else
+    {
+        _xferSize = cmd_rsp->total_size;
+        _xferChunk = cmd_rsp->max_chunk_size < SFE_FPC2534_XFER_CHUNK_SIZE ? cmd_rsp->max_chunk_size
+                                                                           : SFE_FPC2534_XFER_CHUNK_SIZE;
+        rc = sendDataGetRequest();
+    }
+
+    if (rc != FPC_RESULT_OK)
+        failTransfer(rc);
+
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Response to CMD_IMAGE_DATA - the size and dimensions of the image, and the max chunk size of the sensor. The
+// image is then read the same way as a template.
+//
+fpc_result_t sfDevFPC2534::parseImageDataCommand(fpc_cmd_hdr_t *cmd_hdr, size_t size)
+{
+    if (size < sizeof(fpc_cmd_image_response_t))
+        return FPC_RESULT_INVALID_PARAM;
+
+    fpc_cmd_image_response_t *cmd_rsp = (fpc_cmd_image_response_t *)cmd_hdr;
+
+    if (!_xferActive || !_xferImage || _xferSize != 0 || cmd_rsp->type != _xferId || cmd_rsp->max_chunk_size == 0)
+        return FPC_RESULT_WRONG_STATE;
+
+    fpc_result_t rc = FPC_RESULT_OK;
+    if (cmd_rsp->image_size == 0)
+        rc = FPC_RESULT_NO_IMAGE;
+    else if (cmd_rsp->image_size > _xferLimit)
+        rc = FPC_RESULT_OUT_OF_MEMORY;
+    else
+    {
+        _xferSize = cmd_rsp->image_size;
+        _xferChunk = cmd_rsp->max_chunk_size < SFE_FPC2534_XFER_CHUNK_SIZE ? cmd_rsp->max_chunk_size
+                                                                           : SFE_FPC2534_XFER_CHUNK_SIZE;
+        _imageWidth = cmd_rsp->image_width;
+        _imageHeight = cmd_rsp->image_height;
+        rc = sendDataGetRequest();
+    }
+
+    if (rc != FPC_RESULT_OK)
+        failTransfer(rc);
+
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Response to CMD_DATA_GET - a chunk of the template (or image). Request the next chunk, or done.
 //
-// static fpc_result_t parse_cmd_get_template_data(fpc_cmd_hdr_t *cmd, uint16_t size)
-// {
-//     fpc_result_t result = FPC_RESULT_OK;
-//     fpc_cmd_template_data_response_t *data = (fpc_cmd_template_data_response_t *)cmd;
-
-//     if (size < sizeof(fpc_cmd_template_data_response_t))
-//     {
-//         fpc_sample_logf("CMD_GET_TEMPLATE_DATA invalid size (%d vs %d)", size,
-//                         sizeof(fpc_cmd_template_data_response_t));
-//         result = FPC_RESULT_INVALID_PARAM;
-//     }
-
-//     if (result == FPC_RESULT_OK)
-//     {
-//         fpc_sample_logf("Setup Template Data Transfer. Max chunk size = %d", data->max_chunk_size);
-//         // Start transfer loop
-//         result = fpc_cmd_data_get_setup(data->total_size, data->max_chunk_size);
-//     }
-
-//     if (result == FPC_RESULT_OK)
-//     {
-//         result = fpc_cmd_data_get_request();
-//     }
-
-//     return FPC_RESULT_OK;
-// }
-
-// static fpc_result_t parse_cmd_put_template_data(fpc_cmd_hdr_t *cmd, uint16_t size)
-// {
-//     fpc_result_t result = FPC_RESULT_OK;
-//     fpc_cmd_template_data_response_t *data = (fpc_cmd_template_data_response_t *)cmd;
-
-//     if (size < sizeof(fpc_cmd_template_data_response_t))
-//     {
-//         fpc_sample_logf("CMD_PUT_TEMPLATE_DATA invalid size (%d vs %d)", size,
-//                         sizeof(fpc_cmd_template_data_response_t));
-//         result = FPC_RESULT_INVALID_PARAM;
-//     }
-
-//     if (result == FPC_RESULT_OK)
-//     {
-//         // Start transfer loop
-//         result = fpc_cmd_data_put_request(data->max_chunk_size);
-//     }
-
-//     return result;
-// }
-
-// static fpc_result_t parse_cmd_data_get(fpc_cmd_hdr_t *cmd, uint16_t size)
-// {
-//     fpc_result_t result = FPC_RESULT_OK;
-//     fpc_cmd_data_get_response_t *cmd_rsp = (fpc_cmd_data_get_response_t *)cmd;
-
-//     if (transfer_session.data_buf == NULL)
-//     {
-//         fpc_sample_logf("CMD_DATA_GET no data buffer allocated");
-//         result = FPC_RESULT_INVALID_PARAM;
-//     }
-
-//     if (result == FPC_RESULT_OK)
-//     {
-//         if (size < sizeof(fpc_cmd_data_get_response_t))
-//         {
-//             fpc_sample_logf("CMD_DATA_GET invalid size (%d vs %d)", size, sizeof(fpc_cmd_data_get_response_t));
-//             result = FPC_RESULT_INVALID_PARAM;
-//         }
-//     }
-
-//     if (result == FPC_RESULT_OK)
-//     {
-//         if (size != (sizeof(fpc_cmd_data_get_response_t) + cmd_rsp->data_size))
-//         {
-//             fpc_sample_logf("CMD_DATA_GET invalid size, incl data (%d vs %d)", size,
-//                             sizeof(fpc_cmd_data_get_response_t) + cmd_rsp->data_size);
-//             result = FPC_RESULT_INVALID_PARAM;
-//         }
-//     }
-
-//     if (result == FPC_RESULT_OK)
-//     {
-//         fpc_sample_logf("Data: Got %d, remaining %d", cmd_rsp->data_size, cmd_rsp->remaining_size);
-
-//         memcpy(transfer_session.data_buf + transfer_session.transferred_size, cmd_rsp->data, cmd_rsp->data_size);
-
-//         transfer_session.transferred_size += cmd_rsp->data_size;
-//         transfer_session.remaining_size = cmd_rsp->remaining_size;
-
-//         if (cmd_rsp->remaining_size > 0)
-//         {
-//             fpc_cmd_data_get_request();
-//         }
-//         else
-//         {
-//             fpc_sample_logf("CMD_DATA_GET done");
-//             if (_callbacks.on_data_transfer_done)
-//             {
-//                 _callbacks.on_data_transfer_done(transfer_session.data_buf, transfer_session.total_size);
-//             }
-//             free(transfer_session.data_buf);
-//             transfer_session.data_buf = NULL;
-//         }
-//     }
-
-//     return result;
-// }
-
-// static fpc_result_t parse_cmd_data_put(fpc_cmd_hdr_t *cmd, uint16_t size)
-// {
-//     fpc_result_t result = FPC_RESULT_OK;
-//     fpc_cmd_data_put_response_t *cmd_rsp = (fpc_cmd_data_put_response_t *)cmd;
-
-//     if (size < sizeof(fpc_cmd_data_put_response_t))
-//     {
-//         fpc_sample_logf("CMD_DATA_PUT invalid size (%d vs %d)", size, sizeof(fpc_cmd_data_put_response_t));
-//         result = FPC_RESULT_INVALID_PARAM;
-//     }
-
-//     if (result == FPC_RESULT_OK)
-//     {
-//         fpc_sample_logf("DATA Put Response (total put = %d)", cmd_rsp->total_received);
-
-//         if (transfer_session.remaining_size == 0)
-//         {
-//             fpc_sample_logf("CMD_DATA_PUT done");
-//             if (_callbacks.on_data_transfer_done)
-//             {
-//                 _callbacks.on_data_transfer_done(NULL, 0);
-//             }
-//         }
-//         else
-//         {
-//             result = fpc_cmd_data_put_request(transfer_session.max_chunk_size);
-//         }
-//     }
-
-//     return result;
-// }
+fpc_result_t sfDevFPC2534::parseDataGetCommand(fpc_cmd_hdr_t *cmd_hdr, size_t size)
+{
+    if (size < sizeof(fpc_cmd_data_get_response_t))
+        return FPC_RESULT_INVALID_PARAM;
+
+    fpc_cmd_data_get_response_t *cmd_rsp = (fpc_cmd_data_get_response_t *)cmd_hdr;
+
+    if (size != sizeof(fpc_cmd_data_get_response_t) + cmd_rsp->data_size)
+        return FPC_RESULT_INVALID_PARAM;
+
+    if (!_xferActive || !_xferGet || _xferSize == 0)
+        return FPC_RESULT_WRONG_STATE;
+
+    // The chunk must be the next part of the template
+    fpc_result_t rc = FPC_RESULT_OK;
+    if (cmd_rsp->data_size == 0 || cmd_rsp->data_size > _xferChunk || cmd_rsp->data_size > _xferSize - _xferAcked ||
+        cmd_rsp->remaining_size != _xferSize - _xferAcked - cmd_rsp->data_size)
+        rc = FPC_RESULT_IO_BAD_DATA;
+    else if (_xferWriter(_xferArg, _xferAcked, cmd_rsp->data, cmd_rsp->data_size) != cmd_rsp->data_size)
+        rc = FPC_RESULT_FAILURE;
+    else
+    {
+        _xferAcked += cmd_rsp->data_size;
+        if (_xferAcked == _xferSize)
+        {
+            endTransfer(FPC_RESULT_OK);
+
+            if (_callbacks.on_data_transfer_done)
+                _callbacks.on_data_transfer_done(_xferBuffer, _xferSize);
+            return FPC_RESULT_OK;
+        }
+        rc = sendDataGetRequest();
+    }
+
+    if (rc != FPC_RESULT_OK)
+        failTransfer(rc);
+
+    return FPC_RESULT_OK;
+}
 
 //--------------------------------------------------------------------------------------------
 // Main command parser - routes to specific command parsers
@@ -553,54 +1830,97 @@ fpc_result_t sfDevFPC2534::parseCommand(uint8_t *payload, size_t size)
     if (cmdHeader->type != FPC_FRAME_TYPE_CMD_EVENT && cmdHeader->type != FPC_FRAME_TYPE_CMD_RESPONSE)
         return FPC_RESULT_INVALID_PARAM;
 
+    fpc_result_t rc;
     switch (cmdHeader->cmd_id)
     {
     case CMD_STATUS:
-        return parseStatusCommand(cmdHeader, size);
+        rc = parseStatusCommand(cmdHeader, size);
         break;
     case CMD_VERSION:
-        return parseVersionCommand(cmdHeader, size);
+        rc = parseVersionCommand(cmdHeader, size);
         break;
     case CMD_ENROLL:
-        return parseEnrollStatusCommand(cmdHeader, size);
+        rc = parseEnrollStatusCommand(cmdHeader, size);
         break;
     case CMD_IDENTIFY:
-        return parseIdentifyCommand(cmdHeader, size);
+        rc = parseIdentifyCommand(cmdHeader, size);
         break;
     case CMD_LIST_TEMPLATES:
-        return parseListTemplatesCommand(cmdHeader, size);
+        rc = parseListTemplatesCommand(cmdHeader, size);
         break;
     case CMD_NAVIGATION:
-        return parseNavigationEventCommand(cmdHeader, size);
+        rc = parseNavigationEventCommand(cmdHeader, size);
         break;
     case CMD_GPIO_CONTROL:
-        return parseGPIOControlCommand(cmdHeader, size);
+        rc = parseGPIOControlCommand(cmdHeader, size);
         break;
     case CMD_GET_SYSTEM_CONFIG:
-        return parseGetSystemConfigCommand(cmdHeader, size);
+        rc = parseGetSystemConfigCommand(cmdHeader, size);
         break;
     case CMD_BIST:
-        return parseBISTCommand(cmdHeader, size);
+        rc = parseBISTCommand(cmdHeader, size);
+        break;
+    case CMD_PUT_TEMPLATE_DATA:
+        rc = parsePutTemplateDataCommand(cmdHeader, size);
+        break;
+    case CMD_DATA_PUT:
+        rc = parseDataPutCommand(cmdHeader, size);
+        break;
+    case CMD_GET_TEMPLATE_DATA:
+        rc = parseGetTemplateDataCommand(cmdHeader, size);
+        break;
+    case CMD_DATA_GET:
+        rc = parseDataGetCommand(cmdHeader, size);
+        break;
+    case CMD_IMAGE_DATA:
+        rc = parseImageDataCommand(cmdHeader, size);
         break;
-    // case CMD_GET_TEMPLATE_DATA:
-    //     return parse_cmd_get_template_data(cmdHeader, size);
-    //     break;
-    // case CMD_PUT_TEMPLATE_DATA:
-    //     return parse_cmd_put_template_data(cmdHeader, size);
-    //     break;
-    // case CMD_DATA_GET:
-    //     return parse_cmd_data_get(cmdHeader, size);
-    //     break;
-    // case CMD_DATA_PUT:
-    //     return parse_cmd_data_put(cmdHeader, size);
-    //     break;
     default:
-        return FPC_RESULT_INVALID_PARAM;
+        rc = FPC_RESULT_INVALID_PARAM;
         break;
     }
 
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    // let any hooks know - a hook can remove itself in the handler
+    sfDevFPC2534Hook_t *hook = _hooks;
+    while (hook != nullptr)
+    {
+        sfDevFPC2534Hook_t *next = hook->next;
+        hook->handler(hook->arg, cmdHeader, size);
+        hook = next;
+    }
+
     return FPC_RESULT_OK;
 }
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534::addHook(sfDevFPC2534Hook_t &hook)
+{
+    // already in the list?
+    for (sfDevFPC2534Hook_t *h = _hooks; h != nullptr; h = h->next)
+        if (h == &hook)
+            return;
+
+    hook.next = _hooks;
+    _hooks = &hook;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534::removeHook(sfDevFPC2534Hook_t &hook)
+{
+    for (sfDevFPC2534Hook_t **h = &_hooks; *h != nullptr; h = &(*h)->next)
+    {
+        if (*h == &hook)
+        {
+            *h = hook.next;
+            hook.next = nullptr;
+            return;
+        }
+    }
+}
+
 //--------------------------------------------------------------------------------------------
 // Check if this is a NONE event status response
 bool sfDevFPC2534::checkForNoneEvent(uint8_t *payload, size_t size)
@@ -625,30 +1945,16 @@ bool sfDevFPC2534::checkForNoneEvent(uint8_t *payload, size_t size)
 }
 
 //--------------------------------------------------------------------------------------------
-// Called to pump the message queue - should be called regularly (in loop)
+// Read and sanity check the next frame header. On success the read is left open for the payload,
+// otherwise it is ended.
 //
-fpc_result_t sfDevFPC2534::processNextResponse(bool flushNone)
+fpc_result_t sfDevFPC2534::readFrameHeader(fpc_frame_hdr_t &frameHeader)
 {
-    if (_comm == nullptr)
-        return FPC_RESULT_WRONG_STATE;
-
-    // Check if data is available - no data - no dice, just continue
-    if (!_comm->dataAvailable())
-        return FPC_RESULT_OK;
-
-    fpc_frame_hdr_t frameHeader;
-
     _comm->beginRead();
     /* Step 1: Read Frame Header */
-    fpc_result_t rc = _comm->read((uint8_t *)&frameHeader, sizeof(fpc_frame_hdr_t));
+    fpc_result_t rc = readWithRetry((uint8_t *)&frameHeader, sizeof(fpc_frame_hdr_t), true);
 
-    // No data? No problem
-    if (rc == FPC_RESULT_IO_NO_DATA)
-    {
-        _comm->endRead();
-        return FPC_RESULT_OK; // No data to process, just return
-    }
-    else if (rc != FPC_RESULT_OK)
+    if (rc != FPC_RESULT_OK)
     {
         _comm->endRead();
         return rc;
@@ -667,17 +1973,93 @@ fpc_result_t sfDevFPC2534::processNextResponse(bool flushNone)
         _comm->endRead();
         return FPC_RESULT_IO_BAD_DATA;
     }
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Read the next frame into the provided buffer - no parsing
+//
+fpc_result_t sfDevFPC2534::readFrame(uint8_t *payload, size_t maxSize, uint16_t &payloadSize)
+{
+    payloadSize = 0;
+    if (_comm == nullptr)
+        return FPC_RESULT_WRONG_STATE;
+
+    if (payload == nullptr)
+        return FPC_RESULT_INVALID_PARAM;
+
+    if (!_comm->dataAvailable())
+        return FPC_RESULT_IO_NO_DATA;
+
+    fpc_frame_hdr_t frameHeader;
+    fpc_result_t rc = readFrameHeader(frameHeader);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    // Too big for the buffer? Read it in chunks to keep the stream in sync, then drop it
+    if (frameHeader.payload_size > maxSize)
+    {
+        size_t remaining = frameHeader.payload_size;
+        while (remaining > 0 && rc == FPC_RESULT_OK)
+        {
+            size_t chunk = remaining < maxSize ? remaining : maxSize;
+            rc = readWithRetry(payload, chunk);
+            remaining -= chunk;
+        }
+        _comm->endRead();
+        return rc == FPC_RESULT_OK ? FPC_RESULT_OUT_OF_MEMORY : rc;
+    }
+
+    rc = readWithRetry(payload, frameHeader.payload_size);
+    _comm->endRead();
+    if (rc == FPC_RESULT_OK)
+        payloadSize = frameHeader.payload_size;
+
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// Called to pump the message queue - should be called regularly (in loop)
+//
+fpc_result_t sfDevFPC2534::processNextResponse(bool flushNone)
+{
+    if (_comm == nullptr)
+        return FPC_RESULT_WRONG_STATE;
+
+    checkWatchdog();
+
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+    // In I/O task mode, the frames were already read from the bus - take the next one from the queue
+    if (_ioTask != nullptr)
+        return _ioTask->dispatch(0, flushNone);
+#endif
+
+    // Check if data is available - no data - no dice, just continue
+    if (!_comm->dataAvailable())
+        return FPC_RESULT_OK;
+
+    fpc_frame_hdr_t frameHeader;
+
+    fpc_result_t rc = readFrameHeader(frameHeader);
+
+    // No data? No problem
+    if (rc == FPC_RESULT_IO_NO_DATA)
+        return FPC_RESULT_OK; // No data to process, just return
+    else if (rc != FPC_RESULT_OK)
+        return rc;
 
     // okay, lets read the payload
     uint8_t framePayload[frameHeader.payload_size];
 
-    rc = _comm->read(framePayload, frameHeader.payload_size);
+    rc = readWithRetry(framePayload, frameHeader.payload_size);
     _comm->endRead();
     if (rc != FPC_RESULT_OK)
     {
         // Serial.printf("Error reading payload: %d\n\r", rc);
         return rc;
     }
+    noteFrame(framePayload, frameHeader.payload_size);
+
     // if we are flushing NONE events, and this is one, just return
     if (flushNone)
     {
@@ -690,6 +2072,57 @@ fpc_result_t sfDevFPC2534::processNextResponse(bool flushNone)
     return parseCommand(framePayload, frameHeader.payload_size);
 }
 
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534::waitForEvent(uint32_t timeoutMs)
+{
+    if (_comm == nullptr)
+        return FPC_RESULT_WRONG_STATE;
+
+    checkWatchdog();
+
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+    // The I/O task waits on the IRQ - wait for it to queue a frame
+    if (_ioTask != nullptr)
+        return _ioTask->dispatch(timeoutMs);
+#endif
+
+    if (!_comm->dataAvailable() && !_comm->waitForData(timeoutMs))
+        return FPC_RESULT_OK; // timeout - nothing to process
+
+    return processNextResponse();
+}
+
+//--------------------------------------------------------------------------------------------
+// Data available - from the bus, or queued by the I/O task
+bool sfDevFPC2534::isDataAvailable(void) const
+{
+    if (_comm == nullptr)
+        return false;
+
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+    if (_ioTask != nullptr)
+        return _ioTask->framesPending() > 0;
+#endif
+    return _comm->dataAvailable();
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534::clearData(void)
+{
+    if (_comm == nullptr)
+        return;
+
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+    // the I/O task owns the bus reads - it clears the bus
+    if (_ioTask != nullptr)
+    {
+        _ioTask->flush();
+        return;
+    }
+#endif
+    _comm->clearData();
+}
+
 //--------------------------------------------------------------------------------------------
 // Set the on-board LED state
 fpc_result_t sfDevFPC2534::setLED(bool ledOn)
@@ -20,12 +20,50 @@
 // The interface definition for communication classes
 #include "sfDevFPC2534IComm.h"
 
-// This library is dependent on Arduino framework
-#include <Arduino.h>
+// This library is dependent on Arduino framework (or the Linux host shim)
+#include "sfDevFPC2534Platform.h"
+
+// The optional I/O task (see sfDevFPC2534IOTask.h)
+class sfDevFPC2534IOTask;
+
+// The optional stop mode power manager (see sfDevFPC2534Power.h)
+class sfDevFPC2534Power;
 
 // Define the LED pin on the FPC2534 board
 const uint8_t SPARKFUN_FPC2534_LED_PIN = 1;
 
+// Largest template ID tracked by the template ID index (see hasTemplate()). IDs are allocated by the sensor
+// from 1 up - the index uses (max + 1) / 8 bytes.
+#ifndef SFE_FPC2534_MAX_TEMPLATE_ID
+#define SFE_FPC2534_MAX_TEMPLATE_ID 255
+#endif
+
+// Template transfers - the largest chunk sent in a CMD_DATA_PUT request (the chunk size of the sensor is used if
+// smaller). The chunk is built on the stack.
+#ifndef SFE_FPC2534_XFER_CHUNK_SIZE
+#define SFE_FPC2534_XFER_CHUNK_SIZE 256
+#endif
+
+// UART baud rate negotiation - how long to wait for a status response when probing a baud rate
+const uint32_t kFPC2534BaudProbeTimeoutMs = 100;
+
+// Boot handshake (see waitForBoot()) - how often to ask for the status while no boot status has arrived
+const uint32_t kFPC2534BootPollMs = 50;
+
+// Watchdog - time allowed for the sensor to boot after a reset by the watchdog
+const uint32_t kFPC2534WatchdogBootTimeoutMs = 1000;
+
+// Saved device state (see saveState()) - identifies the layout of sfDevFPC2534State_t
+const uint32_t kFPC2534StateMagic = 0x46504301;
+
+// Storage attribute for a saved device state that must survive host deep sleep - RTC memory on ESP32. On other
+// platforms RAM is retained in the low power modes, so no attribute is needed.
+#if defined(ESP32)
+#define SFE_FPC2534_RETAINED RTC_DATA_ATTR
+#else
+#define SFE_FPC2534_RETAINED
+#endif
+
 // The design pattern that the library implements follows the standard implementation
 // pattern of the FPC SDK - response from the sensor is delivered via callback functions.
 //
@@ -53,6 +91,103 @@ typedef struct
 
 } sfDevFPC2534Callbacks_t;
 
+/// @struct sfDevFPC2534Hook_t
+/// @brief Response hook - called with every parsed response/event, after the callbacks.
+///
+/// The callbacks have no context parameter, so library components that track sensor operations (the
+/// async API for example) register a hook instead. Hooks are linked into a list - no allocation.
+typedef struct sfDevFPC2534Hook
+{
+    void (*handler)(void *arg, fpc_cmd_hdr_t *cmd, size_t size);
+    void *arg;
+    struct sfDevFPC2534Hook *next;
+} sfDevFPC2534Hook_t;
+
+//--------------------------------------------------------------------------------------------
+// Template transfers - reads the data to send. Copy len bytes at offset into data, and return the bytes copied
+// (anything but len fails the transfer).
+typedef uint16_t (*sfDevFPC2534DataReader_t)(void *arg, uint32_t offset, uint8_t *data, uint16_t len);
+
+// Template transfers - receives the data read. Store len bytes of data, at offset, and return the bytes stored
+// (anything but len fails the transfer).
+typedef uint16_t (*sfDevFPC2534DataWriter_t)(void *arg, uint32_t offset, const uint8_t *data, uint16_t len);
+
+/// @struct sfDevFPC2534IdentifyTiming_t
+/// @brief Timing of continuous identify mode. All times in microseconds.
+///
+/// armToResult - from sending the identify request to receiving the result (includes the finger wait)
+/// rearm       - from receiving a result to the next identify request being sent (the dead time)
+typedef struct
+{
+    uint32_t cycles;            // results received
+    uint32_t staleDropped;      // results dropped because of a stale tag
+    uint32_t lastArmToResultUs;
+    uint32_t lastRearmUs;
+    uint32_t maxRearmUs;
+    uint32_t totalRearmUs;      // divide by cycles for the average
+} sfDevFPC2534IdentifyTiming_t;
+
+/// @struct sfDevFPC2534WatchdogStats_t
+/// @brief Liveness watchdog statistics - see enableWatchdog()
+typedef struct
+{
+    uint32_t timeouts;       // expected responses that did not arrive
+    uint32_t sysErrors;      // STATE_SYS_ERROR reported by the sensor
+    uint32_t aborts;         // escalation steps taken
+    uint32_t resets;
+    uint32_t reinits;
+    uint32_t recoveries;     // faults recovered from
+    uint32_t rearms;         // continuous identify re-armed after a lost result
+    uint32_t lastDowntimeMs; // fault detected to recovered
+    uint32_t maxDowntimeMs;
+} sfDevFPC2534WatchdogStats_t;
+
+/// @struct sfDevFPC2534RetryPolicy_t
+/// @brief Retry policy for transient transport errors - see setRetryPolicy()
+///
+/// A failed transport call is retried when the result is transient, after a backoff delay that doubles with each
+/// retry (up to maxDelayUs). The last jitterPercent of each delay is random, so retries from several hosts on a
+/// shared bus spread out.
+typedef struct
+{
+    uint8_t maxRetries;    // retries after the first attempt - 0 to disable
+    uint32_t baseDelayUs;  // delay before the first retry
+    uint32_t maxDelayUs;   // backoff limit
+    uint8_t jitterPercent; // 0 - 100
+    // Classify a result - true if transient (retry). nullptr for sfDevFPC2534::isTransientError()
+    bool (*isTransient)(fpc_result_t rc);
+} sfDevFPC2534RetryPolicy_t;
+
+// Default retry policy - 3 retries, from 200 us up to 5 ms
+const sfDevFPC2534RetryPolicy_t kFPC2534DefaultRetryPolicy = {3, 200, 5000, 25, nullptr};
+
+/// @struct sfDevFPC2534RetryStats_t
+/// @brief Transport retry statistics - see setRetryPolicy()
+typedef struct
+{
+    uint32_t writeRetries; // retried writes
+    uint32_t readRetries;  // retried reads
+    uint32_t recovered;    // transport calls that succeeded after a retry
+    uint32_t exhausted;    // transport calls that still failed after all retries
+    uint32_t fatal;        // failures not retried - not transient
+    uint32_t backoffUs;    // total time spent in backoff
+} sfDevFPC2534RetryStats_t;
+
+/// @struct sfDevFPC2534State_t
+/// @brief Device state saved across host deep sleep - see saveState() and restoreState().
+typedef struct
+{
+    uint32_t magic; // kFPC2534StateMagic
+    uint16_t currentState;
+    bool fingerPresent;
+    bool cfgCached;
+    fpc_system_config_t cfg;
+    bool tplIndexValid;
+    uint16_t tplCount;
+    uint32_t tplBitmap[(SFE_FPC2534_MAX_TEMPLATE_ID + 32) / 32];
+    uint32_t checksum;
+} sfDevFPC2534State_t;
+
 /// @class sfDevFPC2534
 /// @brief Core class implementing FPC2534 functionality independent of communication protocol
 class sfDevFPC2534
@@ -97,7 +232,164 @@ class sfDevFPC2534
     fpc_result_t requestIdentify(fpc_id_type_t &id, uint16_t tag);
 
     /**
-     * @brief Send an abort command to the device.
+     * @brief Is the template ID index valid?
+     *
+     * The library keeps an index of the template IDs on the sensor. It is filled by a requestListTemplates()
+     * response, updated when an enroll completes and when a delete succeeds, and invalidated by a factory reset.
+     *
+     * @return true if the index is valid - false until the first list templates response
+     */
+    bool templateIndexValid(void) const
+    {
+        return _tplIndexValid;
+    }
+
+    /**
+     * @brief Is a template with the given ID on the sensor? Uses the template ID index.
+     *
+     * @param id Template ID (up to SFE_FPC2534_MAX_TEMPLATE_ID)
+     * @return true if the template is present
+     */
+    bool hasTemplate(uint16_t id) const
+    {
+        return id <= SFE_FPC2534_MAX_TEMPLATE_ID && (_tplBitmap[id >> 5] & (1UL << (id & 31))) != 0;
+    }
+
+    /**
+     * @brief Number of templates on the sensor. Uses the template ID index (IDs above
+     * SFE_FPC2534_MAX_TEMPLATE_ID are not tracked).
+     */
+    uint16_t templateCount(void) const
+    {
+        return _tplCount;
+    }
+
+    /**
+     * @brief Get the next unused template ID - for use with ID_TYPE_SPECIFIED. Uses the template ID index.
+     *
+     * @param start The first ID to consider
+     * @return The next free ID, or 0 if there are none (or the index is not valid)
+     */
+    uint16_t nextFreeTemplateId(uint16_t start = 1) const;
+
+    /**
+     * @brief Start continuous identify mode.
+     *
+     * Identify operations run back to back - as soon as a result is received, the next identify request is
+     * sent (before on_identify is called), so touches are not missed while the application handles the
+     * result. The tag is incremented on each cycle, and results with a stale tag are dropped.
+     *
+     * The mode ends with stopContinuousIdentify(), requestAbort() or an error reported by the sensor.
+     *
+     * @param id The template(s) to identify against - ID_TYPE_SPECIFIED or ID_TYPE_ALL
+     * @return Result Code
+     */
+    fpc_result_t startContinuousIdentify(fpc_id_type_t &id);
+
+    /**
+     * @brief Stop continuous identify mode - the pending identify operation is aborted.
+     *
+     * @return Result Code
+     */
+    fpc_result_t stopContinuousIdentify(void);
+
+    /**
+     * @brief Is continuous identify mode active?
+     */
+    bool isContinuousIdentify(void) const
+    {
+        return _contIdActive;
+    }
+
+    /**
+     * @brief Enable the liveness watchdog.
+     *
+     * The watchdog expects a frame from the sensor within responseTimeoutMs of each command, and sends a status
+     * request (heartbeat) when there has been no traffic for heartbeatMs. When a response does not arrive, or the
+     * sensor reports STATE_SYS_ERROR, on_error() is called with FPC_RESULT_TIMEOUT and the watchdog escalates -
+     * abort, then sendReset(), then a reinitialization of the bus - until the sensor responds as ready. The
+     * navigation mode or continuous identify mode running at the time of the fault is then restarted.
+     *
+     * The watchdog runs from processNextResponse() / waitForEvent() - call these regularly.
+     *
+     * @param responseTimeoutMs Max time from a command to a frame from the sensor
+     * @param heartbeatMs Idle time before a heartbeat status request - 0 for no heartbeat
+     */
+    void enableWatchdog(uint32_t responseTimeoutMs, uint32_t heartbeatMs = 0);
+
+    /**
+     * @brief Disable the liveness watchdog
+     */
+    void disableWatchdog(void)
+    {
+        _wdEnabled = false;
+    }
+
+    /**
+     * @brief Is the watchdog recovering the sensor from a fault?
+     */
+    bool isRecovering(void) const
+    {
+        return _wdLevel != kWatchdogIdle;
+    }
+
+    void getWatchdogStats(sfDevFPC2534WatchdogStats_t &stats) const
+    {
+        stats = _wdStats;
+    }
+    void resetWatchdogStats(void)
+    {
+        memset(&_wdStats, 0, sizeof(_wdStats));
+    }
+
+    /**
+     * @brief Set the retry policy for transient transport errors.
+     *
+     * Command writes, and reads within a frame, are retried. A frame that has not started to arrive is not waited
+     * for - the next processNextResponse() call reads it. The default is kFPC2534DefaultRetryPolicy.
+     *
+     * @param policy The retry policy - maxRetries of 0 disables retries
+     */
+    void setRetryPolicy(const sfDevFPC2534RetryPolicy_t &policy)
+    {
+        _retryPolicy = policy;
+    }
+
+    void getRetryPolicy(sfDevFPC2534RetryPolicy_t &policy) const
+    {
+        policy = _retryPolicy;
+    }
+
+    /**
+     * @brief The default classification of transport results - bus busy, no data (yet), runtime failures and
+     * failed transfers (a NACK) are transient. Other results - bad data, invalid parameters - are fatal.
+     *
+     * @param rc The result of a transport call
+     * @return true if the call can be retried
+     */
+    static bool isTransientError(fpc_result_t rc);
+
+    void getRetryStats(sfDevFPC2534RetryStats_t &stats) const
+    {
+        stats = _retryStats;
+    }
+    void resetRetryStats(void)
+    {
+        memset(&_retryStats, 0, sizeof(_retryStats));
+    }
+
+    /**
+     * @brief Get the timing of continuous identify mode (reset when the mode is started)
+     *
+     * @param timing Set to the timing values
+     */
+    void getIdentifyTiming(sfDevFPC2534IdentifyTiming_t &timing) const
+    {
+        timing = _contIdTiming;
+    }
+
+    /**
+     * @brief Send an abort command to the device. This also ends continuous identify mode.
      *
      * @return Result Code
      */
@@ -201,30 +493,270 @@ class sfDevFPC2534
      */
     fpc_result_t requestGetSystemConfig(uint8_t type);
 
-    // /**
-    //  * @brief Populate and transfer a CMD_PUT_TEMPLATE_DATA request
-    //  *
-    //  * Send template to device.
-    //  *
-    //  * @param id   Template id.
-    //  * @param data Pointer to template data.
-    //  * @param size Size of template data.
-    //  *
-    //  * @return Result Code
-    //  */
-    // fpc_result_t requestPutTemplateData(uint16_t id, uint8_t *data, size_t size);
-
-    // /**
-    //  * @brief Populate and transfer a CMD_GET_TEMPLATE_DATA request.
-    //  *
-    //  * Read template from device. This function will allocate memory for the template and
-    //  * return data and size in the callback function (on_data_transfer_done).
-    //  *
-    //  * @param id Template id.
-    //  *
-    //  * @return Result Code
-    //  */
-    // fpc_result_t requestGetTemplateData(uint16_t id);
+    // Cached system configuration
+    //
+    // The library caches the active (custom) configuration of the sensor - loaded by a
+    // requestGetSystemConfig(FPC_SYS_CFG_TYPE_CUSTOM) response, or by the sensor accepting a setSystemConfig().
+    // The field setters below change the cached copy only. commitConfig() sends the configuration to the sensor
+    // in one write, and only if a field actually changed.
+
+    /**
+     * @brief Is the system configuration cached? Required by the field setters.
+     */
+    bool isConfigCached(void) const
+    {
+        return _cfgCached;
+    }
+
+    /**
+     * @brief Do the cached configuration changes differ from the sensor configuration?
+     */
+    bool isConfigDirty(void) const
+    {
+        return _cfgCached && memcmp(&_cfgPending, &_cfgActive, sizeof(fpc_system_config_t)) != 0;
+    }
+
+    /**
+     * @brief Get the cached configuration, including any changes not yet committed.
+     *
+     * @param cfg Set to the cached configuration
+     * @return FPC_RESULT_OK, or FPC_RESULT_WRONG_STATE if the configuration is not cached
+     */
+    fpc_result_t getCachedConfig(fpc_system_config_t &cfg) const;
+
+    /**
+     * @brief Set the finger scan interval - the sleep time between finger present checks.
+     *
+     * @param intervalMs Interval in milliseconds [0, 1020]
+     * @return Result Code
+     */
+    fpc_result_t setFingerScanInterval(uint16_t intervalMs);
+
+    /**
+     * @brief Set the idle time after the last command before the sensor enters stop mode.
+     *
+     * @param idleMs Idle time in milliseconds
+     * @return Result Code
+     */
+    fpc_result_t setIdleTimeBeforeSleep(uint16_t idleMs);
+
+    /**
+     * @brief Set the system flags - a combination of CFG_SYS_FLAG_*
+     *
+     * @param flags The flags to set
+     * @return Result Code
+     */
+    fpc_result_t setSystemFlags(uint32_t flags);
+
+    /**
+     * @brief Set the UART settings of the sensor.
+     *
+     * @param baudRate One of CFG_UART_BAUDRATE_*
+     * @param delayBeforeIRQMs Delay between the IRQ pin being set and UART TX starting
+     * @return Result Code
+     */
+    fpc_result_t setUARTConfig(uint8_t baudRate, uint8_t delayBeforeIRQMs);
+
+    /**
+     * @brief Set the identify lockout settings
+     *
+     * @param maxConsecutiveFails Number of failed identify operations before lockout
+     * @param lockoutTimeSecs Lockout time in seconds
+     * @return Result Code
+     */
+    fpc_result_t setIdentifyLockout(uint8_t maxConsecutiveFails, uint8_t lockoutTimeSecs);
+
+    /**
+     * @brief Set the enroll touch settings
+     *
+     * @param touches Number of touches to enroll [12, 20]
+     * @param immobileTouches Max number of immobile touches counted [0, 6] - not more than touches
+     * @return Result Code
+     */
+    fpc_result_t setEnrollTouches(uint8_t touches, uint8_t immobileTouches);
+
+    /**
+     * @brief Send the cached configuration to the sensor - if it changed.
+     *
+     * @param verify If true, the configuration is read back from the sensor and compared. Check the result
+     * with configVerifyResult().
+     * @return FPC_RESULT_OK (also when nothing changed), or an error
+     */
+    fpc_result_t commitConfig(bool verify = false);
+
+    /**
+     * @brief Drop any cached configuration changes not yet committed.
+     */
+    void discardConfigChanges(void)
+    {
+        _cfgPending = _cfgActive;
+    }
+
+    /**
+     * @brief Result of the last verified commitConfig().
+     *
+     * @return FPC_PENDING_OPERATION while waiting for the read back, FPC_RESULT_OK if the sensor configuration
+     * matches the configuration written, FPC_RESULT_FAILURE if it doesn't - the sensor rejected or adjusted a
+     * field (on_error is also called with FPC_RESULT_FAILURE).
+     */
+    fpc_result_t configVerifyResult(void) const
+    {
+        return _cfgVerifyResult;
+    }
+
+    /**
+     * @brief Negotiate the UART baud rate of the sensor and the host UART - UART transports only.
+     *
+     * Finds the sensor by probing the candidate baud rates with a status request, then raises the sensor
+     * baud rate with setSystemConfig(), switches the host UART to match and verifies the link with a status
+     * round trip. If the new rate fails, the sensor is found again and the next lower rate is tried - the
+     * sensor configuration is restored to the working rate.
+     *
+     * This is a blocking call - responses are processed (and callbacks called) while it runs. Call it before
+     * starting the I/O task.
+     *
+     * @param baudRate Target rate - one of CFG_UART_BAUDRATE_*
+     * @return FPC_RESULT_OK if the link is working at the target rate or a fallback rate (see
+     * getUARTBaudRate()), FPC_RESULT_TIMEOUT if the sensor does not respond at any rate, or an error.
+     */
+    fpc_result_t negotiateUARTBaudRate(uint8_t baudRate = CFG_UART_BAUDRATE_921600);
+
+    /**
+     * @brief The current baud rate of the host UART, in bits per second - 0 if unknown or not a UART transport.
+     */
+    uint32_t getUARTBaudRate(void) const
+    {
+        return _comm != nullptr ? _comm->getBaudRate() : 0;
+    }
+
+    /**
+     * @brief Convert a CFG_UART_BAUDRATE_* value to bits per second - 0 if not valid.
+     */
+    static uint32_t uartBaudRateToBps(uint8_t baudRate);
+
+    /**
+     * @brief Send a template to the sensor - a CMD_PUT_TEMPLATE_DATA request, then CMD_DATA_PUT chunks, each sent
+     * when the sensor confirms the previous one. The transfer runs from processNextResponse() - when the sensor
+     * has the whole template, the on_data_transfer_done callback is called (with no data). On a failure, the
+     * on_error callback is called.
+     *
+     * @param id Template id
+     * @param data The template data - must stay valid until the transfer is done
+     * @param size Size of the template data
+     * @return Result Code
+     */
+    fpc_result_t requestPutTemplateData(uint16_t id, const uint8_t *data, size_t size);
+
+    /**
+     * @brief Send a template to the sensor - the data is read in chunks, as they are sent, with the given reader.
+     * The template does not need to be in memory.
+     *
+     * @param id Template id
+     * @param size Size of the template data
+     * @param reader Called for each chunk
+     * @param arg Passed to the reader
+     * @return Result Code
+     */
+    fpc_result_t requestPutTemplateData(uint16_t id, size_t size, sfDevFPC2534DataReader_t reader, void *arg);
+
+    /**
+     * @brief Is a template (or image) transfer running?
+     */
+    bool isTransferActive(void) const
+    {
+        return _xferActive;
+    }
+
+    /**
+     * @brief Bytes of the current (or last) template transfer - confirmed by the sensor (PUT), or received (GET)
+     */
+    uint32_t transferProgress(void) const
+    {
+        return _xferAcked;
+    }
+
+    /**
+     * @brief Size of the template of the current (or last) transfer - for a GET, 0 until the sensor gives it
+     */
+    uint32_t transferSize(void) const
+    {
+        return _xferSize;
+    }
+
+    /**
+     * @brief The result of the last template transfer - FPC_RESULT_IO_BUSY while it runs, FPC_RESULT_OK when the
+     * sensor has the whole template, or the error that ended it.
+     */
+    fpc_result_t transferResult(void) const
+    {
+        return _xferResult;
+    }
+
+    /**
+     * @brief Stop a running template transfer - the sensor is sent an abort.
+     *
+     * @return Result Code
+     */
+    fpc_result_t abortTransfer(void);
+
+    /**
+     * @brief Read a template from the sensor - a CMD_GET_TEMPLATE_DATA request, then CMD_DATA_GET requests, each
+     * sent when the previous chunk arrives. The transfer runs from processNextResponse() - when the whole template
+     * is read, the on_data_transfer_done callback is called with the buffer and the template size. On a failure,
+     * the on_error callback is called.
+     *
+     * @param id Template id
+     * @param buffer Receives the template - must stay valid until the transfer is done
+     * @param bufferSize Size of the buffer - a larger template fails the transfer (FPC_RESULT_OUT_OF_MEMORY)
+     * @return Result Code
+     */
+    fpc_result_t requestGetTemplateData(uint16_t id, uint8_t *buffer, size_t bufferSize);
+
+    /**
+     * @brief Read a template from the sensor - each chunk is passed to the given writer as it arrives, so the
+     * template does not need to be in memory. The size of the template is available from transferSize() when the
+     * writer is called. When done, on_data_transfer_done is called with no data and the template size.
+     *
+     * @param id Template id
+     * @param writer Called for each chunk
+     * @param arg Passed to the writer
+     * @return Result Code
+     */
+    fpc_result_t requestGetTemplateData(uint16_t id, sfDevFPC2534DataWriter_t writer, void *arg);
+
+    /**
+     * @brief Send a capture command to the device - the sensor waits for a finger, and captures an image. When
+     * the image is ready, a status event (EVENT_IMAGE_READY) is sent, and the image can be read with
+     * requestGetImageData().
+     *
+     * @return Result Code
+     */
+    fpc_result_t requestCapture(void);
+
+    /**
+     * @brief Read the captured image from the sensor - a CMD_IMAGE_DATA request, then CMD_DATA_GET requests, the
+     * same as a template GET transfer (see isTransferActive(), transferResult() ...). Each chunk is passed to the
+     * writer as it arrives - the image size and dimensions are available when the writer is called.
+     *
+     * @param type CMD_IMAGE_REQUEST_TYPE_GET_RAW (8 bit gray scale pixels, row by row) or
+     * CMD_IMAGE_REQUEST_TYPE_GET_FMI (the image in the FMI format of the sensor)
+     * @param writer Called for each chunk
+     * @param arg Passed to the writer
+     * @return Result Code
+     */
+    fpc_result_t requestGetImageData(uint16_t type, sfDevFPC2534DataWriter_t writer, void *arg);
+
+    /**
+     * @brief Width and height of the image of the current (or last) image transfer - 0 until the sensor gives them
+     */
+    uint16_t imageWidth(void) const
+    {
+        return _imageWidth;
+    }
+    uint16_t imageHeight(void) const
+    {
+        return _imageHeight;
+    }
 
     /**
      * @brief Send a factory reset command to the device.
@@ -295,22 +827,13 @@ class sfDevFPC2534
      *
      * @return true - if data is available
      */
-    bool isDataAvailable(void) const
-    {
-        if (_comm == nullptr)
-            return false;
-        return _comm->dataAvailable();
-    }
+    bool isDataAvailable(void) const;
 
     /**
      * @brief Clear any available data from the device.
      *
      */
-    void clearData(void)
-    {
-        if (_comm != nullptr)
-            _comm->clearData();
-    }
+    void clearData(void);
     /**
      * @brief Set the state of the on-board LED.
      *
@@ -334,7 +857,129 @@ class sfDevFPC2534
         return processNextResponse(false);
     };
 
+    /**
+     * @brief Sleep until the sensor has data (or timeout), then process the next response. Use in place of
+     * polling processNextResponse() in loop() on low power hosts.
+     *
+     * The host sleeps in the lightest sleep state that still wakes on the sensor IRQ pin - ESP32 light sleep
+     * with GPIO wakeup, RP2 wait for event, AVR idle. On a Linux host, the thread sleeps in the kernel until
+     * the IRQ line fires. In I/O task mode, this waits on the I/O task queue. For UART, connect the IRQ pin and
+     * set the CFG_SYS_FLAG_UART_IRQ_BEFORE_TX system flag on the sensor.
+     *
+     * @param timeoutMs Max time to wait, in milliseconds
+     * @return FPC_RESULT_OK (also on timeout), or the processing error
+     */
+    fpc_result_t waitForEvent(uint32_t timeoutMs);
+
+    /**
+     * @brief Boot handshake - wait for the sensor to report it is ready, in place of a fixed startup delay.
+     *
+     * Call right after a sensor reset (or power up), or at any time for a sensor that is already running. The
+     * ready state comes from the boot status of the sensor (CFG_SYS_FLAG_STATUS_EVT_AT_BOOT), or the response to
+     * a status request - sent every kFPC2534BootPollMs until the sensor responds. on_is_ready_change() is called
+     * when the sensor is ready.
+     *
+     * With loadInfo, the version and system configuration are then requested in one burst, and the
+     * CFG_SYS_FLAG_STATUS_EVT_AT_BOOT flag is enabled on the sensor if it is not set - so the next boot is
+     * reported without a request.
+     *
+     * @param timeoutMs Max time to wait for the sensor, in milliseconds
+     * @param loadInfo Load the version and configuration
+     * @return FPC_RESULT_OK, FPC_RESULT_TIMEOUT, or an error
+     */
+    fpc_result_t waitForBoot(uint32_t timeoutMs, bool loadInfo = false);
+
+    /**
+     * @brief Time the last waitForBoot() waited for the sensor to be ready, in milliseconds.
+     */
+    uint32_t bootTimeMs(void) const
+    {
+        return _bootTimeMs;
+    }
+
+    /**
+     * @brief Save the device state - sensor state, finger state, cached configuration and template ID index.
+     *
+     * Used to skip the startup sequence when the host wakes from deep sleep while the sensor stays powered.
+     * Place the state in retained memory:
+     *
+     *     SFE_FPC2534_RETAINED sfDevFPC2534State_t savedState;
+     *
+     * @param state Set to the current device state
+     */
+    void saveState(sfDevFPC2534State_t &state) const;
+
+    /**
+     * @brief Restore a state saved with saveState() - call after begin(). The sensor is ready, and the next
+     * response can be processed right away (with no reset and startup status).
+     *
+     * The time from the restore to the first identify result is reported by wakeToResultUs().
+     *
+     * @param state The saved state
+     * @return true if restored - false if the state is not valid (first boot), and the normal startup is needed
+     */
+    bool restoreState(const sfDevFPC2534State_t &state);
+
+    /**
+     * @brief Time from restoreState() to the first identify result after it, in microseconds.
+     *
+     * @return The time, or 0 if no identify result was received since the restore
+     */
+    uint32_t wakeToResultUs(void) const
+    {
+        return _wakeToResultUs;
+    }
+
+    /**
+     * @brief Add a response hook. The hook object must remain valid until removed.
+     *
+     * @param hook The hook to add
+     */
+    void addHook(sfDevFPC2534Hook_t &hook);
+
+    /**
+     * @brief Remove a previously added response hook.
+     *
+     * @param hook The hook to remove
+     */
+    void removeHook(sfDevFPC2534Hook_t &hook);
+
+    /**
+     * @brief Number of requests sent and not answered yet. The sensor answers each request with one
+     * FPC_FRAME_TYPE_CMD_RESPONSE frame, in order.
+     */
+    uint8_t responsesPending(void) const
+    {
+        return _rspPending;
+    }
+
+    /**
+     * @brief Number of responses received (wraps) - including the one a hook is called with. The response to a
+     * request is number responsesReceived() + responsesPending() + 1 at the time it is sent.
+     */
+    uint16_t responsesReceived(void) const
+    {
+        return _rspReceived;
+    }
+
+    /**
+     * @brief Read the next complete frame from the device, without parsing it.
+     *
+     * Used by the I/O task to drain frames from the bus. If the payload is larger than maxSize, it is
+     * read and discarded and FPC_RESULT_OUT_OF_MEMORY is returned.
+     *
+     * @param payload Buffer for the frame payload
+     * @param maxSize Size of the payload buffer
+     * @param payloadSize Set to the size of the payload read
+     * @return FPC_RESULT_OK, FPC_RESULT_IO_NO_DATA if no frame is available, or an error
+     */
+    fpc_result_t readFrame(uint8_t *payload, size_t maxSize, uint16_t &payloadSize);
+
   private:
+    friend class sfDevFPC2534IOTask;
+    friend class sfDevFPC2534Power;
+    friend class sfDevFPC2534Manager;
+
     // NOTE:
     // In general, messages are received from the device, identified and sent to the
     // appropriate parser function.
@@ -349,8 +994,15 @@ class sfDevFPC2534
     fpc_result_t parseGPIOControlCommand(fpc_cmd_hdr_t *, size_t);
     fpc_result_t parseGetSystemConfigCommand(fpc_cmd_hdr_t *, size_t);
     fpc_result_t parseBISTCommand(fpc_cmd_hdr_t *, size_t);
+    fpc_result_t parsePutTemplateDataCommand(fpc_cmd_hdr_t *, size_t);
+    fpc_result_t parseDataPutCommand(fpc_cmd_hdr_t *, size_t);
+    fpc_result_t parseGetTemplateDataCommand(fpc_cmd_hdr_t *, size_t);
+    fpc_result_t parseDataGetCommand(fpc_cmd_hdr_t *, size_t);
+    fpc_result_t parseImageDataCommand(fpc_cmd_hdr_t *, size_t);
     fpc_result_t parseCommand(uint8_t *frame_payload, size_t payload_size);
 
+    fpc_result_t readFrameHeader(fpc_frame_hdr_t &frameHeader);
+
     bool checkForNoneEvent(uint8_t *payload, size_t size);
     fpc_result_t flushNoneEvent(void);
 
@@ -366,4 +1018,145 @@ class sfDevFPC2534
 
     // Is a finger present?
     bool _finger_present = false;
+
+    // Response hooks
+    sfDevFPC2534Hook_t *_hooks = nullptr;
+
+    // Cached system configuration - as on the sensor, and with the uncommitted changes
+    fpc_result_t checkConfigCached(void) const
+    {
+        return _cfgCached ? FPC_RESULT_OK : FPC_RESULT_WRONG_STATE;
+    }
+
+    fpc_system_config_t _cfgActive = {0};
+    fpc_system_config_t _cfgPending = {0};
+    fpc_system_config_t _cfgWritten = {0}; // last setSystemConfig() - checked against the read back
+    // Configuration write waiting for its status response - and the responses due before it
+    bool _cfgSetPending = false;
+    uint8_t _cfgSetAhead = 0;
+    bool _cfgCached = false;
+    bool _cfgVerifyPending = false;
+    fpc_result_t _cfgVerifyResult = FPC_RESULT_OK;
+
+    // UART baud rate negotiation
+    fpc_result_t waitForResponse(uint16_t cmdId, uint32_t timeoutMs);
+    bool probeUARTBaudRate(uint32_t bps);
+    uint8_t findUARTBaudRate(void);
+    fpc_result_t loadSystemConfig(void);
+
+    // Template ID index
+    void setTemplateBit(uint16_t id, bool present);
+    void clearTemplateIndex(bool valid);
+
+    static const uint16_t kTemplateBitmapWords = (SFE_FPC2534_MAX_TEMPLATE_ID + 32) / 32;
+    uint32_t _tplBitmap[kTemplateBitmapWords] = {0};
+    uint16_t _tplCount = 0;
+    bool _tplIndexValid = false;
+    // Delete request waiting for its status response - and the responses to earlier requests due before it
+    bool _tplDeletePending = false;
+    uint8_t _tplDeleteAhead = 0;
+    fpc_id_type_t _tplDeleteId = {0, 0};
+
+    // Requests sent and not answered yet - the sensor answers each request with one response, in order
+    void noteResponse(uint8_t *payload, size_t size);
+    void clearResponsesPending(void);
+    static bool isAnswerTo(bool &pending, uint8_t &ahead);
+    static bool isBootStatus(uint8_t *payload, size_t size);
+    uint8_t _rspPending = 0;
+    uint16_t _rspReceived = 0;
+
+    // Template transfer
+    fpc_result_t sendDataPutChunk(void);
+    fpc_result_t sendDataGetRequest(void);
+    fpc_result_t startGetTemplateData(uint16_t id, sfDevFPC2534DataWriter_t writer, void *arg, uint32_t limit,
+                                      uint8_t *buffer);
+    void endTransfer(fpc_result_t rc);
+    void failTransfer(fpc_result_t rc);
+
+    bool _xferActive = false;
+    bool _xferGet = false;   // direction - GET (read from the sensor) or PUT
+    bool _xferImage = false; // GET of an image - _xferId is the image request type
+    fpc_result_t _xferResult = FPC_RESULT_OK;
+    uint16_t _xferId = 0;
+    uint32_t _xferSize = 0;
+    uint32_t _xferLimit = 0; // GET - largest template accepted
+    uint32_t _xferSent = 0;  // PUT - bytes sent
+    uint32_t _xferAcked = 0; // bytes confirmed by the sensor (PUT) or received (GET)
+    uint16_t _xferChunk = 0;
+    sfDevFPC2534DataReader_t _xferReader = nullptr;
+    sfDevFPC2534DataWriter_t _xferWriter = nullptr;
+    uint8_t *_xferBuffer = nullptr; // GET into memory
+    void *_xferArg = nullptr;
+    uint16_t _imageWidth = 0;
+    uint16_t _imageHeight = 0;
+
+    // Continuous identify mode
+    fpc_result_t armContinuousIdentify(void);
+
+    bool _contIdActive = false;
+    fpc_id_type_t _contIdId = {0, 0};
+    uint16_t _contIdTag = 0;
+    uint32_t _contIdArmedAt = 0; // micros()
+    sfDevFPC2534IdentifyTiming_t _contIdTiming = {0};
+
+    // Liveness watchdog
+    typedef enum
+    {
+        kWatchdogIdle = 0,
+        kWatchdogAbort,
+        kWatchdogReset,
+        kWatchdogReinit
+    } watchdog_level_t;
+
+    void noteFrame(uint8_t *payload, size_t size);
+    void checkWatchdog(void);
+    void watchdogFault(void);
+    void watchdogEscalate(void);
+    void watchdogRecovered(void);
+
+    bool _wdEnabled = false;
+    bool _wdBusy = false; // the watchdog is sending commands, or an internal wait is running
+    uint32_t _wdResponseMs = 0;
+    uint32_t _wdHeartbeatMs = 0;
+    bool _wdExpecting = false;    // a command waits for a frame
+    uint32_t _wdExpectSince = 0;  // millis()
+    uint32_t _wdLastTrafficMs = 0;
+    watchdog_level_t _wdLevel = kWatchdogIdle;
+    uint32_t _wdLevelSince = 0;
+    uint32_t _wdFaultSince = 0;
+    bool _wdSysError = false;     // STATE_SYS_ERROR seen - handled by checkWatchdog()
+    bool _wdRecovered = false;    // the sensor responded during recovery - handled by checkWatchdog()
+    uint16_t _wdLastMode = 0;     // navigation/identify mode, as of the last healthy status
+    uint16_t _wdRestoreMode = 0;  // mode to restart after recovery
+    bool _wdRestoreContId = false;
+    uint8_t _navOrientation = 0;
+    sfDevFPC2534WatchdogStats_t _wdStats = {0};
+
+    // Transport calls with retries
+    fpc_result_t writeWithRetry(const uint8_t *data, size_t len);
+    fpc_result_t readWithRetry(uint8_t *data, size_t len, bool frameStart = false);
+    bool retryBackoff(fpc_result_t rc, uint8_t &attempt);
+    void retryDone(fpc_result_t rc, uint8_t attempt);
+
+    sfDevFPC2534RetryPolicy_t _retryPolicy = kFPC2534DefaultRetryPolicy;
+    sfDevFPC2534RetryStats_t _retryStats = {0};
+    uint32_t _retrySeed = 0; // jitter
+
+    // Boot handshake
+    fpc_result_t loadBootInfo(uint32_t timeoutMs);
+
+    uint32_t _bootTimeMs = 0;
+
+    // Restored from a saved state - time the first identify result
+    static uint32_t stateChecksum(const sfDevFPC2534State_t &state);
+
+    bool _wakeTimingPending = false;
+    uint32_t _restoredAtUs = 0; // micros()
+    uint32_t _wakeToResultUs = 0;
+
+    // When set, frames are read by the I/O task and taken from its queue
+    sfDevFPC2534IOTask *_ioTask = nullptr;
+
+    // When set, the sensor is woken from stop mode before commands are sent
+    sfDevFPC2534Power *_power = nullptr;
 };
\ No newline at end of file
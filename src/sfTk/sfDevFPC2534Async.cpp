@@ -0,0 +1,295 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Implementation of the coroutine (awaitable) API
+
+#include "sfDevFPC2534Async.h"
+
+#if defined(SFE_FPC2534_HAS_COROUTINES)
+
+static_assert(SFE_FPC2534_CO_FRAME_COUNT > 0 && SFE_FPC2534_CO_FRAME_COUNT <= 32,
+              "SFE_FPC2534_CO_FRAME_COUNT must be 1 to 32");
+
+//--------------------------------------------------------------------------------------------
+// sfDevFPC2534CoArena
+//--------------------------------------------------------------------------------------------
+
+alignas(alignof(max_align_t)) uint8_t sfDevFPC2534CoArena::_blocks[SFE_FPC2534_CO_FRAME_COUNT][SFE_FPC2534_CO_FRAME_SIZE];
+uint32_t sfDevFPC2534CoArena::_usedMask = 0;
+uint8_t sfDevFPC2534CoArena::_highWater = 0;
+size_t sfDevFPC2534CoArena::_largestFrame = 0;
+
+//--------------------------------------------------------------------------------------------
+void *sfDevFPC2534CoArena::allocate(size_t size)
+{
+    if (size > _largestFrame)
+        _largestFrame = size;
+
+    if (size > SFE_FPC2534_CO_FRAME_SIZE)
+        return nullptr;
+
+    for (uint8_t i = 0; i < SFE_FPC2534_CO_FRAME_COUNT; i++)
+    {
+        if ((_usedMask & (1UL << i)) == 0)
+        {
+            _usedMask |= (1UL << i);
+            uint8_t used = inUse();
+            if (used > _highWater)
+                _highWater = used;
+            return _blocks[i];
+        }
+    }
+    return nullptr; // arena exhausted
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534CoArena::release(void *ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    size_t index = ((uint8_t *)ptr - &_blocks[0][0]) / SFE_FPC2534_CO_FRAME_SIZE;
+    if (index < SFE_FPC2534_CO_FRAME_COUNT)
+        _usedMask &= ~(1UL << index);
+}
+
+//--------------------------------------------------------------------------------------------
+uint8_t sfDevFPC2534CoArena::inUse(void)
+{
+    uint8_t count = 0;
+    for (uint32_t mask = _usedMask; mask != 0; mask &= mask - 1)
+        count++;
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------
+// sfDevFPC2534AsyncOp
+//--------------------------------------------------------------------------------------------
+
+bool sfDevFPC2534AsyncOp::await_suspend(std::coroutine_handle<> waiter)
+{
+    fpc_result_t rc = _async.begin(*this, waiter);
+    if (rc != FPC_RESULT_OK)
+    {
+        // could not start - don't suspend, the result is the error
+        complete(rc);
+        return false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+// Operations
+//--------------------------------------------------------------------------------------------
+
+fpc_result_t sfDevFPC2534IdentifyOp::send(void)
+{
+    return _async.device().requestIdentify(_id, _result.tag);
+}
+
+bool sfDevFPC2534IdentifyOp::onResponse(fpc_cmd_hdr_t *cmd, size_t size)
+{
+    if (cmd->cmd_id != CMD_IDENTIFY || size < sizeof(fpc_cmd_identify_status_response_t))
+        return false;
+
+    fpc_cmd_identify_status_response_t *id_res = (fpc_cmd_identify_status_response_t *)cmd;
+    _result.match = id_res->match == IDENTIFY_RESULT_MATCH;
+    _result.id = id_res->tpl_id.id;
+    _result.tag = id_res->tag;
+    complete(FPC_RESULT_OK);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534EnrollOp::send(void)
+{
+    // Only the first await sends the request - later awaits wait for the next progress update
+    if (_started)
+        return FPC_RESULT_OK;
+
+    _started = true;
+    return _async.device().requestEnroll(_id);
+}
+
+bool sfDevFPC2534EnrollOp::onResponse(fpc_cmd_hdr_t *cmd, size_t size)
+{
+    if (cmd->cmd_id != CMD_ENROLL || size < sizeof(fpc_cmd_enroll_status_response_t))
+        return false;
+
+    fpc_cmd_enroll_status_response_t *status = (fpc_cmd_enroll_status_response_t *)cmd;
+    _templateId = status->id;
+    _feedback = status->feedback;
+    _samplesRemaining = status->samples_remaining;
+    _hasProgress = true;
+
+    if (_samplesRemaining == 0)
+        complete(FPC_RESULT_OK);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534ConfigOp::send(void)
+{
+    return _async.device().requestGetSystemConfig(_type);
+}
+
+bool sfDevFPC2534ConfigOp::onResponse(fpc_cmd_hdr_t *cmd, size_t size)
+{
+    if (cmd->cmd_id != CMD_GET_SYSTEM_CONFIG || size < sizeof(fpc_cmd_get_config_response_t))
+        return false;
+
+    fpc_cmd_get_config_response_t *cmd_cfg = (fpc_cmd_get_config_response_t *)cmd;
+    _result.cfg = cmd_cfg->cfg;
+    complete(FPC_RESULT_OK);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534ListOp::send(void)
+{
+    return _async.device().requestListTemplates();
+}
+
+bool sfDevFPC2534ListOp::onResponse(fpc_cmd_hdr_t *cmd, size_t size)
+{
+    if (cmd->cmd_id != CMD_LIST_TEMPLATES || size < sizeof(fpc_cmd_template_info_response_t))
+        return false;
+
+    fpc_cmd_template_info_response_t *list = (fpc_cmd_template_info_response_t *)cmd;
+    _result.count = list->number_of_templates;
+
+    // copy what fits - and what was actually sent
+    size_t available = (size - sizeof(fpc_cmd_template_info_response_t)) / sizeof(uint16_t);
+    for (size_t i = 0; _ids != nullptr && i < _maxIds && i < available && i < list->number_of_templates; i++)
+        _ids[i] = list->template_id_list[i];
+
+    complete(FPC_RESULT_OK);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+// sfDevFPC2534Async
+//--------------------------------------------------------------------------------------------
+
+sfDevFPC2534Async::sfDevFPC2534Async(sfDevFPC2534 &device)
+    : _device{device}, _hook{hookHandler, this, nullptr}, _pending{nullptr}, _timeoutMs{0}
+{
+    _device.addHook(_hook);
+}
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534Async::~sfDevFPC2534Async()
+{
+    _device.removeHook(_hook);
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534Async::begin(sfDevFPC2534AsyncOp &op, std::coroutine_handle<> waiter)
+{
+    if (_pending != nullptr && _pending != &op)
+        return FPC_RESULT_IO_BUSY;
+
+    uint16_t answer = _device.responsesReceived() + _device.responsesPending() + 1;
+    fpc_result_t rc = op.send();
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    // a continuing operation (enroll) keeps its start time - and its request
+    if (_pending == nullptr)
+    {
+        op._startMs = millis();
+        op._answer = answer;
+    }
+
+    op._waiter = waiter;
+    _pending = &op;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Called by the device for every parsed response/event
+//
+void sfDevFPC2534Async::hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size)
+{
+    sfDevFPC2534Async *self = static_cast<sfDevFPC2534Async *>(arg);
+    sfDevFPC2534AsyncOp *op = self->_pending;
+    if (op == nullptr)
+        return;
+
+    // Is this the response to the request of the operation, or an event once it runs? A failure answering a request
+    // sent before (or after) it is not for the operation.
+    int16_t since = (int16_t)(self->_device.responsesReceived() - op->_answer);
+    bool ours = cmd->type == FPC_FRAME_TYPE_CMD_RESPONSE ? since == 0 : since >= 0;
+
+    bool wake = false;
+
+    // A failure status ends the pending operation
+    if (cmd->cmd_id == CMD_STATUS && size == sizeof(fpc_cmd_status_response_t))
+    {
+        if (!ours)
+            return;
+
+        fpc_cmd_status_response_t *status = (fpc_cmd_status_response_t *)cmd;
+        if (status->app_fail_code != 0)
+        {
+            op->complete(status->app_fail_code);
+            wake = true;
+        }
+        else if (status->event == EVENT_CMD_FAILED)
+        {
+            op->complete(FPC_RESULT_FAILURE);
+            wake = true;
+        }
+    }
+    else
+        wake = op->onResponse(cmd, size);
+
+    if (!wake)
+        return;
+
+    // resumed from resume() - not here, deep in the parser
+    self->_ready = op->_waiter;
+    if (op->_done)
+        self->_pending = nullptr;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534Async::poll(void)
+{
+    fpc_result_t rc = _device.processNextResponse();
+    resume();
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Async::resume(void)
+{
+    // timed out?
+    if (_pending != nullptr && !_ready && _timeoutMs > 0 && millis() - _pending->_startMs > _timeoutMs)
+    {
+        sfDevFPC2534AsyncOp *op = _pending;
+        _pending = nullptr;
+        op->complete(FPC_RESULT_TIMEOUT);
+        _ready = op->_waiter;
+
+        // stop the sensor operation
+        _device.requestAbort();
+    }
+
+    if (_ready)
+    {
+        std::coroutine_handle<> waiter = _ready;
+        _ready = nullptr;
+        waiter.resume();
+    }
+}
+
+#endif
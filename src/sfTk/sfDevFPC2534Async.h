@@ -0,0 +1,520 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// C++20 coroutine (awaitable) API for the FPC2534 library.
+//
+// Instead of chaining operations through the on_* callbacks, sensor operations can be awaited in a
+// coroutine, giving sequential code:
+//
+//     sfDevFPC2534Task enrollAndCheck(sfDevFPC2534Async &sensor)
+//     {
+//         auto enroll = sensor.enroll(newId);
+//         while (co_await enroll)
+//             printf("%u samples left\n", enroll.samplesRemaining());
+//
+//         auto result = co_await sensor.identify();
+//         co_return result.rc;
+//     }
+//
+//     enrollAndCheck(sensor).start();
+//     while (true)
+//         sensor.poll();    // or the I/O task + sensor.resume()
+//
+// Operations are sent when awaited. The coroutine is suspended while the sensor works and resumed from
+// poll()/resume() in the application context, so the application keeps running between sensor events.
+//
+// Coroutine frames are allocated from a fixed, static arena (sfDevFPC2534CoArena) - there is no heap
+// allocation. The arena size is set with SFE_FPC2534_CO_FRAME_SIZE and SFE_FPC2534_CO_FRAME_COUNT.
+//
+// Requires a C++20 compiler with coroutine support (ESP32 Arduino 3.x, GCC 10+ with -std=c++20).
+
+#pragma once
+
+#if defined(__has_include)
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#define SFE_FPC2534_HAS_COROUTINES 1
+#endif
+#endif
+
+#if defined(SFE_FPC2534_HAS_COROUTINES)
+
+#include <coroutine>
+
+#include "sfDevFPC2534.h"
+
+// Size of each coroutine frame block in the arena - frames larger than this fail to allocate
+#ifndef SFE_FPC2534_CO_FRAME_SIZE
+#define SFE_FPC2534_CO_FRAME_SIZE 512
+#endif
+
+// Number of coroutine frames that can be alive at once (max 32)
+#ifndef SFE_FPC2534_CO_FRAME_COUNT
+#define SFE_FPC2534_CO_FRAME_COUNT 4
+#endif
+
+class sfDevFPC2534Async;
+
+//--------------------------------------------------------------------------------------------
+// Fixed block arena for coroutine frames. Only used from the application context.
+//
+class sfDevFPC2534CoArena
+{
+  public:
+    static void *allocate(size_t size);
+    static void release(void *ptr);
+
+    // number of frames in use, and the high water marks - for tuning the arena size
+    static uint8_t inUse(void);
+    static uint8_t highWater(void)
+    {
+        return _highWater;
+    }
+    static size_t largestFrame(void)
+    {
+        return _largestFrame;
+    }
+
+  private:
+    alignas(alignof(max_align_t)) static uint8_t _blocks[SFE_FPC2534_CO_FRAME_COUNT][SFE_FPC2534_CO_FRAME_SIZE];
+    static uint32_t _usedMask;
+    static uint8_t _highWater;
+    static size_t _largestFrame;
+};
+
+//--------------------------------------------------------------------------------------------
+// Coroutine return type. A task starts suspended - either start() it from regular code, or co_await
+// it from another task. The result of the task is a fpc_result_t (co_return).
+//
+class sfDevFPC2534Task
+{
+  public:
+    struct promise_type
+    {
+        std::coroutine_handle<> continuation;
+        bool detached = false;
+        fpc_result_t result = FPC_RESULT_OK;
+
+        sfDevFPC2534Task get_return_object() noexcept
+        {
+            return sfDevFPC2534Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        // arena exhausted - the task is returned invalid
+        static sfDevFPC2534Task get_return_object_on_allocation_failure() noexcept
+        {
+            return sfDevFPC2534Task(nullptr);
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        // On completion, continue the awaiting task - or clean up if detached
+        struct final_awaiter
+        {
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+            {
+                promise_type &promise = h.promise();
+                if (promise.continuation)
+                    return promise.continuation;
+                if (promise.detached)
+                    h.destroy();
+                return std::noop_coroutine();
+            }
+            void await_resume() noexcept
+            {
+            }
+        };
+
+        final_awaiter final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_value(fpc_result_t rc) noexcept
+        {
+            result = rc;
+        }
+
+        void unhandled_exception() noexcept
+        {
+            result = FPC_RESULT_FAILURE;
+        }
+
+        static void *operator new(size_t size) noexcept
+        {
+            return sfDevFPC2534CoArena::allocate(size);
+        }
+
+        static void operator delete(void *ptr) noexcept
+        {
+            sfDevFPC2534CoArena::release(ptr);
+        }
+    };
+
+    sfDevFPC2534Task(sfDevFPC2534Task &&other) noexcept : _handle{other._handle}
+    {
+        other._handle = nullptr;
+    }
+    sfDevFPC2534Task(const sfDevFPC2534Task &) = delete;
+    sfDevFPC2534Task &operator=(const sfDevFPC2534Task &) = delete;
+
+    ~sfDevFPC2534Task()
+    {
+        if (_handle)
+            _handle.destroy();
+    }
+
+    /**
+     * @brief Was the coroutine frame allocated?
+     */
+    bool valid(void) const
+    {
+        return (bool)_handle;
+    }
+
+    /**
+     * @brief Run the task detached - it runs until its first suspension, then continues from poll()/resume().
+     * The frame is released when the task completes.
+     *
+     * @return false if the task is not valid (arena exhausted)
+     */
+    bool start(void)
+    {
+        if (!_handle)
+            return false;
+
+        std::coroutine_handle<promise_type> h = _handle;
+        _handle = nullptr;
+        h.promise().detached = true;
+        h.resume();
+        return true;
+    }
+
+    // Awaiting a task from another task
+    bool await_ready(void) const noexcept
+    {
+        return !_handle || _handle.done();
+    }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> waiter) noexcept
+    {
+        _handle.promise().continuation = waiter;
+        return _handle;
+    }
+    fpc_result_t await_resume(void) const noexcept
+    {
+        return _handle ? _handle.promise().result : FPC_RESULT_OUT_OF_MEMORY;
+    }
+
+  private:
+    explicit sfDevFPC2534Task(std::coroutine_handle<promise_type> handle) : _handle{handle}
+    {
+    }
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+//--------------------------------------------------------------------------------------------
+// Base class of the awaitable sensor operations
+//
+class sfDevFPC2534AsyncOp
+{
+  public:
+    // awaitable interface
+    bool await_ready(void) const noexcept
+    {
+        return false;
+    }
+    bool await_suspend(std::coroutine_handle<> waiter);
+
+  protected:
+    friend class sfDevFPC2534Async;
+
+    sfDevFPC2534AsyncOp(sfDevFPC2534Async &async)
+        : _async{async}, _rc{FPC_RESULT_OK}, _startMs{0}, _done{false}, _answer{0}
+    {
+    }
+
+    // send the request to the sensor
+    virtual fpc_result_t send(void) = 0;
+
+    // a response/event arrived - return true if the waiting coroutine should be resumed
+    virtual bool onResponse(fpc_cmd_hdr_t *cmd, size_t size) = 0;
+
+    // finish the operation
+    void complete(fpc_result_t rc)
+    {
+        _rc = rc;
+        _done = true;
+    }
+
+    sfDevFPC2534Async &_async;
+    std::coroutine_handle<> _waiter;
+    fpc_result_t _rc;
+    uint32_t _startMs;
+    bool _done;
+
+    // Number of the response that answers the request (see sfDevFPC2534::responsesReceived())
+    uint16_t _answer;
+};
+
+//--------------------------------------------------------------------------------------------
+// identify()
+typedef struct
+{
+    fpc_result_t rc;
+    bool match;
+    uint16_t id;
+    uint16_t tag;
+} sfDevFPC2534IdentifyResult_t;
+
+class sfDevFPC2534IdentifyOp : public sfDevFPC2534AsyncOp
+{
+  public:
+    sfDevFPC2534IdentifyResult_t await_resume(void) const noexcept
+    {
+        sfDevFPC2534IdentifyResult_t result = _result;
+        result.rc = _rc;
+        return result;
+    }
+
+  private:
+    friend class sfDevFPC2534Async;
+    sfDevFPC2534IdentifyOp(sfDevFPC2534Async &async, fpc_id_type_t id, uint16_t tag)
+        : sfDevFPC2534AsyncOp(async), _id(id), _result{FPC_RESULT_OK, false, 0, tag}
+    {
+    }
+
+    fpc_result_t send(void) override;
+    bool onResponse(fpc_cmd_hdr_t *cmd, size_t size) override;
+
+    fpc_id_type_t _id;
+    sfDevFPC2534IdentifyResult_t _result;
+};
+
+//--------------------------------------------------------------------------------------------
+// enroll() - awaited repeatedly. Each co_await returns true with a progress update, and false once
+// the enrollment is finished (check result()).
+class sfDevFPC2534EnrollOp : public sfDevFPC2534AsyncOp
+{
+  public:
+    bool await_ready(void) const noexcept
+    {
+        return _done;
+    }
+    bool await_resume(void) noexcept
+    {
+        // report the last progress update - unless there is nothing more to report
+        bool progress = _hasProgress;
+        _hasProgress = false;
+        return progress;
+    }
+
+    fpc_result_t result(void) const
+    {
+        return _done ? _rc : FPC_RESULT_WRONG_STATE;
+    }
+    uint8_t feedback(void) const
+    {
+        return _feedback;
+    }
+    uint8_t samplesRemaining(void) const
+    {
+        return _samplesRemaining;
+    }
+    // ID of the template being enrolled
+    uint16_t id(void) const
+    {
+        return _templateId;
+    }
+
+  private:
+    friend class sfDevFPC2534Async;
+    sfDevFPC2534EnrollOp(sfDevFPC2534Async &async, fpc_id_type_t id)
+        : sfDevFPC2534AsyncOp(async), _id(id), _started{false}, _hasProgress{false}, _feedback{0},
+          _samplesRemaining{0}, _templateId{0}
+    {
+    }
+
+    fpc_result_t send(void) override;
+    bool onResponse(fpc_cmd_hdr_t *cmd, size_t size) override;
+
+    fpc_id_type_t _id;
+    bool _started;
+    bool _hasProgress;
+    uint8_t _feedback;
+    uint8_t _samplesRemaining;
+    uint16_t _templateId;
+};
+
+//--------------------------------------------------------------------------------------------
+// getConfig()
+typedef struct
+{
+    fpc_result_t rc;
+    fpc_system_config_t cfg;
+} sfDevFPC2534ConfigResult_t;
+
+class sfDevFPC2534ConfigOp : public sfDevFPC2534AsyncOp
+{
+  public:
+    sfDevFPC2534ConfigResult_t await_resume(void) const noexcept
+    {
+        sfDevFPC2534ConfigResult_t result = _result;
+        result.rc = _rc;
+        return result;
+    }
+
+  private:
+    friend class sfDevFPC2534Async;
+    sfDevFPC2534ConfigOp(sfDevFPC2534Async &async, uint8_t type) : sfDevFPC2534AsyncOp(async), _type{type}, _result{}
+    {
+    }
+
+    fpc_result_t send(void) override;
+    bool onResponse(fpc_cmd_hdr_t *cmd, size_t size) override;
+
+    uint8_t _type;
+    sfDevFPC2534ConfigResult_t _result;
+};
+
+//--------------------------------------------------------------------------------------------
+// listTemplates() - the IDs are copied to the caller provided buffer
+typedef struct
+{
+    fpc_result_t rc;
+    uint16_t count; // number of templates on the sensor - can be more than were copied
+} sfDevFPC2534ListResult_t;
+
+class sfDevFPC2534ListOp : public sfDevFPC2534AsyncOp
+{
+  public:
+    sfDevFPC2534ListResult_t await_resume(void) const noexcept
+    {
+        sfDevFPC2534ListResult_t result = _result;
+        result.rc = _rc;
+        return result;
+    }
+
+  private:
+    friend class sfDevFPC2534Async;
+    sfDevFPC2534ListOp(sfDevFPC2534Async &async, uint16_t *ids, uint16_t maxIds)
+        : sfDevFPC2534AsyncOp(async), _ids{ids}, _maxIds{maxIds}, _result{FPC_RESULT_OK, 0}
+    {
+    }
+
+    fpc_result_t send(void) override;
+    bool onResponse(fpc_cmd_hdr_t *cmd, size_t size) override;
+
+    uint16_t *_ids;
+    uint16_t _maxIds;
+    sfDevFPC2534ListResult_t _result;
+};
+
+//--------------------------------------------------------------------------------------------
+// The async API for a sensor. One operation can be outstanding at a time (the sensor runs one
+// operation at a time) - awaiting another operation while one is pending returns FPC_RESULT_IO_BUSY.
+//
+class sfDevFPC2534Async
+{
+  public:
+    sfDevFPC2534Async(sfDevFPC2534 &device);
+    ~sfDevFPC2534Async();
+
+    /**
+     * @brief Pump the sensor - process the next response and resume the waiting coroutine.
+     *
+     * Works in polled and in I/O task mode. Call regularly from the application loop.
+     *
+     * @return The result of processing the next response
+     */
+    fpc_result_t poll(void);
+
+    /**
+     * @brief Resume the waiting coroutine if its operation progressed, and check for timeouts. Use this if
+     * the responses are already processed elsewhere (e.g. sfDevFPC2534IOTask::dispatch()).
+     */
+    void resume(void);
+
+    /**
+     * @brief Set the operation timeout. On timeout, the operation is aborted and completes with
+     * FPC_RESULT_TIMEOUT. 0 (the default) waits forever.
+     */
+    void setTimeout(uint32_t timeoutMs)
+    {
+        _timeoutMs = timeoutMs;
+    }
+
+    /**
+     * @brief Is an operation pending?
+     */
+    bool busy(void) const
+    {
+        return _pending != nullptr;
+    }
+
+    sfDevFPC2534 &device(void)
+    {
+        return _device;
+    }
+
+    /**
+     * @brief Identify a finger - await the result.
+     */
+    sfDevFPC2534IdentifyOp identify(fpc_id_type_t id = {ID_TYPE_ALL, 0}, uint16_t tag = 0)
+    {
+        return sfDevFPC2534IdentifyOp(*this, id, tag);
+    }
+
+    /**
+     * @brief Enroll a finger - await repeatedly for progress updates. Keep the returned object in a variable.
+     */
+    sfDevFPC2534EnrollOp enroll(fpc_id_type_t id = {ID_TYPE_GENERATE_NEW, 0})
+    {
+        return sfDevFPC2534EnrollOp(*this, id);
+    }
+
+    /**
+     * @brief Get the system configuration - await the result.
+     */
+    sfDevFPC2534ConfigOp getConfig(uint8_t type = FPC_SYS_CFG_TYPE_CUSTOM)
+    {
+        return sfDevFPC2534ConfigOp(*this, type);
+    }
+
+    /**
+     * @brief List the enrolled templates - await the result.
+     */
+    sfDevFPC2534ListOp listTemplates(uint16_t *ids, uint16_t maxIds)
+    {
+        return sfDevFPC2534ListOp(*this, ids, maxIds);
+    }
+
+  private:
+    friend class sfDevFPC2534AsyncOp;
+
+    static void hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size);
+
+    // start an operation - called from await_suspend
+    fpc_result_t begin(sfDevFPC2534AsyncOp &op, std::coroutine_handle<> waiter);
+
+    sfDevFPC2534 &_device;
+    sfDevFPC2534Hook_t _hook;
+    sfDevFPC2534AsyncOp *_pending;
+    std::coroutine_handle<> _ready;
+    uint32_t _timeoutMs;
+};
+
+#endif
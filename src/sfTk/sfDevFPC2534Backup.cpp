@@ -0,0 +1,729 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Implementation of the template backup format, and of backup and restore
+
+#include "sfDevFPC2534Backup.h"
+
+// Size of the backup header
+const size_t kBackupHeaderSize = 16;
+
+// LZSS parameters - 12 bit offsets, 4 bit lengths
+const uint16_t kLzssWindow = 4096;
+const uint16_t kLzssMinMatch = 3;
+const uint16_t kLzssMaxMatch = 18;
+
+//--------------------------------------------------------------------------------------------
+// CRC32 (IEEE 802.3, reflected) - a nibble at a time, with a 16 entry table
+//
+static const uint32_t kCrcTable[16] = {0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+                                       0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+                                       0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+
+uint32_t sfDevFPC2534Crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ kCrcTable[crc & 0x0F];
+        crc = (crc >> 4) ^ kCrcTable[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+//--------------------------------------------------------------------------------------------
+// Little endian values
+//
+static void putLE16(uint8_t *p, uint16_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+static void putLE32(uint8_t *p, uint32_t value)
+{
+    putLE16(p, value & 0xFFFF);
+    putLE16(p + 2, value >> 16);
+}
+
+static uint16_t getLE16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t getLE32(const uint8_t *p)
+{
+    return getLE16(p) | ((uint32_t)getLE16(p + 2) << 16);
+}
+
+//--------------------------------------------------------------------------------------------
+// LZSS compress a block - a flag byte for each 8 items, then the items: a literal byte (flag bit 0), or a match
+// (flag bit 1) of 2 bytes - offset - 1 (12 bits), length - 3 (4 bits).
+//
+// Returns the compressed size - 0 if it does not fit in outMax
+//
+static uint16_t lzssCompress(const uint8_t *in, uint16_t len, uint8_t *out, uint16_t outMax)
+{
+    uint16_t i = 0, o = 0;
+    uint16_t flagPos = 0;
+    uint8_t bit = 8;
+
+    while (i < len)
+    {
+        if (bit == 8)
+        {
+            if (o >= outMax)
+                return 0;
+            flagPos = o++;
+            out[flagPos] = 0;
+            bit = 0;
+        }
+
+        // The longest match in the window - a match may run into the bytes it copies
+        uint16_t bestLen = 0, bestOffset = 0;
+        uint16_t maxLen = len - i < kLzssMaxMatch ? len - i : kLzssMaxMatch;
+        for (uint16_t j = i > kLzssWindow ? i - kLzssWindow : 0; j < i && bestLen < maxLen; j++)
+        {
+            uint16_t n = 0;
+            while (n < maxLen && in[j + n] == in[i + n])
+                n++;
+            if (n > bestLen)
+            {
+                bestLen = n;
+                bestOffset = i - j;
+            }
+        }
+
+        if (bestLen >= kLzssMinMatch)
+        {
+            if (o + 2 > outMax)
+                return 0;
+            out[flagPos] |= 1 << bit;
+            out[o++] = (bestOffset - 1) & 0xFF;
+            out[o++] = (((bestOffset - 1) >> 8) << 4) | (bestLen - kLzssMinMatch);
+            i += bestLen;
+        }
+        else
+        {
+            if (o >= outMax)
+                return 0;
+            out[o++] = in[i++];
+        }
+        bit++;
+    }
+    return o;
+}
+
+//--------------------------------------------------------------------------------------------
+// LZSS decompress a block - returns the decompressed size, 0 if the data is not valid or does not fit in outMax
+//
+static uint16_t lzssDecompress(const uint8_t *in, uint16_t len, uint8_t *out, uint16_t outMax)
+{
+    uint16_t i = 0, o = 0;
+    uint8_t flags = 0, bit = 8;
+
+    while (i < len)
+    {
+        if (bit == 8)
+        {
+            flags = in[i++];
+            bit = 0;
+            if (i >= len)
+                return 0;
+        }
+
+        if ((flags & (1 << bit)) != 0)
+        {
+            if (i + 2 > len)
+                return 0;
+
+            uint16_t offset = (in[i] | ((in[i + 1] >> 4) << 8)) + 1;
+            uint16_t n = (in[i + 1] & 0x0F) + kLzssMinMatch;
+            i += 2;
+
+            if (offset > o || o + n > outMax)
+                return 0;
+            for (; n > 0; n--, o++)
+                out[o] = out[o - offset];
+        }
+        else
+        {
+            if (o >= outMax)
+                return 0;
+            out[o++] = in[i++];
+        }
+        bit++;
+    }
+    return o;
+}
+
+#if defined(ESP32)
+//--------------------------------------------------------------------------------------------
+// ESP32 partition storage
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534BackupPartition::begin(const char *label)
+{
+    _partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    rewind();
+    return _partition != nullptr;
+}
+
+//--------------------------------------------------------------------------------------------
+size_t sfDevFPC2534BackupPartition::write(const uint8_t *data, size_t len)
+{
+    if (_partition == nullptr || _offset + len > _partition->size)
+        return 0;
+
+    // Erase the sectors the write reaches into
+    if (_offset + len > _erased)
+    {
+        uint32_t end = (_offset + len + SPI_FLASH_SEC_SIZE - 1) / SPI_FLASH_SEC_SIZE * SPI_FLASH_SEC_SIZE;
+        if (end > _partition->size || esp_partition_erase_range(_partition, _erased, end - _erased) != ESP_OK)
+            return 0;
+        _erased = end;
+    }
+
+    if (esp_partition_write(_partition, _offset, data, len) != ESP_OK)
+        return 0;
+
+    _offset += len;
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------
+size_t sfDevFPC2534BackupPartition::read(uint8_t *data, size_t len)
+{
+    if (_partition == nullptr || _offset + len > _partition->size)
+        return 0;
+
+    if (esp_partition_read(_partition, _offset, data, len) != ESP_OK)
+        return 0;
+
+    _offset += len;
+    return len;
+}
+#endif
+
+//--------------------------------------------------------------------------------------------
+// Backup writer
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534BackupWriter::sfDevFPC2534BackupWriter()
+    : _storage{nullptr}, _compress{false}, _count{0}, _written{0}, _inTemplate{false}, _size{0}, _remaining{0},
+      _crc{0}, _bytesIn{0}, _bytesOut{0}
+{
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534BackupWriter::put(const void *data, size_t len)
+{
+    if (_storage->write((const uint8_t *)data, len) != len)
+        return FPC_RESULT_FAILURE;
+
+    _bytesOut += len;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534BackupWriter::begin(sfDevFPC2534BackupStorage &storage, uint16_t count, bool compress)
+{
+    _storage = &storage;
+    _compress = compress;
+    _count = count;
+    _written = 0;
+    _inTemplate = false;
+    _bytesIn = 0;
+    _bytesOut = 0;
+
+    uint8_t header[kBackupHeaderSize];
+    putLE32(header, kFPC2534BackupMagic);
+    header[4] = kFPC2534BackupVersion;
+    header[5] = compress ? kFPC2534BackupFlagCompressed : 0;
+    putLE16(header + 6, count);
+    putLE16(header + 8, SFE_FPC2534_XFER_CHUNK_SIZE);
+    putLE16(header + 10, 0);
+    putLE32(header + 12, sfDevFPC2534Crc32(0, header, 12));
+
+    return put(header, sizeof(header));
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534BackupWriter::beginTemplate(uint16_t id, uint16_t size)
+{
+    if (_storage == nullptr || _inTemplate || _written >= _count)
+        return FPC_RESULT_WRONG_STATE;
+
+    if (size == 0)
+        return FPC_RESULT_INVALID_PARAM;
+
+    uint8_t record[4];
+    putLE16(record, id);
+    putLE16(record + 2, size);
+
+    _inTemplate = true;
+    _size = size;
+    _remaining = size;
+    _crc = 0;
+
+    return put(record, sizeof(record));
+}
+
+//--------------------------------------------------------------------------------------------
+// A block - compressed if that makes it smaller
+//
+fpc_result_t sfDevFPC2534BackupWriter::writeBlock(const uint8_t *data, uint16_t len)
+{
+    uint8_t length[2];
+
+    _crc = sfDevFPC2534Crc32(_crc, data, len);
+    _bytesIn += len;
+
+    if (_compress)
+    {
+        uint8_t packed[SFE_FPC2534_XFER_CHUNK_SIZE];
+        uint16_t packedLen = lzssCompress(data, len, packed, len - 1);
+        if (packedLen > 0)
+        {
+            putLE16(length, packedLen | kFPC2534BackupBlockCompressed);
+            fpc_result_t rc = put(length, sizeof(length));
+            return rc != FPC_RESULT_OK ? rc : put(packed, packedLen);
+        }
+    }
+
+    putLE16(length, len);
+    fpc_result_t rc = put(length, sizeof(length));
+    return rc != FPC_RESULT_OK ? rc : put(data, len);
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534BackupWriter::write(const uint8_t *data, uint16_t len)
+{
+    if (!_inTemplate)
+        return FPC_RESULT_WRONG_STATE;
+
+    if (len > _remaining)
+        return FPC_RESULT_INVALID_PARAM;
+
+    while (len > 0)
+    {
+        uint16_t n = len < SFE_FPC2534_XFER_CHUNK_SIZE ? len : SFE_FPC2534_XFER_CHUNK_SIZE;
+        fpc_result_t rc = writeBlock(data, n);
+        if (rc != FPC_RESULT_OK)
+            return rc;
+
+        data += n;
+        len -= n;
+        _remaining -= n;
+    }
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534BackupWriter::endTemplate(void)
+{
+    if (!_inTemplate)
+        return FPC_RESULT_WRONG_STATE;
+
+    if (_remaining != 0)
+        return FPC_RESULT_INVALID_PARAM;
+
+    // the terminating 0 length block, and the CRC
+    uint8_t trailer[6];
+    putLE16(trailer, 0);
+    putLE32(trailer + 2, _crc);
+
+    _inTemplate = false;
+    _written++;
+
+    return put(trailer, sizeof(trailer));
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534BackupWriter::end(void)
+{
+    if (_storage == nullptr || _inTemplate)
+        return FPC_RESULT_WRONG_STATE;
+
+    _storage = nullptr;
+    return _written == _count ? FPC_RESULT_OK : FPC_RESULT_INVALID_PARAM;
+}
+
+//--------------------------------------------------------------------------------------------
+// Backup reader
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534BackupReader::sfDevFPC2534BackupReader()
+    : _storage{nullptr}, _count{0}, _read{0}, _inTemplate{false}, _size{0}, _remaining{0}, _crc{0},
+      _error{FPC_RESULT_OK}, _bytesIn{0}, _block{}, _blockLen{0}, _blockPos{0}
+{
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534BackupReader::get(void *data, size_t len)
+{
+    if (_storage->read((uint8_t *)data, len) != len)
+        return FPC_RESULT_IO_BAD_DATA;
+
+    _bytesIn += len;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534BackupReader::begin(sfDevFPC2534BackupStorage &storage)
+{
+    _storage = &storage;
+    _count = 0;
+    _read = 0;
+    _inTemplate = false;
+    _error = FPC_RESULT_OK;
+    _bytesIn = 0;
+
+    uint8_t header[kBackupHeaderSize];
+    fpc_result_t rc = get(header, sizeof(header));
+    if (rc == FPC_RESULT_OK &&
+        (getLE32(header) != kFPC2534BackupMagic || getLE32(header + 12) != sfDevFPC2534Crc32(0, header, 12)))
+        rc = FPC_RESULT_IO_BAD_DATA;
+    else if (rc == FPC_RESULT_OK && (header[4] != kFPC2534BackupVersion || getLE16(header + 8) == 0 ||
+                                     getLE16(header + 8) > SFE_FPC2534_XFER_CHUNK_SIZE))
+        rc = FPC_RESULT_NOT_SUPPORTED;
+
+    if (rc != FPC_RESULT_OK)
+    {
+        _storage = nullptr;
+        return _error = rc;
+    }
+
+    _count = getLE16(header + 6);
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534BackupReader::nextTemplate(uint16_t &id, uint16_t &size)
+{
+    if (_storage == nullptr || _inTemplate || _read >= _count)
+        return FPC_RESULT_WRONG_STATE;
+
+    uint8_t record[4];
+    fpc_result_t rc = get(record, sizeof(record));
+    if (rc == FPC_RESULT_OK && getLE16(record + 2) == 0)
+        rc = FPC_RESULT_IO_BAD_DATA;
+    if (rc != FPC_RESULT_OK)
+        return _error = rc;
+
+    id = getLE16(record);
+    size = getLE16(record + 2);
+
+    _inTemplate = true;
+    _read++;
+    _size = size;
+    _remaining = size;
+    _crc = 0;
+    _blockLen = 0;
+    _blockPos = 0;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Read the next block into the block buffer - decompressed
+//
+fpc_result_t sfDevFPC2534BackupReader::readBlock(void)
+{
+    uint8_t length[2];
+    fpc_result_t rc = get(length, sizeof(length));
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    uint16_t len = getLE16(length) & ~kFPC2534BackupBlockCompressed;
+    uint16_t maxLen = _remaining < sizeof(_block) ? _remaining : sizeof(_block);
+
+    if (len == 0 || len > sizeof(_block))
+        return FPC_RESULT_IO_BAD_DATA;
+
+    if ((getLE16(length) & kFPC2534BackupBlockCompressed) == 0)
+    {
+        if (len > maxLen)
+            return FPC_RESULT_IO_BAD_DATA;
+        rc = get(_block, len);
+    }
+    else
+    {
+        uint8_t packed[SFE_FPC2534_XFER_CHUNK_SIZE];
+        rc = get(packed, len);
+        if (rc == FPC_RESULT_OK)
+        {
+            len = lzssDecompress(packed, len, _block, maxLen);
+            if (len == 0)
+                rc = FPC_RESULT_IO_BAD_DATA;
+        }
+    }
+
+    _blockLen = rc == FPC_RESULT_OK ? len : 0;
+    _blockPos = 0;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// The end of a template - the terminating block, and the CRC
+//
+fpc_result_t sfDevFPC2534BackupReader::endTemplate(void)
+{
+    _inTemplate = false;
+
+    uint8_t trailer[6];
+    fpc_result_t rc = get(trailer, sizeof(trailer));
+    if (rc == FPC_RESULT_OK && (getLE16(trailer) != 0 || getLE32(trailer + 2) != _crc))
+        rc = FPC_RESULT_IO_BAD_DATA;
+
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+uint16_t sfDevFPC2534BackupReader::read(uint8_t *data, uint16_t len)
+{
+    if (!_inTemplate)
+    {
+        _error = FPC_RESULT_WRONG_STATE;
+        return 0;
+    }
+
+    uint16_t n = 0;
+    while (n < len && _remaining > 0)
+    {
+        if (_blockPos == _blockLen)
+        {
+            fpc_result_t rc = readBlock();
+            if (rc != FPC_RESULT_OK)
+            {
+                _inTemplate = false;
+                _error = rc;
+                return n;
+            }
+        }
+
+        uint16_t copy = _blockLen - _blockPos;
+        if (copy > len - n)
+            copy = len - n;
+
+        memcpy(data + n, _block + _blockPos, copy);
+        _crc = sfDevFPC2534Crc32(_crc, _block + _blockPos, copy);
+        _blockPos += copy;
+        _remaining -= copy;
+        n += copy;
+    }
+
+    // The end of the template - the data is only good if the CRC matches
+    if (_remaining == 0 && _blockPos == _blockLen)
+    {
+        fpc_result_t rc = endTemplate();
+        if (rc != FPC_RESULT_OK)
+        {
+            _error = rc;
+            return 0;
+        }
+    }
+    return n;
+}
+
+//--------------------------------------------------------------------------------------------
+// Backup and restore
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534TemplateBackup::sfDevFPC2534TemplateBackup()
+    : _device{nullptr}, _hook{hookHandler, this, nullptr}, _id{0}, _listed{false}, _stats{}
+{
+}
+
+//--------------------------------------------------------------------------------------------
+// Called by the device for each parsed frame - flags the template list response
+//
+void sfDevFPC2534TemplateBackup::hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size)
+{
+    sfDevFPC2534TemplateBackup *self = static_cast<sfDevFPC2534TemplateBackup *>(arg);
+
+    if (cmd->cmd_id == CMD_LIST_TEMPLATES)
+        self->_listed = true;
+}
+
+//--------------------------------------------------------------------------------------------
+// Request the template list - the template index of the device is rebuilt from it
+//
+fpc_result_t sfDevFPC2534TemplateBackup::listTemplates(uint32_t timeoutMs)
+{
+    _listed = false;
+    _device->addHook(_hook);
+
+    fpc_result_t rc = _device->requestListTemplates();
+
+    uint32_t start = millis();
+    while (rc == FPC_RESULT_OK && !_listed)
+    {
+        if (millis() - start >= timeoutMs)
+            rc = FPC_RESULT_TIMEOUT;
+        else
+            _device->waitForEvent(50);
+    }
+
+    _device->removeHook(_hook);
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// Run the transfer until it is done - the timeout restarts each time the transfer moves along. On a failure, the
+// sensor is sent an abort - it drops the transfer.
+//
+fpc_result_t sfDevFPC2534TemplateBackup::waitForTransfer(uint32_t timeoutMs)
+{
+    uint32_t progress = _device->transferProgress();
+    uint32_t lastMs = millis();
+
+    while (_device->isTransferActive())
+    {
+        _device->waitForEvent(50);
+
+        if (_device->transferProgress() != progress)
+        {
+            progress = _device->transferProgress();
+            lastMs = millis();
+        }
+        else if (millis() - lastMs >= timeoutMs)
+        {
+            _device->abortTransfer();
+            return FPC_RESULT_TIMEOUT;
+        }
+    }
+
+    fpc_result_t rc = _device->transferResult();
+    if (rc != FPC_RESULT_OK)
+        _device->requestAbort();
+
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// Writer of a template read from the sensor - into the backup
+//
+uint16_t sfDevFPC2534TemplateBackup::writeChunk(void *arg, uint32_t offset, const uint8_t *data, uint16_t len)
+{
+    sfDevFPC2534TemplateBackup *self = static_cast<sfDevFPC2534TemplateBackup *>(arg);
+    uint32_t size = self->_device->transferSize();
+
+    if (offset == 0 && self->_writer.beginTemplate(self->_id, size) != FPC_RESULT_OK)
+        return 0;
+
+    if (self->_writer.write(data, len) != FPC_RESULT_OK)
+        return 0;
+
+    if (offset + len == size && self->_writer.endTemplate() != FPC_RESULT_OK)
+        return 0;
+
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------
+// Reader of a template sent to the sensor - from the backup, in order
+//
+uint16_t sfDevFPC2534TemplateBackup::readChunk(void *arg, uint32_t offset, uint8_t *data, uint16_t len)
+{
+    sfDevFPC2534TemplateBackup *self = static_cast<sfDevFPC2534TemplateBackup *>(arg);
+
+    if (offset != self->_reader.position())
+        return 0;
+
+    return self->_reader.read(data, len);
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534TemplateBackup::backup(sfDevFPC2534 &device, sfDevFPC2534BackupStorage &storage,
+                                                const uint16_t *ids, uint16_t count, bool compress,
+                                                uint32_t timeoutMs)
+{
+    if (device.isTransferActive())
+        return FPC_RESULT_WRONG_STATE;
+
+    _device = &device;
+    memset(&_stats, 0, sizeof(_stats));
+    uint32_t start = millis();
+
+    // All the templates on the sensor - from its template list
+    fpc_result_t rc = FPC_RESULT_OK;
+    if (ids == nullptr)
+    {
+        rc = listTemplates(timeoutMs);
+        count = device.templateCount();
+    }
+
+    if (rc == FPC_RESULT_OK)
+        rc = _writer.begin(storage, count, compress);
+
+    uint16_t next = 0; // the next ID to check in the template index
+    for (uint16_t i = 0; i < count && rc == FPC_RESULT_OK; i++)
+    {
+        if (ids != nullptr)
+            _id = ids[i];
+        else
+        {
+            while (next < SFE_FPC2534_MAX_TEMPLATE_ID && !device.hasTemplate(next))
+                next++;
+            _id = next++;
+        }
+
+        rc = device.requestGetTemplateData(_id, writeChunk, this);
+        if (rc == FPC_RESULT_OK)
+            rc = waitForTransfer(timeoutMs);
+
+        if (rc == FPC_RESULT_OK)
+        {
+            _stats.templates++;
+            _stats.bytes += device.transferSize();
+        }
+    }
+
+    if (rc == FPC_RESULT_OK)
+        rc = _writer.end();
+
+    _stats.stored = _writer.bytesOut();
+    _stats.elapsedMs = millis() - start;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534TemplateBackup::restore(sfDevFPC2534 &device, sfDevFPC2534BackupStorage &storage,
+                                                 uint32_t timeoutMs)
+{
+    if (device.isTransferActive())
+        return FPC_RESULT_WRONG_STATE;
+
+    _device = &device;
+    memset(&_stats, 0, sizeof(_stats));
+    uint32_t start = millis();
+
+    fpc_result_t rc = _reader.begin(storage);
+    for (uint16_t i = 0; i < _reader.count() && rc == FPC_RESULT_OK; i++)
+    {
+        uint16_t size;
+        rc = _reader.nextTemplate(_id, size);
+        if (rc == FPC_RESULT_OK)
+            rc = device.requestPutTemplateData(_id, size, readChunk, this);
+        if (rc == FPC_RESULT_OK)
+            rc = waitForTransfer(timeoutMs);
+
+        // A corrupt backup fails the transfer - report why
+        if (rc != FPC_RESULT_OK && _reader.lastError() != FPC_RESULT_OK)
+            rc = _reader.lastError();
+
+        if (rc == FPC_RESULT_OK)
+        {
+            _stats.templates++;
+            _stats.bytes += size;
+        }
+    }
+
+    _stats.stored = _reader.bytesIn();
+    _stats.elapsedMs = millis() - start;
+    return rc;
+}
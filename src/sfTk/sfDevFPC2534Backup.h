@@ -0,0 +1,375 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Template backup for the FPC2534 library.
+//
+// The templates of a sensor are read (template GET transfers) into a backup - a file on LittleFS or SD, an ESP32
+// flash partition, or a plain file on a Linux host - and restored to the same, or a replacement, sensor (template
+// PUT transfers). Backups and restores stream one chunk at a time - a whole template is never held in memory, and
+// a restore is one pass through the backup.
+//
+// Format (version 1) - all values little endian:
+//
+//   header    magic "FPCB" (u32), version (u8), flags (u8), template count (u16), max block size (u16),
+//             reserved (u16), CRC32 of the preceding fields (u32)                                    - 16 bytes
+//   template  ID (u16), size (u16), blocks, a 0 length block (u16), CRC32 of the template data (u32)
+//   block     length (u16) and data - with bit 15 of the length set, the data is LZSS compressed
+//
+// A block holds up to max block size bytes of the template (SFE_FPC2534_XFER_CHUNK_SIZE when written). Each block
+// is compressed on its own (LZSS - 4 KB window, 3 to 18 byte matches), and stored as is when compression does not
+// make it smaller. The CRC32 (IEEE 802.3) of a template is checked on restore before its last chunk is sent, so a
+// corrupt template is never stored on the sensor.
+
+#pragma once
+
+#include "sfDevFPC2534.h"
+
+#if defined(SFE_FPC2534_LINUX_HOST)
+#include <stdio.h>
+#endif
+
+#if defined(ESP32)
+#include "esp_partition.h"
+#endif
+
+// Backup format
+const uint32_t kFPC2534BackupMagic = 0x42435046; // "FPCB"
+const uint8_t kFPC2534BackupVersion = 1;
+const uint8_t kFPC2534BackupFlagCompressed = 0x01;
+const uint16_t kFPC2534BackupBlockCompressed = 0x8000;
+
+// CRC32 (IEEE 802.3) of data - continued from crc (0 to start)
+uint32_t sfDevFPC2534Crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+//--------------------------------------------------------------------------------------------
+// Where a backup is kept - written and read in order, in chunks
+class sfDevFPC2534BackupStorage
+{
+  public:
+    // Write len bytes - returns the bytes written
+    virtual size_t write(const uint8_t *data, size_t len) = 0;
+
+    // Read len bytes - returns the bytes read
+    virtual size_t read(uint8_t *data, size_t len) = 0;
+};
+
+#if defined(ARDUINO)
+//--------------------------------------------------------------------------------------------
+// Backup storage on a stream - a File of LittleFS, SD, SPIFFS ...
+class sfDevFPC2534BackupStream : public sfDevFPC2534BackupStorage
+{
+  public:
+    sfDevFPC2534BackupStream(Stream &stream) : _stream{stream}
+    {
+    }
+
+    size_t write(const uint8_t *data, size_t len)
+    {
+        return _stream.write(data, len);
+    }
+
+    size_t read(uint8_t *data, size_t len)
+    {
+        return _stream.readBytes(data, len);
+    }
+
+  private:
+    Stream &_stream;
+};
+#endif
+
+#if defined(ESP32)
+//--------------------------------------------------------------------------------------------
+// Backup storage in an ESP32 flash data partition - the flash is erased a sector at a time, as it is written
+class sfDevFPC2534BackupPartition : public sfDevFPC2534BackupStorage
+{
+  public:
+    sfDevFPC2534BackupPartition() : _partition{nullptr}, _offset{0}, _erased{0}
+    {
+    }
+
+    /**
+     * @brief Use the data partition with the given label - reads and writes start at the start of the partition
+     *
+     * @param label The label of the partition (partitions.csv)
+     * @return true if the partition is found
+     */
+    bool begin(const char *label);
+
+    /**
+     * @brief Start over - at the start of the partition
+     */
+    void rewind(void)
+    {
+        _offset = 0;
+        _erased = 0;
+    }
+
+    size_t write(const uint8_t *data, size_t len);
+    size_t read(uint8_t *data, size_t len);
+
+  private:
+    const esp_partition_t *_partition;
+    uint32_t _offset;
+    uint32_t _erased; // erased up to here
+};
+#endif
+
+#if defined(SFE_FPC2534_LINUX_HOST)
+//--------------------------------------------------------------------------------------------
+// Backup storage in a file - on a Linux host
+class sfDevFPC2534BackupFile : public sfDevFPC2534BackupStorage
+{
+  public:
+    sfDevFPC2534BackupFile(FILE *file) : _file{file}
+    {
+    }
+
+    size_t write(const uint8_t *data, size_t len)
+    {
+        return fwrite(data, 1, len, _file);
+    }
+
+    size_t read(uint8_t *data, size_t len)
+    {
+        return fread(data, 1, len, _file);
+    }
+
+  private:
+    FILE *_file;
+};
+#endif
+
+//--------------------------------------------------------------------------------------------
+// Writes the backup format - a template at a time, in chunks
+class sfDevFPC2534BackupWriter
+{
+  public:
+    sfDevFPC2534BackupWriter();
+
+    /**
+     * @brief Start a backup - writes the header
+     *
+     * @param storage Where to write the backup
+     * @param count The number of templates the backup will hold
+     * @param compress Compress the templates (LZSS)
+     * @return Result Code
+     */
+    fpc_result_t begin(sfDevFPC2534BackupStorage &storage, uint16_t count, bool compress = true);
+
+    /**
+     * @brief Start a template
+     *
+     * @param id Template ID
+     * @param size Size of the template - exactly this many bytes must be written
+     * @return Result Code
+     */
+    fpc_result_t beginTemplate(uint16_t id, uint16_t size);
+
+    /**
+     * @brief Write the next part of the template - a block for each SFE_FPC2534_XFER_CHUNK_SIZE bytes
+     *
+     * @return Result Code
+     */
+    fpc_result_t write(const uint8_t *data, uint16_t len);
+
+    /**
+     * @brief End the template - writes its CRC
+     *
+     * @return Result Code - FPC_RESULT_INVALID_PARAM if the size of the template was not written
+     */
+    fpc_result_t endTemplate(void);
+
+    /**
+     * @brief End the backup
+     *
+     * @return Result Code - FPC_RESULT_INVALID_PARAM if the number of templates given to begin() was not written
+     */
+    fpc_result_t end(void);
+
+    // Template bytes written, and bytes stored (with the format overhead)
+    uint32_t bytesIn(void) const
+    {
+        return _bytesIn;
+    }
+    uint32_t bytesOut(void) const
+    {
+        return _bytesOut;
+    }
+
+  private:
+    fpc_result_t put(const void *data, size_t len);
+    fpc_result_t writeBlock(const uint8_t *data, uint16_t len);
+
+    sfDevFPC2534BackupStorage *_storage;
+    bool _compress;
+    uint16_t _count;   // templates in the backup
+    uint16_t _written; // templates written
+    bool _inTemplate;
+    uint16_t _size;      // of the template
+    uint16_t _remaining; // of the template
+    uint32_t _crc;
+    uint32_t _bytesIn;
+    uint32_t _bytesOut;
+};
+
+//--------------------------------------------------------------------------------------------
+// Reads the backup format - a template at a time, in chunks
+class sfDevFPC2534BackupReader
+{
+  public:
+    sfDevFPC2534BackupReader();
+
+    /**
+     * @brief Start reading a backup - reads and checks the header
+     *
+     * @param storage The backup
+     * @return Result Code - FPC_RESULT_IO_BAD_DATA if not a valid backup, FPC_RESULT_NOT_SUPPORTED if its version or
+     * block size is not supported
+     */
+    fpc_result_t begin(sfDevFPC2534BackupStorage &storage);
+
+    /**
+     * @brief Number of templates in the backup
+     */
+    uint16_t count(void) const
+    {
+        return _count;
+    }
+
+    /**
+     * @brief Start reading the next template
+     *
+     * @param id Set to the template ID
+     * @param size Set to the size of the template
+     * @return Result Code - FPC_RESULT_WRONG_STATE if there are no more templates, or the previous template was
+     * not read to its end
+     */
+    fpc_result_t nextTemplate(uint16_t &id, uint16_t &size);
+
+    /**
+     * @brief Read the next part of the template. With the end of the template, its CRC is checked.
+     *
+     * @return The bytes read - less than len on an error (see lastError()), or at the end of the template
+     */
+    uint16_t read(uint8_t *data, uint16_t len);
+
+    /**
+     * @brief Bytes of the template read so far
+     */
+    uint16_t position(void) const
+    {
+        return _size - _remaining;
+    }
+
+    /**
+     * @brief The error that stopped the read - FPC_RESULT_IO_BAD_DATA for a corrupt backup (CRC mismatch)
+     */
+    fpc_result_t lastError(void) const
+    {
+        return _error;
+    }
+
+    // Backup bytes read (with the format overhead)
+    uint32_t bytesIn(void) const
+    {
+        return _bytesIn;
+    }
+
+  private:
+    fpc_result_t get(void *data, size_t len);
+    fpc_result_t readBlock(void);
+    fpc_result_t endTemplate(void);
+
+    sfDevFPC2534BackupStorage *_storage;
+    uint16_t _count;
+    uint16_t _read; // templates started
+    bool _inTemplate;
+    uint16_t _size;
+    uint16_t _remaining;
+    uint32_t _crc;
+    fpc_result_t _error;
+    uint32_t _bytesIn;
+
+    // The current block - decompressed
+    uint8_t _block[SFE_FPC2534_XFER_CHUNK_SIZE];
+    uint16_t _blockLen;
+    uint16_t _blockPos;
+};
+
+//--------------------------------------------------------------------------------------------
+// Statistics of a backup or restore
+typedef struct
+{
+    uint16_t templates; // templates backed up or restored
+    uint32_t bytes;     // template bytes
+    uint32_t stored;    // backup bytes, with the format overhead
+    uint32_t elapsedMs;
+} sfDevFPC2534BackupStats_t;
+
+//--------------------------------------------------------------------------------------------
+// Backup and restore of the templates of a sensor
+class sfDevFPC2534TemplateBackup
+{
+  public:
+    sfDevFPC2534TemplateBackup();
+
+    /**
+     * @brief Back up templates of the sensor - each template is read from the sensor, and written to the storage,
+     * in chunks. Runs until done (or failed) - the sensor must be idle.
+     *
+     * @param device The sensor
+     * @param storage Where to write the backup
+     * @param ids The IDs of the templates to back up - nullptr for all the templates on the sensor (its template
+     * list is requested; IDs up to SFE_FPC2534_MAX_TEMPLATE_ID)
+     * @param count The number of IDs
+     * @param compress Compress the templates (LZSS)
+     * @param timeoutMs The maximum time for each template (or the template list) with no progress
+     * @return Result Code - the backup is incomplete on an error
+     */
+    fpc_result_t backup(sfDevFPC2534 &device, sfDevFPC2534BackupStorage &storage, const uint16_t *ids = nullptr,
+                        uint16_t count = 0, bool compress = true, uint32_t timeoutMs = 2000);
+
+    /**
+     * @brief Restore a backup to the sensor - in one pass through the backup, each template is read and sent to
+     * the sensor in chunks. Runs until done (or failed) - the sensor must be idle.
+     *
+     * @param device The sensor
+     * @param storage The backup
+     * @param timeoutMs The maximum time for each template with no progress
+     * @return Result Code - FPC_RESULT_IO_BAD_DATA if the backup is corrupt (the template is not stored)
+     */
+    fpc_result_t restore(sfDevFPC2534 &device, sfDevFPC2534BackupStorage &storage, uint32_t timeoutMs = 2000);
+
+    /**
+     * @brief Statistics of the last backup or restore
+     */
+    void getStats(sfDevFPC2534BackupStats_t &stats) const
+    {
+        stats = _stats;
+    }
+
+  private:
+    // Run the transfer of the device until it is done - restart the timeout on progress
+    fpc_result_t waitForTransfer(uint32_t timeoutMs);
+    fpc_result_t listTemplates(uint32_t timeoutMs);
+
+    static uint16_t writeChunk(void *arg, uint32_t offset, const uint8_t *data, uint16_t len);
+    static uint16_t readChunk(void *arg, uint32_t offset, uint8_t *data, uint16_t len);
+    static void hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size);
+
+    sfDevFPC2534 *_device;
+    sfDevFPC2534Hook_t _hook;
+    uint16_t _id; // template being transferred
+    bool _listed;
+    sfDevFPC2534BackupWriter _writer;
+    sfDevFPC2534BackupReader _reader;
+    sfDevFPC2534BackupStats_t _stats;
+};
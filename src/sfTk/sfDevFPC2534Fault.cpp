@@ -0,0 +1,293 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Implementation of the fault injection transport
+
+#include "sfDevFPC2534Fault.h"
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534FaultComm::sfDevFPC2534FaultComm(sfDevFPC2534IComm &inner)
+    : _inner{&inner}, _device{nullptr}, _hook{hookHandler, this, nullptr}, _config{0}, _enabled{true}, _random{0},
+      _irqHeld{false}, _irqSeen{false}, _irqReleaseMs{0}, _splitPending{false}, _faulted{false}, _faultedAtUs{0},
+      _stats{0}
+{
+}
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534FaultComm::~sfDevFPC2534FaultComm()
+{
+    detach();
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534FaultComm::setConfig(const sfDevFPC2534FaultConfig_t &config)
+{
+    _config = config;
+
+    // a sequence per fault - spread the seed (never 0)
+    for (uint8_t i = 0; i < kFPC2534FaultCount; i++)
+    {
+        uint32_t seed = (config.seed != 0 ? config.seed : 1) * 0x9E3779B1u + i * 0x85EBCA6Bu;
+        _random[i] = seed != 0 ? seed : 1;
+    }
+    _irqHeld = false;
+    _splitPending = false;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534FaultComm::attach(sfDevFPC2534 &device)
+{
+    detach();
+    _device = &device;
+    _device->addHook(_hook);
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534FaultComm::detach(void)
+{
+    if (_device == nullptr)
+        return;
+
+    _device->removeHook(_hook);
+    _device = nullptr;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534FaultComm::resetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+    _faulted = false;
+}
+
+//--------------------------------------------------------------------------------------------
+// xorshift32 - a fixed sequence for a seed
+//
+uint32_t sfDevFPC2534FaultComm::nextRandom(sfDevFPC2534Fault_t fault)
+{
+    uint32_t &x = _random[fault];
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534FaultComm::inject(sfDevFPC2534Fault_t fault)
+{
+    if (!_enabled || _config.rate[fault] == 0)
+        return false;
+
+    // draw for every opportunity
+    if (nextRandom(fault) % kFPC2534FaultRateScale >= _config.rate[fault])
+        return false;
+
+    _stats.injected[fault]++;
+
+    // a spurious IRQ costs a read, the link is not disrupted
+    if (!_faulted && fault != kFPC2534FaultSpuriousIRQ)
+    {
+        _faulted = true;
+        _faultedAtUs = micros();
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+// A frame was parsed by the library - the link is healthy again
+//
+void sfDevFPC2534FaultComm::hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size)
+{
+    (void)cmd;
+    (void)size;
+    sfDevFPC2534FaultComm *self = static_cast<sfDevFPC2534FaultComm *>(arg);
+
+    self->_stats.framesParsed++;
+    if (!self->_faulted)
+        return;
+
+    self->_faulted = false;
+    uint32_t recoveryUs = micros() - self->_faultedAtUs;
+    self->_stats.recoveries++;
+    self->_stats.lastRecoveryUs = recoveryUs;
+    self->_stats.totalRecoveryUs += recoveryUs;
+    if (recoveryUs > self->_stats.maxRecoveryUs)
+        self->_stats.maxRecoveryUs = recoveryUs;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534FaultComm::dataAvailable(void)
+{
+    if (!_inner->dataAvailable())
+    {
+        _irqHeld = false;
+        _irqSeen = false;
+        return inject(kFPC2534FaultSpuriousIRQ);
+    }
+
+    // A new data signal - hold it back?
+    if (!_irqSeen)
+    {
+        _irqSeen = true;
+        if (inject(kFPC2534FaultDelayIRQ))
+        {
+            _irqHeld = true;
+            _irqReleaseMs = millis() + _config.delayIRQMs;
+        }
+    }
+    if (_irqHeld && (int32_t)(millis() - _irqReleaseMs) < 0)
+        return false;
+
+    _irqHeld = false;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534FaultComm::clearData(void)
+{
+    _inner->clearData();
+    _irqHeld = false;
+    _irqSeen = false;
+    _splitPending = false;
+}
+
+//--------------------------------------------------------------------------------------------
+uint16_t sfDevFPC2534FaultComm::write(const uint8_t *data, size_t len)
+{
+    _stats.writes++;
+    if (inject(kFPC2534FaultNack))
+        return FPC_RESULT_FAILURE;
+
+    return _inner->write(data, len);
+}
+
+//--------------------------------------------------------------------------------------------
+uint16_t sfDevFPC2534FaultComm::read(uint8_t *data, size_t len)
+{
+    _stats.reads++;
+
+    // The rest of a split read has arrived
+    if (_splitPending)
+    {
+        _splitPending = false;
+        return _inner->read(data, len);
+    }
+
+    if (inject(kFPC2534FaultNack))
+        return FPC_RESULT_IO_BUSY;
+
+    if (inject(kFPC2534FaultSplit))
+    {
+        _splitPending = true;
+        return FPC_RESULT_IO_NO_DATA;
+    }
+
+    // Lose a byte ahead of the data
+    if (inject(kFPC2534FaultDropByte))
+    {
+        uint8_t lost;
+        _inner->read(&lost, 1);
+    }
+
+    // Part of the data, then the read fails - the rest stays in the stream
+    if (len > 1 && inject(kFPC2534FaultTruncate))
+    {
+        _inner->read(data, 1 + nextRandom(kFPC2534FaultTruncate) % (len - 1));
+        return FPC_RESULT_IO_NO_DATA;
+    }
+
+    uint16_t rc = _inner->read(data, len);
+
+    if (rc == FPC_RESULT_OK && len > 0 && inject(kFPC2534FaultBitFlip))
+    {
+        uint32_t bit = nextRandom(kFPC2534FaultBitFlip) % (len * 8);
+        data[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+    }
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// Bracketing and link control - passed through
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534FaultComm::beginWrite(void)
+{
+    _inner->beginWrite();
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534FaultComm::endWrite(void)
+{
+    _inner->endWrite();
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534FaultComm::beginRead(void)
+{
+    _inner->beginRead();
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534FaultComm::endRead(void)
+{
+    _inner->endRead();
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534FaultComm::setBaudRate(uint32_t baudRate)
+{
+    return _inner->setBaudRate(baudRate);
+}
+
+//--------------------------------------------------------------------------------------------
+uint32_t sfDevFPC2534FaultComm::getBaudRate(void)
+{
+    return _inner->getBaudRate();
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534FaultComm::wakeSensor(void)
+{
+    return _inner->wakeSensor();
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534FaultComm::reinitialize(void)
+{
+    _irqHeld = false;
+    _irqSeen = false;
+    _splitPending = false;
+    return _inner->reinitialize();
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534FaultComm::transferPending(void)
+{
+    return _inner->transferPending();
+}
+
+//--------------------------------------------------------------------------------------------
+// Sleep in the wrapped transport until it has data - then apply the IRQ faults
+//
+bool sfDevFPC2534FaultComm::waitForData(uint32_t timeoutMs)
+{
+    uint32_t start = millis();
+    while (!dataAvailable())
+    {
+        uint32_t elapsed = millis() - start;
+        if (elapsed >= timeoutMs)
+            return false;
+
+        // the data is there, but held back (delayed IRQ)
+        if (_inner->dataAvailable())
+            delay(1);
+        else
+            _inner->waitForData(timeoutMs - elapsed);
+    }
+    return true;
+}
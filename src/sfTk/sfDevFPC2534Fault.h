@@ -0,0 +1,165 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Fault injection transport for the FPC2534 library.
+//
+// sfDevFPC2534FaultComm wraps another transport - a real one, or one connected to a simulated sensor - and
+// injects faults into the traffic, to measure how the library (retries, resync, watchdog) and the application
+// recover:
+//
+//   - dropped bytes    - a byte of the received stream is lost
+//   - bit flips        - a bit of the received data is flipped
+//   - truncated frames - a read gets part of the data, then fails - the rest is left in the stream
+//   - delayed IRQs     - data available is held back for a time
+//   - spurious IRQs    - data available, with no data
+//   - NACKs            - a write or read is refused by the bus
+//   - split frames     - a read finds only part of the data - the rest arrives by the next read
+//
+// Each fault is drawn from its own pseudo random sequence, at each opportunity for it - the same seed gives the
+// same faults for the same traffic. (Spurious IRQs are drawn each time the library polls with no data, so they
+// also depend on the timing.)
+//
+// With the device attached, the time from a fault to the next frame parsed by the library (healthy again) is
+// measured.
+//
+// The wrapper is polled - it does not support the I/O task mode (the data available callback is not passed
+// through).
+
+#pragma once
+
+#include "sfDevFPC2534.h"
+
+// Fault rates are given in faults per kFPC2534FaultRateScale opportunities
+const uint16_t kFPC2534FaultRateScale = 10000;
+
+typedef enum
+{
+    kFPC2534FaultDropByte = 0, // per read
+    kFPC2534FaultBitFlip,      // per read
+    kFPC2534FaultTruncate,     // per read
+    kFPC2534FaultDelayIRQ,     // per data available signal
+    kFPC2534FaultSpuriousIRQ,  // per data available check with no data
+    kFPC2534FaultNack,         // per read or write
+    kFPC2534FaultSplit,        // per read
+    kFPC2534FaultCount
+} sfDevFPC2534Fault_t;
+
+//--------------------------------------------------------------------------------------------
+// Fault injection settings
+typedef struct
+{
+    uint32_t seed;                     // same seed, same faults
+    uint16_t rate[kFPC2534FaultCount]; // in kFPC2534FaultRateScale - 0 to disable a fault
+    uint32_t delayIRQMs;               // time a delayed IRQ is held back
+} sfDevFPC2534FaultConfig_t;
+
+//--------------------------------------------------------------------------------------------
+// Fault injection statistics
+typedef struct
+{
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t injected[kFPC2534FaultCount];
+    uint32_t framesParsed;    // frames parsed by the library
+    uint32_t recoveries;      // healthy again after a fault
+    uint32_t lastRecoveryUs;  // first fault to the next frame parsed
+    uint32_t maxRecoveryUs;
+    uint32_t totalRecoveryUs; // divide by recoveries for the average
+} sfDevFPC2534FaultStats_t;
+
+//--------------------------------------------------------------------------------------------
+class sfDevFPC2534FaultComm : public sfDevFPC2534IComm
+{
+  public:
+    sfDevFPC2534FaultComm(sfDevFPC2534IComm &inner);
+    ~sfDevFPC2534FaultComm();
+
+    /**
+     * @brief Set the faults to inject - and restart the fault sequence from the seed
+     *
+     * @param config The fault settings
+     */
+    void setConfig(const sfDevFPC2534FaultConfig_t &config);
+
+    /**
+     * @brief Enable or disable fault injection - the traffic passes through untouched while disabled
+     */
+    void setEnabled(bool enabled)
+    {
+        _enabled = enabled;
+    }
+
+    /**
+     * @brief Measure the recovery time of the given device - the device must use this transport.
+     *
+     * @param device The device object
+     */
+    void attach(sfDevFPC2534 &device);
+    void detach(void);
+
+    /**
+     * @brief Is the link healthy - no fault since the last frame parsed by the library?
+     */
+    bool isHealthy(void) const
+    {
+        return !_faulted;
+    }
+
+    void getStats(sfDevFPC2534FaultStats_t &stats) const
+    {
+        stats = _stats;
+    }
+    void resetStats(void);
+
+    // The transport interface - passed to the wrapped transport, with faults
+    bool dataAvailable(void);
+    void clearData(void);
+    uint16_t write(const uint8_t *data, size_t len);
+    uint16_t read(uint8_t *data, size_t len);
+    void beginWrite(void);
+    void endWrite(void);
+    void beginRead(void);
+    void endRead(void);
+    bool waitForData(uint32_t timeoutMs);
+    bool setBaudRate(uint32_t baudRate);
+    uint32_t getBaudRate(void);
+    bool wakeSensor(void);
+    bool reinitialize(void);
+    bool transferPending(void);
+
+  private:
+    // Draw from the fault sequence - inject the fault now?
+    bool inject(sfDevFPC2534Fault_t fault);
+    uint32_t nextRandom(sfDevFPC2534Fault_t fault);
+
+    static void hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size);
+
+    sfDevFPC2534IComm *_inner;
+    sfDevFPC2534 *_device;
+    sfDevFPC2534Hook_t _hook;
+
+    sfDevFPC2534FaultConfig_t _config;
+    bool _enabled;
+    uint32_t _random[kFPC2534FaultCount];
+
+    // Delayed IRQ - data available is held back until this time
+    bool _irqHeld;
+    bool _irqSeen;
+    uint32_t _irqReleaseMs;
+
+    // A split read - the next read gets the data
+    bool _splitPending;
+
+    // The link is faulted - since this time
+    bool _faulted;
+    uint32_t _faultedAtUs;
+
+    sfDevFPC2534FaultStats_t _stats;
+};
@@ -22,16 +22,30 @@ static sfDevFPC2534I2C_IRead *__readHelper = &__esp32ReadHelper;
 static sfDevFPC2534I2C_Helper __rp2040ReadHelper;
 static sfDevFPC2534I2C_IRead *__readHelper = &__rp2040ReadHelper;
 #else
-
-#warning "No platform specific I2C read helper defined"
-static sfDevFPC2534I2C_IRead *__readHelper = nullptr;
-
+// everything else - chunked reads on the Wire API
+#include "sfDevFPC2534I2C_wire.h"
+static sfDevFPC2534I2C_Helper __wireReadHelper;
+static sfDevFPC2534I2C_IRead *__readHelper = &__wireReadHelper;
 #endif
 
+// The read helper is shared by all the I2C transports (sensors). It is set up for the bus of one transport at a
+// time, and runs one background transfer at a time - see claimHelper().
+static sfDevFPC2534I2C *__helperOwner = nullptr;
+
 // --------------------------------------------------------------------------------------------
 // CTOR
-sfDevFPC2534I2C::sfDevFPC2534I2C() : _i2cAddress{0}, _i2cPort{nullptr}, _i2cBusNumber{0}
+sfDevFPC2534I2C::sfDevFPC2534I2C()
+    : _sdaPin{kFPC2534NoBusPin}, _sclPin{kFPC2534NoBusPin}, _clockHz{0}, _recovering{false}, _i2cAddress{0},
+      _i2cPort{nullptr}, _i2cBusNumber{0}, _payloadPending{false}, _firstRead{false}, _stats{0}, _readStartUs{0},
+      _payloadEndUs{0}
+{
+}
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534I2C::~sfDevFPC2534I2C()
 {
+    if (__helperOwner == this)
+        __helperOwner = nullptr;
 }
 
 //--------------------------------------------------------------------------------------------
@@ -41,11 +55,17 @@ bool sfDevFPC2534I2C::initialize(uint8_t address, TwoWire &wirePort, uint8_t i2c
     if (__readHelper == nullptr)
         return false;
 
-    // Initialize the I2C read helper - pass in the bus number being used ...
+    // another sensor may have a transfer in flight on the helper
+    if (__helperOwner != nullptr && __helperOwner != this && __helperOwner->_payloadPending)
+        __helperOwner->finishPayload();
+
+    // Initialize the I2C read helper - pass in the Wire port and bus number being used ...
+    __readHelper->setWirePort(wirePort);
     __readHelper->initialize(i2cBusNumber);
     _i2cAddress = address;
     _i2cPort = &wirePort;
     _i2cBusNumber = i2cBusNumber;
+    __helperOwner = this;
 
     // Call our super to init the ISR handler
     sfDevFPC2534IComm::initISRHandler(interruptPin);
@@ -64,7 +84,10 @@ bool sfDevFPC2534I2C::dataAvailable()
     if (_i2cPort == nullptr)
         return false;
 
-    // the data available flag is set, or we have data in the buffer
+    // the data available flag is set, or we have data in the buffer - or a background payload read completed
+    if (_payloadPending)
+        return _dataCount > 0 || !__readHelper->payloadBusy();
+
     return isISRDataAvailable() || _dataCount > 0;
 }
 
@@ -73,6 +96,10 @@ bool sfDevFPC2534I2C::dataAvailable()
 //
 void sfDevFPC2534I2C::clearData()
 {
+    // let any transfer in flight finish - and drop it
+    if (_payloadPending)
+        finishPayload();
+
     _dataCount = 0;
     _dataHead = 0;
     _dataTail = 0;
@@ -80,6 +107,154 @@ void sfDevFPC2534I2C::clearData()
     clearISRDataAvailable();
 }
 
+//--------------------------------------------------------------------------------------------
+// Take the shared read helper for this transport - before any transfer. A background transfer in flight - of this
+// sensor or another - is finished first (its data goes to that sensor's buffer, for its next read), and the helper
+// is moved to this bus if needed.
+//
+void sfDevFPC2534I2C::claimHelper(void)
+{
+    sfDevFPC2534I2C *owner = __helperOwner;
+    if (owner != nullptr && owner->_payloadPending)
+        owner->finishPayload();
+
+    if (owner == this)
+        return;
+
+    if (owner == nullptr || owner->_i2cPort != _i2cPort || owner->_i2cBusNumber != _i2cBusNumber)
+    {
+        __readHelper->setWirePort(*_i2cPort);
+        __readHelper->initialize(_i2cBusNumber);
+    }
+    __helperOwner = this;
+}
+
+//--------------------------------------------------------------------------------------------
+// A background payload read is running on the bus
+//
+bool sfDevFPC2534I2C::transferPending(void)
+{
+    return _payloadPending && __readHelper->payloadBusy();
+}
+
+//--------------------------------------------------------------------------------------------
+// Drop any transfer and data, and reinitialize the read helper on the bus
+//
+bool sfDevFPC2534I2C::reinitialize(void)
+{
+    if (_i2cPort == nullptr || __readHelper == nullptr)
+        return false;
+
+    // recoverBus() reinitializes the helper
+    clearData();
+    recoverBus();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+// Bus recovery
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534I2C::setBusPins(uint32_t sdaPin, uint32_t sclPin, uint32_t clockHz)
+{
+    _sdaPin = sdaPin;
+    _sclPin = sclPin;
+    _clockHz = clockHz;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534I2C::isSDAHeldLow(void)
+{
+    // the pin reads the line while Wire owns it
+    return _sdaPin != kFPC2534NoBusPin && digitalRead(_sdaPin) == LOW;
+}
+
+//--------------------------------------------------------------------------------------------
+// Clock out the bus on the pins - the lines are driven open drain (output low, or released to the pull-ups)
+//
+bool sfDevFPC2534I2C::clockOutBus(void)
+{
+    if (_sdaPin == kFPC2534NoBusPin || _sclPin == kFPC2534NoBusPin)
+        return false;
+
+    // Wire recreates its bus driver - the helper drops what it holds on the old one
+    __readHelper->releaseBus(_i2cBusNumber);
+    _i2cPort->end();
+
+    pinMode(_sdaPin, INPUT_PULLUP);
+    pinMode(_sclPin, INPUT_PULLUP);
+    delayMicroseconds(kFPC2534BusRecoveryHalfClockUs);
+
+    // 9 clocks - the device holding SDA shifts out the rest of its byte, and releases SDA for the (NACK) bit
+    for (uint8_t i = 0; i < 9; i++)
+    {
+        digitalWrite(_sclPin, LOW);
+        pinMode(_sclPin, OUTPUT);
+        delayMicroseconds(kFPC2534BusRecoveryHalfClockUs);
+        pinMode(_sclPin, INPUT_PULLUP);
+        delayMicroseconds(kFPC2534BusRecoveryHalfClockUs);
+    }
+
+    // STOP - SDA rises while SCL is high
+    digitalWrite(_sclPin, LOW);
+    pinMode(_sclPin, OUTPUT);
+    digitalWrite(_sdaPin, LOW);
+    pinMode(_sdaPin, OUTPUT);
+    delayMicroseconds(kFPC2534BusRecoveryHalfClockUs);
+    pinMode(_sclPin, INPUT_PULLUP);
+    delayMicroseconds(kFPC2534BusRecoveryHalfClockUs);
+    pinMode(_sdaPin, INPUT_PULLUP);
+    delayMicroseconds(kFPC2534BusRecoveryHalfClockUs);
+
+    bool released = digitalRead(_sdaPin) == HIGH && digitalRead(_sclPin) == HIGH;
+
+    // give the pins back to Wire
+#if defined(ESP32)
+    _i2cPort->begin((int)_sdaPin, (int)_sclPin, _clockHz);
+#else
+    _i2cPort->begin();
+    if (_clockHz != 0)
+        _i2cPort->setClock(_clockHz);
+#endif
+    return released;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534I2C::recoverBus(void)
+{
+    if (_i2cPort == nullptr || __readHelper == nullptr || _recovering)
+        return false;
+
+    _recovering = true;
+    claimHelper();
+
+    // any transfer in flight is lost
+    if (_payloadPending)
+        finishPayload();
+
+    // the bus driver first - it keeps the bus setup of Wire
+    bool released = __readHelper->recoverBus() || clockOutBus();
+
+    // start fresh - no STOP pending from a read that started before the recovery
+    __readHelper->initialize(_i2cBusNumber);
+    _stats.recoveries++;
+
+    _recovering = false;
+    return released;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534I2C::busError(sfDevFPC2534I2CError_t error)
+{
+    if (error == kFPC2534I2CErrorTimeout)
+        _stats.timeouts++;
+    else if (error == kFPC2534I2CErrorArbitration)
+        _stats.arbitrationLost++;
+
+    // A NACK is normal (the sensor is busy or resetting) - unless SDA is held low
+    if (error == kFPC2534I2CErrorTimeout || error == kFPC2534I2CErrorArbitration || isSDAHeldLow())
+        recoverBus();
+}
+
 //--------------------------------------------------------------------------------------------
 // Write data to the device
 //
@@ -94,11 +269,21 @@ uint16_t sfDevFPC2534I2C::write(const uint8_t *data, size_t len)
     buffer[1] = (len >> 8) & 0xFF;
     memcpy(&buffer[2], data, len);
 
+    // A payload read of this sensor (or another on the bus) may still be running - finish it before the write
+    claimHelper();
     _i2cPort->beginTransmission(_i2cAddress);
 
     _i2cPort->write(buffer, sizeof(buffer));
 
-    return _i2cPort->endTransmission() ? FPC_RESULT_FAILURE : FPC_RESULT_OK;
+    // 4 - other error (lost arbitration, bus error), 5 - timeout
+    uint8_t status = _i2cPort->endTransmission();
+    if (status == 0)
+        return FPC_RESULT_OK;
+
+    busError(status == 5   ? kFPC2534I2CErrorTimeout
+             : status == 4 ? kFPC2534I2CErrorArbitration
+                           : kFPC2534I2CErrorNack);
+    return FPC_RESULT_FAILURE;
 }
 
 //--------------------------------------------------------------------------------------------
@@ -148,6 +333,59 @@ bool sfDevFPC2534I2C::fifo_dequeue(uint8_t *data, size_t len)
     return true;
 }
 
+//--------------------------------------------------------------------------------------------
+// Asynchronous payload reads
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534I2C::onPayloadDone(void *arg)
+{
+    sfDevFPC2534I2C *self = static_cast<sfDevFPC2534I2C *>(arg);
+    self->_payloadEndUs = micros();
+
+    // wake the I/O task - if one is waiting
+    self->notifyDataAvailable();
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534I2C::countRead(uint16_t nBytes, uint32_t endUs)
+{
+    if (nBytes == 0)
+    {
+        _stats.errors++;
+        return;
+    }
+    _stats.packets++;
+    _stats.bytes += nBytes;
+    _stats.busyUs += endUs - _readStartUs;
+}
+
+//--------------------------------------------------------------------------------------------
+// Complete the payload read in flight (waits if needed). The payload was read into the start of the
+// (empty) data buffer - just account for it.
+uint16_t sfDevFPC2534I2C::finishPayload(void)
+{
+    uint16_t nRead = __readHelper->finishPayload();
+    _payloadPending = false;
+    countRead(nRead, _payloadEndUs);
+
+    if (nRead == 0)
+        busError(__readHelper->lastError());
+
+    if (nRead == 0 || nRead >= kDataBufferSize)
+        return FPC_RESULT_IO_BAD_DATA;
+
+    _dataTail = 0;
+    _dataHead = nRead;
+    _dataCount = nRead;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Start of a frame read by the library
+void sfDevFPC2534I2C::beginRead(void)
+{
+    _firstRead = true;
+}
+
 //--------------------------------------------------------------------------------------------
 uint16_t sfDevFPC2534I2C::read(uint8_t *data, size_t len)
 {
@@ -156,23 +394,71 @@ uint16_t sfDevFPC2534I2C::read(uint8_t *data, size_t len)
     if (_i2cPort == nullptr || __readHelper == nullptr)
         return FPC_RESULT_IO_RUNTIME_FAILURE;
 
+    // Only the first read of a frame can be deferred to an asynchronous transfer - the rest of a frame is needed now
+    bool canDefer = _firstRead && _dataCount == 0;
+    _firstRead = false;
+
+    // A payload read in flight? Pick it up when done - or wait for it if the data is needed now.
+    if (_payloadPending)
+    {
+        if (canDefer && __readHelper->payloadBusy())
+            return FPC_RESULT_IO_NO_DATA;
+
+        uint16_t rc = finishPayload();
+        if (rc != FPC_RESULT_OK)
+            return rc;
+    }
     // is new data available from the sensor - always grab new data if we have room
-    if (isISRDataAvailable())
+    else if (isISRDataAvailable())
     {
         // clear flag
         clearISRDataAvailable();
+        claimHelper();
 
         // how much data is available?
+        _readStartUs = micros();
         uint16_t dataAvailable = __readHelper->readTransferSize(_i2cAddress);
 
+        if (dataAvailable == 0)
+        {
+            countRead(0, 0);
+            busError(__readHelper->lastError());
+
+            // The size read failed, but the sensor still holds the data - keep the IRQ, the read can be retried
+            if (isIRQAsserted())
+            {
+                setISRDataAvailable();
+                return FPC_RESULT_IO_BUSY;
+            }
+        }
+
+        // Start the payload transfer in the background - the frame is read when it completes
+        if (dataAvailable > 0 && dataAvailable < kDataBufferSize && canDefer)
+        {
+            if (__readHelper->startPayload(_dataBuffer, dataAvailable, onPayloadDone, this))
+            {
+                _payloadPending = true;
+                if (__readHelper->payloadBusy())
+                    return FPC_RESULT_IO_NO_DATA;
+
+                // already complete (synchronous bus)
+                uint16_t rc = finishPayload();
+                if (rc != FPC_RESULT_OK)
+                    return rc;
+                dataAvailable = 0;
+            }
+        }
+
         if (dataAvailable > 0)
         {
             uint8_t tempBuffer[dataAvailable];
             dataAvailable = __readHelper->readPayload(dataAvailable, tempBuffer);
+            countRead(dataAvailable, micros());
 
             // Was there an error
             if (dataAvailable == 0)
             {
+                busError(__readHelper->lastError());
                 return FPC_RESULT_IO_BAD_DATA; // error
             }
 
@@ -21,6 +21,21 @@
 // The default I2C address for the FPC2534
 const uint8_t kFPC2534DefaultAddress = 0x24;
 
+// Bus recovery - no SDA/SCL pins set (see setBusPins())
+const uint32_t kFPC2534NoBusPin = 255;
+
+// Bus recovery - half period of the recovery clock (100 kHz)
+const uint32_t kFPC2534BusRecoveryHalfClockUs = 5;
+
+// I2C transfer errors - reported by the read helpers, to detect a stuck bus
+typedef enum
+{
+    kFPC2534I2CErrorNone = 0,
+    kFPC2534I2CErrorNack,        // no response - the sensor is busy, resetting or not there
+    kFPC2534I2CErrorTimeout,     // the transfer did not complete - a line is held low
+    kFPC2534I2CErrorArbitration, // arbitration lost - a line is held low, or another controller is on the bus
+} sfDevFPC2534I2CError_t;
+
 // Define an interface to perform the needed read actions for the I2C protocol - this is needed since
 // the FPC2534 uses a custom I2C read protocol that the standard Arduino Wire library does not support.
 //
@@ -28,25 +43,148 @@ class sfDevFPC2534I2C_IRead
 {
   public:
     virtual void initialize(uint8_t i2cBusNumber) = 0;
+
+    // The Wire port used - only needed by helpers built on Wire
+    virtual void setWirePort(TwoWire &wirePort)
+    {
+        (void)wirePort;
+    }
+
     virtual uint16_t readPayload(size_t len, uint8_t *data) = 0;
     virtual uint16_t readTransferSize(uint8_t device_address) = 0;
+
+    // Optional - asynchronous payload read. startPayload() starts reading len payload bytes into data (which must
+    // stay valid until finishPayload()) and returns at once; done(arg) is called when the transfer completes
+    // (possibly from an ISR). payloadBusy() is true while the transfer runs and has not timed out.
+    // finishPayload() waits for the transfer, if still running (aborts it on timeout), and returns the bytes
+    // read - 0 on error. Helpers without asynchronous transfers return false from startPayload().
+    virtual bool startPayload(uint8_t *data, size_t len, void (*done)(void *), void *arg)
+    {
+        (void)data;
+        (void)len;
+        (void)done;
+        (void)arg;
+        return false;
+    }
+    virtual bool payloadBusy(void)
+    {
+        return false;
+    }
+    virtual uint16_t finishPayload(void)
+    {
+        return 0;
+    }
+
+    // The error of the last failed transfer. Helpers that can't tell report a NACK.
+    virtual sfDevFPC2534I2CError_t lastError(void)
+    {
+        return kFPC2534I2CErrorNack;
+    }
+
+    // Optional - free a bus held by a device (9 clocks and a STOP) with the bus driver. Helpers that can't
+    // return false, and the transport clocks the bus out on the SDA/SCL pins. initialize() is called after.
+    virtual bool recoverBus(void)
+    {
+        return false;
+    }
+
+    // Optional - the Wire port of the bus is about to be ended (and begun again) - release anything tied to the
+    // bus driver instance, it doesn't survive. initialize() is called after.
+    virtual void releaseBus(uint8_t i2cBusNumber)
+    {
+        (void)i2cBusNumber;
+    }
 };
 
+// I2C read statistics - to see the effective throughput a board achieves
+typedef struct
+{
+    uint32_t packets; // packets read from the sensor
+    uint32_t bytes;   // payload bytes read
+    uint32_t busyUs;  // time taken by the reads (size + payload), in microseconds
+    uint32_t errors;  // failed reads
+    // Bus health - failed transfers (reads and writes) by cause, and the bus recoveries run
+    uint32_t timeouts;
+    uint32_t arbitrationLost;
+    uint32_t recoveries;
+} sfDevFPC2534I2CStats_t;
+
 // i2c impl for the FPC2534 communication interface
 
 class sfDevFPC2534I2C : public sfDevFPC2534IComm
 {
   public:
     sfDevFPC2534I2C();
+    ~sfDevFPC2534I2C();
     bool initialize(uint8_t address, TwoWire &wirePort, uint8_t i2cBusNumber, uint32_t interruptPin);
     bool dataAvailable();
     void clearData();
     uint16_t write(const uint8_t *data, size_t len);
     uint16_t read(uint8_t *data, size_t len);
+    void beginRead(void);
+    bool reinitialize(void);
+    bool transferPending(void);
+
+    /**
+     * @brief Set the SDA and SCL pins of the bus - needed to recover a stuck bus on platforms where the bus
+     * driver can't (all but ESP32 with ESP-IDF 5.4+). The Wire port is restarted after the recovery.
+     *
+     * @param sdaPin The SDA pin
+     * @param sclPin The SCL pin
+     * @param clockHz The bus clock to restart Wire at - 0 for the Wire default
+     */
+    void setBusPins(uint32_t sdaPin, uint32_t sclPin, uint32_t clockHz = 0);
+
+    /**
+     * @brief Free a stuck bus - a device (the sensor reset mid-read) holding SDA low. 9 clock pulses and a STOP
+     * are sent, and the read helper is reinitialized. Run automatically on a transfer timeout or lost
+     * arbitration, or when SDA is found held low after a failed transfer.
+     *
+     * @return true if the bus was clocked out, and the lines are released
+     */
+    bool recoverBus(void);
+
+    /**
+     * @brief Get the read statistics
+     */
+    void getStats(sfDevFPC2534I2CStats_t &stats) const
+    {
+        stats = _stats;
+    }
+
+    void resetStats(void)
+    {
+        memset(&_stats, 0, sizeof(_stats));
+    }
+
+    /**
+     * @brief Effective read throughput - payload bytes per second of read time
+     */
+    uint32_t throughput(void) const
+    {
+        return _stats.busyUs > 0 ? (uint32_t)((uint64_t)_stats.bytes * 1000000UL / _stats.busyUs) : 0;
+    }
 
   private:
+    // Take the read helper (shared by all the I2C sensors) for a transfer on this bus
+    void claimHelper(void);
+
+    // A transfer failed - count it, and recover the bus if it looks stuck
+    void busError(sfDevFPC2534I2CError_t error);
+    bool isSDAHeldLow(void);
+    bool clockOutBus(void);
+
+    uint32_t _sdaPin;
+    uint32_t _sclPin;
+    uint32_t _clockHz;
+    bool _recovering;
+
     bool fifo_enqueue(uint8_t *data, size_t len);
     bool fifo_dequeue(uint8_t *data, size_t len);
+    uint16_t finishPayload(void);
+
+    // called by the read helper when an asynchronous payload read completes
+    static void onPayloadDone(void *arg);
 
     uint8_t _i2cAddress;
     TwoWire *_i2cPort;
@@ -61,4 +199,16 @@ class sfDevFPC2534I2C : public sfDevFPC2534IComm
     uint16_t _dataHead;
     uint16_t _dataTail;
     uint16_t _dataCount;
+
+    // Asynchronous payload read in flight (helpers that support it) - straight into the (empty) data buffer.
+    // Only the first read of a frame is deferred - the bus transfer then overlaps the application, and the
+    // frame is read when it completes.
+    bool _payloadPending;
+    bool _firstRead;
+
+    // read statistics - the start of the read, and the end of a background payload transfer
+    void countRead(uint16_t nBytes, uint32_t endUs);
+    sfDevFPC2534I2CStats_t _stats;
+    uint32_t _readStartUs;
+    volatile uint32_t _payloadEndUs;
 };
\ No newline at end of file
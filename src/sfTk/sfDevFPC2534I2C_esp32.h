@@ -16,12 +16,272 @@
 // ESP32 implementation for the FPC2534 I2C communication class - read protocol.
 
 #ifdef ESP32
+#include <esp_idf_version.h>
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0)
+
+// With ESP-IDF 5.4 and later (Arduino ESP32 core 3.2+), Wire is built on the i2c_master driver. The helper uses
+// the same bus (not the legacy driver on the same port) and adds a device for the sensor once.
+//
+// A packet is read as one I2C read transaction, as with the legacy driver - the size prefix is read without a
+// STOP (a defined operation list: START, address, 2 bytes ACKed), then the payload continues the same transaction
+// and ends it with a NACK and STOP. A size read that isn't followed by a payload read leaves a STOP pending, sent
+// before the next transaction.
+//
+// The reads are synchronous - the bus created by Wire has no transaction queue, so the driver can't run a
+// transfer in the background on it.
+
+#include <driver/i2c_master.h>
+#include <esp32-hal-i2c.h>
+
+class sfDevFPC2534I2C_Helper : public sfDevFPC2534I2C_IRead
+{
+  public:
+    sfDevFPC2534I2C_Helper()
+        : _i2cBusNumber{0}, _busHandle{nullptr}, _devices{}, _nextDevice{0}, _devHandle{nullptr}, _deviceAddress{0},
+          _deviceBus{0}, _isInitialized{false}, _pendingStop{false}, _timeOutMillis{50},
+          _lastError{kFPC2534I2CErrorNone}, _ops{}
+    {
+    }
+
+    void initialize(uint8_t i2cBusNumber)
+    {
+        _i2cBusNumber = i2cBusNumber;
+
+        // The bus is owned by Wire - it must be started (Wire.begin()) first
+        _isInitialized = i2c_master_get_bus_handle((i2c_port_num_t)i2cBusNumber, &_busHandle) == ESP_OK;
+        _pendingStop = false;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // Read the payload data from the device - this is called after readTransferSize() to get
+    // the actual data. It continues the read transaction started there, and ends it.
+    //--------------------------------------------------------------------------------------------
+    uint16_t readPayload(size_t len, uint8_t *data)
+    {
+        if (_devHandle == nullptr || !_pendingStop || len == 0)
+            return 0;
+
+        // all bytes ACKed but the last
+        size_t nOps = 0;
+        if (len > 1)
+            _ops[nOps++] = readOp(data, len - 1, I2C_ACK_VAL);
+        _ops[nOps++] = readOp(data + len - 1, 1, I2C_NACK_VAL);
+        _ops[nOps++] = stopOp();
+
+        esp_err_t err = i2c_master_execute_defined_operations(_devHandle, _ops, nOps, transferTimeout(len));
+        _pendingStop = false;
+        if (err != ESP_OK)
+        {
+            _lastError = toError(err);
+            return 0;
+        }
+        return len;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // For the FPC data, the first two bytes are the length of the data to follow. So this method reads in
+    // the length and returns it. This method is the "start" of a FPC data read operation. It doesn't
+    // stop/end the I2C read operation, that is done in the readPayload() method.
+    //
+    uint16_t readTransferSize(uint8_t device_address)
+    {
+        if (!addDevice(device_address))
+            return 0;
+
+        // do we need to stop a previous read operation?
+        if (_pendingStop)
+        {
+            _ops[0] = stopOp();
+            i2c_master_execute_defined_operations(_devHandle, _ops, 1, _timeOutMillis);
+            _pendingStop = false;
+        }
+
+        uint8_t address = (uint8_t)(device_address << 1 | 1);
+        uint8_t size[2] = {0};
+
+        _ops[0] = {};
+        _ops[0].command = I2C_MASTER_CMD_START;
+        _ops[1] = {};
+        _ops[1].command = I2C_MASTER_CMD_WRITE;
+        _ops[1].write.ack_check = true;
+        _ops[1].write.data = &address;
+        _ops[1].write.total_bytes = 1;
+        _ops[2] = readOp(size, sizeof(size), I2C_ACK_VAL);
+
+        esp_err_t err = i2c_master_execute_defined_operations(_devHandle, _ops, 3, _timeOutMillis);
+        if (err != ESP_OK)
+        {
+            _lastError = toError(err);
+            return 0;
+        }
+        _lastError = kFPC2534I2CErrorNone;
+        _pendingStop = true;
+
+        uint16_t theSize = size[0] | (size[1] << 8);
+        return theSize <= kMaxPayload ? theSize : 0;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    sfDevFPC2534I2CError_t lastError(void)
+    {
+        return _lastError;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // The driver clocks out the bus (9 clocks and a STOP) - the bus and the device handle stay valid
+    bool recoverBus(void)
+    {
+        return _busHandle != nullptr && i2c_master_bus_reset(_busHandle) == ESP_OK;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // Wire.end() deletes the bus (it can't while devices are on it) - remove the device handles on it first. The
+    // sensors are added to the new bus on their next transfer.
+    void releaseBus(uint8_t i2cBusNumber)
+    {
+        for (uint8_t i = 0; i < kMaxDevices; i++)
+        {
+            if (_devices[i].handle == nullptr || _devices[i].bus != i2cBusNumber)
+                continue;
+            if (_devices[i].handle == _devHandle)
+                _devHandle = nullptr;
+            i2c_master_bus_rm_device(_devices[i].handle);
+            _devices[i].handle = nullptr;
+        }
+
+        if (i2cBusNumber == _i2cBusNumber)
+        {
+            _busHandle = nullptr;
+            _isInitialized = false;
+            _pendingStop = false;
+        }
+    }
+
+  private:
+    static constexpr size_t kMaxPayload = MAX_HOST_PACKET_SIZE_DEFAULT;
+
+    static sfDevFPC2534I2CError_t toError(esp_err_t err)
+    {
+        return err == ESP_ERR_TIMEOUT ? kFPC2534I2CErrorTimeout : kFPC2534I2CErrorNack;
+    }
+
+    // Transfer timeout - scales with the transfer size (200 us per byte covers 100 kHz with clock stretching)
+    uint32_t transferTimeout(size_t len) const
+    {
+        return _timeOutMillis + (uint32_t)(len * 200 / 1000);
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // Add the sensor to the bus - once. The handle is reused for every transfer - a handle is kept for each
+    // sensor (bus and address), so several sensors can share the helper.
+    bool addDevice(uint8_t device_address)
+    {
+        if (!_isInitialized)
+            return false;
+
+        if (_devHandle != nullptr && device_address == _deviceAddress && _i2cBusNumber == _deviceBus)
+            return true;
+
+        for (uint8_t i = 0; i < kMaxDevices; i++)
+        {
+            if (_devices[i].handle != nullptr && _devices[i].address == device_address &&
+                _devices[i].bus == _i2cBusNumber)
+            {
+                _devHandle = _devices[i].handle;
+                _deviceAddress = device_address;
+                _deviceBus = _i2cBusNumber;
+                return true;
+            }
+        }
+
+        // A new sensor - take the next slot (the oldest handle is removed from its bus)
+        device_t &slot = _devices[_nextDevice];
+        _nextDevice = (_nextDevice + 1) % kMaxDevices;
+        if (slot.handle != nullptr)
+        {
+            i2c_master_bus_rm_device(slot.handle);
+            slot.handle = nullptr;
+        }
+        _devHandle = nullptr;
+
+        uint32_t frequency = 0;
+        if (i2cGetClock(_i2cBusNumber, &frequency) != ESP_OK || frequency == 0)
+            frequency = 100000;
+
+        i2c_device_config_t config = {};
+        config.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+        config.device_address = device_address;
+        config.scl_speed_hz = frequency;
+
+        if (i2c_master_bus_add_device(_busHandle, &config, &slot.handle) != ESP_OK)
+        {
+            slot.handle = nullptr;
+            return false;
+        }
+        slot.address = device_address;
+        slot.bus = _i2cBusNumber;
+        _devHandle = slot.handle;
+        _deviceAddress = device_address;
+        _deviceBus = _i2cBusNumber;
+
+        return true;
+    }
+
+    static i2c_operation_job_t readOp(uint8_t *data, size_t len, i2c_ack_value_t ack)
+    {
+        i2c_operation_job_t op = {};
+        op.command = I2C_MASTER_CMD_READ;
+        op.read.ack_value = ack;
+        op.read.data = data;
+        op.read.total_bytes = len;
+        return op;
+    }
+
+    static i2c_operation_job_t stopOp(void)
+    {
+        i2c_operation_job_t op = {};
+        op.command = I2C_MASTER_CMD_STOP;
+        return op;
+    }
+
+    uint8_t _i2cBusNumber;
+    i2c_master_bus_handle_t _busHandle;
+
+    // The device handles - one per sensor, the current one in _devHandle
+    static constexpr uint8_t kMaxDevices = 4;
+    typedef struct
+    {
+        i2c_master_dev_handle_t handle;
+        uint8_t bus;
+        uint8_t address;
+    } device_t;
+    device_t _devices[kMaxDevices];
+    uint8_t _nextDevice;
+
+    i2c_master_dev_handle_t _devHandle;
+    uint8_t _deviceAddress;
+    uint8_t _deviceBus;
+    bool _isInitialized;
+    bool _pendingStop;
+    uint16_t _timeOutMillis;
+    sfDevFPC2534I2CError_t _lastError;
+
+    // The operation list - reused for every transfer
+    i2c_operation_job_t _ops[3];
+};
+
+#else
+
+// Earlier ESP-IDF versions - Wire uses the legacy I2C driver
 #include "driver/i2c.h"
 
 class sfDevFPC2534I2C_Helper : public sfDevFPC2534I2C_IRead
 {
   public:
-    sfDevFPC2534I2C_Helper() : _i2cBusNumber{0}, _isInitialized{false}, _pendingStop{false}, _timeOutMillis{50}
+    sfDevFPC2534I2C_Helper()
+        : _i2cBusNumber{0}, _isInitialized{false}, _pendingStop{false}, _timeOutMillis{50},
+          _lastError{kFPC2534I2CErrorNone}
     {
     }
     void initialize(uint8_t i2cBusNumber)
@@ -59,6 +319,8 @@ class sfDevFPC2534I2C_Helper : public sfDevFPC2534I2C_IRead
 
             if (err == ESP_OK)
                 theSize = len;
+            else
+                _lastError = toError(err);
 
             _pendingStop = false;
 
@@ -114,7 +376,10 @@ class sfDevFPC2534I2C_Helper : public sfDevFPC2534I2C_IRead
                     err = i2c_master_cmd_begin((i2c_port_t)_i2cBusNumber, handle, _timeOutMillis / portTICK_PERIOD_MS);
 
                     if (err != ESP_OK)
+                    {
                         theSize = 0;
+                        _lastError = toError(err);
+                    }
                     else
                         _pendingStop = true;
                 }
@@ -125,11 +390,26 @@ class sfDevFPC2534I2C_Helper : public sfDevFPC2534I2C_IRead
         return theSize;
     }
 
+    //--------------------------------------------------------------------------------------------
+    sfDevFPC2534I2CError_t lastError(void)
+    {
+        return _lastError;
+    }
+
   private:
+    // ESP_FAIL is a NACK
+    static sfDevFPC2534I2CError_t toError(esp_err_t err)
+    {
+        return err == ESP_ERR_TIMEOUT ? kFPC2534I2CErrorTimeout : kFPC2534I2CErrorNack;
+    }
+
     uint8_t _i2cBusNumber;
     bool _isInitialized;
     bool _pendingStop;
     uint16_t _timeOutMillis;
+    sfDevFPC2534I2CError_t _lastError;
 };
 
-#endif
\ No newline at end of file
+#endif // ESP_IDF_VERSION
+
+#endif
@@ -14,13 +14,23 @@
 // RP2 implementation for the FPC2534 I2C communication class - read protocol.
 
 #if defined(ARDUINO_ARCH_RP2040)
+#include <hardware/dma.h>
 #include <hardware/i2c.h>
+#include <hardware/irq.h>
+
+// Payload reads are DMA driven - one channel feeds the read commands to the I2C controller (a second one
+// adds the final read + STOP command), and one moves the received bytes straight into the buffer of the
+// transport. The core is free while the payload is on the bus; a DMA interrupt signals completion.
+//
+// Timeouts scale with the transfer size, instead of one long fixed timeout.
 
 class sfDevFPC2534I2C_Helper : public sfDevFPC2534I2C_IRead
 {
   public:
     sfDevFPC2534I2C_Helper()
-        : _device_address{0}, _i2cPort{nullptr}, _isInitialized{false}, _pendingStop{false}, _timeOutMillis{5000}
+        : _device_address{0}, _i2cPort{nullptr}, _isInitialized{false}, _pendingStop{false}, _rxChannel{-1},
+          _cmdChannel{-1}, _lastCmdChannel{-1}, _payloadSize{0}, _deadline{}, _done{nullptr}, _doneArg{nullptr},
+          _complete{false}, _lastError{kFPC2534I2CErrorNone}
     {
     }
     void initialize(uint8_t i2cBusNumber)
@@ -52,6 +62,8 @@ class sfDevFPC2534I2C_Helper : public sfDevFPC2534I2C_IRead
         }
         _isInitialized = true;
         _pendingStop = false;
+
+        setupDMA();
     }
     //--------------------------------------------------------------------------------------------
     // Read the payload data from the device - this is called after readTransferSize() to get
@@ -67,8 +79,7 @@ class sfDevFPC2534I2C_Helper : public sfDevFPC2534I2C_IRead
         bool restart0 = _i2cPort->restart_on_next;
 
         _i2cPort->restart_on_next = false;
-        int rc =
-            i2c_read_blocking_until(_i2cPort, _device_address, data, len, false, make_timeout_time_ms(_timeOutMillis));
+        int rc = i2c_read_blocking_until(_i2cPort, _device_address, data, len, false, transferDeadline(len));
 
         // restore the restart flag to its previous state
         _i2cPort->restart_on_next = restart0;
@@ -76,7 +87,10 @@ class sfDevFPC2534I2C_Helper : public sfDevFPC2534I2C_IRead
 
         // Problem?
         if (rc == PICO_ERROR_GENERIC || rc == PICO_ERROR_TIMEOUT)
+        {
+            _lastError = toError(rc);
             len = 0;
+        }
 
         return len;
     }
@@ -94,22 +108,213 @@ class sfDevFPC2534I2C_Helper : public sfDevFPC2534I2C_IRead
         _device_address = device_address;
         uint16_t theSize = 0;
         int rc = i2c_read_blocking_until(_i2cPort, device_address, (uint8_t *)&theSize, sizeof(theSize), true,
-                                         make_timeout_time_ms(_timeOutMillis));
+                                         transferDeadline(sizeof(theSize)));
 
         if (rc == PICO_ERROR_GENERIC || rc == PICO_ERROR_TIMEOUT)
+        {
+            _lastError = toError(rc);
             theSize = 0;
+        }
         else
             _pendingStop = true;
 
         return theSize;
     }
 
+    //--------------------------------------------------------------------------------------------
+    // Continue the read started by readTransferSize() - the payload is read by DMA into data.
+    //
+    bool startPayload(uint8_t *data, size_t len, void (*done)(void *), void *arg)
+    {
+        if (!_pendingStop || _rxChannel < 0 || len == 0)
+            return false;
+
+        _payloadSize = len;
+        _done = done;
+        _doneArg = arg;
+        _complete = false;
+        _deadline = transferDeadline(len);
+
+        i2c_hw_t *hw = i2c_get_hw(_i2cPort);
+        (void)hw->clr_tx_abrt;
+
+        // Receive - from the data register into the buffer
+        dma_channel_config config = dma_channel_get_default_config(_rxChannel);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+        channel_config_set_read_increment(&config, false);
+        channel_config_set_write_increment(&config, true);
+        channel_config_set_dreq(&config, i2c_get_dreq(_i2cPort, false));
+        dma_channel_configure(_rxChannel, &config, data, &hw->data_cmd, len, true);
+
+        // The last read command also ends the transfer (STOP) - chained after the others
+        config = dma_channel_get_default_config(_lastCmdChannel);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+        channel_config_set_read_increment(&config, false);
+        channel_config_set_write_increment(&config, false);
+        channel_config_set_dreq(&config, i2c_get_dreq(_i2cPort, true));
+        dma_channel_configure(_lastCmdChannel, &config, &hw->data_cmd, &kReadStopCommand, 1, len == 1);
+
+        // The read commands - a continued read, so no RESTART
+        if (len > 1)
+        {
+            config = dma_channel_get_default_config(_cmdChannel);
+            channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+            channel_config_set_read_increment(&config, false);
+            channel_config_set_write_increment(&config, false);
+            channel_config_set_dreq(&config, i2c_get_dreq(_i2cPort, true));
+            channel_config_set_chain_to(&config, _lastCmdChannel);
+            dma_channel_configure(_cmdChannel, &config, &hw->data_cmd, &kReadCommand, len - 1, true);
+        }
+
+        _pendingStop = false;
+        return true;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    bool payloadBusy(void)
+    {
+        if (_complete)
+            return false;
+
+        // A NACK aborts the transfer - the DMA would wait forever
+        if (i2c_get_hw(_i2cPort)->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+            return false;
+
+        return !time_reached(_deadline);
+    }
+
+    //--------------------------------------------------------------------------------------------
+    uint16_t finishPayload(void)
+    {
+        while (payloadBusy())
+            tight_loop_contents();
+
+        // the transfer is over - the next transfer of the SDK starts fresh
+        _i2cPort->restart_on_next = false;
+
+        if (_complete)
+            return _payloadSize;
+
+        // why did it fail? The abort source is cleared by the abort
+        i2c_hw_t *hw = i2c_get_hw(_i2cPort);
+        if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+            _lastError = (hw->tx_abrt_source & I2C_IC_TX_ABRT_SOURCE_ARB_LOST_BITS) ? kFPC2534I2CErrorArbitration
+                                                                                   : kFPC2534I2CErrorNack;
+        else
+            _lastError = kFPC2534I2CErrorTimeout;
+
+        abortPayload();
+        return 0;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    sfDevFPC2534I2CError_t lastError(void)
+    {
+        return _lastError;
+    }
+
   private:
+    // Read command for the I2C data register, and the same with STOP for the last byte
+    static constexpr uint32_t kReadCommand = I2C_IC_DATA_CMD_CMD_BITS;
+    static constexpr uint32_t kReadStopCommand = I2C_IC_DATA_CMD_CMD_BITS | I2C_IC_DATA_CMD_STOP_BITS;
+
+    // Timeout - a fixed part plus a per byte part (200 us per byte covers 100 kHz with clock stretching)
+    static constexpr uint32_t kTimeoutBaseUs = 5000;
+    static constexpr uint32_t kTimeoutPerByteUs = 200;
+
+    static absolute_time_t transferDeadline(size_t len)
+    {
+        return make_timeout_time_us(kTimeoutBaseUs + (uint64_t)len * kTimeoutPerByteUs);
+    }
+
+    static sfDevFPC2534I2CError_t toError(int rc)
+    {
+        return rc == PICO_ERROR_TIMEOUT ? kFPC2534I2CErrorTimeout : kFPC2534I2CErrorNack;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // Claim the DMA channels, and hook the completion interrupt. If channels are not available, the
+    // blocking reads are used.
+    void setupDMA(void)
+    {
+        if (_rxChannel >= 0)
+            return;
+
+        int rx = dma_claim_unused_channel(false);
+        int cmd = dma_claim_unused_channel(false);
+        int last = dma_claim_unused_channel(false);
+        if (rx < 0 || cmd < 0 || last < 0)
+        {
+            if (rx >= 0)
+                dma_channel_unclaim(rx);
+            if (cmd >= 0)
+                dma_channel_unclaim(cmd);
+            if (last >= 0)
+                dma_channel_unclaim(last);
+            return;
+        }
+        _rxChannel = rx;
+        _cmdChannel = cmd;
+        _lastCmdChannel = last;
+
+        _instance = this;
+        dma_channel_set_irq1_enabled(_rxChannel, true);
+        irq_add_shared_handler(DMA_IRQ_1, onDMAComplete, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_1, true);
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // DMA interrupt - the last payload byte has been received
+    static void onDMAComplete(void)
+    {
+        sfDevFPC2534I2C_Helper *self = _instance;
+        if (self == nullptr || !dma_channel_get_irq1_status(self->_rxChannel))
+            return;
+
+        dma_channel_acknowledge_irq1(self->_rxChannel);
+        self->_complete = true;
+        if (self->_done != nullptr)
+            self->_done(self->_doneArg);
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // Stop a failed transfer - the DMA channels and the I2C controller
+    void abortPayload(void)
+    {
+        dma_channel_abort(_cmdChannel);
+        dma_channel_abort(_lastCmdChannel);
+        dma_channel_abort(_rxChannel);
+        dma_channel_acknowledge_irq1(_rxChannel);
+
+        i2c_hw_t *hw = i2c_get_hw(_i2cPort);
+        hw_set_bits(&hw->enable, I2C_IC_ENABLE_ABORT_BITS);
+        while (hw->enable & I2C_IC_ENABLE_ABORT_BITS)
+            tight_loop_contents();
+        (void)hw->clr_tx_abrt;
+
+        // drop anything left in the receive FIFO
+        while (hw->rxflr > 0)
+            (void)hw->data_cmd;
+    }
+
+    static inline sfDevFPC2534I2C_Helper *_instance = nullptr;
+
     uint8_t _device_address;
     i2c_inst_t *_i2cPort;
     bool _isInitialized;
     bool _pendingStop;
-    uint16_t _timeOutMillis;
+
+    // DMA payload transfer
+    int _rxChannel;
+    int _cmdChannel;
+    int _lastCmdChannel;
+    size_t _payloadSize;
+    absolute_time_t _deadline;
+    void (*_done)(void *);
+    void *_doneArg;
+    volatile bool _complete;
+
+    sfDevFPC2534I2CError_t _lastError;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,147 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// I2C helper for platforms without a platform specific helper - built on the Arduino Wire API.
+
+#pragma once
+
+#include "sfDevFPC2534I2C.h"
+
+// Generic implementation of the FPC2534 I2C communication class - read protocol.
+//
+// Wire can't continue a read - each requestFrom() is a new read transaction, limited to the Wire buffer size. So
+// the packet is read in chunks as large as the Wire buffer allows, chained with repeated starts (no STOP until
+// the last chunk).
+//
+// EXPERIMENTAL - this assumes the sensor continues the packet across the repeated starts. That has not been
+// verified on hardware: the ESP32 and RP2 helpers read a packet (size and payload) in one read transaction, which
+// Wire can't do. Until it is verified, I2C is not supported on these platforms (AVR, ESP8266, ...) - use SPI or
+// UART there.
+
+#if !defined(ESP32) && !defined(ARDUINO_ARCH_RP2040)
+
+// The chunk size - the size of the Wire buffer, unless set
+#ifndef SFE_FPC2534_WIRE_CHUNK_SIZE
+#if defined(I2C_BUFFER_LENGTH)
+#define SFE_FPC2534_WIRE_CHUNK_SIZE I2C_BUFFER_LENGTH
+#elif defined(BUFFER_LENGTH)
+#define SFE_FPC2534_WIRE_CHUNK_SIZE BUFFER_LENGTH
+#else
+#define SFE_FPC2534_WIRE_CHUNK_SIZE 32
+#endif
+#endif
+
+class sfDevFPC2534I2C_Helper : public sfDevFPC2534I2C_IRead
+{
+  public:
+    sfDevFPC2534I2C_Helper() : _i2cPort{nullptr}, _device_address{0}, _pendingStop{false}, _payloadSize{0}
+    {
+    }
+
+    void setWirePort(TwoWire &wirePort)
+    {
+        _i2cPort = &wirePort;
+    }
+
+    void initialize(uint8_t i2cBusNumber)
+    {
+        // The bus is the Wire port - no bus number needed
+        (void)i2cBusNumber;
+        _pendingStop = false;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // Read the payload data from the device - this is called after readTransferSize() to get
+    // the actual data.
+    //--------------------------------------------------------------------------------------------
+    uint16_t readPayload(size_t len, uint8_t *data)
+    {
+        if (_i2cPort == nullptr || !_pendingStop)
+            return 0;
+
+        _pendingStop = false;
+
+        for (size_t offset = 0; offset < len; offset += kChunkSize)
+        {
+            size_t chunk = len - offset < kChunkSize ? len - offset : kChunkSize;
+
+            // STOP after the last chunk only
+            if (!readChunk(data + offset, chunk, offset + chunk == len))
+                return 0;
+        }
+        return len;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // For the FPC data, the first two bytes are the length of the data to follow. So this method reads in
+    // in the length and returns it. This method is the "start" of a FPC data read operation. It doesn't
+    // stop/end the I2C read operation, that is done in the readPayload() method.
+    //
+    uint16_t readTransferSize(uint8_t device_address)
+    {
+        if (_i2cPort == nullptr)
+            return 0;
+
+        _device_address = device_address;
+        uint16_t theSize = 0;
+        if (!readChunk((uint8_t *)&theSize, sizeof(theSize), false))
+            return 0;
+
+        _pendingStop = true;
+        return theSize;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // The payload is read straight into the buffer of the transport - Wire is blocking, so the transfer is
+    // complete on return.
+    //
+    bool startPayload(uint8_t *data, size_t len, void (*done)(void *), void *arg)
+    {
+        _payloadSize = readPayload(len, data);
+        if (done != nullptr)
+            done(arg);
+        return true;
+    }
+
+    bool payloadBusy(void)
+    {
+        return false;
+    }
+
+    uint16_t finishPayload(void)
+    {
+        return _payloadSize;
+    }
+
+  private:
+    // requestFrom() takes the count as a uint8_t on some platforms
+    static constexpr size_t kChunkSize = SFE_FPC2534_WIRE_CHUNK_SIZE > 255 ? 255 : SFE_FPC2534_WIRE_CHUNK_SIZE;
+
+    //--------------------------------------------------------------------------------------------
+    bool readChunk(uint8_t *data, size_t len, bool sendStop)
+    {
+        size_t nRead = _i2cPort->requestFrom(_device_address, (uint8_t)len, (uint8_t)sendStop);
+
+        for (size_t i = 0; i < nRead && _i2cPort->available(); i++)
+        {
+            uint8_t value = (uint8_t)_i2cPort->read();
+            if (i < len)
+                data[i] = value;
+        }
+        return nRead == len;
+    }
+
+    TwoWire *_i2cPort;
+    uint8_t _device_address;
+    bool _pendingStop;
+    uint16_t _payloadSize;
+};
+
+#endif
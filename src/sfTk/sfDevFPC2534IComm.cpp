@@ -8,10 +8,23 @@
  *---------------------------------------------------------------------------------
  */
 
-#include <Arduino.h>
+#include "sfDevFPC2534Platform.h"
 // Implementation file for the I2C communication class of the library.
 #include "sfDevFPC2534IComm.h"
 
+#if defined(ARDUINO)
+
+// Platform sleep support for waitForData()
+#if defined(ESP32)
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#elif defined(ARDUINO_ARCH_RP2040)
+#include <pico/time.h>
+#elif defined(ARDUINO_ARCH_AVR)
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#endif
+
 // When in I2C comm mode, an interrupt pin from the FPC2534 is used to signal when
 // data is available to read. We manage this here.
 //
@@ -51,6 +64,7 @@ void sfDevFPC2534IComm::initISRHandler(uint32_t interruptPin)
     // us to set the data_available flag in the instance, rather than a static/global flag
     // and possibly support multiple sensors at the same time.
 
+    _interruptPin = interruptPin;
     pinMode(interruptPin, INPUT);
 #if defined(ESP32)
 
@@ -70,12 +84,131 @@ void sfDevFPC2534IComm::initISRHandler(uint32_t interruptPin)
     isISRInitialized = true;
     _usingISRParam = false;
 #endif
+
+    // The IRQ is edge triggered - if the line is already high (raised while the host was in deep sleep for
+    // example), data is waiting.
+    if (digitalRead(interruptPin) == HIGH)
+    {
+        if (_usingISRParam)
+            setISRDataAvailable();
+        else
+            data_available = true;
+    }
 }
+#else
+//--------------------------------------------------------------------------------------------
+// Linux host - there is no ISR. Host transports watch the IRQ line themselves (GPIO character
+// device + epoll) and call setISRDataAvailable() when it fires.
+void sfDevFPC2534IComm::initISRHandler(uint32_t interruptPin)
+{
+    (void)interruptPin;
+    _usingISRParam = true;
+}
+#endif
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534IComm::isIRQAsserted(void)
+{
+#if defined(ARDUINO)
+    return _interruptPin != kFPC2534NoIRQPin && digitalRead(_interruptPin) == HIGH;
+#else
+    // Linux host transports watch the line themselves
+    return false;
+#endif
+}
+
 //--------------------------------------------------------------------------------------------
 void sfDevFPC2534IComm::setISRDataAvailable(void)
 {
     _dataAvailable = true;
+
+    // anyone waiting on this (I/O task)?
+    notifyDataAvailable();
+}
+
+//--------------------------------------------------------------------------------------------
+// Default wait - sleep until the sensor IRQ, then wait for the data. Without an IRQ pin, or once the IRQ
+// fired (the UART IRQ comes before the data), poll for data until the timeout expires.
+bool sfDevFPC2534IComm::waitForData(uint32_t timeoutMs)
+{
+    uint32_t start = millis();
+    while (!dataAvailable())
+    {
+        uint32_t elapsed = millis() - start;
+        if (elapsed >= timeoutMs)
+            return false;
+
+        if (_interruptPin != kFPC2534NoIRQPin && !isISRDataAvailable())
+            sleepUntilIRQ(timeoutMs - elapsed);
+        else
+            delay(1);
+    }
+    return true;
 }
+
+#if defined(ARDUINO)
+//--------------------------------------------------------------------------------------------
+// Platform sleep
+void sfDevFPC2534IComm::sleepUntilIRQ(uint32_t timeoutMs)
+{
+#if defined(ESP32) && !defined(SFE_FPC2534_NO_LIGHT_SLEEP)
+    // Light sleep - wakes on the IRQ level, or the timer. Note: GPIO wakeup changes the interrupt type of the
+    // pin - restore the edge interrupt of the ISR handler after.
+    gpio_num_t pin = (gpio_num_t)_interruptPin;
+    gpio_intr_disable(pin);
+    if (gpio_wakeup_enable(pin, GPIO_INTR_HIGH_LEVEL) != ESP_OK)
+    {
+        gpio_intr_enable(pin);
+        delay(1);
+        return;
+    }
+    esp_sleep_enable_gpio_wakeup();
+    esp_sleep_enable_timer_wakeup((uint64_t)timeoutMs * 1000);
+
+    esp_light_sleep_start();
+
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+    gpio_wakeup_disable(pin);
+    gpio_set_intr_type(pin, GPIO_INTR_POSEDGE);
+    gpio_intr_enable(pin);
+
+    // The edge is not seen by the ISR while asleep - check the level
+    if (digitalRead(_interruptPin) == HIGH)
+        setISRDataAvailable();
+
+#elif defined(ARDUINO_ARCH_RP2040)
+    // Wait for event - any interrupt (the IRQ pin, UART, ...) or the timeout wakes the core
+    best_effort_wfe_or_timeout(make_timeout_time_ms(timeoutMs));
+
+#elif defined(ARDUINO_ARCH_AVR)
+    // Idle - the CPU stops, and any interrupt wakes it (the millis() timer at least every 1 ms). Interrupts
+    // are held off until the sleep instruction, so an IRQ after the check is not missed.
+    (void)timeoutMs;
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    cli();
+    if (!isISRDataAvailable())
+    {
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+    }
+    sei();
+
+#else
+    (void)timeoutMs;
+    delay(1);
+#endif
+}
+#else
+//--------------------------------------------------------------------------------------------
+// Linux host - the transports sleep in the kernel (epoll), this is not used
+void sfDevFPC2534IComm::sleepUntilIRQ(uint32_t timeoutMs)
+{
+    (void)timeoutMs;
+    delay(1);
+}
+#endif
 //--------------------------------------------------------------------------------------------
 // method used to clear the data available flag
 void sfDevFPC2534IComm::clearISRDataAvailable(void)
@@ -83,8 +216,10 @@ void sfDevFPC2534IComm::clearISRDataAvailable(void)
     // Are we using the ISR param method?
     if (_usingISRParam)
         _dataAvailable = false;
+#if defined(ARDUINO)
     else if (isISRInitialized)
         data_available = false;
+#endif
 }
 
 //--------------------------------------------------------------------------------------------
@@ -96,9 +231,13 @@ bool sfDevFPC2534IComm::isISRDataAvailable(void)
     if (_usingISRParam)
         return _dataAvailable;
 
+#if defined(ARDUINO)
     // Nope, using the static ISR and static flag in this file (this only supports one instance)
     if (!isISRInitialized)
         return false;
 
     return data_available;
+#else
+    return false;
+#endif
 }
\ No newline at end of file
@@ -15,10 +15,21 @@
 
 // Define the communication interface for the FPC2534 fingerprint sensor library
 
+// Interrupt pin value for "no IRQ pin connected"
+const uint32_t kFPC2534NoIRQPin = 255;
+
+// Wake pin value for "no wake pin connected"
+const uint32_t kFPC2534NoWakePin = 255;
+
+// Width of the wake pulse on the wake-up pin (CS) of the sensor, in microseconds
+const uint32_t kFPC2534WakePulseUs = 100;
+
 class sfDevFPC2534IComm
 {
   public:
-    sfDevFPC2534IComm() : _dataAvailable{false}, _usingISRParam{true} {};
+    sfDevFPC2534IComm()
+        : _dataAvailable{false}, _usingISRParam{true}, _interruptPin{kFPC2534NoIRQPin}, _notifyCallback{nullptr},
+          _notifyCallbackArg{nullptr} {};
     virtual bool dataAvailable(void) = 0;
     virtual void clearData(void) = 0;
     virtual uint16_t write(const uint8_t *data, size_t len) = 0;
@@ -35,10 +46,57 @@ class sfDevFPC2534IComm
     virtual void beginRead(void) {};
     virtual void endRead(void) {};
 
+    // Wait until data is available, or the timeout expires. The default implementation sleeps the host in the
+    // lightest sleep state that still wakes on the sensor IRQ pin (polls if there is no IRQ pin); transports
+    // that can sleep in the OS until the sensor signals (e.g. Linux epoll) override this.
+    virtual bool waitForData(uint32_t timeoutMs);
+
+    // UART transports - change/report the baud rate of the host side of the link. Used by the baud rate
+    // negotiation of the library. Other transports don't have a baud rate - setBaudRate() returns false.
+    virtual bool setBaudRate(uint32_t baudRate)
+    {
+        (void)baudRate;
+        return false;
+    }
+    virtual uint32_t getBaudRate(void)
+    {
+        return 0;
+    }
+
+    // Wake the sensor from stop mode - a pulse on its wake-up pin (CS). Used by the power manager of the library.
+    // Transports without a wake pin return false.
+    virtual bool wakeSensor(void)
+    {
+        return false;
+    }
+
+    // Bring the link back to a known state - the last recovery step of the watchdog of the library, when the
+    // sensor stays silent after a reset. The default just drops any pending data.
+    virtual bool reinitialize(void)
+    {
+        clearData();
+        return true;
+    }
+
+    // A transfer runs in the background on the bus (I2C asynchronous payload reads) - other sensors on the bus
+    // have to wait for it. Used by the multi-sensor manager of the library to schedule the bus.
+    virtual bool transferPending(void)
+    {
+        return false;
+    }
+
     // public method -- for the ISR handler to set the data available flag for the specific object
     // representing the IRS callback parameter.
     void setISRDataAvailable(void);
 
+    // Register a function that is called (from the ISR) when the sensor signals data is available. This is
+    // used by the I/O task mode to wake the I/O task. Only supported on platforms with ISR parameters.
+    void setDataAvailableCallback(void (*callback)(void *), void *arg)
+    {
+        _notifyCallbackArg = arg;
+        _notifyCallback = callback;
+    }
+
   protected:
     // All communication protocols/types supported by the sensor use an interrupt to signal data availability.
     // This is required for i2c and SPI interfaces (UART is okay b/c of Arduino Serial buffer handling). So
@@ -48,7 +106,25 @@ class sfDevFPC2534IComm
 
     void clearISRDataAvailable(void);
 
+    // Is the IRQ line raised now - the sensor has data waiting? False without an IRQ pin.
+    bool isIRQAsserted(void);
+
+    // Wake anyone waiting on data (the I/O task), without setting the data available flag. Used by transports
+    // that complete transfers in the background.
+    void notifyDataAvailable(void)
+    {
+        if (_notifyCallback != nullptr)
+            _notifyCallback(_notifyCallbackArg);
+    }
+
   private:
+    // Sleep until the IRQ pin is raised - or the timeout expires, or anything else wakes the host
+    void sleepUntilIRQ(uint32_t timeoutMs);
+
     volatile bool _dataAvailable;
     bool _usingISRParam;
+    uint32_t _interruptPin;
+
+    void (*volatile _notifyCallback)(void *);
+    void *volatile _notifyCallbackArg;
 };
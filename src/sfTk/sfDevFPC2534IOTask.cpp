@@ -0,0 +1,472 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Implementation of the optional I/O task mode - FreeRTOS on ESP32, std::thread on a Linux host.
+
+#include "sfDevFPC2534IOTask.h"
+
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+
+#include "sfDevFPC2534.h"
+
+#include <stdlib.h>
+
+#if !defined(ESP32)
+#include <chrono>
+#endif
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534IOTask::sfDevFPC2534IOTask()
+    : _device{nullptr}, _config(kFPC2534IOTaskDefaultConfig), _stats{0}, _slots{nullptr}, _slotMemory{nullptr},
+      _running{false}, _flushRequested{false}
+#if defined(ESP32)
+      ,
+      _task{nullptr}, _readyQueue{nullptr}, _freeQueue{nullptr}, _busLock{nullptr}, _stopped{nullptr}
+#endif
+{
+}
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534IOTask::~sfDevFPC2534IOTask()
+{
+    stop();
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534IOTask::start(sfDevFPC2534 &device, const sfDevFPC2534IOTaskConfig_t &config)
+{
+    if (_running || device._comm == nullptr || device._ioTask != nullptr)
+        return false;
+
+    if (config.frameSize == 0 || config.queueDepth == 0)
+        return false;
+
+    _device = &device;
+    _config = config;
+    resetStats();
+
+    // All frame memory is allocated once, up front
+    _slots = (frame_slot_t *)calloc(_config.queueDepth, sizeof(frame_slot_t));
+    _slotMemory = (uint8_t *)malloc((size_t)_config.queueDepth * _config.frameSize);
+    if (_slots == nullptr || _slotMemory == nullptr)
+    {
+        releaseSlots();
+        return false;
+    }
+    for (uint8_t i = 0; i < _config.queueDepth; i++)
+        _slots[i].payload = _slotMemory + (size_t)i * _config.frameSize;
+
+    if (!createOS())
+    {
+        releaseSlots();
+        return false;
+    }
+
+    // the device now takes frames from our queue
+    _device->_ioTask = this;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534IOTask::stop(void)
+{
+    if (_device == nullptr)
+        return;
+
+    // Back to polled mode first, so the device no longer calls into us
+    lockBus();
+    _device->_ioTask = nullptr;
+    unlockBus();
+
+    destroyOS();
+    releaseSlots();
+    _device = nullptr;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534IOTask::releaseSlots(void)
+{
+    free(_slots);
+    free(_slotMemory);
+    _slots = nullptr;
+    _slotMemory = nullptr;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534IOTask::resetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+//--------------------------------------------------------------------------------------------
+// The I/O task - drain frames from the bus into free slots, and queue them for the application
+//
+void sfDevFPC2534IOTask::run(void)
+{
+    while (_running)
+    {
+        if (_flushRequested)
+        {
+            lockBus();
+            _device->_comm->clearData();
+            unlockBus();
+            _flushRequested = false;
+        }
+
+        // Nothing pending? Sleep until the IRQ fires
+        if (!_device->_comm->dataAvailable())
+        {
+            waitForIRQ(_config.idleWaitMs);
+            if (!_device->_comm->dataAvailable())
+                continue;
+        }
+        uint32_t wokeAt = micros();
+
+        // get a slot - if none are free, the application is behind - wait for it
+        uint8_t index;
+        if (!popFree(index, 0))
+        {
+            _stats.stalls++;
+            if (!popFree(index, _config.idleWaitMs))
+                continue;
+        }
+
+        frame_slot_t &slot = _slots[index];
+
+        lockBus();
+        fpc_result_t rc = _device->readFrame(slot.payload, _config.frameSize, slot.size);
+        unlockBus();
+
+        // A frame too large for a slot was read and discarded - still queued, so a transfer waiting on it fails
+        slot.dropped = rc == FPC_RESULT_OUT_OF_MEMORY;
+        if (slot.dropped)
+            _stats.dropped++;
+        else if (rc != FPC_RESULT_OK)
+        {
+            if (rc != FPC_RESULT_IO_NO_DATA)
+                _stats.errors++;
+            pushFree(index);
+            continue;
+        }
+
+        slot.queuedAt = micros();
+        uint32_t readUs = slot.queuedAt - wokeAt;
+        if (readUs > _stats.maxReadUs)
+            _stats.maxReadUs = readUs;
+        _stats.frames++;
+
+        pushReady(index);
+
+        uint16_t pending = framesPending();
+        if (pending > _stats.queueHighWater)
+            _stats.queueHighWater = (uint8_t)pending;
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// Called from the application context - parse the next frame
+//
+fpc_result_t sfDevFPC2534IOTask::dispatch(uint32_t timeoutMs, bool flushNone)
+{
+    if (!_running)
+        return FPC_RESULT_WRONG_STATE;
+
+    uint8_t index;
+    if (!popReady(index, timeoutMs))
+        return FPC_RESULT_OK; // no data to process
+
+    frame_slot_t &slot = _slots[index];
+
+    uint32_t waitUs = micros() - slot.queuedAt;
+    if (waitUs > _stats.maxDispatchUs)
+        _stats.maxDispatchUs = waitUs;
+    _stats.dispatched++;
+
+    fpc_result_t rc = FPC_RESULT_OK;
+
+    // the data of a transfer is lost - fail it in the application context (calls on_error)
+    if (slot.dropped)
+    {
+        if (_device->_xferActive)
+            _device->failTransfer(FPC_RESULT_OUT_OF_MEMORY);
+        pushFree(index);
+        return FPC_RESULT_OUT_OF_MEMORY;
+    }
+
+    _device->noteFrame(slot.payload, slot.size);
+
+    // if we are flushing NONE events, and this is one, just drop it
+    if (!flushNone || !_device->checkForNoneEvent(slot.payload, slot.size))
+        rc = _device->parseCommand(slot.payload, slot.size);
+
+    pushFree(index);
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534IOTask::flush(void)
+{
+    uint8_t index;
+    while (popReady(index, 0))
+        pushFree(index);
+
+    _flushRequested = true;
+}
+
+#if defined(ESP32)
+//--------------------------------------------------------------------------------------------
+// ESP32 - FreeRTOS
+//--------------------------------------------------------------------------------------------
+
+void sfDevFPC2534IOTask::taskEntry(void *arg)
+{
+    sfDevFPC2534IOTask *self = static_cast<sfDevFPC2534IOTask *>(arg);
+    self->run();
+
+    // signal stop() that we are done - then delete ourselves
+    xSemaphoreGive(self->_stopped);
+    vTaskDelete(nullptr);
+}
+
+//--------------------------------------------------------------------------------------------
+// Called from the sensor IRQ handler (via the comm object) - wake the I/O task. Transports that complete
+// transfers in the background can also call this from task context.
+void IRAM_ATTR sfDevFPC2534IOTask::notifyFromISR(void *arg)
+{
+    sfDevFPC2534IOTask *self = static_cast<sfDevFPC2534IOTask *>(arg);
+    if (self->_task == nullptr)
+        return;
+
+    if (!xPortInIsrContext())
+    {
+        xTaskNotifyGive(self->_task);
+        return;
+    }
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->_task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534IOTask::createOS(void)
+{
+    _readyQueue = xQueueCreate(_config.queueDepth, sizeof(uint8_t));
+    _freeQueue = xQueueCreate(_config.queueDepth, sizeof(uint8_t));
+    _busLock = xSemaphoreCreateMutex();
+    _stopped = xSemaphoreCreateBinary();
+
+    if (_readyQueue == nullptr || _freeQueue == nullptr || _busLock == nullptr || _stopped == nullptr)
+    {
+        destroyOS();
+        return false;
+    }
+    for (uint8_t i = 0; i < _config.queueDepth; i++)
+        pushFree(i);
+
+    _running = true;
+
+    BaseType_t rc;
+    if (_config.core == kFPC2534IOTaskNoAffinity)
+        rc = xTaskCreate(taskEntry, "fpc2534_io", _config.stackSize, this, _config.priority, &_task);
+    else
+        rc = xTaskCreatePinnedToCore(taskEntry, "fpc2534_io", _config.stackSize, this, _config.priority, &_task,
+                                     _config.core);
+    if (rc != pdPASS)
+    {
+        _running = false;
+        _task = nullptr;
+        destroyOS();
+        return false;
+    }
+
+    // The IRQ now wakes the task
+    _device->_comm->setDataAvailableCallback(notifyFromISR, this);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534IOTask::destroyOS(void)
+{
+    if (_device != nullptr && _device->_comm != nullptr)
+        _device->_comm->setDataAvailableCallback(nullptr, nullptr);
+
+    if (_task != nullptr)
+    {
+        _running = false;
+        xTaskNotifyGive(_task);
+        xSemaphoreTake(_stopped, portMAX_DELAY);
+        _task = nullptr;
+    }
+    if (_readyQueue != nullptr)
+        vQueueDelete(_readyQueue);
+    if (_freeQueue != nullptr)
+        vQueueDelete(_freeQueue);
+    if (_busLock != nullptr)
+        vSemaphoreDelete(_busLock);
+    if (_stopped != nullptr)
+        vSemaphoreDelete(_stopped);
+
+    _readyQueue = _freeQueue = nullptr;
+    _busLock = _stopped = nullptr;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534IOTask::waitForIRQ(uint32_t timeoutMs)
+{
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs) > 0 ? pdMS_TO_TICKS(timeoutMs) : 1);
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534IOTask::popReady(uint8_t &index, uint32_t timeoutMs)
+{
+    return _readyQueue != nullptr && xQueueReceive(_readyQueue, &index, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+void sfDevFPC2534IOTask::pushReady(uint8_t index)
+{
+    xQueueSend(_readyQueue, &index, portMAX_DELAY);
+}
+
+bool sfDevFPC2534IOTask::popFree(uint8_t &index, uint32_t timeoutMs)
+{
+    return _freeQueue != nullptr && xQueueReceive(_freeQueue, &index, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+void sfDevFPC2534IOTask::pushFree(uint8_t index)
+{
+    xQueueSend(_freeQueue, &index, portMAX_DELAY);
+}
+
+uint16_t sfDevFPC2534IOTask::framesPending(void) const
+{
+    return _readyQueue != nullptr ? (uint16_t)uxQueueMessagesWaiting(_readyQueue) : 0;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534IOTask::lockBus(void)
+{
+    if (_busLock != nullptr)
+        xSemaphoreTake(_busLock, portMAX_DELAY);
+}
+
+void sfDevFPC2534IOTask::unlockBus(void)
+{
+    if (_busLock != nullptr)
+        xSemaphoreGive(_busLock);
+}
+
+#else
+//--------------------------------------------------------------------------------------------
+// Linux host - std::thread
+//--------------------------------------------------------------------------------------------
+
+bool sfDevFPC2534IOTask::createOS(void)
+{
+    {
+        std::lock_guard<std::mutex> guard(_queueLock);
+        _readyQueue.clear();
+        _freeQueue.clear();
+        for (uint8_t i = 0; i < _config.queueDepth; i++)
+            _freeQueue.push_back(i);
+    }
+    _running = true;
+    _thread = std::thread(&sfDevFPC2534IOTask::run, this);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534IOTask::destroyOS(void)
+{
+    if (_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard(_queueLock);
+            _running = false;
+        }
+        _freeCond.notify_all();
+        _thread.join();
+    }
+    _running = false;
+
+    std::lock_guard<std::mutex> guard(_queueLock);
+    _readyQueue.clear();
+    _freeQueue.clear();
+}
+
+//--------------------------------------------------------------------------------------------
+// The Linux transports sleep in epoll until the IRQ line (or UART) signals
+void sfDevFPC2534IOTask::waitForIRQ(uint32_t timeoutMs)
+{
+    _device->_comm->waitForData(timeoutMs);
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534IOTask::popReady(uint8_t &index, uint32_t timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(_queueLock);
+    if (!_readyCond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return !_readyQueue.empty(); }))
+        return false;
+
+    index = _readyQueue.front();
+    _readyQueue.pop_front();
+    return true;
+}
+
+void sfDevFPC2534IOTask::pushReady(uint8_t index)
+{
+    {
+        std::lock_guard<std::mutex> guard(_queueLock);
+        _readyQueue.push_back(index);
+    }
+    _readyCond.notify_one();
+}
+
+bool sfDevFPC2534IOTask::popFree(uint8_t &index, uint32_t timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(_queueLock);
+    if (!_freeCond.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                            [this] { return !_freeQueue.empty() || !_running; }) ||
+        _freeQueue.empty())
+        return false;
+
+    index = _freeQueue.front();
+    _freeQueue.pop_front();
+    return true;
+}
+
+void sfDevFPC2534IOTask::pushFree(uint8_t index)
+{
+    {
+        std::lock_guard<std::mutex> guard(_queueLock);
+        _freeQueue.push_back(index);
+    }
+    _freeCond.notify_one();
+}
+
+uint16_t sfDevFPC2534IOTask::framesPending(void) const
+{
+    std::lock_guard<std::mutex> guard(_queueLock);
+    return (uint16_t)_readyQueue.size();
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534IOTask::lockBus(void)
+{
+    _busLock.lock();
+}
+
+void sfDevFPC2534IOTask::unlockBus(void)
+{
+    _busLock.unlock();
+}
+
+#endif
+#endif
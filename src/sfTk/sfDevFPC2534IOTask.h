@@ -0,0 +1,205 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Optional I/O task mode for the FPC2534 library.
+//
+// By default the application pumps the library from loop() by calling processNextResponse(), so the
+// response latency is set by the loop period. In I/O task mode, the library owns a dedicated task:
+//
+//   - The sensor IRQ (ISR) sends a notification to the I/O task
+//   - The I/O task wakes, drains all available frames from the bus into a pool of frame slots, and
+//     queues them for the application
+//   - The application calls processNextResponse() (or dispatch()) as before - queued frames are parsed
+//     and the callbacks are called in the application context
+//
+// Commands sent by the application (sendCommand()) and the bus reads of the I/O task are serialized with
+// a bus lock.
+//
+// On ESP32 this is a FreeRTOS task (with core affinity and priority controls), on a Linux host it is
+// a std::thread, which allows the same logic to be run and tested on a desktop.
+
+#pragma once
+
+#include "sfDevFPC2534Platform.h"
+
+#if defined(SFE_FPC2534_HAS_IO_TASK)
+
+// from the FPC SDK
+#include "fpc_api.h"
+
+// SFE_FPC2534_XFER_CHUNK_SIZE
+#include "sfDevFPC2534.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#else
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+class sfDevFPC2534;
+
+// Use any core for the I/O task
+const int8_t kFPC2534IOTaskNoAffinity = -1;
+
+//--------------------------------------------------------------------------------------------
+// I/O task configuration
+typedef struct
+{
+    // Largest frame payload to queue - larger frames are read and dropped (and fail a template or image transfer).
+    uint16_t frameSize;
+    // Number of frame slots - when all are in use, the I/O task waits for the application.
+    uint8_t queueDepth;
+    // Max time the I/O task sleeps between checks of the bus when no IRQ notification arrives (UART has
+    // no IRQ in the library). Also bounds the time stop() takes.
+    uint16_t idleWaitMs;
+    // FreeRTOS task settings (ESP32 only)
+    uint32_t stackSize;
+    uint8_t priority;
+    int8_t core;
+} sfDevFPC2534IOTaskConfig_t;
+
+// Defaults - frame size covers all responses and events, including a CMD_DATA_GET response of a full transfer chunk
+//   {frameSize, queueDepth, idleWaitMs, stackSize, priority, core}
+const sfDevFPC2534IOTaskConfig_t kFPC2534IOTaskDefaultConfig = {
+    sizeof(fpc_cmd_data_get_response_t) + SFE_FPC2534_XFER_CHUNK_SIZE, 8, 10, 4096, 5, 1};
+
+//--------------------------------------------------------------------------------------------
+// I/O task statistics
+typedef struct
+{
+    uint32_t frames;          // frames read from the bus
+    uint32_t dispatched;      // frames parsed by the application
+    uint32_t stalls;          // times the I/O task had to wait for a free slot (queue full)
+    uint32_t dropped;         // frames too large for a slot - an active transfer fails
+    uint32_t errors;          // bus read errors
+    uint32_t maxReadUs;       // max time from IRQ wake to frame queued
+    uint32_t maxDispatchUs;   // max time a frame waited in the queue for the application
+    uint8_t queueHighWater;   // max number of queued frames
+} sfDevFPC2534IOTaskStats_t;
+
+//--------------------------------------------------------------------------------------------
+class sfDevFPC2534IOTask
+{
+  public:
+    sfDevFPC2534IOTask();
+    ~sfDevFPC2534IOTask();
+
+    /**
+     * @brief Start the I/O task for the given device. The device must be initialized.
+     *
+     * Once started, processNextResponse() on the device takes frames from the I/O task queue.
+     *
+     * @param device The initialized device object
+     * @param config Task configuration
+     * @return true on success
+     */
+    bool start(sfDevFPC2534 &device, const sfDevFPC2534IOTaskConfig_t &config = kFPC2534IOTaskDefaultConfig);
+
+    /**
+     * @brief Stop the I/O task and return the device to polled mode. Queued frames are dropped.
+     */
+    void stop(void);
+
+    bool isRunning(void) const
+    {
+        return _running;
+    }
+
+    /**
+     * @brief Parse the next queued frame, calling the device callbacks in the caller context.
+     *
+     * @param timeoutMs Time to wait for a frame - 0 returns immediately
+     * @param flushNone If true, NONE events are dropped
+     * @return FPC_RESULT_OK if no frame was queued, or the result of parsing the frame
+     */
+    fpc_result_t dispatch(uint32_t timeoutMs, bool flushNone = false);
+
+    /**
+     * @brief Number of frames waiting to be dispatched
+     */
+    uint16_t framesPending(void) const;
+
+    /**
+     * @brief Drop all queued frames. The I/O task clears any pending data on the bus.
+     */
+    void flush(void);
+
+    void getStats(sfDevFPC2534IOTaskStats_t &stats) const
+    {
+        stats = _stats;
+    }
+    void resetStats(void);
+
+    // Bus lock - used by the device to serialize commands with the I/O task reads
+    void lockBus(void);
+    void unlockBus(void);
+
+  private:
+    // A frame read from the bus
+    typedef struct
+    {
+        uint8_t *payload;
+        uint16_t size;
+        bool dropped;      // too large - queued so the application learns of it in order
+        uint32_t queuedAt; // micros()
+    } frame_slot_t;
+
+    void run(void);
+
+    // pass the slot index between the I/O task and the application
+    bool popReady(uint8_t &index, uint32_t timeoutMs);
+    void pushReady(uint8_t index);
+    bool popFree(uint8_t &index, uint32_t timeoutMs);
+    void pushFree(uint8_t index);
+
+    // Sleep until the IRQ fires or the timeout expires
+    void waitForIRQ(uint32_t timeoutMs);
+
+    bool createOS(void);
+    void destroyOS(void);
+    void releaseSlots(void);
+
+    sfDevFPC2534 *_device;
+    sfDevFPC2534IOTaskConfig_t _config;
+    sfDevFPC2534IOTaskStats_t _stats;
+
+    frame_slot_t *_slots;
+    uint8_t *_slotMemory;
+
+    volatile bool _running;
+    volatile bool _flushRequested;
+
+#if defined(ESP32)
+    static void taskEntry(void *arg);
+    static void notifyFromISR(void *arg);
+
+    TaskHandle_t _task;
+    QueueHandle_t _readyQueue;
+    QueueHandle_t _freeQueue;
+    SemaphoreHandle_t _busLock;
+    SemaphoreHandle_t _stopped;
+#else
+    std::thread _thread;
+    mutable std::mutex _queueLock;
+    std::condition_variable _readyCond;
+    std::condition_variable _freeCond;
+    std::deque<uint8_t> _readyQueue;
+    std::deque<uint8_t> _freeQueue;
+    std::mutex _busLock;
+#endif
+};
+
+#endif
@@ -0,0 +1,732 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Implementation of the Linux userspace transports
+
+#include "sfDevFPC2534Linux.h"
+
+#if defined(SFE_FPC2534_LINUX_HOST)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <linux/gpio.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <linux/spi/spidev.h>
+
+// The SPI datasheet delay needed after CS goes low before clocking data (see sfDevFPC2534SPI)
+static const uint16_t kSPICSDelayUs = 600;
+
+// How long a UART read waits for the rest of a frame that is still on the wire
+static const int32_t kUARTReadTimeoutMs = 100;
+
+//--------------------------------------------------------------------------------------------
+// sfDevFPC2534LinuxComm
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534LinuxComm::sfDevFPC2534LinuxComm() : _epollFd{-1}, _irqFd{-1}, _wakeFd{-1}
+{
+}
+
+sfDevFPC2534LinuxComm::~sfDevFPC2534LinuxComm()
+{
+    end();
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534LinuxComm::end(void)
+{
+    if (_irqFd >= 0)
+        close(_irqFd);
+    if (_wakeFd >= 0)
+        close(_wakeFd);
+    if (_epollFd >= 0)
+        close(_epollFd);
+    _irqFd = -1;
+    _wakeFd = -1;
+    _epollFd = -1;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534LinuxComm::openEpoll(void)
+{
+    if (_epollFd >= 0)
+        return true;
+
+    _epollFd = epoll_create1(EPOLL_CLOEXEC);
+    return _epollFd >= 0;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534LinuxComm::watchFd(int fd)
+{
+    if (!openEpoll())
+        return false;
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+//--------------------------------------------------------------------------------------------
+// Request the IRQ line as an input with rising edge events - the same edge used by the Arduino ISR
+//
+bool sfDevFPC2534LinuxComm::attachIRQ(const char *gpioChip, uint32_t lineOffset)
+{
+    if (gpioChip == nullptr)
+        return false;
+
+    int chipFd = open(gpioChip, O_RDONLY | O_CLOEXEC);
+    if (chipFd < 0)
+        return false;
+
+    struct gpio_v2_line_request req = {};
+    req.offsets[0] = lineOffset;
+    req.num_lines = 1;
+    req.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING;
+    strncpy(req.consumer, "sfDevFPC2534", sizeof(req.consumer) - 1);
+
+    int rc = ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &req);
+    close(chipFd);
+    if (rc < 0)
+        return false;
+
+    if (_irqFd >= 0)
+        close(_irqFd);
+    _irqFd = req.fd;
+
+    // The IRQ is edge triggered - if the line is already high, data is waiting.
+    struct gpio_v2_line_values values = {};
+    values.mask = 1;
+    if (ioctl(_irqFd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) == 0 && (values.bits & 1))
+        setISRDataAvailable();
+
+    return watchFd(_irqFd);
+}
+
+//--------------------------------------------------------------------------------------------
+// Request the wake line as an output, idle high
+//
+bool sfDevFPC2534LinuxComm::attachWakePin(const char *gpioChip, uint32_t lineOffset)
+{
+    if (gpioChip == nullptr)
+        return false;
+
+    int chipFd = open(gpioChip, O_RDONLY | O_CLOEXEC);
+    if (chipFd < 0)
+        return false;
+
+    struct gpio_v2_line_request req = {};
+    req.offsets[0] = lineOffset;
+    req.num_lines = 1;
+    req.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+    req.config.num_attrs = 1;
+    req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+    req.config.attrs[0].attr.values = 1;
+    req.config.attrs[0].mask = 1;
+    strncpy(req.consumer, "sfDevFPC2534", sizeof(req.consumer) - 1);
+
+    int rc = ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &req);
+    close(chipFd);
+    if (rc < 0)
+        return false;
+
+    if (_wakeFd >= 0)
+        close(_wakeFd);
+    _wakeFd = req.fd;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534LinuxComm::wakeSensor(void)
+{
+    if (_wakeFd < 0)
+        return false;
+
+    struct gpio_v2_line_values values = {};
+    values.mask = 1;
+    values.bits = 0;
+    if (ioctl(_wakeFd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) < 0)
+        return false;
+
+    delayMicroseconds(kFPC2534WakePulseUs);
+
+    values.bits = 1;
+    return ioctl(_wakeFd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) == 0;
+}
+
+//--------------------------------------------------------------------------------------------
+// Wait on the epoll set, dispatching the events. Returns true if anything was signaled.
+//
+bool sfDevFPC2534LinuxComm::servicePoll(int32_t timeoutMs)
+{
+    if (_epollFd < 0)
+        return false;
+
+    struct epoll_event events[4];
+    int n;
+    do
+    {
+        n = epoll_wait(_epollFd, events, 4, timeoutMs < 0 ? -1 : (int)timeoutMs);
+    } while (n < 0 && errno == EINTR);
+
+    for (int i = 0; i < n; i++)
+    {
+        int fd = events[i].data.fd;
+        if (fd == _irqFd)
+        {
+            // drain the edge events from the line
+            struct gpio_v2_line_event lineEvents[8];
+            while (::read(_irqFd, lineEvents, sizeof(lineEvents)) == (ssize_t)sizeof(lineEvents))
+                ;
+            setISRDataAvailable();
+        }
+        else
+            onReadable(fd);
+    }
+    return n > 0;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534LinuxComm::waitForData(uint32_t timeoutMs)
+{
+    if (dataAvailable())
+        return true;
+
+    // no IRQ line or port being watched? Fall back to polling
+    if (_epollFd < 0)
+        return sfDevFPC2534IComm::waitForData(timeoutMs);
+
+    // Sleep in epoll until something is signaled, or we time out
+    unsigned long start = millis();
+    while (true)
+    {
+        uint32_t elapsed = (uint32_t)(millis() - start);
+        if (elapsed >= timeoutMs)
+            return dataAvailable();
+
+        servicePoll((int32_t)(timeoutMs - elapsed));
+        if (dataAvailable())
+            return true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// sfDevFPC2534LinuxI2C
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534LinuxI2C::sfDevFPC2534LinuxI2C() : _fd{-1}, _address{0}, _dataCount{0}, _dataTail{0}
+{
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534LinuxI2C::initialize(const char *device, uint8_t address)
+{
+    if (device == nullptr)
+        return false;
+
+    end();
+    _fd = open(device, O_RDWR | O_CLOEXEC);
+    if (_fd < 0)
+        return false;
+
+    // We need plain I2C transfers (I2C_RDWR) - check the adapter supports them
+    unsigned long funcs = 0;
+    if (ioctl(_fd, I2C_FUNCS, &funcs) < 0 || (funcs & I2C_FUNC_I2C) == 0)
+    {
+        end();
+        return false;
+    }
+    _address = address;
+
+    // Host transports always use the per-instance data flag
+    sfDevFPC2534IComm::initISRHandler(0);
+    clearData();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534LinuxI2C::end(void)
+{
+    if (_fd >= 0)
+        close(_fd);
+    _fd = -1;
+    sfDevFPC2534LinuxComm::end();
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534LinuxI2C::dataAvailable(void)
+{
+    if (_fd < 0)
+        return false;
+
+    // pick up any IRQ edges without blocking
+    servicePoll(0);
+    return isISRDataAvailable() || _dataCount > 0;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534LinuxI2C::clearData(void)
+{
+    _dataCount = 0;
+    _dataTail = 0;
+    clearISRDataAvailable();
+}
+
+//--------------------------------------------------------------------------------------------
+// Write data - the FPC I2C protocol prefixes each write with the packet size. The prefix and
+// data are sent as one I2C message.
+//
+uint16_t sfDevFPC2534LinuxI2C::write(const uint8_t *data, size_t len)
+{
+    if (_fd < 0)
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    if (len > MAX_HOST_PACKET_SIZE_DEFAULT)
+        return FPC_RESULT_INVALID_PARAM;
+
+    uint8_t buffer[len + 2];
+    buffer[0] = len & 0xFF;
+    buffer[1] = (len >> 8) & 0xFF;
+    memcpy(&buffer[2], data, len);
+
+    struct i2c_msg msg = {_address, 0, (uint16_t)sizeof(buffer), buffer};
+    struct i2c_rdwr_ioctl_data xfer = {&msg, 1};
+
+    return ioctl(_fd, I2C_RDWR, &xfer) < 0 ? FPC_RESULT_FAILURE : FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Read the next packet from the sensor. The packet is length prefixed. i2c-dev cannot hold the bus
+// between ioctl calls, so the size is peeked with a short read, then the whole packet (prefix +
+// payload) is read in a single combined transfer. Reading the packet again after the STOP of the
+// peek is not verified on hardware - the prefix check below catches a sensor that moved on.
+//
+bool sfDevFPC2534LinuxI2C::fetchPacket(void)
+{
+    uint16_t theSize = 0;
+    struct i2c_msg msg = {_address, I2C_M_RD, sizeof(theSize), (uint8_t *)&theSize};
+    struct i2c_rdwr_ioctl_data xfer = {&msg, 1};
+
+    if (ioctl(_fd, I2C_RDWR, &xfer) < 0)
+        return false;
+
+    if (theSize == 0 || theSize > kDataBufferSize - 2)
+        return false;
+
+    msg.len = theSize + 2;
+    msg.buf = _dataBuffer;
+    if (ioctl(_fd, I2C_RDWR, &xfer) < 0)
+        return false;
+
+    // the prefix should match what we peeked
+    if ((uint16_t)(_dataBuffer[0] | (_dataBuffer[1] << 8)) != theSize)
+        return false;
+
+    _dataTail = 2;
+    _dataCount = theSize;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+uint16_t sfDevFPC2534LinuxI2C::read(uint8_t *data, size_t len)
+{
+    if (_fd < 0)
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    // new packet available and our buffer is drained?
+    if (_dataCount == 0 && isISRDataAvailable())
+    {
+        clearISRDataAvailable();
+        if (!fetchPacket())
+        {
+            _dataCount = 0;
+            return FPC_RESULT_IO_BAD_DATA;
+        }
+    }
+
+    if (data == nullptr)
+        return FPC_RESULT_INVALID_PARAM;
+
+    if (len == 0)
+        return FPC_RESULT_OK;
+
+    if (len > _dataCount)
+        return FPC_RESULT_IO_NO_DATA;
+
+    memcpy(data, &_dataBuffer[_dataTail], len);
+    _dataTail += len;
+    _dataCount -= len;
+
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// sfDevFPC2534LinuxSPI
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534LinuxSPI::sfDevFPC2534LinuxSPI()
+    : _fd{-1}, _speedHz{kFPC2534LinuxSPISpeedHz}, _inWrite{false}, _inRead{false}, _csAsserted{false}, _writeCount{0}
+{
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534LinuxSPI::initialize(const char *device, uint32_t speedHz)
+{
+    if (device == nullptr)
+        return false;
+
+    end();
+    _fd = open(device, O_RDWR | O_CLOEXEC);
+    if (_fd < 0)
+        return false;
+
+    uint8_t mode = SPI_MODE_0;
+    uint8_t bits = 8;
+    if (ioctl(_fd, SPI_IOC_WR_MODE, &mode) < 0 || ioctl(_fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(_fd, SPI_IOC_WR_MAX_SPEED_HZ, &speedHz) < 0)
+    {
+        end();
+        return false;
+    }
+    _speedHz = speedHz;
+
+    sfDevFPC2534IComm::initISRHandler(0);
+    clearData();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534LinuxSPI::end(void)
+{
+    if (_fd >= 0)
+        close(_fd);
+    _fd = -1;
+    sfDevFPC2534LinuxComm::end();
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534LinuxSPI::dataAvailable(void)
+{
+    if (_fd < 0)
+        return false;
+
+    servicePoll(0);
+    return isISRDataAvailable();
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534LinuxSPI::clearData(void)
+{
+    clearISRDataAvailable();
+}
+
+//--------------------------------------------------------------------------------------------
+// Run one SPI message. If CS is not yet asserted, a zero length transfer carrying the datasheet
+// CS setup delay is prepended. If keepCS is set, CS stays asserted after the message (spidev
+// cs_change on the last transfer) so the next message continues the same transaction.
+//
+bool sfDevFPC2534LinuxSPI::transfer(const uint8_t *tx, uint8_t *rx, size_t len, bool keepCS)
+{
+    struct spi_ioc_transfer xfer[2] = {};
+    int n = 0;
+
+    if (!_csAsserted)
+    {
+        xfer[n].speed_hz = _speedHz;
+        xfer[n].delay_usecs = kSPICSDelayUs;
+        n++;
+    }
+    xfer[n].tx_buf = (uintptr_t)tx;
+    xfer[n].rx_buf = (uintptr_t)rx;
+    xfer[n].len = (uint32_t)len;
+    xfer[n].speed_hz = _speedHz;
+    xfer[n].cs_change = keepCS ? 1 : 0;
+    n++;
+
+    if (ioctl(_fd, SPI_IOC_MESSAGE(n), xfer) < 0)
+    {
+        _csAsserted = false;
+        return false;
+    }
+    _csAsserted = keepCS;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534LinuxSPI::beginWrite(void)
+{
+    _writeCount = 0;
+    _inWrite = true;
+}
+
+//--------------------------------------------------------------------------------------------
+// All the blocks of the write are sent in one full duplex message
+void sfDevFPC2534LinuxSPI::endWrite(void)
+{
+    if (_fd < 0 || !_inWrite)
+        return;
+
+    if (_writeCount > 0)
+        transfer(_writeBuffer, nullptr, _writeCount, false);
+
+    _writeCount = 0;
+    _inWrite = false;
+}
+
+//--------------------------------------------------------------------------------------------
+uint16_t sfDevFPC2534LinuxSPI::write(const uint8_t *data, size_t len)
+{
+    if (_fd < 0)
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    if (!_inWrite)
+        return transfer(data, nullptr, len, false) ? FPC_RESULT_OK : FPC_RESULT_FAILURE;
+
+    if (_writeCount + len > kWriteBufferSize)
+        return FPC_RESULT_INVALID_PARAM;
+
+    memcpy(&_writeBuffer[_writeCount], data, len);
+    _writeCount += len;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534LinuxSPI::beginRead(void)
+{
+    _inRead = true;
+}
+
+//--------------------------------------------------------------------------------------------
+// End the read transaction - release CS if a read left it asserted
+void sfDevFPC2534LinuxSPI::endRead(void)
+{
+    if (_fd >= 0 && _csAsserted)
+    {
+        struct spi_ioc_transfer xfer = {};
+        xfer.speed_hz = _speedHz;
+        ioctl(_fd, SPI_IOC_MESSAGE(1), &xfer);
+        _csAsserted = false;
+    }
+    _inRead = false;
+}
+
+//--------------------------------------------------------------------------------------------
+uint16_t sfDevFPC2534LinuxSPI::read(uint8_t *data, size_t len)
+{
+    if (_fd < 0)
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    if (len == 0)
+        return FPC_RESULT_OK;
+
+    if (data == nullptr)
+        return FPC_RESULT_INVALID_PARAM;
+
+    if (_inWrite)
+        endWrite();
+
+    if (!_inRead)
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    clearISRDataAvailable();
+
+    // Keep CS asserted between the blocks of the read - endRead() releases it
+    memset(data, 0, len);
+    return transfer(data, data, len, true) ? FPC_RESULT_OK : FPC_RESULT_IO_RUNTIME_FAILURE;
+}
+
+//--------------------------------------------------------------------------------------------
+// sfDevFPC2534LinuxUART
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534LinuxUART::sfDevFPC2534LinuxUART() : _fd{-1}, _baudRate{0}, _dataHead{0}, _dataTail{0}, _dataCount{0}
+{
+}
+
+//--------------------------------------------------------------------------------------------
+static speed_t baudToSpeed(uint32_t baudRate)
+{
+    switch (baudRate)
+    {
+    case 9600:
+        return B9600;
+    case 19200:
+        return B19200;
+    case 57600:
+        return B57600;
+    case 115200:
+        return B115200;
+    case 921600:
+        return B921600;
+    default:
+        return B0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534LinuxUART::initialize(const char *device, uint32_t baudRate)
+{
+    if (device == nullptr)
+        return false;
+
+    end();
+    _fd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (_fd < 0)
+        return false;
+
+    if (!setBaudRate(baudRate) || !watchFd(_fd))
+    {
+        end();
+        return false;
+    }
+    clearData();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534LinuxUART::setBaudRate(uint32_t baudRate)
+{
+    speed_t speed = baudToSpeed(baudRate);
+    if (_fd < 0 || speed == B0)
+        return false;
+
+    struct termios tio;
+    if (tcgetattr(_fd, &tio) != 0)
+        return false;
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+
+    // wait for pending output to go out at the old rate
+    if (tcsetattr(_fd, TCSADRAIN, &tio) != 0)
+        return false;
+
+    _baudRate = baudRate;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534LinuxUART::end(void)
+{
+    if (_fd >= 0)
+        close(_fd);
+    _fd = -1;
+    sfDevFPC2534LinuxComm::end();
+}
+
+//--------------------------------------------------------------------------------------------
+// Move whatever the kernel has into our FIFO
+void sfDevFPC2534LinuxUART::fillBuffer(void)
+{
+    while (_dataCount < kDataBufferSize)
+    {
+        // read into the contiguous free region of the FIFO
+        size_t space = _dataHead >= _dataTail ? kDataBufferSize - _dataHead : _dataTail - _dataHead;
+        space = space < kDataBufferSize - _dataCount ? space : kDataBufferSize - _dataCount;
+
+        ssize_t n = ::read(_fd, &_dataBuffer[_dataHead], space);
+        if (n <= 0)
+            break;
+
+        _dataHead = (_dataHead + (size_t)n) % kDataBufferSize;
+        _dataCount += (size_t)n;
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534LinuxUART::onReadable(int fd)
+{
+    if (fd == _fd)
+        fillBuffer();
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534LinuxUART::dataAvailable(void)
+{
+    if (_fd < 0)
+        return false;
+
+    servicePoll(0);
+    return _dataCount > 0;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534LinuxUART::clearData(void)
+{
+    if (_fd >= 0)
+        tcflush(_fd, TCIFLUSH);
+
+    _dataHead = 0;
+    _dataTail = 0;
+    _dataCount = 0;
+    clearISRDataAvailable();
+}
+
+//--------------------------------------------------------------------------------------------
+uint16_t sfDevFPC2534LinuxUART::write(const uint8_t *data, size_t len)
+{
+    if (_fd < 0)
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    size_t nWritten = 0;
+    while (nWritten < len)
+    {
+        ssize_t n = ::write(_fd, data + nWritten, len - nWritten);
+        if (n < 0)
+        {
+            if (errno == EAGAIN || errno == EINTR)
+            {
+                tcdrain(_fd);
+                continue;
+            }
+            return FPC_RESULT_FAILURE;
+        }
+        nWritten += (size_t)n;
+    }
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Same semantics as the Arduino UART transport - all or nothing reads
+uint16_t sfDevFPC2534LinuxUART::read(uint8_t *data, size_t len)
+{
+    if (_fd < 0)
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    fillBuffer();
+
+    // The frame header can arrive before the payload - give the rest of the frame time to arrive,
+    // sleeping in epoll rather than spinning
+    unsigned long start = millis();
+    while (_dataCount < len && (int32_t)(millis() - start) < kUARTReadTimeoutMs)
+        servicePoll(kUARTReadTimeoutMs - (int32_t)(millis() - start));
+
+    if (_dataCount == 0 || _dataCount < len)
+        return FPC_RESULT_IO_NO_DATA;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        data[i] = _dataBuffer[_dataTail];
+        _dataTail = (_dataTail + 1) % kDataBufferSize;
+    }
+    _dataCount -= len;
+
+    return FPC_RESULT_OK;
+}
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Linux userspace transports for the FPC2534 - for use on embedded Linux gateways.
+//
+//   sfDevFPC2534LinuxI2C   - /dev/i2c-*    (i2c-dev, I2C_RDWR combined transfers)
+//   sfDevFPC2534LinuxSPI   - /dev/spidev*  (spidev, batched full-duplex SPI_IOC_MESSAGE transfers)
+//   sfDevFPC2534LinuxUART  - /dev/tty*     (POSIX termios)
+//
+// The IRQ pin of the sensor is monitored through the GPIO character device (/dev/gpiochipN) and
+// epoll, so waitForData() sleeps in the kernel until the sensor signals data, instead of polling.
+//
+// The I2C transport is EXPERIMENTAL - i2c-dev ends every transfer with a STOP, so a packet can't be read in one
+// read transaction whose length is learned part way through (as the ESP32 and RP2 helpers do). The size is read
+// first, then the whole packet is read again - this assumes the sensor serves the same packet again after the
+// STOP, which has not been verified on hardware. The Wire reader on other Arduino platforms relies on a different
+// unverified behaviour (a packet continued across repeated starts) - see sfDevFPC2534I2C_wire.h.
+//
+// These are only built on a Linux host (no ARDUINO define).
+
+#pragma once
+
+#include "sfDevFPC2534Platform.h"
+
+#if defined(SFE_FPC2534_LINUX_HOST)
+
+// from the FPC SDK
+#include "fpc_api.h"
+
+#include "sfDevFPC2534IComm.h"
+
+// Default SPI clock used for the sensor - matches the Arduino SPI implementation
+const uint32_t kFPC2534LinuxSPISpeedHz = 3000000;
+
+//--------------------------------------------------------------------------------------------
+// Base class for the Linux transports - manages the epoll set and the GPIO IRQ line
+//
+class sfDevFPC2534LinuxComm : public sfDevFPC2534IComm
+{
+  public:
+    sfDevFPC2534LinuxComm();
+    virtual ~sfDevFPC2534LinuxComm();
+
+    /**
+     * @brief Monitor the sensor IRQ pin via the GPIO character device. Call after initialize().
+     *
+     * @param gpioChip Path to the GPIO chip device (e.g. "/dev/gpiochip0")
+     * @param lineOffset Line offset of the IRQ pin on the chip
+     * @return true on success
+     */
+    bool attachIRQ(const char *gpioChip, uint32_t lineOffset);
+
+    /**
+     * @brief Drive the sensor wake-up pin (CS) via the GPIO character device - needed to wake the sensor from
+     * stop mode (UART). Call after initialize().
+     *
+     * @param gpioChip Path to the GPIO chip device (e.g. "/dev/gpiochip0")
+     * @param lineOffset Line offset of the wake pin on the chip
+     * @return true on success
+     */
+    bool attachWakePin(const char *gpioChip, uint32_t lineOffset);
+
+    /**
+     * @brief Pulse the wake pin - false if no wake pin is attached
+     */
+    bool wakeSensor(void) override;
+
+    /**
+     * @brief Sleep in the kernel until the sensor signals data (or timeout).
+     *
+     * @param timeoutMs Timeout in milliseconds.
+     * @return true - if data is available
+     */
+    bool waitForData(uint32_t timeoutMs) override;
+
+    // Close all file descriptors
+    virtual void end(void);
+
+  protected:
+    // add a file descriptor to the epoll set
+    bool watchFd(int fd);
+
+    // handle any pending epoll events. Returns true if anything was signaled
+    bool servicePoll(int32_t timeoutMs);
+
+    // called by servicePoll() when a watched (non IRQ) descriptor is readable
+    virtual void onReadable(int fd)
+    {
+        (void)fd;
+    }
+
+    bool openEpoll(void);
+
+    int _epollFd;
+    int _irqFd;
+    int _wakeFd;
+};
+
+//--------------------------------------------------------------------------------------------
+// i2c-dev transport
+//
+class sfDevFPC2534LinuxI2C : public sfDevFPC2534LinuxComm
+{
+  public:
+    sfDevFPC2534LinuxI2C();
+    ~sfDevFPC2534LinuxI2C()
+    {
+        end();
+    }
+
+    /**
+     * @brief Open the I2C bus device
+     *
+     * @param device Bus device path (e.g. "/dev/i2c-1")
+     * @param address 7 bit I2C address of the sensor
+     * @return true on success
+     */
+    bool initialize(const char *device, uint8_t address);
+
+    bool dataAvailable(void) override;
+    void clearData(void) override;
+    uint16_t write(const uint8_t *data, size_t len) override;
+    uint16_t read(uint8_t *data, size_t len) override;
+    void end(void) override;
+
+  private:
+    bool fetchPacket(void);
+
+    int _fd;
+    uint8_t _address;
+
+    // Packet received from the sensor and read position
+    static constexpr size_t kDataBufferSize = MAX_HOST_PACKET_SIZE_DEFAULT + 2;
+    uint8_t _dataBuffer[kDataBufferSize];
+    size_t _dataCount;
+    size_t _dataTail;
+};
+
+//--------------------------------------------------------------------------------------------
+// spidev transport
+//
+class sfDevFPC2534LinuxSPI : public sfDevFPC2534LinuxComm
+{
+  public:
+    sfDevFPC2534LinuxSPI();
+    ~sfDevFPC2534LinuxSPI()
+    {
+        end();
+    }
+
+    /**
+     * @brief Open the SPI device
+     *
+     * @param device spidev device path (e.g. "/dev/spidev0.0")
+     * @param speedHz SPI clock speed
+     * @return true on success
+     */
+    bool initialize(const char *device, uint32_t speedHz = kFPC2534LinuxSPISpeedHz);
+
+    bool dataAvailable(void) override;
+    void clearData(void) override;
+    uint16_t write(const uint8_t *data, size_t len) override;
+    uint16_t read(uint8_t *data, size_t len) override;
+
+    void beginWrite(void) override;
+    void endWrite(void) override;
+    void beginRead(void) override;
+    void endRead(void) override;
+    void end(void) override;
+
+  private:
+    bool transfer(const uint8_t *tx, uint8_t *rx, size_t len, bool keepCS);
+
+    int _fd;
+    uint32_t _speedHz;
+    bool _inWrite;
+    bool _inRead;
+    bool _csAsserted;
+
+    // Writes are batched and sent as one SPI message in endWrite()
+    static constexpr size_t kWriteBufferSize = MAX_HOST_PACKET_SIZE_DEFAULT;
+    uint8_t _writeBuffer[kWriteBufferSize];
+    size_t _writeCount;
+};
+
+//--------------------------------------------------------------------------------------------
+// termios UART transport
+//
+class sfDevFPC2534LinuxUART : public sfDevFPC2534LinuxComm
+{
+  public:
+    sfDevFPC2534LinuxUART();
+    ~sfDevFPC2534LinuxUART()
+    {
+        end();
+    }
+
+    /**
+     * @brief Open and configure the serial device (8N1, raw)
+     *
+     * @param device tty device path (e.g. "/dev/ttyAMA0")
+     * @param baudRate Baud rate - the sensor default is 921600
+     * @return true on success
+     */
+    bool initialize(const char *device, uint32_t baudRate = 921600);
+
+    /**
+     * @brief Change the baud rate of the open port
+     */
+    bool setBaudRate(uint32_t baudRate) override;
+
+    uint32_t getBaudRate(void) override
+    {
+        return _baudRate;
+    }
+
+    bool dataAvailable(void) override;
+    void clearData(void) override;
+    uint16_t write(const uint8_t *data, size_t len) override;
+    uint16_t read(uint8_t *data, size_t len) override;
+    void end(void) override;
+
+  protected:
+    void onReadable(int fd) override;
+
+  private:
+    void fillBuffer(void);
+
+    int _fd;
+    uint32_t _baudRate;
+
+    // receive FIFO
+    static constexpr size_t kDataBufferSize = 4096;
+    uint8_t _dataBuffer[kDataBufferSize];
+    size_t _dataHead;
+    size_t _dataTail;
+    size_t _dataCount;
+};
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Implementation of the multi-sensor manager
+
+#include "sfDevFPC2534Manager.h"
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534Manager::sfDevFPC2534Manager()
+    : _sensors{}, _count{0}, _next{0}, _current{kFPC2534NoSensor}, _passStartUs{0}, _handler{nullptr},
+      _handlerArg{nullptr}
+{
+}
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534Manager::~sfDevFPC2534Manager()
+{
+    end();
+}
+
+//--------------------------------------------------------------------------------------------
+uint8_t sfDevFPC2534Manager::addSensor(sfDevFPC2534 &device, uint8_t bus)
+{
+    if (_count >= kFPC2534MaxSensors || device._comm == nullptr)
+        return kFPC2534NoSensor;
+
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (_sensors[i].device == &device)
+            return kFPC2534NoSensor;
+    }
+
+    sensor_t &sensor = _sensors[_count];
+    memset(&sensor, 0, sizeof(sensor));
+    sensor.device = &device;
+    sensor.manager = this;
+    sensor.index = _count;
+    sensor.bus = bus;
+    sensor.hook = {hookHandler, &sensor, nullptr};
+    sensor.lastResult = FPC_RESULT_OK;
+
+    device.addHook(sensor.hook);
+    return _count++;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Manager::end(void)
+{
+    for (uint8_t i = 0; i < _count; i++)
+        _sensors[i].device->removeHook(_sensors[i].hook);
+
+    _count = 0;
+    _next = 0;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534Manager::isBusBusy(const sensor_t &sensor) const
+{
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        const sensor_t &other = _sensors[i];
+        if (&other != &sensor && other.bus == sensor.bus && other.device->_comm->transferPending())
+            return true;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------
+// Pump a sensor - the library callbacks and the hook are called with the sensor current
+//
+fpc_result_t sfDevFPC2534Manager::pump(sensor_t &sensor)
+{
+    _current = sensor.index;
+    fpc_result_t rc = sensor.device->processNextResponse();
+    _current = kFPC2534NoSensor;
+
+    sensor.lastResult = rc;
+    if (rc != FPC_RESULT_OK)
+        sensor.stats.errors++;
+
+    // No frame waiting, and no transfer running for one - the data was only a NONE event, or was dropped
+    if (sensor.ready && !sensor.device->isDataAvailable() && !sensor.device->_comm->transferPending())
+        sensor.ready = false;
+
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// A scheduling pass - the sensors with data first, in turn, then the housekeeping of the idle sensors
+//
+fpc_result_t sfDevFPC2534Manager::poll(void)
+{
+    if (_count == 0)
+        return FPC_RESULT_WRONG_STATE;
+
+    fpc_result_t rc = FPC_RESULT_OK;
+    _passStartUs = micros();
+
+    // Which sensors have data - the IRQ flags, no bus traffic
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        sensor_t &sensor = _sensors[i];
+        if (!sensor.ready && sensor.device->isDataAvailable())
+        {
+            sensor.ready = true;
+            sensor.readyAtUs = _passStartUs;
+        }
+    }
+
+    // One frame for each sensor with data - a bus is serialized, a sensor on a busy bus waits for the next pass
+    uint32_t pumped = 0;
+    for (uint8_t n = 0; n < _count; n++)
+    {
+        uint8_t i = (_next + n) % _count;
+        sensor_t &sensor = _sensors[i];
+        if (!sensor.ready)
+            continue;
+
+        pumped |= 1UL << i;
+        if (isBusBusy(sensor))
+        {
+            sensor.stats.deferrals++;
+            continue;
+        }
+
+        fpc_result_t result = pump(sensor);
+        if (result != FPC_RESULT_OK)
+            rc = result;
+    }
+
+    // Housekeeping - the watchdog of an idle sensor, and any data that arrived during the pass
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        sensor_t &sensor = _sensors[i];
+        if ((pumped & (1UL << i)) != 0 || isBusBusy(sensor))
+            continue;
+
+        fpc_result_t result = pump(sensor);
+        if (result != FPC_RESULT_OK)
+            rc = result;
+    }
+
+    // Next pass starts with the next sensor
+    _next = (_next + 1) % _count;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534Manager::waitForEvent(uint32_t timeoutMs)
+{
+    if (_count == 0)
+        return FPC_RESULT_WRONG_STATE;
+
+    uint32_t start = millis();
+    for (;;)
+    {
+        for (uint8_t i = 0; i < _count; i++)
+        {
+            if (_sensors[i].ready || _sensors[i].device->isDataAvailable())
+                return poll();
+        }
+        if (millis() - start >= timeoutMs)
+            break;
+
+        delay(1);
+    }
+
+    // timeout - the housekeeping pass
+    return poll();
+}
+
+//--------------------------------------------------------------------------------------------
+// Called by a device for each parsed frame
+//
+void sfDevFPC2534Manager::hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size)
+{
+    sensor_t *sensor = static_cast<sensor_t *>(arg);
+    sfDevFPC2534Manager *self = sensor->manager;
+
+    // Serviced by the manager - not a frame read by a command of the application waiting for its response
+    if (self->_current == sensor->index)
+    {
+        uint32_t since = sensor->ready ? sensor->readyAtUs : self->_passStartUs;
+        uint32_t latencyUs = micros() - since;
+        sensor->ready = false;
+
+        sensor->stats.frames++;
+        sensor->stats.lastLatencyUs = latencyUs;
+        sensor->stats.totalLatencyUs += latencyUs;
+        if (latencyUs > sensor->stats.maxLatencyUs)
+            sensor->stats.maxLatencyUs = latencyUs;
+    }
+
+    if (self->_handler != nullptr)
+        self->_handler(self->_handlerArg, sensor->index, cmd, size);
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534Manager::getStats(uint8_t sensor, sfDevFPC2534ManagerStats_t &stats) const
+{
+    if (sensor >= _count)
+        return false;
+
+    stats = _sensors[sensor].stats;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Manager::resetStats(void)
+{
+    for (uint8_t i = 0; i < _count; i++)
+        memset(&_sensors[i].stats, 0, sizeof(_sensors[i].stats));
+}
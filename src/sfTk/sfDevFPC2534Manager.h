@@ -0,0 +1,186 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Multi-sensor manager for the FPC2534 library.
+//
+// Several sensors - at different I2C addresses on one bus, or on their own buses - are pumped from one loop by
+// the manager, instead of a processNextResponse() loop per sensor:
+//
+//   - Each pass checks the data available (IRQ) flag of every sensor - no bus traffic for an idle sensor
+//   - The sensors with data are serviced first, one frame each, starting with a different sensor each pass - a
+//     busy sensor can't starve the others
+//   - Access to a bus is serialized - while a background transfer (I2C asynchronous payload read) runs for one
+//     sensor, the other sensors on that bus wait for the next pass, and the sensors on other buses are serviced.
+//     (The I2C transports share one read helper, with one background transfer at a time - a sensor on another
+//     bus waits for the transfer to complete before its own.)
+//   - Frames are passed to an event handler tagged with the sensor index, and currentSensor() tells which
+//     sensor the library callbacks are called for
+//
+// The time from when the manager sees a sensor with data, to its frame being parsed, is measured for each
+// sensor. An idle sensor only costs a flag check, so adding a sensor adds little to the latency of the others.
+//
+// Sensors in I/O task mode are supported - the manager dispatches the frames queued by their I/O tasks.
+//
+// NOTE: The IRQ pins of the sensors must be on a platform with ISR parameters (ESP32, RP2) - on others, the data
+// available flag is shared by all the sensors.
+
+#pragma once
+
+#include "sfDevFPC2534.h"
+
+// Maximum number of sensors a manager handles
+const uint8_t kFPC2534MaxSensors = 8;
+
+// Sensor index value for "no sensor"
+const uint8_t kFPC2534NoSensor = 255;
+
+//--------------------------------------------------------------------------------------------
+// Per sensor statistics
+typedef struct
+{
+    uint32_t frames;        // frames parsed
+    uint32_t errors;        // pumps that failed
+    uint32_t deferrals;     // passes the sensor had data, but its bus was in use by another sensor
+    uint32_t lastLatencyUs; // data seen by the manager to the frame parsed
+    uint32_t maxLatencyUs;
+    uint32_t totalLatencyUs; // divide by frames for the average
+} sfDevFPC2534ManagerStats_t;
+
+//--------------------------------------------------------------------------------------------
+// Event handler - called with the index of the sensor, for each frame parsed (after the library callbacks)
+typedef void (*sfDevFPC2534ManagerHandler_t)(void *arg, uint8_t sensor, fpc_cmd_hdr_t *cmd, size_t size);
+
+//--------------------------------------------------------------------------------------------
+class sfDevFPC2534Manager
+{
+  public:
+    sfDevFPC2534Manager();
+    ~sfDevFPC2534Manager();
+
+    /**
+     * @brief Add a sensor to the manager. The device must be initialized.
+     *
+     * @param device The initialized device object
+     * @param bus The bus the sensor is on - any id, the same for all the sensors that share a bus (Wire port)
+     * @return The index of the sensor, or kFPC2534NoSensor if the manager is full (or the device is already added)
+     */
+    uint8_t addSensor(sfDevFPC2534 &device, uint8_t bus = 0);
+
+    /**
+     * @brief Remove all the sensors from the manager
+     */
+    void end(void);
+
+    /**
+     * @brief Number of sensors added
+     */
+    uint8_t sensorCount(void) const
+    {
+        return _count;
+    }
+
+    /**
+     * @brief The device object of a sensor
+     *
+     * @param sensor The index of the sensor
+     * @return The device, or nullptr if the index is not valid
+     */
+    sfDevFPC2534 *sensor(uint8_t sensor) const
+    {
+        return sensor < _count ? _sensors[sensor].device : nullptr;
+    }
+
+    /**
+     * @brief Set the event handler - called for each frame parsed, with the index of the sensor
+     *
+     * @param handler The handler - nullptr for none
+     * @param arg Passed to the handler
+     */
+    void setEventHandler(sfDevFPC2534ManagerHandler_t handler, void *arg = nullptr)
+    {
+        _handlerArg = arg;
+        _handler = handler;
+    }
+
+    /**
+     * @brief The sensor being serviced - call from the library callbacks to know which sensor they are for
+     *
+     * @return The index of the sensor, or kFPC2534NoSensor outside of poll()/waitForEvent()
+     */
+    uint8_t currentSensor(void) const
+    {
+        return _current;
+    }
+
+    /**
+     * @brief One scheduling pass - each sensor with data is serviced once (one frame), and each idle sensor gets
+     * its housekeeping (watchdog). Call regularly (in loop).
+     *
+     * @return FPC_RESULT_OK, or the last error of a sensor this pass - see lastResult() for each sensor
+     */
+    fpc_result_t poll(void);
+
+    /**
+     * @brief Wait until a sensor has data - or the timeout expires - and run a scheduling pass.
+     *
+     * @param timeoutMs The maximum time to wait, in milliseconds
+     * @return FPC_RESULT_OK, or the last error of a sensor - see lastResult() for each sensor
+     */
+    fpc_result_t waitForEvent(uint32_t timeoutMs);
+
+    /**
+     * @brief The result of the last pump of a sensor
+     */
+    fpc_result_t lastResult(uint8_t sensor) const
+    {
+        return sensor < _count ? _sensors[sensor].lastResult : FPC_RESULT_INVALID_PARAM;
+    }
+
+    /**
+     * @brief Get the statistics of a sensor
+     *
+     * @param sensor The index of the sensor
+     * @param stats Set to the statistics
+     * @return true if the index is valid
+     */
+    bool getStats(uint8_t sensor, sfDevFPC2534ManagerStats_t &stats) const;
+    void resetStats(void);
+
+  private:
+    typedef struct
+    {
+        sfDevFPC2534 *device;
+        sfDevFPC2534Manager *manager;
+        uint8_t index;
+        uint8_t bus;
+        sfDevFPC2534Hook_t hook;
+        bool ready;         // seen with data, not yet serviced
+        uint32_t readyAtUs; // when the data was seen
+        fpc_result_t lastResult;
+        sfDevFPC2534ManagerStats_t stats;
+    } sensor_t;
+
+    // Pump a sensor - one frame, or the housekeeping of an idle sensor
+    fpc_result_t pump(sensor_t &sensor);
+
+    // Is a background transfer running on the bus of the sensor - for another sensor?
+    bool isBusBusy(const sensor_t &sensor) const;
+
+    static void hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size);
+
+    sensor_t _sensors[kFPC2534MaxSensors];
+    uint8_t _count;
+    uint8_t _next; // the first sensor serviced next pass
+    uint8_t _current;
+    uint32_t _passStartUs;
+
+    sfDevFPC2534ManagerHandler_t _handler;
+    void *_handlerArg;
+};
@@ -0,0 +1,796 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Implementation of the host-side minutiae extraction and matching
+
+#include "sfDevFPC2534Matcher.h"
+
+#if defined(SFE_FPC2534_LINUX_HOST)
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SFE_FPC2534_MATCH_X86
+#endif
+
+// Binarization window (pixels each side of the center), and the foreground threshold - the local variance
+const int kMeanRadius = 7;
+const uint32_t kForegroundVariance = 100;
+
+// Minutiae are not taken this close to the image border, or to the background
+const int kBorder = 10;
+
+// Ridge trace length for the direction of a minutia, and the shortest ridge kept behind an ending (a spur)
+const int kTraceSteps = 10;
+const int kMinRidge = 5;
+
+// Minutiae closer than this to another are dropped - broken ridges and spurs come in pairs
+const int kMinDistance = 6;
+
+// Local structure tolerances - distance in pixels, directions in 1/64 turns. A minutia matches when this many of
+// its neighbors match.
+const int16_t kDistTolerance = 6;
+const int16_t kDirTolerance = 3;
+const int16_t kRelTolerance = 3;
+const int16_t kNeighborsNeeded = 3;
+
+// Minutiae per gallery block - the AVX2 width
+const uint16_t kBlockLanes = 16;
+
+// Neighbor distances of a missing neighbor (or an unused lane) - never within tolerance of the other side
+const int16_t kMissingGallery = -1000;
+const int16_t kMissingProbe = -3000;
+
+// A search is split across threads when each thread has at least this many entries
+const uint32_t kEntriesPerThread = 256;
+
+//--------------------------------------------------------------------------------------------
+// The local structures of a probe
+//
+struct sfDevFPC2534MatchProbe
+{
+    uint16_t count;
+    int16_t dist[kFPC2534MaxMinutiae][kFPC2534MatchNeighbors];
+    int16_t dir[kFPC2534MaxMinutiae][kFPC2534MatchNeighbors];
+    int16_t rel[kFPC2534MaxMinutiae][kFPC2534MatchNeighbors];
+};
+
+// The features of the blocks of a gallery entry
+typedef struct
+{
+    const int16_t *dist[kFPC2534MatchNeighbors];
+    const int16_t *dir[kFPC2534MatchNeighbors];
+    const int16_t *rel[kFPC2534MatchNeighbors];
+    uint16_t blocks;
+} sfDevFPC2534MatchColumns_t;
+
+//--------------------------------------------------------------------------------------------
+// Direction of a vector - 0-255 for a full turn
+//
+static uint8_t angleOf(float dx, float dy)
+{
+    return (uint8_t)((int)lroundf(atan2f(dy, dx) * 128.0f / (float)M_PI) & 0xFF);
+}
+
+//--------------------------------------------------------------------------------------------
+// sfDevFPC2534MinutiaeExtractor
+//--------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------
+// Smooth (3 x 3), then a ridge is a pixel darker than the mean of its window. The foreground is where the
+// window has the variance of ridges and valleys.
+//
+void sfDevFPC2534MinutiaeExtractor::binarize(const uint8_t *image)
+{
+    int w = _width, h = _height;
+
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            int sum = 0, n = 0;
+            for (int dy = -1; dy <= 1; dy++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    int yy = y + dy, xx = x + dx;
+                    if (yy >= 0 && yy < h && xx >= 0 && xx < w)
+                    {
+                        sum += image[yy * w + xx];
+                        n++;
+                    }
+                }
+            }
+            _smooth[y * w + x] = (uint8_t)(sum / n);
+        }
+    }
+
+    // Integral images of the values and the squares - (w + 1) x (h + 1), two values each
+    int iw = w + 1;
+    memset(_integral.data(), 0, _integral.size() * sizeof(uint32_t));
+    for (int y = 0; y < h; y++)
+    {
+        uint32_t rowSum = 0, rowSquares = 0;
+        for (int x = 0; x < w; x++)
+        {
+            uint32_t v = _smooth[y * w + x];
+            rowSum += v;
+            rowSquares += v * v;
+
+            uint32_t *cell = &_integral[((y + 1) * iw + x + 1) * 2];
+            const uint32_t *above = &_integral[(y * iw + x + 1) * 2];
+            cell[0] = above[0] + rowSum;
+            cell[1] = above[1] + rowSquares;
+        }
+    }
+
+    for (int y = 0; y < h; y++)
+    {
+        int y0 = std::max(y - kMeanRadius, 0), y1 = std::min(y + kMeanRadius + 1, h);
+        for (int x = 0; x < w; x++)
+        {
+            int x0 = std::max(x - kMeanRadius, 0), x1 = std::min(x + kMeanRadius + 1, w);
+            uint32_t area = (uint32_t)((y1 - y0) * (x1 - x0));
+
+            const uint32_t *a = &_integral[(y0 * iw + x0) * 2];
+            const uint32_t *b = &_integral[(y0 * iw + x1) * 2];
+            const uint32_t *c = &_integral[(y1 * iw + x0) * 2];
+            const uint32_t *d = &_integral[(y1 * iw + x1) * 2];
+            uint32_t sum = d[0] - b[0] - c[0] + a[0];
+            uint64_t squares = (uint64_t)(d[1] - b[1] - c[1] + a[1]);
+
+            uint32_t mean = sum / area;
+            uint32_t variance = (uint32_t)(squares / area - (uint64_t)mean * mean);
+
+            _ridge[y * w + x] = _smooth[y * w + x] < mean;
+            _mask[y * w + x] = variance >= kForegroundVariance;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// Zhang-Suen thinning - the ridges are reduced to one pixel wide lines
+//
+void sfDevFPC2534MinutiaeExtractor::thin(void)
+{
+    int w = _width, h = _height;
+
+    // No ridge on the border - the neighbors of every ridge pixel are in the image
+    for (int x = 0; x < w; x++)
+        _ridge[x] = _ridge[(h - 1) * w + x] = 0;
+    for (int y = 0; y < h; y++)
+        _ridge[y * w] = _ridge[y * w + w - 1] = 0;
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int pass = 0; pass < 2; pass++)
+        {
+            int removed = 0;
+            for (int y = 1; y < h - 1; y++)
+            {
+                for (int x = 1; x < w - 1; x++)
+                {
+                    const uint8_t *p = &_ridge[y * w + x];
+                    _remove[y * w + x] = 0;
+                    if (!*p)
+                        continue;
+
+                    // P2 (north) to P9, clockwise
+                    uint8_t n[8] = {p[-w], p[-w + 1], p[1], p[w + 1], p[w], p[w - 1], p[-1], p[-w - 1]};
+                    int count = 0, transitions = 0;
+                    for (int i = 0; i < 8; i++)
+                    {
+                        count += n[i];
+                        transitions += !n[i] && n[(i + 1) & 7];
+                    }
+                    if (count < 2 || count > 6 || transitions != 1)
+                        continue;
+
+                    if (pass == 0 ? (n[0] && n[2] && n[4]) || (n[2] && n[4] && n[6])
+                                  : (n[0] && n[2] && n[6]) || (n[0] && n[4] && n[6]))
+                        continue;
+
+                    _remove[y * w + x] = 1;
+                    removed++;
+                }
+            }
+
+            if (removed == 0)
+                continue;
+
+            changed = true;
+            for (size_t i = 0; i < _ridge.size(); i++)
+                _ridge[i] &= !_remove[i];
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// Follow a ridge of the skeleton from start (away from the pixel from) for up to steps pixels - stops at the end
+// of the ridge, or at a junction. Returns the steps taken, with the last pixel in endX, endY.
+//
+int sfDevFPC2534MinutiaeExtractor::trace(int start, int from, int steps, int &endX, int &endY)
+{
+    static const int kDX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static const int kDY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+    int w = _width;
+    int visited[3] = {from, from, from};
+    int current = start;
+    int taken = 0;
+
+    while (taken < steps)
+    {
+        int next = -1, candidates = 0;
+        int cx = current % w, cy = current / w;
+        for (int i = 0; i < 8; i++)
+        {
+            int x = cx + kDX[i], y = cy + kDY[i];
+            if (x < 0 || x >= w || y < 0 || y >= _height)
+                continue;
+
+            int pixel = y * w + x;
+            if (!_ridge[pixel] || pixel == visited[0] || pixel == visited[1] || pixel == visited[2])
+                continue;
+
+            // a corner step next to a side step is the same ridge - take the side step
+            bool side = (i & 1) == 0;
+            if (next >= 0 && abs(pixel % w - next % w) <= 1 && abs(pixel / w - next / w) <= 1)
+            {
+                if (side)
+                    next = pixel;
+                continue;
+            }
+            next = pixel;
+            candidates++;
+        }
+
+        if (candidates != 1)
+            break;
+
+        visited[2] = visited[1];
+        visited[1] = visited[0];
+        visited[0] = current;
+        current = next;
+        taken++;
+    }
+
+    endX = current % w;
+    endY = current / w;
+    return taken;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534MinutiaeExtractor::extract(const uint8_t *image, uint16_t width, uint16_t height,
+                                                    sfDevFPC2534Minutiae_t &minutiae)
+{
+    minutiae.count = 0;
+    if (image == nullptr || width < 32 || height < 32)
+        return FPC_RESULT_INVALID_PARAM;
+
+    _width = width;
+    _height = height;
+    size_t pixels = (size_t)width * height;
+    _smooth.resize(pixels);
+    _ridge.resize(pixels);
+    _mask.resize(pixels);
+    _remove.resize(pixels);
+    _integral.resize((size_t)(width + 1) * (height + 1) * 2);
+
+    binarize(image);
+    thin();
+
+    // Crossing numbers of the skeleton - 1 for an ending, 3 for a bifurcation
+    int w = _width;
+    std::vector<sfDevFPC2534Minutia_t> found;
+    for (int y = kBorder; y < _height - kBorder; y++)
+    {
+        for (int x = kBorder; x < w - kBorder; x++)
+        {
+            int pixel = y * w + x;
+            if (!_ridge[pixel] || !_mask[pixel] || !_mask[pixel - kBorder * w - kBorder] ||
+                !_mask[pixel - kBorder * w + kBorder] || !_mask[pixel + kBorder * w - kBorder] ||
+                !_mask[pixel + kBorder * w + kBorder])
+                continue;
+
+            const uint8_t *p = &_ridge[pixel];
+            int n[8] = {p[-w], p[-w + 1], p[1], p[w + 1], p[w], p[w - 1], p[-1], p[-w - 1]};
+            int offsets[8] = {-w, -w + 1, 1, w + 1, w, w - 1, -1, -w - 1};
+
+            // the start of each run of ridge neighbors is a branch
+            int branches[4], count = 0;
+            for (int i = 0; i < 8; i++)
+            {
+                if (n[i] && !n[(i + 7) & 7] && count < 4)
+                    branches[count++] = pixel + offsets[i];
+            }
+
+            if (count == 1)
+            {
+                // The direction is from the ridge to its end
+                int ex, ey;
+                if (trace(branches[0], pixel, kTraceSteps, ex, ey) < kMinRidge)
+                    continue;
+                found.push_back({(uint16_t)x, (uint16_t)y, angleOf(x - ex, y - ey), kFPC2534MinutiaEnding});
+            }
+            else if (count == 3)
+            {
+                // The direction is from the stem - the branch the furthest from the other two - to the fork
+                uint8_t angles[3];
+                int ends[3][2];
+                for (int b = 0; b < 3; b++)
+                {
+                    trace(branches[b], pixel, kTraceSteps, ends[b][0], ends[b][1]);
+                    angles[b] = angleOf(ends[b][0] - x, ends[b][1] - y);
+                }
+
+                int stem = 0, widest = -1;
+                for (int b = 0; b < 3; b++)
+                {
+                    int d1 = abs((int8_t)(angles[b] - angles[(b + 1) % 3]));
+                    int d2 = abs((int8_t)(angles[b] - angles[(b + 2) % 3]));
+                    if (std::min(d1, d2) > widest)
+                    {
+                        widest = std::min(d1, d2);
+                        stem = b;
+                    }
+                }
+                found.push_back({(uint16_t)x, (uint16_t)y, angleOf(x - ends[stem][0], y - ends[stem][1]),
+                                 kFPC2534MinutiaBifurcation});
+            }
+        }
+    }
+
+    // Drop the minutiae with a close neighbor
+    std::vector<bool> drop(found.size(), false);
+    for (size_t i = 0; i < found.size(); i++)
+    {
+        for (size_t j = i + 1; j < found.size(); j++)
+        {
+            int dx = found[i].x - found[j].x, dy = found[i].y - found[j].y;
+            if (dx * dx + dy * dy < kMinDistance * kMinDistance)
+                drop[i] = drop[j] = true;
+        }
+    }
+
+    std::vector<sfDevFPC2534Minutia_t> kept;
+    for (size_t i = 0; i < found.size(); i++)
+    {
+        if (!drop[i])
+            kept.push_back(found[i]);
+    }
+
+    // Those nearest the center - the sensor is centered on the finger
+    if (kept.size() > kFPC2534MaxMinutiae)
+    {
+        int cx = width / 2, cy = height / 2;
+        auto centerDistance = [cx, cy](const sfDevFPC2534Minutia_t &m) {
+            return (m.x - cx) * (m.x - cx) + (m.y - cy) * (m.y - cy);
+        };
+        std::sort(kept.begin(), kept.end(), [&](const sfDevFPC2534Minutia_t &a, const sfDevFPC2534Minutia_t &b) {
+            return centerDistance(a) < centerDistance(b);
+        });
+        kept.resize(kFPC2534MaxMinutiae);
+    }
+
+    minutiae.count = (uint16_t)kept.size();
+    std::copy(kept.begin(), kept.end(), minutiae.minutiae);
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Scoring kernels - the probe minutiae that match a minutia of the entry, as a bit mask
+//--------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------
+// Scalar - one gallery minutia at a time
+//
+static uint64_t scoreScalar(const sfDevFPC2534MatchProbe &probe, const sfDevFPC2534MatchColumns_t &cols)
+{
+    uint64_t hits = 0;
+    for (uint32_t lane = 0; lane < (uint32_t)cols.blocks * kBlockLanes; lane++)
+    {
+        for (uint16_t i = 0; i < probe.count; i++)
+        {
+            if (hits & (1ULL << i))
+                continue;
+
+            int matched = 0;
+            for (int k = 0; k < kFPC2534MatchNeighbors; k++)
+            {
+                for (int j = 0; j < kFPC2534MatchNeighbors; j++)
+                {
+                    int dist = abs(cols.dist[j][lane] - probe.dist[i][k]);
+                    int dir = (cols.dir[j][lane] - probe.dir[i][k]) & 63;
+                    int rel = (cols.rel[j][lane] - probe.rel[i][k]) & 63;
+                    if (dist <= kDistTolerance && std::min(dir, 64 - dir) <= kDirTolerance &&
+                        std::min(rel, 64 - rel) <= kRelTolerance)
+                    {
+                        matched++;
+                        break;
+                    }
+                }
+            }
+            if (matched >= kNeighborsNeeded)
+                hits |= 1ULL << i;
+        }
+    }
+    return hits;
+}
+
+#if defined(SFE_FPC2534_MATCH_X86)
+//--------------------------------------------------------------------------------------------
+// SSE2 - 8 gallery minutiae at a time
+//
+__attribute__((target("sse2"))) static uint64_t scoreSSE2(const sfDevFPC2534MatchProbe &probe,
+                                                          const sfDevFPC2534MatchColumns_t &cols)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask63 = _mm_set1_epi16(63);
+    const __m128i full = _mm_set1_epi16(64);
+    const __m128i distLimit = _mm_set1_epi16(kDistTolerance + 1);
+    const __m128i dirLimit = _mm_set1_epi16(kDirTolerance + 1);
+    const __m128i relLimit = _mm_set1_epi16(kRelTolerance + 1);
+    const __m128i needed = _mm_set1_epi16(kNeighborsNeeded - 1);
+
+    uint64_t hits = 0;
+    for (uint32_t lane = 0; lane < (uint32_t)cols.blocks * kBlockLanes; lane += 8)
+    {
+        __m128i gDist[kFPC2534MatchNeighbors], gDir[kFPC2534MatchNeighbors], gRel[kFPC2534MatchNeighbors];
+        for (int j = 0; j < kFPC2534MatchNeighbors; j++)
+        {
+            gDist[j] = _mm_loadu_si128((const __m128i *)(cols.dist[j] + lane));
+            gDir[j] = _mm_loadu_si128((const __m128i *)(cols.dir[j] + lane));
+            gRel[j] = _mm_loadu_si128((const __m128i *)(cols.rel[j] + lane));
+        }
+
+        for (uint16_t i = 0; i < probe.count; i++)
+        {
+            if (hits & (1ULL << i))
+                continue;
+
+            __m128i matched = zero;
+            for (int k = 0; k < kFPC2534MatchNeighbors; k++)
+            {
+                __m128i pDist = _mm_set1_epi16(probe.dist[i][k]);
+                __m128i pDir = _mm_set1_epi16(probe.dir[i][k]);
+                __m128i pRel = _mm_set1_epi16(probe.rel[i][k]);
+
+                __m128i any = zero;
+                for (int j = 0; j < kFPC2534MatchNeighbors; j++)
+                {
+                    __m128i d = _mm_sub_epi16(gDist[j], pDist);
+                    d = _mm_max_epi16(d, _mm_sub_epi16(zero, d));
+
+                    __m128i a = _mm_and_si128(_mm_sub_epi16(gDir[j], pDir), mask63);
+                    a = _mm_min_epi16(a, _mm_sub_epi16(full, a));
+
+                    __m128i r = _mm_and_si128(_mm_sub_epi16(gRel[j], pRel), mask63);
+                    r = _mm_min_epi16(r, _mm_sub_epi16(full, r));
+
+                    __m128i m = _mm_and_si128(_mm_cmplt_epi16(a, dirLimit), _mm_cmplt_epi16(r, relLimit));
+                    m = _mm_and_si128(m, _mm_cmplt_epi16(d, distLimit));
+                    any = _mm_or_si128(any, m);
+                }
+                matched = _mm_sub_epi16(matched, any);
+            }
+
+            if (_mm_movemask_epi8(_mm_cmpgt_epi16(matched, needed)) != 0)
+                hits |= 1ULL << i;
+        }
+    }
+    return hits;
+}
+
+//--------------------------------------------------------------------------------------------
+// AVX2 - 16 gallery minutiae (a block) at a time
+//
+__attribute__((target("avx2"))) static uint64_t scoreAVX2(const sfDevFPC2534MatchProbe &probe,
+                                                          const sfDevFPC2534MatchColumns_t &cols)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mask63 = _mm256_set1_epi16(63);
+    const __m256i full = _mm256_set1_epi16(64);
+    const __m256i distLimit = _mm256_set1_epi16(kDistTolerance + 1);
+    const __m256i dirLimit = _mm256_set1_epi16(kDirTolerance + 1);
+    const __m256i relLimit = _mm256_set1_epi16(kRelTolerance + 1);
+    const __m256i needed = _mm256_set1_epi16(kNeighborsNeeded - 1);
+
+    uint64_t hits = 0;
+    for (uint32_t lane = 0; lane < (uint32_t)cols.blocks * kBlockLanes; lane += kBlockLanes)
+    {
+        __m256i gDist[kFPC2534MatchNeighbors], gDir[kFPC2534MatchNeighbors], gRel[kFPC2534MatchNeighbors];
+        for (int j = 0; j < kFPC2534MatchNeighbors; j++)
+        {
+            gDist[j] = _mm256_loadu_si256((const __m256i *)(cols.dist[j] + lane));
+            gDir[j] = _mm256_loadu_si256((const __m256i *)(cols.dir[j] + lane));
+            gRel[j] = _mm256_loadu_si256((const __m256i *)(cols.rel[j] + lane));
+        }
+
+        for (uint16_t i = 0; i < probe.count; i++)
+        {
+            if (hits & (1ULL << i))
+                continue;
+
+            __m256i matched = zero;
+            for (int k = 0; k < kFPC2534MatchNeighbors; k++)
+            {
+                __m256i pDist = _mm256_set1_epi16(probe.dist[i][k]);
+                __m256i pDir = _mm256_set1_epi16(probe.dir[i][k]);
+                __m256i pRel = _mm256_set1_epi16(probe.rel[i][k]);
+
+                __m256i any = zero;
+                for (int j = 0; j < kFPC2534MatchNeighbors; j++)
+                {
+                    __m256i d = _mm256_abs_epi16(_mm256_sub_epi16(gDist[j], pDist));
+
+                    __m256i a = _mm256_and_si256(_mm256_sub_epi16(gDir[j], pDir), mask63);
+                    a = _mm256_min_epi16(a, _mm256_sub_epi16(full, a));
+
+                    __m256i r = _mm256_and_si256(_mm256_sub_epi16(gRel[j], pRel), mask63);
+                    r = _mm256_min_epi16(r, _mm256_sub_epi16(full, r));
+
+                    __m256i m = _mm256_and_si256(_mm256_cmpgt_epi16(distLimit, d),
+                                                 _mm256_and_si256(_mm256_cmpgt_epi16(dirLimit, a),
+                                                                  _mm256_cmpgt_epi16(relLimit, r)));
+                    any = _mm256_or_si256(any, m);
+                }
+                matched = _mm256_sub_epi16(matched, any);
+            }
+
+            if (_mm256_movemask_epi8(_mm256_cmpgt_epi16(matched, needed)) != 0)
+                hits |= 1ULL << i;
+        }
+    }
+    return hits;
+}
+#endif
+
+//--------------------------------------------------------------------------------------------
+// sfDevFPC2534Gallery
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534Gallery::sfDevFPC2534Gallery() : _minScore{kFPC2534DefaultMatchScore}, _kernel{kFPC2534MatchScalar}
+{
+    setKernel(kFPC2534MatchAuto);
+    setThreads(0);
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Gallery::setKernel(sfDevFPC2534MatchKernel_t kernel)
+{
+#if defined(SFE_FPC2534_MATCH_X86)
+    bool avx2 = __builtin_cpu_supports("avx2");
+    bool sse2 = __builtin_cpu_supports("sse2");
+#else
+    bool avx2 = false, sse2 = false;
+#endif
+
+    if (kernel == kFPC2534MatchAuto || (kernel == kFPC2534MatchAVX2 && !avx2) || (kernel == kFPC2534MatchSSE2 && !sse2))
+        kernel = avx2 ? kFPC2534MatchAVX2 : (sse2 ? kFPC2534MatchSSE2 : kFPC2534MatchScalar);
+
+    _kernel = kernel;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Gallery::setThreads(uint16_t threads)
+{
+    if (threads == 0)
+        threads = (uint16_t)std::thread::hardware_concurrency();
+    _threads = threads > 0 ? threads : 1;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Gallery::clear(void)
+{
+    _ids.clear();
+    _first.clear();
+    _blocks.clear();
+    for (int k = 0; k < kFPC2534MatchNeighbors; k++)
+    {
+        _dist[k].clear();
+        _dir[k].clear();
+        _rel[k].clear();
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// The local structure of each minutia - its nearest neighbors, nearest first: the distance, the direction to the
+// neighbor and the direction of the neighbor, relative to the direction of the minutia (1/64 turns)
+//
+void sfDevFPC2534Gallery::describe(const sfDevFPC2534Minutiae_t &minutiae, int16_t (*dist)[kFPC2534MatchNeighbors],
+                                   int16_t (*dir)[kFPC2534MatchNeighbors], int16_t (*rel)[kFPC2534MatchNeighbors],
+                                   int16_t missing) const
+{
+    // the tables hold kFPC2534MaxMinutiae rows - a larger count from the caller is not trusted
+    uint16_t count = minutiae.count < kFPC2534MaxMinutiae ? minutiae.count : kFPC2534MaxMinutiae;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        const sfDevFPC2534Minutia_t &m = minutiae.minutiae[i];
+
+        int nearest[kFPC2534MatchNeighbors];
+        int nearestD2[kFPC2534MatchNeighbors];
+        int found = 0;
+        for (uint16_t j = 0; j < count; j++)
+        {
+            if (j == i)
+                continue;
+
+            int dx = minutiae.minutiae[j].x - m.x, dy = minutiae.minutiae[j].y - m.y;
+            int d2 = dx * dx + dy * dy;
+
+            // insertion into the sorted nearest list
+            int at = found < kFPC2534MatchNeighbors ? found++ : kFPC2534MatchNeighbors;
+            while (at > 0 && nearestD2[at - 1] > d2)
+            {
+                if (at < kFPC2534MatchNeighbors)
+                {
+                    nearest[at] = nearest[at - 1];
+                    nearestD2[at] = nearestD2[at - 1];
+                }
+                at--;
+            }
+            if (at < kFPC2534MatchNeighbors)
+            {
+                nearest[at] = j;
+                nearestD2[at] = d2;
+            }
+        }
+
+        for (int k = 0; k < kFPC2534MatchNeighbors; k++)
+        {
+            if (k >= found)
+            {
+                dist[i][k] = missing;
+                dir[i][k] = rel[i][k] = 0;
+                continue;
+            }
+
+            const sfDevFPC2534Minutia_t &n = minutiae.minutiae[nearest[k]];
+            dist[i][k] = (int16_t)lroundf(sqrtf((float)nearestD2[k]));
+            dir[i][k] = (uint8_t)(angleOf(n.x - m.x, n.y - m.y) - m.angle) >> 2;
+            rel[i][k] = (uint8_t)(n.angle - m.angle) >> 2;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+uint32_t sfDevFPC2534Gallery::add(uint32_t id, const sfDevFPC2534Minutiae_t &minutiae)
+{
+    sfDevFPC2534MatchProbe local;
+    local.count = minutiae.count < kFPC2534MaxMinutiae ? minutiae.count : kFPC2534MaxMinutiae;
+    describe(minutiae, local.dist, local.dir, local.rel, kMissingGallery);
+
+    // Whole blocks - the unused lanes never match
+    uint16_t blocks = (local.count + kBlockLanes - 1) / kBlockLanes;
+    size_t first = _dist[0].size();
+    for (int k = 0; k < kFPC2534MatchNeighbors; k++)
+    {
+        _dist[k].resize(first + (size_t)blocks * kBlockLanes, kMissingGallery);
+        _dir[k].resize(first + (size_t)blocks * kBlockLanes, 0);
+        _rel[k].resize(first + (size_t)blocks * kBlockLanes, 0);
+
+        for (uint16_t i = 0; i < local.count; i++)
+        {
+            _dist[k][first + i] = local.dist[i][k];
+            _dir[k][first + i] = local.dir[i][k];
+            _rel[k][first + i] = local.rel[i][k];
+        }
+    }
+
+    _ids.push_back(id);
+    _first.push_back((uint32_t)(first / kBlockLanes));
+    _blocks.push_back(blocks);
+    return (uint32_t)_ids.size() - 1;
+}
+
+//--------------------------------------------------------------------------------------------
+uint16_t sfDevFPC2534Gallery::scoreEntry(const sfDevFPC2534MatchProbe &probe, uint32_t index) const
+{
+    sfDevFPC2534MatchColumns_t cols;
+    size_t first = (size_t)_first[index] * kBlockLanes;
+    for (int k = 0; k < kFPC2534MatchNeighbors; k++)
+    {
+        cols.dist[k] = _dist[k].data() + first;
+        cols.dir[k] = _dir[k].data() + first;
+        cols.rel[k] = _rel[k].data() + first;
+    }
+    cols.blocks = _blocks[index];
+
+    uint64_t hits;
+#if defined(SFE_FPC2534_MATCH_X86)
+    if (_kernel == kFPC2534MatchAVX2)
+        hits = scoreAVX2(probe, cols);
+    else if (_kernel == kFPC2534MatchSSE2)
+        hits = scoreSSE2(probe, cols);
+    else
+#endif
+        hits = scoreScalar(probe, cols);
+
+    return (uint16_t)__builtin_popcountll(hits);
+}
+
+//--------------------------------------------------------------------------------------------
+uint16_t sfDevFPC2534Gallery::score(const sfDevFPC2534Minutiae_t &probe, uint32_t index) const
+{
+    if (index >= _ids.size())
+        return 0;
+
+    sfDevFPC2534MatchProbe local;
+    local.count = probe.count < kFPC2534MaxMinutiae ? probe.count : kFPC2534MaxMinutiae;
+    describe(probe, local.dist, local.dir, local.rel, kMissingProbe);
+    return scoreEntry(local, index);
+}
+
+//--------------------------------------------------------------------------------------------
+// The best entry of a range
+//
+void sfDevFPC2534Gallery::search(const sfDevFPC2534MatchProbe &probe, uint32_t first, uint32_t last,
+                                 sfDevFPC2534MatchResult_t &result) const
+{
+    result = {false, 0, first, 0};
+    for (uint32_t index = first; index < last; index++)
+    {
+        uint16_t score = scoreEntry(probe, index);
+        if (score > result.score)
+        {
+            result.score = score;
+            result.index = index;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// The gallery is split in ranges, one for each thread - the calling thread takes the first
+//
+bool sfDevFPC2534Gallery::identify(const sfDevFPC2534Minutiae_t &probe, sfDevFPC2534MatchResult_t &result) const
+{
+    result = {false, 0, 0, 0};
+    if (_ids.empty())
+        return false;
+
+    sfDevFPC2534MatchProbe local;
+    local.count = probe.count < kFPC2534MaxMinutiae ? probe.count : kFPC2534MaxMinutiae;
+    describe(probe, local.dist, local.dir, local.rel, kMissingProbe);
+
+    uint32_t entries = (uint32_t)_ids.size();
+    uint32_t threads = std::min<uint32_t>(_threads, std::max<uint32_t>(entries / kEntriesPerThread, 1));
+
+    std::vector<sfDevFPC2534MatchResult_t> results(threads);
+    std::vector<std::thread> workers;
+    for (uint32_t t = 1; t < threads; t++)
+    {
+        uint32_t first = (uint32_t)((uint64_t)entries * t / threads);
+        uint32_t last = (uint32_t)((uint64_t)entries * (t + 1) / threads);
+        workers.emplace_back(&sfDevFPC2534Gallery::search, this, std::cref(local), first, last, std::ref(results[t]));
+    }
+    search(local, 0, entries / threads, results[0]);
+
+    for (std::thread &worker : workers)
+        worker.join();
+
+    for (uint32_t t = 0; t < threads; t++)
+    {
+        if (results[t].score > result.score)
+            result = results[t];
+    }
+
+    result.id = _ids[result.index];
+    result.match = result.score >= _minScore;
+    return result.match;
+}
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Host-side fingerprint matching for the FPC2534 library - for Linux gateways with more identities than the
+// template storage of a sensor holds.
+//
+// Images are read from the sensor (requestCapture(), then requestGetImageData()), their minutiae extracted on the
+// host, and identified (1:N) against a gallery held on the host:
+//
+//   sfDevFPC2534MinutiaeExtractor  - ridge endings and bifurcations of an 8 bit gray scale image (dark ridges):
+//                                    local mean binarization, thinning, crossing numbers, and the direction of
+//                                    each minutia from its ridge
+//   sfDevFPC2534Gallery            - the minutiae of the enrolled fingers, matched with local structures: each
+//                                    minutia is described by its nearest neighbors (distance, direction to the
+//                                    neighbor, and relative ridge direction), which does not change when the
+//                                    finger moves or turns on the sensor. The score of a gallery entry is the
+//                                    number of probe minutiae with a matching local structure.
+//
+// The gallery is a structure of arrays - each neighbor feature of all the minutiae in one array, 16 minutiae per
+// block - scored 16 minutiae at a time (AVX2), 8 at a time (SSE2), or one at a time (the scalar kernel on other
+// hosts). The kernel is picked at run time, and a search is split across threads.
+//
+// These are only built on a Linux host (no ARDUINO define).
+
+#pragma once
+
+#include "sfDevFPC2534Platform.h"
+
+#if defined(SFE_FPC2534_LINUX_HOST)
+
+// from the FPC SDK
+#include "fpc_api.h"
+
+#include <vector>
+
+struct sfDevFPC2534MatchProbe;
+
+// Most minutiae kept for an image
+const uint16_t kFPC2534MaxMinutiae = 64;
+
+// Neighbors in the local structure of a minutia
+const uint8_t kFPC2534MatchNeighbors = 4;
+
+// Default minimum score for an identification
+const uint16_t kFPC2534DefaultMatchScore = 6;
+
+//--------------------------------------------------------------------------------------------
+// A minutia - position in pixels, direction (0-255 for a full turn), type
+typedef enum
+{
+    kFPC2534MinutiaEnding = 1,
+    kFPC2534MinutiaBifurcation = 3 // the crossing numbers
+} sfDevFPC2534MinutiaType_t;
+
+typedef struct
+{
+    uint16_t x;
+    uint16_t y;
+    uint8_t angle;
+    uint8_t type;
+} sfDevFPC2534Minutia_t;
+
+// The minutiae of an image
+typedef struct
+{
+    uint16_t count;
+    sfDevFPC2534Minutia_t minutiae[kFPC2534MaxMinutiae];
+} sfDevFPC2534Minutiae_t;
+
+//--------------------------------------------------------------------------------------------
+// Extracts the minutiae of an image - the work buffers are kept for the next image
+class sfDevFPC2534MinutiaeExtractor
+{
+  public:
+    /**
+     * @brief Extract the minutiae of an image
+     *
+     * @param image 8 bit gray scale pixels, row by row - dark ridges
+     * @param width Image width
+     * @param height Image height
+     * @param minutiae Set to the minutiae found - those nearest the center when there are more than
+     * kFPC2534MaxMinutiae
+     * @return Result Code - FPC_RESULT_INVALID_PARAM for an image smaller than 32 x 32
+     */
+    fpc_result_t extract(const uint8_t *image, uint16_t width, uint16_t height, sfDevFPC2534Minutiae_t &minutiae);
+
+  private:
+    void binarize(const uint8_t *image);
+    void thin(void);
+    int trace(int start, int from, int steps, int &endX, int &endY);
+
+    int _width = 0;
+    int _height = 0;
+    std::vector<uint8_t> _smooth;
+    std::vector<uint32_t> _integral;
+    std::vector<uint8_t> _ridge;  // binary, then the skeleton
+    std::vector<uint8_t> _mask;   // foreground
+    std::vector<uint8_t> _remove; // thinning pass
+};
+
+//--------------------------------------------------------------------------------------------
+// Scoring kernels
+typedef enum
+{
+    kFPC2534MatchAuto = 0, // the best kernel the host supports
+    kFPC2534MatchScalar,
+    kFPC2534MatchSSE2,
+    kFPC2534MatchAVX2
+} sfDevFPC2534MatchKernel_t;
+
+// Result of an identification
+typedef struct
+{
+    bool match;     // the best score is at least the minimum score
+    uint32_t id;    // of the best gallery entry
+    uint32_t index; // of the best gallery entry
+    uint16_t score; // the best score
+} sfDevFPC2534MatchResult_t;
+
+//--------------------------------------------------------------------------------------------
+// A gallery of enrolled fingers - identified in parallel, with SIMD scoring
+class sfDevFPC2534Gallery
+{
+  public:
+    sfDevFPC2534Gallery();
+
+    /**
+     * @brief Add the minutiae of a finger to the gallery
+     *
+     * @param id The ID of the entry - returned by identify(), any value
+     * @param minutiae The minutiae
+     * @return The index of the entry
+     */
+    uint32_t add(uint32_t id, const sfDevFPC2534Minutiae_t &minutiae);
+
+    /**
+     * @brief Number of entries
+     */
+    uint32_t size(void) const
+    {
+        return (uint32_t)_ids.size();
+    }
+
+    void clear(void);
+
+    /**
+     * @brief Score a probe against one entry (1:1)
+     *
+     * @return The score - the number of probe minutiae that match
+     */
+    uint16_t score(const sfDevFPC2534Minutiae_t &probe, uint32_t index) const;
+
+    /**
+     * @brief Identify a probe - the entry with the best score (1:N)
+     *
+     * @param probe The minutiae of the probe
+     * @param result Set to the best entry - match is set if its score is at least the minimum score
+     * @return true on a match
+     */
+    bool identify(const sfDevFPC2534Minutiae_t &probe, sfDevFPC2534MatchResult_t &result) const;
+
+    /**
+     * @brief Set the minimum score for a match (default kFPC2534DefaultMatchScore)
+     */
+    void setMinScore(uint16_t score)
+    {
+        _minScore = score;
+    }
+
+    /**
+     * @brief Set the scoring kernel - a kernel the host does not support is replaced by the best one it does
+     */
+    void setKernel(sfDevFPC2534MatchKernel_t kernel);
+
+    /**
+     * @brief The scoring kernel in use
+     */
+    sfDevFPC2534MatchKernel_t kernel(void) const
+    {
+        return _kernel;
+    }
+
+    /**
+     * @brief Set the number of threads a search is split across (default - the cores of the host). Small galleries
+     * are searched on the calling thread.
+     */
+    void setThreads(uint16_t threads);
+
+  private:
+    void describe(const sfDevFPC2534Minutiae_t &minutiae, int16_t (*dist)[kFPC2534MatchNeighbors],
+                  int16_t (*dir)[kFPC2534MatchNeighbors], int16_t (*rel)[kFPC2534MatchNeighbors],
+                  int16_t missing) const;
+    void search(const sfDevFPC2534MatchProbe &probe, uint32_t first, uint32_t last,
+                sfDevFPC2534MatchResult_t &result) const;
+    uint16_t scoreEntry(const sfDevFPC2534MatchProbe &probe, uint32_t index) const;
+
+    // Per entry
+    std::vector<uint32_t> _ids;
+    std::vector<uint32_t> _first;  // first block of the entry
+    std::vector<uint16_t> _blocks; // blocks of the entry
+
+    // Per minutia, in blocks - each feature of neighbor k in its own array
+    std::vector<int16_t> _dist[kFPC2534MatchNeighbors];
+    std::vector<int16_t> _dir[kFPC2534MatchNeighbors];
+    std::vector<int16_t> _rel[kFPC2534MatchNeighbors];
+
+    uint16_t _minScore;
+    sfDevFPC2534MatchKernel_t _kernel;
+    uint16_t _threads;
+};
+
+#endif
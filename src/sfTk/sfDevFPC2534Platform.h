@@ -0,0 +1,77 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Platform layer for the core of the library.
+//
+// The core of the library (sfDevFPC2534) only needs a handful of timing functions from the
+// Arduino framework. When built with Arduino, this just pulls in Arduino.h. When built on a
+// Linux host (no ARDUINO define), minimal versions of these functions are provided so the core
+// can be used with the Linux transports (sfDevFPC2534Linux.h) on embedded Linux gateways.
+
+#pragma once
+
+#if defined(ARDUINO)
+
+#include <Arduino.h>
+
+#elif defined(__linux__)
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// Flag used by the library to enable host only functionality
+#define SFE_FPC2534_LINUX_HOST 1
+
+//--------------------------------------------------------------------------------------------
+// Time in microseconds since an arbitrary, monotonic, start point
+static inline unsigned long micros(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long)((uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL);
+}
+
+//--------------------------------------------------------------------------------------------
+// Time in milliseconds since an arbitrary, monotonic, start point
+static inline unsigned long millis(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long)((uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL);
+}
+
+//--------------------------------------------------------------------------------------------
+static inline void delayMicroseconds(unsigned int us)
+{
+    struct timespec ts = {(time_t)(us / 1000000U), (long)(us % 1000000U) * 1000L};
+    while (nanosleep(&ts, &ts) != 0)
+        ;
+}
+
+//--------------------------------------------------------------------------------------------
+static inline void delay(unsigned long ms)
+{
+    struct timespec ts = {(time_t)(ms / 1000UL), (long)(ms % 1000UL) * 1000000L};
+    while (nanosleep(&ts, &ts) != 0)
+        ;
+}
+
+#else
+
+#error "sfDevFPC2534: unsupported platform - an Arduino framework or Linux host is required"
+
+#endif
+
+// Platforms with an RTOS/thread layer that can run the library I/O task (sfDevFPC2534IOTask.h)
+#if defined(ESP32) || defined(SFE_FPC2534_LINUX_HOST)
+#define SFE_FPC2534_HAS_IO_TASK 1
+#endif
@@ -0,0 +1,187 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Implementation of the sensor stop mode power manager
+
+#include "sfDevFPC2534Power.h"
+
+// Sensor states where an operation is running - the sensor does not enter stop mode
+#define FPC2534_POWER_BUSY_STATES (STATE_CAPTURE | STATE_DATA_TRANSFER | STATE_ENROLL | STATE_IDENTIFY | STATE_NAVIGATION)
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534Power::sfDevFPC2534Power()
+    : _device{nullptr}, _hook{hookHandler, this, nullptr}, _stats{0}, _fixedConfig{false}, _stopMode{false},
+      _idleMs{0}, _wakeDelayUs{kFPC2534DefaultWakeDelayUs}, _lastActivityMs{0}, _accountedToMs{0},
+      _statsStartMs{0}, _busy{false}
+{
+}
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534Power::~sfDevFPC2534Power()
+{
+    end();
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534Power::begin(sfDevFPC2534 &device)
+{
+    if (_device != nullptr || device._comm == nullptr || device._power != nullptr)
+        return false;
+
+    _device = &device;
+    _busy = (_device->_current_state & FPC2534_POWER_BUSY_STATES) != 0;
+    _lastActivityMs = millis();
+    resetStats();
+
+    _device->addHook(_hook);
+    _device->_power = this;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Power::end(void)
+{
+    if (_device == nullptr)
+        return;
+
+    _device->_power = nullptr;
+    _device->removeHook(_hook);
+    _device = nullptr;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Power::setStopMode(bool stopMode, uint16_t idleMs)
+{
+    _fixedConfig = true;
+    _stopMode = stopMode;
+    _idleMs = idleMs;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Power::updateConfig(void)
+{
+    if (_fixedConfig || !_device->_cfgCached)
+        return;
+
+    // What is on the sensor - not any uncommitted changes
+    _stopMode = (_device->_cfgActive.sys_flags & CFG_SYS_FLAG_UART_IN_STOP_MODE) != 0;
+    _idleMs = _device->_cfgActive.idle_time_before_sleep_ms;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534Power::asleepAt(uint32_t nowMs, uint32_t &sleptAtMs)
+{
+    updateConfig();
+    if (!_stopMode || _busy)
+        return false;
+
+    sleptAtMs = _lastActivityMs + _idleMs;
+    return nowMs - _lastActivityMs >= _idleMs;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Power::accountSleep(uint32_t nowMs)
+{
+    uint32_t sleptAtMs;
+    if (asleepAt(nowMs, sleptAtMs))
+    {
+        // part of this sleep period may already be accounted (getStats())
+        uint32_t fromMs = (int32_t)(sleptAtMs - _accountedToMs) > 0 ? sleptAtMs : _accountedToMs;
+        _stats.asleepMs += nowMs - fromMs;
+    }
+    _accountedToMs = nowMs;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Power::markAwake(uint32_t nowMs)
+{
+    accountSleep(nowMs);
+    _lastActivityMs = nowMs;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534Power::isSensorAsleep(void)
+{
+    uint32_t sleptAtMs;
+    return _device != nullptr && asleepAt(millis(), sleptAtMs);
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534Power::wake(void)
+{
+    if (!isSensorAsleep())
+        return FPC_RESULT_OK;
+
+    uint32_t startUs = micros();
+    if (!_device->_comm->wakeSensor())
+    {
+        _stats.wakeFailures++;
+        return FPC_RESULT_IO_NOT_SUPPORTED;
+    }
+
+    // the sensor needs time to start its UART
+    if (_wakeDelayUs >= 1000)
+        delay(_wakeDelayUs / 1000);
+    delayMicroseconds(_wakeDelayUs % 1000);
+
+    uint32_t latencyUs = micros() - startUs;
+    _stats.wakeups++;
+    _stats.totalWakeLatencyUs += latencyUs;
+    if (latencyUs > _stats.maxWakeLatencyUs)
+        _stats.maxWakeLatencyUs = latencyUs;
+
+    markAwake(millis());
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Called by the device before each command is sent. If the wake fails, the command is sent anyway - the sleep
+// state is a model, and the sensor may well be awake.
+//
+void sfDevFPC2534Power::beforeCommand(void)
+{
+    _stats.commands++;
+    wake();
+
+    // the command restarts the idle timer
+    markAwake(millis());
+}
+
+//--------------------------------------------------------------------------------------------
+// Called by the device for every parsed response/event - the sensor is awake
+//
+void sfDevFPC2534Power::hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size)
+{
+    sfDevFPC2534Power *self = static_cast<sfDevFPC2534Power *>(arg);
+
+    self->markAwake(millis());
+
+    if (cmd->cmd_id == CMD_STATUS && size == sizeof(fpc_cmd_status_response_t))
+        self->_busy = (((fpc_cmd_status_response_t *)cmd)->state & FPC2534_POWER_BUSY_STATES) != 0;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Power::getStats(sfDevFPC2534PowerStats_t &stats)
+{
+    uint32_t nowMs = millis();
+    if (_device != nullptr)
+        accountSleep(nowMs);
+
+    _stats.trackedMs = nowMs - _statsStartMs;
+    stats = _stats;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Power::resetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+    _statsStartMs = millis();
+    _accountedToMs = _statsStartMs;
+}
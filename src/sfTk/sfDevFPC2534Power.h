@@ -0,0 +1,144 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Sensor stop mode power manager for the FPC2534 library.
+//
+// With the CFG_SYS_FLAG_UART_IN_STOP_MODE system flag set, the sensor enters stop mode once it has been idle
+// for idle_time_before_sleep_ms, and must be woken by a pulse on its wake-up pin (CS) before it can receive
+// UART data - a command sent while the sensor sleeps is lost.
+//
+// The power manager tracks the sleep state of the sensor from the idle timer and the traffic with the sensor:
+//
+//   - The idle timer restarts when a command is sent, or a frame is received from the sensor
+//   - While an operation is running (enroll, identify, navigation, capture), the sensor is awake
+//
+// Before each command, the device asks the power manager to wake the sensor if it is modeled asleep - the wake
+// pin is pulsed by the transport, then the wake delay is waited. Time asleep and the wake latency paid are
+// accounted, so the idle time can be tuned for energy against responsiveness.
+
+#pragma once
+
+#include "sfDevFPC2534.h"
+
+// Default time from the wake pulse until the sensor accepts UART data, in microseconds
+const uint32_t kFPC2534DefaultWakeDelayUs = 1000;
+
+//--------------------------------------------------------------------------------------------
+// Power manager statistics. Sleep time is an estimate from the idle timer model.
+typedef struct
+{
+    uint32_t commands;           // commands sent
+    uint32_t wakeups;            // wakes of the sensor from stop mode
+    uint32_t wakeFailures;       // wakes the transport could not do (no wake pin)
+    uint32_t trackedMs;          // time tracked - since begin() or resetStats()
+    uint32_t asleepMs;           // time the sensor spent in stop mode
+    uint32_t totalWakeLatencyUs; // divide by wakeups for the average
+    uint32_t maxWakeLatencyUs;
+} sfDevFPC2534PowerStats_t;
+
+//--------------------------------------------------------------------------------------------
+class sfDevFPC2534Power
+{
+  public:
+    sfDevFPC2534Power();
+    ~sfDevFPC2534Power();
+
+    /**
+     * @brief Start managing the sensor power state for the given device. The device must be initialized, and
+     * its transport must support a wake pin (see the transport setWakePin()/attachWakePin()).
+     *
+     * The sensor is assumed awake at this point.
+     *
+     * @param device The initialized device object
+     * @return true on success
+     */
+    bool begin(sfDevFPC2534 &device);
+
+    /**
+     * @brief Stop managing the sensor power state - commands are sent without a wake.
+     */
+    void end(void);
+
+    /**
+     * @brief Set the stop mode settings of the sensor.
+     *
+     * By default, the settings are taken from the cached system configuration of the device (see
+     * isConfigCached()) - the CFG_SYS_FLAG_UART_IN_STOP_MODE flag and idle_time_before_sleep_ms. Call this
+     * when the configuration is not cached - the settings then stay fixed.
+     *
+     * @param stopMode Does the sensor enter stop mode?
+     * @param idleMs Idle time before the sensor enters stop mode, in milliseconds
+     */
+    void setStopMode(bool stopMode, uint16_t idleMs);
+
+    /**
+     * @brief Set the time to wait after the wake pulse, before a command is sent.
+     *
+     * @param delayUs Wake delay in microseconds
+     */
+    void setWakeDelay(uint32_t delayUs)
+    {
+        _wakeDelayUs = delayUs;
+    }
+
+    /**
+     * @brief Is the sensor (modeled as) in stop mode?
+     */
+    bool isSensorAsleep(void);
+
+    /**
+     * @brief Wake the sensor now if it is asleep - for example, ahead of a command when the latency matters.
+     *
+     * @return FPC_RESULT_OK if the sensor is awake, or an error if the wake failed
+     */
+    fpc_result_t wake(void);
+
+    /**
+     * @brief Get the statistics - including the current sleep period, if the sensor is asleep.
+     *
+     * @param stats Set to the current statistics
+     */
+    void getStats(sfDevFPC2534PowerStats_t &stats);
+    void resetStats(void);
+
+  private:
+    friend class sfDevFPC2534;
+
+    // Called by the device before each command is sent
+    void beforeCommand(void);
+
+    // Take the stop mode settings from the cached system configuration of the device
+    void updateConfig(void);
+
+    static void hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size);
+
+    // The sensor is known to be awake at the given time - restart the idle timer
+    void markAwake(uint32_t nowMs);
+
+    // Account the sleep period (if any) up to the given time
+    void accountSleep(uint32_t nowMs);
+
+    // Is the sensor asleep at the given time? Sets the time it entered stop mode.
+    bool asleepAt(uint32_t nowMs, uint32_t &sleptAtMs);
+
+    sfDevFPC2534 *_device;
+    sfDevFPC2534Hook_t _hook;
+    sfDevFPC2534PowerStats_t _stats;
+
+    bool _fixedConfig;
+    bool _stopMode;
+    uint16_t _idleMs;
+    uint32_t _wakeDelayUs;
+
+    uint32_t _lastActivityMs; // idle timer start
+    uint32_t _accountedToMs;  // sleep time is accounted up to here
+    uint32_t _statsStartMs;
+    bool _busy; // an operation is running on the sensor
+};
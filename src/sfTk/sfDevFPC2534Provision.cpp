@@ -0,0 +1,380 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Implementation of the bulk template provisioning pipeline
+
+#include "sfDevFPC2534Provision.h"
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534Provision::sfDevFPC2534Provision()
+    : _manager{nullptr}, _source{nullptr}, _config(kFPC2534DefaultProvisionConfig), _sensors{}, _count{0},
+      _startMs{0}
+{
+}
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534Provision::~sfDevFPC2534Provision()
+{
+    end();
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534Provision::begin(sfDevFPC2534Manager &manager, sfDevFPC2534TemplateSource &source,
+                                  const sfDevFPC2534ProvisionConfig_t &config)
+{
+    if (_manager != nullptr || manager.sensorCount() == 0 || config.maxAttempts == 0)
+        return false;
+
+    // The templates are verified with the template index of the sensors - the IDs must be in it
+    for (uint16_t i = 0; i < source.templateCount(); i++)
+    {
+        uint16_t id;
+        uint32_t size;
+        if (!source.templateInfo(i, id, size) || id > SFE_FPC2534_MAX_TEMPLATE_ID || size == 0 || size > 0xFFFF)
+            return false;
+    }
+
+    _manager = &manager;
+    _source = &source;
+    _config = config;
+    _count = manager.sensorCount();
+    _startMs = millis();
+
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        sensor_t &sensor = _sensors[i];
+        memset(&sensor, 0, sizeof(sensor));
+        sensor.owner = this;
+        sensor.device = manager.sensor(i);
+        sensor.hook = {hookHandler, &sensor, nullptr};
+        sensor.stats.lastError = FPC_RESULT_OK;
+
+        sensor.device->addHook(sensor.hook);
+
+        // What the sensor has already - only needed to skip templates
+        if (_config.skipPresent)
+            requestList(sensor, kFPC2534ProvisionListing);
+        else
+        {
+            sensor.stats.state = kFPC2534ProvisionSending;
+            sendNext(sensor);
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Provision::end(void)
+{
+    if (_manager == nullptr)
+        return;
+
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        sensor_t &sensor = _sensors[i];
+        if (sensor.stats.state == kFPC2534ProvisionSending && sensor.device->isTransferActive())
+            sensor.device->abortTransfer();
+
+        sensor.device->removeHook(sensor.hook);
+    }
+
+    _count = 0;
+    _manager = nullptr;
+    _source = nullptr;
+}
+
+//--------------------------------------------------------------------------------------------
+// Request the template list of a sensor - the hook flags its arrival
+//
+void sfDevFPC2534Provision::requestList(sensor_t &sensor, sfDevFPC2534ProvisionState_t state)
+{
+    sensor.stats.state = state;
+    sensor.listed = false;
+    sensor.lastProgressMs = millis();
+
+    fpc_result_t rc = sensor.device->requestListTemplates();
+    if (rc != FPC_RESULT_OK)
+        retry(sensor, rc);
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Provision::finish(sensor_t &sensor, sfDevFPC2534ProvisionState_t state)
+{
+    sensor.stats.state = state;
+    sensor.doneMs = millis();
+    sensor.stats.elapsedMs = sensor.doneMs - _startMs;
+}
+
+//--------------------------------------------------------------------------------------------
+// Start the transfer of the next template the sensor needs
+//
+void sfDevFPC2534Provision::sendNext(sensor_t &sensor)
+{
+    uint16_t id;
+    uint32_t size;
+
+    for (; sensor.tpl < _source->templateCount(); sensor.tpl++)
+    {
+        if (!_source->templateInfo(sensor.tpl, id, size))
+        {
+            sensor.stats.lastError = FPC_RESULT_INVALID_PARAM;
+            finish(sensor, kFPC2534ProvisionFailed);
+            return;
+        }
+
+        if (sensor.skipPresent && sensor.device->hasTemplate(id))
+        {
+            // Only counted on the first round - a verify round skips the templates sent before
+            if (sensor.rounds == 0)
+                sensor.stats.templatesSkipped++;
+            continue;
+        }
+
+        sensor.progress = 0;
+        sensor.lastProgressMs = millis();
+
+        fpc_result_t rc = sensor.device->requestPutTemplateData(id, size, readChunk, &sensor);
+        if (rc != FPC_RESULT_OK)
+            retry(sensor, rc);
+        return;
+    }
+
+    // All sent - check what the sensor has
+    requestList(sensor, kFPC2534ProvisionVerifying);
+}
+
+//--------------------------------------------------------------------------------------------
+// A transfer (or list request) failed - start it again, or fail the sensor after maxAttempts
+//
+void sfDevFPC2534Provision::retry(sensor_t &sensor, fpc_result_t rc)
+{
+    sensor.stats.lastError = rc;
+    if (++sensor.attempts >= _config.maxAttempts)
+    {
+        finish(sensor, kFPC2534ProvisionFailed);
+        return;
+    }
+    sensor.stats.retries++;
+
+    if (sensor.stats.state == kFPC2534ProvisionSending)
+        sendNext(sensor);
+    else
+        requestList(sensor, sensor.stats.state);
+}
+
+//--------------------------------------------------------------------------------------------
+// Move a sensor along - called after each pass of the manager
+//
+void sfDevFPC2534Provision::step(sensor_t &sensor)
+{
+    uint32_t now = millis();
+
+    switch (sensor.stats.state)
+    {
+    case kFPC2534ProvisionListing:
+        if (sensor.listed)
+        {
+            sensor.attempts = 0;
+            sensor.skipPresent = true;
+            sensor.stats.state = kFPC2534ProvisionSending;
+            sendNext(sensor);
+        }
+        else if (now - sensor.lastProgressMs >= _config.timeoutMs)
+            retry(sensor, FPC_RESULT_TIMEOUT);
+        break;
+
+    case kFPC2534ProvisionSending:
+        if (sensor.device->isTransferActive())
+        {
+            // Still moving?
+            uint32_t progress = sensor.device->transferProgress();
+            if (progress != sensor.progress)
+            {
+                sensor.progress = progress;
+                sensor.lastProgressMs = now;
+            }
+            else if (now - sensor.lastProgressMs >= _config.timeoutMs)
+            {
+                sensor.device->abortTransfer();
+                retry(sensor, FPC_RESULT_TIMEOUT);
+            }
+        }
+        else if (sensor.device->transferResult() == FPC_RESULT_OK)
+        {
+            uint16_t id;
+            uint32_t size;
+            if (_source->templateInfo(sensor.tpl, id, size))
+                sensor.stats.bytes += size;
+            sensor.stats.templatesSent++;
+
+            sensor.attempts = 0;
+            sensor.tpl++;
+            sendNext(sensor);
+        }
+        else
+            retry(sensor, sensor.device->transferResult());
+        break;
+
+    case kFPC2534ProvisionVerifying:
+        if (sensor.listed)
+        {
+            bool complete = true;
+            for (uint16_t i = 0; i < _source->templateCount() && complete; i++)
+            {
+                uint16_t id;
+                uint32_t size;
+                complete = _source->templateInfo(i, id, size) && sensor.device->hasTemplate(id);
+            }
+
+            if (complete)
+                finish(sensor, kFPC2534ProvisionDone);
+            else if (++sensor.rounds >= _config.maxAttempts)
+            {
+                sensor.stats.lastError = FPC_RESULT_FAILURE;
+                finish(sensor, kFPC2534ProvisionFailed);
+            }
+            else
+            {
+                // Send what is missing
+                sensor.attempts = 0;
+                sensor.tpl = 0;
+                sensor.skipPresent = true;
+                sensor.stats.state = kFPC2534ProvisionSending;
+                sendNext(sensor);
+            }
+        }
+        else if (now - sensor.lastProgressMs >= _config.timeoutMs)
+            retry(sensor, FPC_RESULT_TIMEOUT);
+        break;
+
+    default:
+        break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534Provision::poll(void)
+{
+    if (_manager == nullptr)
+        return FPC_RESULT_WRONG_STATE;
+
+    fpc_result_t rc = _manager->poll();
+
+    for (uint8_t i = 0; i < _count; i++)
+        step(_sensors[i]);
+
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534Provision::run(uint32_t timeoutMs)
+{
+    if (_manager == nullptr)
+        return FPC_RESULT_WRONG_STATE;
+
+    uint32_t start = millis();
+    while (!isDone())
+    {
+        if (millis() - start >= timeoutMs)
+            return FPC_RESULT_TIMEOUT;
+
+        // Wait for a sensor to have data - a short wait, so stalled transfers are noticed
+        _manager->waitForEvent(10);
+        for (uint8_t i = 0; i < _count; i++)
+            step(_sensors[i]);
+    }
+
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (_sensors[i].stats.state == kFPC2534ProvisionFailed)
+            return FPC_RESULT_FAILURE;
+    }
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534Provision::isDone(void) const
+{
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (_sensors[i].stats.state != kFPC2534ProvisionDone && _sensors[i].stats.state != kFPC2534ProvisionFailed)
+            return false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534Provision::getSensorStats(uint8_t sensor, sfDevFPC2534ProvisionSensorStats_t &stats) const
+{
+    if (sensor >= _count)
+        return false;
+
+    stats = _sensors[sensor].stats;
+
+    // still running - elapsed to now
+    if (stats.state != kFPC2534ProvisionDone && stats.state != kFPC2534ProvisionFailed)
+        stats.elapsedMs = millis() - _startMs;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534Provision::getStats(sfDevFPC2534ProvisionStats_t &stats) const
+{
+    memset(&stats, 0, sizeof(stats));
+    stats.sensors = _count;
+
+    bool running = false;
+    uint32_t lastDoneMs = _startMs;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        const sensor_t &sensor = _sensors[i];
+        stats.templatesSent += sensor.stats.templatesSent;
+        stats.retries += sensor.stats.retries;
+        stats.bytes += sensor.stats.bytes;
+
+        if (sensor.stats.state == kFPC2534ProvisionDone)
+            stats.done++;
+        else if (sensor.stats.state == kFPC2534ProvisionFailed)
+            stats.failed++;
+        else
+        {
+            running = true;
+            continue;
+        }
+
+        if (sensor.doneMs - _startMs > lastDoneMs - _startMs)
+            lastDoneMs = sensor.doneMs;
+    }
+
+    stats.elapsedMs = (running ? millis() : lastDoneMs) - _startMs;
+    stats.throughput = stats.elapsedMs > 0 ? (uint32_t)((uint64_t)stats.bytes * 1000 / stats.elapsedMs) : 0;
+}
+
+//--------------------------------------------------------------------------------------------
+// Called by a device for each parsed frame - flags the template list response
+//
+void sfDevFPC2534Provision::hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size)
+{
+    sensor_t *sensor = static_cast<sensor_t *>(arg);
+
+    if (cmd->cmd_id == CMD_LIST_TEMPLATES)
+        sensor->listed = true;
+}
+
+//--------------------------------------------------------------------------------------------
+// Read a chunk of the template being sent to a sensor - at the offset of that sensor
+//
+uint16_t sfDevFPC2534Provision::readChunk(void *arg, uint32_t offset, uint8_t *data, uint16_t len)
+{
+    sensor_t *sensor = static_cast<sensor_t *>(arg);
+
+    return sensor->owner->_source->readTemplate(sensor->tpl, offset, data, len);
+}
@@ -0,0 +1,245 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Bulk template provisioning for the FPC2534 library.
+//
+// The provisioning pipeline pushes one set of templates (a template source) to all the sensors of a multi-sensor
+// manager at once, with template PUT transfers:
+//
+//   - Each sensor runs its own transfer - the chunks are read from the source as they are sent, at the offset of
+//     that sensor, so the templates do not need to be in memory
+//   - The manager pumps the sensors in turn, and each confirmed chunk sends the next - the chunks of the sensors
+//     are interleaved across the buses, and a slow sensor does not hold up the others
+//   - When a sensor has all the templates, its template list is requested (requestListTemplates()) and checked
+//     against the source - missing templates are sent again
+//   - A failed or stalled transfer is restarted for that sensor only, from the template that failed - the
+//     templates already on the sensor are kept. After maxAttempts failures of a template, the sensor is failed.
+//
+// The sensors should be idle (no enroll, identify or navigation running) while they are provisioned. The template
+// IDs must be in the template index of the library (up to SFE_FPC2534_MAX_TEMPLATE_ID), and each template is at
+// most 64 KB (the size field of the PUT request).
+
+#pragma once
+
+#include "sfDevFPC2534.h"
+#include "sfDevFPC2534Manager.h"
+
+//--------------------------------------------------------------------------------------------
+// A set of templates to provision - read in chunks, at any offset (several sensors read the same template at
+// their own pace).
+class sfDevFPC2534TemplateSource
+{
+  public:
+    // Number of templates
+    virtual uint16_t templateCount(void) = 0;
+
+    // The ID and size of a template - false if the index is not valid
+    virtual bool templateInfo(uint16_t index, uint16_t &id, uint32_t &size) = 0;
+
+    // Read len bytes of a template, at offset, into data - returns the bytes read
+    virtual uint16_t readTemplate(uint16_t index, uint32_t offset, uint8_t *data, uint16_t len) = 0;
+};
+
+//--------------------------------------------------------------------------------------------
+// A template in memory
+typedef struct
+{
+    uint16_t id;
+    const uint8_t *data;
+    uint32_t size;
+} sfDevFPC2534Template_t;
+
+//--------------------------------------------------------------------------------------------
+// Template source for templates in memory
+class sfDevFPC2534MemoryTemplates : public sfDevFPC2534TemplateSource
+{
+  public:
+    sfDevFPC2534MemoryTemplates(const sfDevFPC2534Template_t *templates, uint16_t count)
+        : _templates{templates}, _count{count}
+    {
+    }
+
+    uint16_t templateCount(void)
+    {
+        return _count;
+    }
+
+    bool templateInfo(uint16_t index, uint16_t &id, uint32_t &size)
+    {
+        if (index >= _count)
+            return false;
+
+        id = _templates[index].id;
+        size = _templates[index].size;
+        return true;
+    }
+
+    uint16_t readTemplate(uint16_t index, uint32_t offset, uint8_t *data, uint16_t len)
+    {
+        if (index >= _count || offset + len > _templates[index].size)
+            return 0;
+
+        memcpy(data, _templates[index].data + offset, len);
+        return len;
+    }
+
+  private:
+    const sfDevFPC2534Template_t *_templates;
+    uint16_t _count;
+};
+
+//--------------------------------------------------------------------------------------------
+// Provisioning settings
+typedef struct
+{
+    uint8_t maxAttempts; // attempts for each template on a sensor, before the sensor is failed
+    uint32_t timeoutMs;  // a transfer with no progress for this long is restarted
+    bool skipPresent;    // don't send the templates a sensor already has (from its template list)
+} sfDevFPC2534ProvisionConfig_t;
+
+const sfDevFPC2534ProvisionConfig_t kFPC2534DefaultProvisionConfig = {3, 2000, true};
+
+//--------------------------------------------------------------------------------------------
+// Provisioning state of a sensor
+typedef enum
+{
+    kFPC2534ProvisionIdle = 0,
+    kFPC2534ProvisionListing,   // reading the template list of the sensor
+    kFPC2534ProvisionSending,   // sending the templates
+    kFPC2534ProvisionVerifying, // checking the template list of the sensor
+    kFPC2534ProvisionDone,
+    kFPC2534ProvisionFailed
+} sfDevFPC2534ProvisionState_t;
+
+//--------------------------------------------------------------------------------------------
+// Provisioning statistics of a sensor
+typedef struct
+{
+    sfDevFPC2534ProvisionState_t state;
+    uint16_t templatesSent;    // templates confirmed by the sensor
+    uint16_t templatesSkipped; // already on the sensor
+    uint16_t retries;          // transfers restarted
+    uint32_t bytes;            // template bytes confirmed by the sensor
+    uint32_t elapsedMs;        // begin() to done - or to now, while running
+    fpc_result_t lastError;
+} sfDevFPC2534ProvisionSensorStats_t;
+
+//--------------------------------------------------------------------------------------------
+// Provisioning statistics of all the sensors
+typedef struct
+{
+    uint8_t sensors;
+    uint8_t done;
+    uint8_t failed;
+    uint32_t templatesSent;
+    uint32_t retries;
+    uint32_t bytes;      // template bytes confirmed, all sensors
+    uint32_t elapsedMs;  // begin() to the last sensor done - or to now, while running
+    uint32_t throughput; // bytes per second, all sensors
+} sfDevFPC2534ProvisionStats_t;
+
+//--------------------------------------------------------------------------------------------
+class sfDevFPC2534Provision
+{
+  public:
+    sfDevFPC2534Provision();
+    ~sfDevFPC2534Provision();
+
+    /**
+     * @brief Start provisioning the templates of the source to all the sensors of the manager.
+     *
+     * @param manager The manager of the sensors - its sensors must be added first
+     * @param source The templates - must stay valid until done
+     * @param config The provisioning settings
+     * @return true on success - false if a template ID or size of the source is out of range
+     */
+    bool begin(sfDevFPC2534Manager &manager, sfDevFPC2534TemplateSource &source,
+               const sfDevFPC2534ProvisionConfig_t &config = kFPC2534DefaultProvisionConfig);
+
+    /**
+     * @brief Stop provisioning - transfers running are aborted
+     */
+    void end(void);
+
+    /**
+     * @brief Pump the sensors (a pass of the manager), and move each sensor along. Call regularly (in loop).
+     *
+     * @return FPC_RESULT_OK, or the last error of a pass of the manager
+     */
+    fpc_result_t poll(void);
+
+    /**
+     * @brief Run the provisioning until all the sensors are done or failed - or the timeout expires.
+     *
+     * @param timeoutMs The maximum time to run, in milliseconds
+     * @return FPC_RESULT_OK if all the sensors were provisioned, FPC_RESULT_FAILURE if a sensor failed, or
+     * FPC_RESULT_TIMEOUT
+     */
+    fpc_result_t run(uint32_t timeoutMs);
+
+    /**
+     * @brief Are all the sensors done (or failed)?
+     */
+    bool isDone(void) const;
+
+    /**
+     * @brief Get the provisioning statistics of a sensor
+     *
+     * @param sensor The index of the sensor in the manager
+     * @param stats Set to the statistics
+     * @return true if the index is valid
+     */
+    bool getSensorStats(uint8_t sensor, sfDevFPC2534ProvisionSensorStats_t &stats) const;
+
+    /**
+     * @brief Get the provisioning statistics of all the sensors
+     */
+    void getStats(sfDevFPC2534ProvisionStats_t &stats) const;
+
+  private:
+    typedef struct
+    {
+        sfDevFPC2534Provision *owner;
+        sfDevFPC2534 *device;
+        sfDevFPC2534Hook_t hook;
+        uint16_t tpl;      // index of the template being sent
+        uint8_t attempts;  // failed attempts of the template
+        uint8_t rounds;    // verify rounds
+        bool listed;       // the template list response arrived
+        bool skipPresent;
+        uint32_t progress; // transfer progress, as of lastProgressMs
+        uint32_t lastProgressMs;
+        uint32_t doneMs;
+        sfDevFPC2534ProvisionSensorStats_t stats;
+    } sensor_t;
+
+    // Move a sensor along
+    void step(sensor_t &sensor);
+
+    // Start the transfer of the next template the sensor needs - or verify when there are none left
+    void sendNext(sensor_t &sensor);
+
+    // A transfer failed - restart it, or fail the sensor
+    void retry(sensor_t &sensor, fpc_result_t rc);
+
+    void requestList(sensor_t &sensor, sfDevFPC2534ProvisionState_t state);
+    void finish(sensor_t &sensor, sfDevFPC2534ProvisionState_t state);
+
+    static void hookHandler(void *arg, fpc_cmd_hdr_t *cmd, size_t size);
+    static uint16_t readChunk(void *arg, uint32_t offset, uint8_t *data, uint16_t len);
+
+    sfDevFPC2534Manager *_manager;
+    sfDevFPC2534TemplateSource *_source;
+    sfDevFPC2534ProvisionConfig_t _config;
+
+    sensor_t _sensors[kFPC2534MaxSensors];
+    uint8_t _count;
+    uint32_t _startMs;
+};
@@ -0,0 +1,352 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Implementation of the streaming image quality analysis
+
+#include "sfDevFPC2534Quality.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SFE_FPC2534_QUALITY_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SFE_FPC2534_QUALITY_NEON
+#endif
+
+//--------------------------------------------------------------------------------------------
+// Block sum kernels - add the sum and the sum of squares of each 8 pixel block of a row to the block row
+// totals. The squares go to 4 lanes for each block (the scalar kernel only uses the first).
+//--------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------
+// Scalar - the pixel sums 4 at a time in a 32 bit word (two 16 bit lanes)
+//
+static void blockSumsScalar(const uint8_t *row, uint16_t blocks, uint32_t *sums, uint32_t (*squares)[4])
+{
+    for (uint16_t b = 0; b < blocks; b++)
+    {
+        const uint8_t *p = row + b * kFPC2534QualityBlock;
+
+        uint32_t a, c;
+        memcpy(&a, p, 4);
+        memcpy(&c, p + 4, 4);
+        uint32_t lanes = (a & 0x00FF00FF) + ((a >> 8) & 0x00FF00FF) + (c & 0x00FF00FF) + ((c >> 8) & 0x00FF00FF);
+        sums[b] += (lanes & 0xFFFF) + (lanes >> 16);
+
+        uint32_t q = 0;
+        for (uint8_t i = 0; i < kFPC2534QualityBlock; i++)
+            q += (uint32_t)p[i] * p[i];
+        squares[b][0] += q;
+    }
+}
+
+#if defined(SFE_FPC2534_QUALITY_SSE2)
+//--------------------------------------------------------------------------------------------
+// SSE2 - two blocks at a time: the sums with a SAD against zero, the squares with a multiply-add
+//
+static void blockSumsSSE2(const uint8_t *row, uint16_t blocks, uint32_t *sums, uint32_t (*squares)[4])
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    uint16_t b = 0;
+    for (; b + 2 <= blocks; b += 2)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(row + b * kFPC2534QualityBlock));
+
+        __m128i s = _mm_sad_epu8(v, zero);
+        sums[b] += (uint32_t)_mm_cvtsi128_si32(s);
+        sums[b + 1] += (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(s, 8));
+
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i *q0 = (__m128i *)squares[b];
+        __m128i *q1 = (__m128i *)squares[b + 1];
+        _mm_storeu_si128(q0, _mm_add_epi32(_mm_loadu_si128(q0), _mm_madd_epi16(lo, lo)));
+        _mm_storeu_si128(q1, _mm_add_epi32(_mm_loadu_si128(q1), _mm_madd_epi16(hi, hi)));
+    }
+
+    if (b < blocks)
+        blockSumsScalar(row + b * kFPC2534QualityBlock, blocks - b, sums + b, squares + b);
+}
+#endif
+
+#if defined(SFE_FPC2534_QUALITY_NEON)
+//--------------------------------------------------------------------------------------------
+// NEON - two blocks at a time: the sums with pairwise adds, the squares with a widening multiply
+//
+static void blockSumsNEON(const uint8_t *row, uint16_t blocks, uint32_t *sums, uint32_t (*squares)[4])
+{
+    uint16_t b = 0;
+    for (; b + 2 <= blocks; b += 2)
+    {
+        uint8x16_t v = vld1q_u8(row + b * kFPC2534QualityBlock);
+
+        uint64x2_t s = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(v)));
+        sums[b] += (uint32_t)vgetq_lane_u64(s, 0);
+        sums[b + 1] += (uint32_t)vgetq_lane_u64(s, 1);
+
+        uint16x8_t lo = vmull_u8(vget_low_u8(v), vget_low_u8(v));
+        uint16x8_t hi = vmull_u8(vget_high_u8(v), vget_high_u8(v));
+        vst1q_u32(squares[b], vpadalq_u16(vld1q_u32(squares[b]), lo));
+        vst1q_u32(squares[b + 1], vpadalq_u16(vld1q_u32(squares[b + 1]), hi));
+    }
+
+    if (b < blocks)
+        blockSumsScalar(row + b * kFPC2534QualityBlock, blocks - b, sums + b, squares + b);
+}
+#endif
+
+//--------------------------------------------------------------------------------------------
+// Integer square root
+//
+static uint32_t squareRoot(uint32_t value)
+{
+    uint32_t root = 0;
+    for (uint32_t bit = 1UL << 30; bit != 0; bit >>= 2)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+            root >>= 1;
+    }
+    return root;
+}
+
+//--------------------------------------------------------------------------------------------
+// sfDevFPC2534ImageAnalyzer
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534ImageAnalyzer::sfDevFPC2534ImageAnalyzer()
+    : _width{0}, _height{0}, _row{0}, _fill{0}, _blocks{0}, _background{0}, _claritySum{0}, _rejected{false},
+      _limits{kFPC2534DefaultQualityLimits}, _earlyReject{false}, _foreground{kFPC2534ForegroundThreshold},
+      _kernel{kFPC2534QualityScalar}, _sensor{nullptr}, _writer{nullptr}, _writerArg{nullptr}
+{
+    setKernel(kFPC2534QualityAuto);
+    memset(_histogram, 0, sizeof(_histogram));
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534ImageAnalyzer::setKernel(sfDevFPC2534QualityKernel_t kernel)
+{
+#if defined(SFE_FPC2534_QUALITY_SSE2)
+    const sfDevFPC2534QualityKernel_t vector = kFPC2534QualitySSE2;
+#elif defined(SFE_FPC2534_QUALITY_NEON)
+    const sfDevFPC2534QualityKernel_t vector = kFPC2534QualityNEON;
+#else
+    const sfDevFPC2534QualityKernel_t vector = kFPC2534QualityScalar;
+#endif
+
+    _kernel = (kernel == kFPC2534QualityAuto || kernel == vector) ? vector : kFPC2534QualityScalar;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534ImageAnalyzer::begin(uint16_t width, uint16_t height)
+{
+    _width = 0;
+    if (width == 0 || height == 0 || width % kFPC2534QualityBlock != 0 || width > SFE_FPC2534_QUALITY_MAX_WIDTH ||
+        (uint32_t)(width / kFPC2534QualityBlock) * (height / kFPC2534QualityBlock) > SFE_FPC2534_QUALITY_MAX_BLOCKS)
+        return FPC_RESULT_INVALID_PARAM;
+
+    _width = width;
+    _height = height;
+    _row = 0;
+    _fill = 0;
+    _blocks = 0;
+    _background = 0;
+    _claritySum = 0;
+    _rejected = false;
+    memset(_sums, 0, sizeof(_sums));
+    memset(_squares, 0, sizeof(_squares));
+    memset(_histogram, 0, sizeof(_histogram));
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Rows are analyzed in place when they are whole in the data, and gathered in the row buffer when they are split
+// across calls.
+//
+fpc_result_t sfDevFPC2534ImageAnalyzer::add(const uint8_t *data, size_t len)
+{
+    if (_width == 0 || (size_t)(_height - _row) * _width - _fill < len)
+        return FPC_RESULT_WRONG_STATE;
+
+    while (len > 0)
+    {
+        if (_fill == 0 && len >= _width)
+        {
+            addRow(data);
+            data += _width;
+            len -= _width;
+            continue;
+        }
+
+        uint16_t n = len < (size_t)(_width - _fill) ? (uint16_t)len : _width - _fill;
+        memcpy(_rowBuffer + _fill, data, n);
+        _fill += n;
+        data += n;
+        len -= n;
+
+        if (_fill == _width)
+        {
+            _fill = 0;
+            addRow(_rowBuffer);
+        }
+    }
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534ImageAnalyzer::addRow(const uint8_t *row)
+{
+    for (uint16_t x = 0; x < _width; x++)
+        _histogram[row[x]]++;
+
+    // The rows past the last whole block row are only in the histogram
+    if (_row < mapHeight() * kFPC2534QualityBlock)
+    {
+        uint16_t blocks = mapWidth();
+#if defined(SFE_FPC2534_QUALITY_SSE2)
+        if (_kernel == kFPC2534QualitySSE2)
+            blockSumsSSE2(row, blocks, _sums, _squares);
+        else
+#elif defined(SFE_FPC2534_QUALITY_NEON)
+        if (_kernel == kFPC2534QualityNEON)
+            blockSumsNEON(row, blocks, _sums, _squares);
+        else
+#endif
+            blockSumsScalar(row, blocks, _sums, _squares);
+    }
+
+    _row++;
+    if (_row % kFPC2534QualityBlock == 0 && _row <= mapHeight() * kFPC2534QualityBlock)
+        endBlockRow();
+}
+
+//--------------------------------------------------------------------------------------------
+// The standard deviation of each block of the block row, into the clarity map
+//
+void sfDevFPC2534ImageAnalyzer::endBlockRow(void)
+{
+    const uint32_t n = kFPC2534QualityBlock * kFPC2534QualityBlock;
+
+    for (uint16_t b = 0; b < mapWidth(); b++)
+    {
+        uint32_t squares = _squares[b][0] + _squares[b][1] + _squares[b][2] + _squares[b][3];
+
+        // n * n * variance - fits in 32 bits for 8 x 8 blocks
+        uint32_t scaled = squares * n - _sums[b] * _sums[b];
+        uint32_t deviation = squareRoot(scaled) / n;
+        uint8_t clarity = deviation > 255 ? 255 : (uint8_t)deviation;
+
+        _map[_blocks++] = clarity;
+        if (clarity >= _foreground)
+            _claritySum += clarity;
+        else
+            _background++;
+    }
+
+    memset(_sums, 0, sizeof(_sums));
+    memset(_squares, 0, sizeof(_squares));
+
+    // Too much background already for the coverage limit
+    uint32_t total = (uint32_t)mapWidth() * mapHeight();
+    if (_earlyReject && (uint32_t)_background * 100 > total * (100 - _limits.minCoverage))
+        _rejected = true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534ImageAnalyzer::getQuality(sfDevFPC2534ImageQuality_t &quality) const
+{
+    memset(&quality, 0, sizeof(quality));
+
+    uint64_t sum = 0;
+    for (uint16_t v = 0; v < 256; v++)
+    {
+        quality.pixels += _histogram[v];
+        sum += (uint64_t)v * _histogram[v];
+    }
+    if (quality.pixels == 0)
+        return;
+
+    quality.mean = (uint8_t)(sum / quality.pixels);
+
+    uint32_t lowCount = quality.pixels / 20;
+    uint32_t highCount = quality.pixels - quality.pixels / 20;
+    uint32_t count = 0;
+    bool first = true;
+    for (uint16_t v = 0; v < 256; v++)
+    {
+        if (_histogram[v] == 0)
+            continue;
+
+        if (first)
+        {
+            quality.minimum = (uint8_t)v;
+            first = false;
+        }
+        quality.maximum = (uint8_t)v;
+
+        if (count <= lowCount && count + _histogram[v] > lowCount)
+            quality.low = (uint8_t)v;
+        if (count < highCount && count + _histogram[v] >= highCount)
+            quality.high = (uint8_t)v;
+        count += _histogram[v];
+    }
+    quality.contrast = quality.high - quality.low;
+
+    uint16_t foreground = _blocks - _background;
+    quality.clarity = foreground > 0 ? (uint8_t)(_claritySum / foreground) : 0;
+    quality.coverage = _blocks > 0 ? (uint8_t)((uint32_t)foreground * 100 / _blocks) : 0;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534ImageAnalyzer::isAcceptable(void) const
+{
+    if (!isComplete())
+        return false;
+
+    sfDevFPC2534ImageQuality_t quality;
+    getQuality(quality);
+    return quality.contrast >= _limits.minContrast && quality.clarity >= _limits.minClarity &&
+           quality.coverage >= _limits.minCoverage;
+}
+
+//--------------------------------------------------------------------------------------------
+// Writer of the image transfer - the image dimensions are known when the first chunk arrives
+//
+uint16_t sfDevFPC2534ImageAnalyzer::imageWriter(void *arg, uint32_t offset, const uint8_t *data, uint16_t len)
+{
+    sfDevFPC2534ImageAnalyzer *self = (sfDevFPC2534ImageAnalyzer *)arg;
+
+    if (offset == 0 && self->begin(self->_sensor->imageWidth(), self->_sensor->imageHeight()) != FPC_RESULT_OK)
+        return 0;
+
+    if (self->add(data, len) != FPC_RESULT_OK || self->_rejected)
+        return 0;
+
+    if (self->_writer != nullptr && self->_writer(self->_writerArg, offset, data, len) != len)
+        return 0;
+
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534ImageAnalyzer::requestImage(sfDevFPC2534 &sensor, sfDevFPC2534DataWriter_t writer, void *arg)
+{
+    _sensor = &sensor;
+    _writer = writer;
+    _writerArg = arg;
+    _width = 0;
+    _rejected = false;
+
+    return sensor.requestGetImageData(CMD_IMAGE_REQUEST_TYPE_GET_RAW, imageWriter, this);
+}
@@ -0,0 +1,235 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Image quality for the FPC2534 library - to reject a poor capture before it is matched, or read again in
+// another format.
+//
+// The image is analyzed as it streams in (a raw image GET transfer, or any source of rows) - only one row is held,
+// never the whole image:
+//
+//   histogram  - of the pixel values, with the minimum, maximum, mean, and the 5th and 95th percentiles. The
+//                contrast is the spread between the percentiles.
+//   clarity    - the standard deviation of each 8 x 8 block (the clarity map): high where ridges and valleys are
+//                sharp, low on background and smudges. The clarity of the image is the mean of its foreground
+//                blocks.
+//   coverage   - the percent of the blocks in the foreground (a standard deviation of at least the foreground
+//                threshold) - how much of the sensor the finger covers.
+//
+// The block sums are computed with SSE2 (x86 hosts) or NEON (ARM hosts, and ARM boards with NEON), 16 pixels at a
+// time, or with the scalar kernel on other boards.
+
+#pragma once
+
+#include "sfDevFPC2534.h"
+
+// Widest image analyzed
+#ifndef SFE_FPC2534_QUALITY_MAX_WIDTH
+#define SFE_FPC2534_QUALITY_MAX_WIDTH 256
+#endif
+
+// Most blocks in the clarity map - 1024 blocks is a 256 x 256 image
+#ifndef SFE_FPC2534_QUALITY_MAX_BLOCKS
+#define SFE_FPC2534_QUALITY_MAX_BLOCKS 1024
+#endif
+
+// Size of a clarity block
+const uint8_t kFPC2534QualityBlock = 8;
+
+// Default block standard deviation of the foreground
+const uint8_t kFPC2534ForegroundThreshold = 10;
+
+/// @struct sfDevFPC2534ImageQuality_t
+/// @brief Quality metrics of an image
+typedef struct
+{
+    uint32_t pixels;   // analyzed
+    uint8_t minimum;   // pixel value
+    uint8_t maximum;   // pixel value
+    uint8_t mean;      // pixel value
+    uint8_t low;       // 5th percentile
+    uint8_t high;      // 95th percentile
+    uint8_t contrast;  // high - low
+    uint8_t clarity;   // mean standard deviation of the foreground blocks
+    uint8_t coverage;  // percent of the blocks in the foreground
+} sfDevFPC2534ImageQuality_t;
+
+/// @struct sfDevFPC2534QualityLimits_t
+/// @brief The least quality of an acceptable image
+typedef struct
+{
+    uint8_t minContrast;
+    uint8_t minClarity;
+    uint8_t minCoverage; // percent
+} sfDevFPC2534QualityLimits_t;
+
+const sfDevFPC2534QualityLimits_t kFPC2534DefaultQualityLimits = {64, 20, 60};
+
+// Block sum kernels
+typedef enum
+{
+    kFPC2534QualityAuto = 0, // the vector kernel of the platform, if it has one
+    kFPC2534QualityScalar,
+    kFPC2534QualitySSE2,
+    kFPC2534QualityNEON
+} sfDevFPC2534QualityKernel_t;
+
+//--------------------------------------------------------------------------------------------
+// Computes the quality of an image, row by row as it arrives
+class sfDevFPC2534ImageAnalyzer
+{
+  public:
+    sfDevFPC2534ImageAnalyzer();
+
+    /**
+     * @brief Start an image
+     *
+     * @param width Image width - a multiple of 8, up to SFE_FPC2534_QUALITY_MAX_WIDTH
+     * @param height Image height - the clarity map is at most SFE_FPC2534_QUALITY_MAX_BLOCKS blocks
+     * @return Result Code - FPC_RESULT_INVALID_PARAM for an image that is not supported
+     */
+    fpc_result_t begin(uint16_t width, uint16_t height);
+
+    /**
+     * @brief Add the next pixels of the image - any number, row by row
+     *
+     * @param data The pixels
+     * @param len Number of pixels
+     * @return Result Code - FPC_RESULT_WRONG_STATE before begin(), or past the end of the image
+     */
+    fpc_result_t add(const uint8_t *data, size_t len);
+
+    /**
+     * @brief Read the raw captured image from the sensor, and analyze it as it arrives - the image dimensions are
+     * taken from the sensor. Run processNextResponse() until the transfer is done (isTransferActive()).
+     *
+     * With early reject set, the transfer stops (transferResult() is FPC_RESULT_FAILURE) as soon as the coverage
+     * can no longer reach the limit - isRejected() is then set, and requestAbort() ends the transfer on the sensor.
+     *
+     * @param sensor The sensor, with a captured image
+     * @param writer Optional - called with each chunk after it is analyzed (to keep the image)
+     * @param arg Passed to the writer
+     * @return Result Code
+     */
+    fpc_result_t requestImage(sfDevFPC2534 &sensor, sfDevFPC2534DataWriter_t writer = nullptr, void *arg = nullptr);
+
+    /**
+     * @brief All the rows of the image were added
+     */
+    bool isComplete(void) const
+    {
+        return _width > 0 && _row == _height;
+    }
+
+    /**
+     * @brief The image was rejected while it was read (see requestImage())
+     */
+    bool isRejected(void) const
+    {
+        return _rejected;
+    }
+
+    /**
+     * @brief The quality of the rows added so far
+     */
+    void getQuality(sfDevFPC2534ImageQuality_t &quality) const;
+
+    /**
+     * @brief The image is complete, and meets the quality limits
+     */
+    bool isAcceptable(void) const;
+
+    /**
+     * @brief Set the quality limits (default kFPC2534DefaultQualityLimits), and if an image is rejected while it
+     * is read with requestImage()
+     */
+    void setLimits(const sfDevFPC2534QualityLimits_t &limits, bool earlyReject = false)
+    {
+        _limits = limits;
+        _earlyReject = earlyReject;
+    }
+
+    /**
+     * @brief Set the block standard deviation of the foreground (default kFPC2534ForegroundThreshold)
+     */
+    void setForegroundThreshold(uint8_t threshold)
+    {
+        _foreground = threshold;
+    }
+
+    /**
+     * @brief The histogram of the pixel values - 256 counts
+     */
+    const uint32_t *histogram(void) const
+    {
+        return _histogram;
+    }
+
+    /**
+     * @brief The clarity map - the standard deviation of each block, row by row (mapWidth() x mapHeight())
+     */
+    const uint8_t *clarityMap(void) const
+    {
+        return _map;
+    }
+    uint16_t mapWidth(void) const
+    {
+        return _width / kFPC2534QualityBlock;
+    }
+    uint16_t mapHeight(void) const
+    {
+        return _height / kFPC2534QualityBlock;
+    }
+
+    /**
+     * @brief Set the block sum kernel - a kernel the platform does not have is replaced by the scalar kernel
+     */
+    void setKernel(sfDevFPC2534QualityKernel_t kernel);
+
+    /**
+     * @brief The block sum kernel in use
+     */
+    sfDevFPC2534QualityKernel_t kernel(void) const
+    {
+        return _kernel;
+    }
+
+  private:
+    static uint16_t imageWriter(void *arg, uint32_t offset, const uint8_t *data, uint16_t len);
+    void addRow(const uint8_t *row);
+    void endBlockRow(void);
+
+    uint16_t _width;
+    uint16_t _height;
+    uint16_t _row;     // rows added
+    uint16_t _fill;    // pixels of the current row held
+    uint16_t _blocks;  // blocks in the map so far
+    uint16_t _background;
+    uint32_t _claritySum; // of the foreground blocks
+    bool _rejected;
+
+    sfDevFPC2534QualityLimits_t _limits;
+    bool _earlyReject;
+    uint8_t _foreground;
+    sfDevFPC2534QualityKernel_t _kernel;
+
+    // requestImage()
+    sfDevFPC2534 *_sensor;
+    sfDevFPC2534DataWriter_t _writer;
+    void *_writerArg;
+
+    uint8_t _rowBuffer[SFE_FPC2534_QUALITY_MAX_WIDTH];
+
+    // Sums of the blocks of the current block row - the squares in 4 lanes, added up at the end of the block row
+    uint32_t _sums[SFE_FPC2534_QUALITY_MAX_WIDTH / kFPC2534QualityBlock];
+    uint32_t _squares[SFE_FPC2534_QUALITY_MAX_WIDTH / kFPC2534QualityBlock][4];
+
+    uint8_t _map[SFE_FPC2534_QUALITY_MAX_BLOCKS];
+    uint32_t _histogram[256];
+};
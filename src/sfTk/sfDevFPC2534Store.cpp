@@ -0,0 +1,816 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Implementation of the host template store
+
+#include "sfDevFPC2534Store.h"
+
+#if defined(SFE_FPC2534_LINUX_HOST)
+
+#include "sfDevFPC2534Backup.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+// Layout - the two header copies are in separate sectors of the first page, the index starts on the next page
+const uint64_t kHeaderCopyOffset = 512;
+const uint64_t kPageSize = 4096;
+
+// The data is grown by at least this much - the file is extended, and remapped
+const uint64_t kGrowBytes = 1024 * 1024;
+
+// sfDevFPC2534StoreHeader flags
+const uint16_t kHeaderFlagDirty = 0x0001;
+
+// sfDevFPC2534StoreRecord flags
+const uint16_t kRecordFlagDeleted = 0x0001;
+
+// Index slot states
+const uint16_t kSlotEmpty = 0;
+const uint16_t kSlotUsed = 1;
+const uint16_t kSlotDeleted = 2;
+
+//--------------------------------------------------------------------------------------------
+// File structures - in host byte order
+//
+struct sfDevFPC2534StoreHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint64_t generation;
+    uint32_t slotCount;
+    uint32_t templates;
+    uint64_t indexOffset;
+    uint64_t dataOffset;
+    uint64_t dataEnd;
+    uint64_t liveBytes;
+    uint32_t rebuilds;
+    uint32_t crc; // of the preceding fields
+};
+
+struct sfDevFPC2534StoreSlot
+{
+    uint32_t sensor;
+    uint16_t id;
+    uint16_t state;
+    uint64_t offset; // of the record
+};
+
+struct sfDevFPC2534StoreRecord
+{
+    uint32_t sensor;
+    uint16_t id;
+    uint16_t flags;
+    uint32_t size; // of the data that follows
+    uint32_t crc;  // of the preceding fields and the data
+};
+
+static_assert(sizeof(sfDevFPC2534StoreHeader) == 64, "store header layout");
+static_assert(sizeof(sfDevFPC2534StoreSlot) == 16, "store slot layout");
+static_assert(sizeof(sfDevFPC2534StoreRecord) == 16, "store record layout");
+
+//--------------------------------------------------------------------------------------------
+static uint64_t alignUp(uint64_t value, uint64_t align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+// Size of a record in the file - records start on 8 byte boundaries
+static uint64_t recordLength(uint32_t size)
+{
+    return alignUp(sizeof(sfDevFPC2534StoreRecord) + size, 8);
+}
+
+static uint32_t headerCrc(const sfDevFPC2534StoreHeader *h)
+{
+    return sfDevFPC2534Crc32(0, (const uint8_t *)h, offsetof(sfDevFPC2534StoreHeader, crc));
+}
+
+static uint32_t recordCrc(const sfDevFPC2534StoreRecord *rec)
+{
+    uint32_t crc = sfDevFPC2534Crc32(0, (const uint8_t *)rec, offsetof(sfDevFPC2534StoreRecord, crc));
+    return sfDevFPC2534Crc32(crc, (const uint8_t *)(rec + 1), rec->size);
+}
+
+static uint32_t slotHash(uint32_t sensor, uint16_t id)
+{
+    uint64_t key = ((uint64_t)sensor << 16 | id) * 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(key >> 32);
+}
+
+// Sync the pages of a range of the mapping to the file
+static bool syncRange(uint8_t *base, uint64_t start, uint64_t end)
+{
+    start &= ~(kPageSize - 1);
+    return end <= start || msync(base + start, end - start, MS_SYNC) == 0;
+}
+
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534TemplateStore::sfDevFPC2534TemplateStore()
+    : _fd{-1}, _base{nullptr}, _mapSize{0}, _generation{0}, _slotCount{0}, _indexOffset{0}, _dataOffset{0},
+      _committedEnd{0}, _dataEnd{0}, _templates{0}, _slotsUsed{0}, _liveBytes{0}, _rebuilds{0}, _dirty{false},
+      _batch{false}, _appending{false}, _appendOffset{0}
+{
+}
+
+sfDevFPC2534TemplateStore::~sfDevFPC2534TemplateStore()
+{
+    close();
+}
+
+//--------------------------------------------------------------------------------------------
+const sfDevFPC2534StoreRecord *sfDevFPC2534TemplateStore::record(uint64_t offset) const
+{
+    return (const sfDevFPC2534StoreRecord *)(_base + offset);
+}
+
+sfDevFPC2534StoreSlot *sfDevFPC2534TemplateStore::slots(void) const
+{
+    return (sfDevFPC2534StoreSlot *)(_base + _indexOffset);
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534TemplateStore::open(const char *path, uint32_t slots)
+{
+    if (isOpen())
+        return FPC_RESULT_WRONG_STATE;
+
+    _fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (_fd < 0)
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    fpc_result_t rc = FPC_RESULT_OK;
+    struct stat st;
+    if (flock(_fd, LOCK_EX | LOCK_NB) != 0)
+        rc = errno == EWOULDBLOCK ? FPC_RESULT_IO_BUSY : FPC_RESULT_IO_RUNTIME_FAILURE;
+    else if (fstat(_fd, &st) != 0)
+        rc = FPC_RESULT_IO_RUNTIME_FAILURE;
+    else if (st.st_size == 0)
+        rc = create(slots);
+    else if (st.st_size < (off_t)kPageSize)
+        rc = FPC_RESULT_IO_BAD_DATA;
+    else
+    {
+        rc = map(st.st_size);
+        if (rc == FPC_RESULT_OK)
+            rc = load();
+    }
+
+    if (rc != FPC_RESULT_OK)
+    {
+        if (_base != nullptr)
+            munmap(_base, _mapSize);
+        _base = nullptr;
+        ::close(_fd);
+        _fd = -1;
+        return rc;
+    }
+
+    _path = path;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534TemplateStore::close(void)
+{
+    if (!isOpen())
+        return;
+
+    abortAppend();
+    commit();
+
+    munmap(_base, _mapSize);
+    ::close(_fd);
+    _base = nullptr;
+    _fd = -1;
+    _mapSize = 0;
+}
+
+//--------------------------------------------------------------------------------------------
+// Map size bytes of the file - or remap, after the file is extended
+//
+fpc_result_t sfDevFPC2534TemplateStore::map(uint64_t size)
+{
+    void *base;
+    if (_base == nullptr)
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    else
+        base = mremap(_base, _mapSize, size, MREMAP_MAYMOVE);
+
+    if (base == MAP_FAILED)
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    _base = (uint8_t *)base;
+    _mapSize = size;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// A new store - an empty index, and room for the first records
+//
+fpc_result_t sfDevFPC2534TemplateStore::create(uint32_t slots)
+{
+    _slotCount = 64;
+    while (_slotCount < slots && _slotCount < 0x80000000)
+        _slotCount <<= 1;
+
+    _indexOffset = kPageSize;
+    _dataOffset = alignUp(_indexOffset + (uint64_t)_slotCount * sizeof(sfDevFPC2534StoreSlot), kPageSize);
+    _committedEnd = _dataEnd = _dataOffset;
+    _generation = 0;
+    _templates = 0;
+    _slotsUsed = 0;
+    _liveBytes = 0;
+    _rebuilds = 0;
+    _dirty = false;
+
+    // The file is extended with zeros - all the index slots are empty
+    uint64_t size = _dataOffset + kGrowBytes;
+    if (ftruncate(_fd, size) != 0)
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    fpc_result_t rc = map(size);
+    if (rc == FPC_RESULT_OK)
+        rc = writeHeader(false);
+    if (rc == FPC_RESULT_OK && fsync(_fd) != 0)
+        rc = FPC_RESULT_IO_RUNTIME_FAILURE;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// Load the header of an existing store - the newest good copy. The index is rebuilt if it is dirty.
+//
+fpc_result_t sfDevFPC2534TemplateStore::load(void)
+{
+    const sfDevFPC2534StoreHeader *use = nullptr;
+    bool otherVersion = false;
+
+    for (uint64_t copy = 0; copy < 2; copy++)
+    {
+        const sfDevFPC2534StoreHeader *h = (const sfDevFPC2534StoreHeader *)(_base + copy * kHeaderCopyOffset);
+        if (h->magic != kFPC2534StoreMagic || h->crc != headerCrc(h))
+            continue;
+
+        if (h->version != kFPC2534StoreVersion)
+            otherVersion = true;
+        else if (use == nullptr || h->generation > use->generation)
+            use = h;
+    }
+
+    if (use == nullptr)
+        return otherVersion ? FPC_RESULT_NOT_SUPPORTED : FPC_RESULT_IO_BAD_DATA;
+
+    // The layout must fit in the file
+    if (use->slotCount == 0 || (use->slotCount & (use->slotCount - 1)) != 0 || use->indexOffset < kPageSize ||
+        use->dataOffset < use->indexOffset + (uint64_t)use->slotCount * sizeof(sfDevFPC2534StoreSlot) ||
+        use->dataEnd < use->dataOffset || use->dataEnd > _mapSize)
+        return FPC_RESULT_IO_BAD_DATA;
+
+    _generation = use->generation;
+    _slotCount = use->slotCount;
+    _indexOffset = use->indexOffset;
+    _dataOffset = use->dataOffset;
+    _committedEnd = _dataEnd = use->dataEnd;
+    _templates = use->templates;
+    _liveBytes = use->liveBytes;
+    _rebuilds = use->rebuilds;
+    _dirty = (use->flags & kHeaderFlagDirty) != 0;
+
+    // Count the used slots - for the load of the index
+    _slotsUsed = 0;
+    for (uint32_t i = 0; i < _slotCount; i++)
+        _slotsUsed += slots()[i].state != kSlotEmpty;
+
+    if (!_dirty)
+        return FPC_RESULT_OK;
+
+    // Not closed cleanly - the index can hold changes that were never committed
+    rebuildIndex();
+    _rebuilds++;
+    return commit();
+}
+
+//--------------------------------------------------------------------------------------------
+// Rebuild the index from the committed records - the last record of a template is the current one. The scan
+// stops at a record with a bad CRC (the data is only trusted up to there).
+//
+void sfDevFPC2534TemplateStore::rebuildIndex(void)
+{
+    memset(slots(), 0, (size_t)_slotCount * sizeof(sfDevFPC2534StoreSlot));
+    _templates = 0;
+    _slotsUsed = 0;
+    _liveBytes = 0;
+
+    uint64_t offset = _dataOffset;
+    while (offset + sizeof(sfDevFPC2534StoreRecord) <= _committedEnd)
+    {
+        const sfDevFPC2534StoreRecord *rec = record(offset);
+        if (offset + sizeof(sfDevFPC2534StoreRecord) + rec->size > _committedEnd || rec->crc != recordCrc(rec))
+            break;
+
+        setSlot(rec->sensor, rec->id, offset, (rec->flags & kRecordFlagDeleted) != 0);
+        offset += recordLength(rec->size);
+    }
+
+    _committedEnd = _dataEnd = offset;
+}
+
+//--------------------------------------------------------------------------------------------
+// Write the header - to the other copy, with the next generation. Only the committed data is in the header.
+//
+fpc_result_t sfDevFPC2534TemplateStore::writeHeader(bool dirty)
+{
+    sfDevFPC2534StoreHeader h = {0};
+    h.magic = kFPC2534StoreMagic;
+    h.version = kFPC2534StoreVersion;
+    h.flags = dirty ? kHeaderFlagDirty : 0;
+    h.generation = _generation + 1;
+    h.slotCount = _slotCount;
+    h.templates = _templates;
+    h.indexOffset = _indexOffset;
+    h.dataOffset = _dataOffset;
+    h.dataEnd = _committedEnd;
+    h.liveBytes = _liveBytes;
+    h.rebuilds = _rebuilds;
+    h.crc = headerCrc(&h);
+
+    memcpy(_base + (h.generation & 1) * kHeaderCopyOffset, &h, sizeof(h));
+    if (!syncRange(_base, 0, kPageSize))
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    _generation = h.generation;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+// Commit a dirty header before the first change to the index since the last commit
+//
+fpc_result_t sfDevFPC2534TemplateStore::markDirty(void)
+{
+    if (_dirty)
+        return FPC_RESULT_OK;
+
+    fpc_result_t rc = writeHeader(true);
+    if (rc == FPC_RESULT_OK)
+        _dirty = true;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534TemplateStore::commit(void)
+{
+    if (!isOpen())
+        return FPC_RESULT_WRONG_STATE;
+
+    _batch = false;
+    if (!_dirty && _dataEnd == _committedEnd)
+        return FPC_RESULT_OK;
+
+    // The records and the index first - then the header that makes them part of the store
+    if (!syncRange(_base, _committedEnd, _dataEnd) ||
+        !syncRange(_base, _indexOffset, _indexOffset + (uint64_t)_slotCount * sizeof(sfDevFPC2534StoreSlot)))
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    _committedEnd = _dataEnd;
+    fpc_result_t rc = writeHeader(false);
+    if (rc == FPC_RESULT_OK)
+        _dirty = false;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534TemplateStore::rollback(void)
+{
+    if (!isOpen())
+        return FPC_RESULT_WRONG_STATE;
+
+    _appending = false;
+    _batch = false;
+    if (!_dirty)
+        return FPC_RESULT_OK;
+
+    // Only the records up to the committed end are scanned
+    rebuildIndex();
+    return commit();
+}
+
+//--------------------------------------------------------------------------------------------
+// Make room for len more bytes at the end of the data (and an open append)
+//
+fpc_result_t sfDevFPC2534TemplateStore::reserve(uint64_t len)
+{
+    uint64_t end = _dataEnd;
+    if (_appending)
+        end = _appendOffset + sizeof(sfDevFPC2534StoreRecord) + record(_appendOffset)->size;
+
+    end = alignUp(end + len, 8);
+    if (end <= _mapSize)
+        return FPC_RESULT_OK;
+
+    uint64_t size = alignUp(std::max(_mapSize * 2, end + kGrowBytes), kPageSize);
+    if (ftruncate(_fd, size) != 0)
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+
+    return map(size);
+}
+
+//--------------------------------------------------------------------------------------------
+// Index
+//
+sfDevFPC2534StoreSlot *sfDevFPC2534TemplateStore::findSlot(uint32_t sensor, uint16_t id, bool insert) const
+{
+    sfDevFPC2534StoreSlot *table = slots();
+    sfDevFPC2534StoreSlot *reuse = nullptr;
+    uint32_t mask = _slotCount - 1;
+
+    for (uint32_t n = 0, i = slotHash(sensor, id) & mask; n < _slotCount; n++, i = (i + 1) & mask)
+    {
+        sfDevFPC2534StoreSlot *slot = &table[i];
+        if (slot->state == kSlotEmpty)
+            return insert ? (reuse != nullptr ? reuse : slot) : nullptr;
+
+        if (slot->state == kSlotDeleted)
+        {
+            if (reuse == nullptr)
+                reuse = slot;
+        }
+        else if (slot->sensor == sensor && slot->id == id)
+            return slot;
+    }
+    return insert ? reuse : nullptr;
+}
+
+//--------------------------------------------------------------------------------------------
+// Point the index at the new record of a template - or delete the template
+//
+void sfDevFPC2534TemplateStore::setSlot(uint32_t sensor, uint16_t id, uint64_t offset, bool remove)
+{
+    sfDevFPC2534StoreSlot *slot = findSlot(sensor, id, true);
+    if (slot == nullptr)
+        return;
+
+    if (slot->state == kSlotUsed)
+    {
+        _liveBytes -= recordLength(record(slot->offset)->size);
+        if (remove)
+        {
+            slot->state = kSlotDeleted;
+            _templates--;
+            return;
+        }
+    }
+    else if (remove)
+        return;
+    else
+    {
+        if (slot->state == kSlotEmpty)
+            _slotsUsed++;
+
+        slot->sensor = sensor;
+        slot->id = id;
+        slot->state = kSlotUsed;
+        _templates++;
+    }
+
+    slot->offset = offset;
+    _liveBytes += recordLength(record(offset)->size);
+}
+
+//--------------------------------------------------------------------------------------------
+// Append a complete record, and index it
+//
+fpc_result_t sfDevFPC2534TemplateStore::appendRecord(uint32_t sensor, uint16_t id, uint16_t flags,
+                                                     const uint8_t *data, uint32_t size)
+{
+    fpc_result_t rc = markDirty();
+    if (rc == FPC_RESULT_OK)
+        rc = reserve(recordLength(size));
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    sfDevFPC2534StoreRecord *rec = (sfDevFPC2534StoreRecord *)(_base + _dataEnd);
+    rec->sensor = sensor;
+    rec->id = id;
+    rec->flags = flags;
+    rec->size = size;
+    if (size > 0)
+        memcpy(rec + 1, data, size);
+    rec->crc = recordCrc(rec);
+
+    setSlot(sensor, id, _dataEnd, (flags & kRecordFlagDeleted) != 0);
+    _dataEnd += recordLength(size);
+
+    return _batch ? FPC_RESULT_OK : commit();
+}
+
+//--------------------------------------------------------------------------------------------
+const uint8_t *sfDevFPC2534TemplateStore::get(uint32_t sensor, uint16_t id, uint32_t &size) const
+{
+    if (!isOpen())
+        return nullptr;
+
+    const sfDevFPC2534StoreSlot *slot = findSlot(sensor, id, false);
+    if (slot == nullptr)
+        return nullptr;
+
+    const sfDevFPC2534StoreRecord *rec = record(slot->offset);
+    size = rec->size;
+    return (const uint8_t *)(rec + 1);
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534TemplateStore::verify(uint32_t sensor, uint16_t id) const
+{
+    const sfDevFPC2534StoreSlot *slot = isOpen() ? findSlot(sensor, id, false) : nullptr;
+    if (slot == nullptr)
+        return FPC_RESULT_USER_ID_NOT_FOUND;
+
+    const sfDevFPC2534StoreRecord *rec = record(slot->offset);
+    return rec->crc == recordCrc(rec) ? FPC_RESULT_OK : FPC_RESULT_IO_BAD_DATA;
+}
+
+//--------------------------------------------------------------------------------------------
+// Before a template is added - when the index is 3/4 full, the store is compacted (with twice the slots, if
+// more than half are templates). Compaction commits - a batch carries on after it.
+//
+fpc_result_t sfDevFPC2534TemplateStore::makeRoom(uint32_t sensor, uint16_t id)
+{
+    if (contains(sensor, id) || _slotsUsed + 1 <= _slotCount / 4 * 3)
+        return FPC_RESULT_OK;
+
+    bool batch = _batch;
+    fpc_result_t rc = compact(_templates + 1 > _slotCount / 2 ? _slotCount * 2 : _slotCount);
+    _batch = batch;
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534TemplateStore::put(uint32_t sensor, uint16_t id, const uint8_t *data, uint32_t size)
+{
+    if (!isOpen() || _appending)
+        return FPC_RESULT_WRONG_STATE;
+
+    fpc_result_t rc = makeRoom(sensor, id);
+    if (rc == FPC_RESULT_OK)
+        rc = appendRecord(sensor, id, 0, data, size);
+    return rc;
+}
+
+//--------------------------------------------------------------------------------------------
+// The record is written in place, past the end of the data - it is indexed by endAppend()
+//
+fpc_result_t sfDevFPC2534TemplateStore::beginAppend(uint32_t sensor, uint16_t id)
+{
+    if (!isOpen() || _appending)
+        return FPC_RESULT_WRONG_STATE;
+
+    fpc_result_t rc = makeRoom(sensor, id);
+    if (rc == FPC_RESULT_OK)
+        rc = markDirty();
+    if (rc == FPC_RESULT_OK)
+        rc = reserve(sizeof(sfDevFPC2534StoreRecord));
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    sfDevFPC2534StoreRecord *rec = (sfDevFPC2534StoreRecord *)(_base + _dataEnd);
+    rec->sensor = sensor;
+    rec->id = id;
+    rec->flags = 0;
+    rec->size = 0;
+
+    _appendOffset = _dataEnd;
+    _appending = true;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534TemplateStore::append(const uint8_t *data, uint32_t len)
+{
+    if (!_appending)
+        return FPC_RESULT_WRONG_STATE;
+
+    if (record(_appendOffset)->size + (uint64_t)len > 0xFFFFFFFF)
+        return FPC_RESULT_INVALID_PARAM;
+
+    fpc_result_t rc = reserve(len);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    sfDevFPC2534StoreRecord *rec = (sfDevFPC2534StoreRecord *)(_base + _appendOffset);
+    memcpy((uint8_t *)(rec + 1) + rec->size, data, len);
+    rec->size += len;
+    return FPC_RESULT_OK;
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534TemplateStore::endAppend(void)
+{
+    if (!_appending)
+        return FPC_RESULT_WRONG_STATE;
+
+    sfDevFPC2534StoreRecord *rec = (sfDevFPC2534StoreRecord *)(_base + _appendOffset);
+    rec->crc = recordCrc(rec);
+    _appending = false;
+
+    setSlot(rec->sensor, rec->id, _appendOffset, false);
+    _dataEnd = _appendOffset + recordLength(rec->size);
+
+    return _batch ? FPC_RESULT_OK : commit();
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534TemplateStore::abortAppend(void)
+{
+    // Nothing was indexed - the record is past the end of the data
+    _appending = false;
+}
+
+//--------------------------------------------------------------------------------------------
+// A delete is a record too - so a rebuilt index does not bring the template back
+//
+fpc_result_t sfDevFPC2534TemplateStore::remove(uint32_t sensor, uint16_t id)
+{
+    if (!isOpen() || _appending)
+        return FPC_RESULT_WRONG_STATE;
+
+    if (!contains(sensor, id))
+        return FPC_RESULT_USER_ID_NOT_FOUND;
+
+    return appendRecord(sensor, id, kRecordFlagDeleted, nullptr, 0);
+}
+
+//--------------------------------------------------------------------------------------------
+fpc_result_t sfDevFPC2534TemplateStore::removeSensor(uint32_t sensor)
+{
+    if (!isOpen() || _appending)
+        return FPC_RESULT_WRONG_STATE;
+
+    std::vector<uint16_t> ids(list(sensor, nullptr, 0));
+    list(sensor, ids.data(), ids.size());
+
+    bool batch = _batch;
+    _batch = true;
+
+    fpc_result_t rc = FPC_RESULT_OK;
+    for (size_t i = 0; i < ids.size() && rc == FPC_RESULT_OK; i++)
+        rc = remove(sensor, ids[i]);
+
+    _batch = batch;
+    return rc != FPC_RESULT_OK || _batch ? rc : commit();
+}
+
+//--------------------------------------------------------------------------------------------
+uint32_t sfDevFPC2534TemplateStore::list(uint32_t sensor, uint16_t *ids, uint32_t max) const
+{
+    if (!isOpen())
+        return 0;
+
+    std::vector<uint16_t> found;
+    const sfDevFPC2534StoreSlot *table = slots();
+    for (uint32_t i = 0; i < _slotCount; i++)
+    {
+        if (table[i].state == kSlotUsed && table[i].sensor == sensor)
+            found.push_back(table[i].id);
+    }
+    std::sort(found.begin(), found.end());
+
+    for (uint32_t i = 0; i < found.size() && i < max; i++)
+        ids[i] = found[i];
+
+    return found.size();
+}
+
+//--------------------------------------------------------------------------------------------
+// The live records are copied to a new store (in file order), which is then renamed over this one
+//
+fpc_result_t sfDevFPC2534TemplateStore::compact(uint32_t slots)
+{
+    if (!isOpen() || _appending)
+        return FPC_RESULT_WRONG_STATE;
+
+    fpc_result_t rc = commit();
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    if (slots == 0)
+        slots = _slotCount;
+    while (_templates >= slots / 4 * 3)
+        slots *= 2;
+
+    std::vector<uint64_t> offsets;
+    offsets.reserve(_templates);
+    const sfDevFPC2534StoreSlot *table = this->slots();
+    for (uint32_t i = 0; i < _slotCount; i++)
+    {
+        if (table[i].state == kSlotUsed)
+            offsets.push_back(table[i].offset);
+    }
+    std::sort(offsets.begin(), offsets.end());
+
+    std::string next = _path + ".compact";
+    unlink(next.c_str());
+
+    sfDevFPC2534TemplateStore store;
+    rc = store.open(next.c_str(), slots);
+    if (rc != FPC_RESULT_OK)
+        return rc;
+
+    store.beginBatch();
+    for (size_t i = 0; i < offsets.size() && rc == FPC_RESULT_OK; i++)
+    {
+        const sfDevFPC2534StoreRecord *rec = record(offsets[i]);
+        rc = store.put(rec->sensor, rec->id, (const uint8_t *)(rec + 1), rec->size);
+    }
+
+    store._rebuilds = _rebuilds;
+    if (rc == FPC_RESULT_OK)
+        rc = store.commit();
+    if (rc == FPC_RESULT_OK && fsync(store._fd) != 0)
+        rc = FPC_RESULT_IO_RUNTIME_FAILURE;
+    store.close();
+
+    if (rc != FPC_RESULT_OK)
+    {
+        unlink(next.c_str());
+        return rc;
+    }
+
+    // The rename replaces the store in one step - the directory is synced so it survives a crash
+    if (rename(next.c_str(), _path.c_str()) != 0)
+    {
+        unlink(next.c_str());
+        return FPC_RESULT_IO_RUNTIME_FAILURE;
+    }
+
+    std::string dir = _path.substr(0, _path.find_last_of('/') + 1);
+    int dirFd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0)
+    {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+
+    std::string path = _path;
+    close();
+    return open(path.c_str());
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534TemplateStore::getStats(sfDevFPC2534StoreStats_t &stats) const
+{
+    stats.templates = _templates;
+    stats.slots = _slotCount;
+    stats.liveBytes = _liveBytes;
+    stats.deadBytes = _dataEnd - _dataOffset - _liveBytes;
+    stats.fileSize = _mapSize;
+    stats.rebuilds = _rebuilds;
+}
+
+//--------------------------------------------------------------------------------------------
+// sfDevFPC2534StoreTemplates
+//--------------------------------------------------------------------------------------------
+sfDevFPC2534StoreTemplates::sfDevFPC2534StoreTemplates(const sfDevFPC2534TemplateStore &store, uint32_t sensor)
+    : _store{store}, _sensor{sensor}, _ids(store.list(sensor, nullptr, 0))
+{
+    store.list(sensor, _ids.data(), _ids.size());
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534StoreTemplates::templateInfo(uint16_t index, uint16_t &id, uint32_t &size)
+{
+    if (index >= _ids.size() || _store.get(_sensor, _ids[index], size) == nullptr)
+        return false;
+
+    id = _ids[index];
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+uint16_t sfDevFPC2534StoreTemplates::readTemplate(uint16_t index, uint32_t offset, uint8_t *data, uint16_t len)
+{
+    uint32_t size;
+    const uint8_t *tmpl = index < _ids.size() ? _store.get(_sensor, _ids[index], size) : nullptr;
+    if (tmpl == nullptr || offset + len > size)
+        return 0;
+
+    memcpy(data, tmpl + offset, len);
+    return len;
+}
+
+#endif
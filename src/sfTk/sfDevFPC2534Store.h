@@ -0,0 +1,261 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2025, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Host template store for the FPC2534 library - for Linux gateways that keep copies of the templates of many
+// sensors (read with template GET transfers).
+//
+// The store is a single memory mapped file:
+//
+//   header   two copies, each in its own sector - the copy with the highest generation and a good CRC is used
+//   index    a hash table (open addressing, linear probing) keyed by (sensor, template ID), with the file
+//            offset of the current record of each template
+//   data     append-only records - a record header (sensor, ID, flags, size, CRC32) and the template data. An
+//            update or delete appends a record, and the older record is dead space until the store is compacted.
+//
+// A lookup is a probe of the index, and a read returns a pointer into the mapping - no copy, no file per template.
+// Records are written past the committed end of the data, and only become part of the store when a header with
+// the new end is written (a commit). Before the index is changed, a header with the dirty flag is committed - if
+// the host stops before the next clean commit, the index is rebuilt from the committed records when the store is
+// opened (one pass through the file). A crash mid-write loses the changes since the last commit, and nothing else.
+// Compaction writes the live records to a new file, and renames it over the store.
+//
+// The file is in the byte order of the host. A store is used by one process at a time (it is locked while open),
+// and is not thread safe. These are only built on a Linux host (no ARDUINO define).
+
+#pragma once
+
+#include "sfDevFPC2534Platform.h"
+
+#if defined(SFE_FPC2534_LINUX_HOST)
+
+#include "sfDevFPC2534.h"
+#include "sfDevFPC2534Provision.h"
+
+#include <string>
+#include <vector>
+
+// Store format
+const uint32_t kFPC2534StoreMagic = 0x53435046; // "FPCS"
+const uint16_t kFPC2534StoreVersion = 1;
+
+// Default number of index slots of a new store - the index is doubled (by compaction) when it is 3/4 full
+const uint32_t kFPC2534StoreDefaultSlots = 4096;
+
+// File structures of the store
+struct sfDevFPC2534StoreSlot;
+struct sfDevFPC2534StoreRecord;
+
+//--------------------------------------------------------------------------------------------
+// Statistics of the store
+typedef struct
+{
+    uint32_t templates; // templates in the store
+    uint32_t slots;     // index slots
+    uint64_t liveBytes; // bytes of the current records
+    uint64_t deadBytes; // bytes of replaced and deleted records - reclaimed by compact()
+    uint64_t fileSize;
+    uint32_t rebuilds; // index rebuilds on open (after a crash) since the store was created
+} sfDevFPC2534StoreStats_t;
+
+//--------------------------------------------------------------------------------------------
+// The store
+class sfDevFPC2534TemplateStore
+{
+  public:
+    sfDevFPC2534TemplateStore();
+    ~sfDevFPC2534TemplateStore();
+
+    /**
+     * @brief Open a store - created if the file does not exist. The index is rebuilt if the store was not closed
+     * cleanly.
+     *
+     * @param path The store file
+     * @param slots The index slots of a new store (rounded up to a power of 2)
+     * @return Result Code - FPC_RESULT_IO_BAD_DATA if the file is not a valid store, FPC_RESULT_NOT_SUPPORTED for
+     * a store of another version, FPC_RESULT_IO_BUSY if another process has it open,
+     * FPC_RESULT_IO_RUNTIME_FAILURE if the file can't be opened or mapped
+     */
+    fpc_result_t open(const char *path, uint32_t slots = kFPC2534StoreDefaultSlots);
+
+    /**
+     * @brief Commit, and close the store
+     */
+    void close(void);
+
+    bool isOpen(void) const
+    {
+        return _base != nullptr;
+    }
+
+    /**
+     * @brief Look up a template - zero copy
+     *
+     * @param sensor The sensor the template belongs to - any value the application uses to name its sensors
+     * @param id Template ID
+     * @param size Set to the size of the template
+     * @return The template data, in the mapping of the store - nullptr if not in the store. Valid until the store
+     * is next changed (put(), remove(), compact() ... can move the mapping).
+     */
+    const uint8_t *get(uint32_t sensor, uint16_t id, uint32_t &size) const;
+
+    bool contains(uint32_t sensor, uint16_t id) const
+    {
+        uint32_t size;
+        return get(sensor, id, size) != nullptr;
+    }
+
+    /**
+     * @brief Check the CRC of a template
+     *
+     * @return Result Code - FPC_RESULT_USER_ID_NOT_FOUND if not in the store, FPC_RESULT_IO_BAD_DATA on a CRC
+     * mismatch
+     */
+    fpc_result_t verify(uint32_t sensor, uint16_t id) const;
+
+    /**
+     * @brief Add or replace a template - committed, unless in a batch
+     *
+     * @return Result Code
+     */
+    fpc_result_t put(uint32_t sensor, uint16_t id, const uint8_t *data, uint32_t size);
+
+    /**
+     * @brief Add or replace a template, in parts - the data is written straight into the store as it arrives
+     * (the writer of a template GET transfer). Committed by endAppend(), unless in a batch.
+     *
+     * @return Result Code - FPC_RESULT_WRONG_STATE if an append is already open
+     */
+    fpc_result_t beginAppend(uint32_t sensor, uint16_t id);
+    fpc_result_t append(const uint8_t *data, uint32_t len);
+    fpc_result_t endAppend(void);
+
+    /**
+     * @brief Drop an open append - the store is not changed
+     */
+    void abortAppend(void);
+
+    /**
+     * @brief Delete a template - committed, unless in a batch
+     *
+     * @return Result Code - FPC_RESULT_USER_ID_NOT_FOUND if not in the store
+     */
+    fpc_result_t remove(uint32_t sensor, uint16_t id);
+
+    /**
+     * @brief Delete all the templates of a sensor - committed, unless in a batch
+     *
+     * @return Result Code
+     */
+    fpc_result_t removeSensor(uint32_t sensor);
+
+    /**
+     * @brief Start a batch of changes - they are committed together by commit(), with one sync of the file
+     */
+    void beginBatch(void)
+    {
+        _batch = true;
+    }
+
+    /**
+     * @brief Commit the changes - the records and index are synced to the file, then a clean header
+     *
+     * @return Result Code
+     */
+    fpc_result_t commit(void);
+
+    /**
+     * @brief Drop the changes since the last commit - the index is rebuilt from the committed records, as after
+     * a crash
+     *
+     * @return Result Code
+     */
+    fpc_result_t rollback(void);
+
+    /**
+     * @brief The template IDs of a sensor, in ID order
+     *
+     * @return The number of templates of the sensor - up to max are written to ids
+     */
+    uint32_t list(uint32_t sensor, uint16_t *ids, uint32_t max) const;
+
+    /**
+     * @brief Write the live records to a new file, with an index of the given slots (0 - keep the size), and
+     * rename it over the store. Commits first.
+     *
+     * @return Result Code
+     */
+    fpc_result_t compact(uint32_t slots = 0);
+
+    void getStats(sfDevFPC2534StoreStats_t &stats) const;
+
+  private:
+    const sfDevFPC2534StoreRecord *record(uint64_t offset) const;
+    sfDevFPC2534StoreSlot *slots(void) const;
+
+    fpc_result_t create(uint32_t slots);
+    fpc_result_t map(uint64_t size);
+    fpc_result_t load(void);
+    fpc_result_t writeHeader(bool dirty);
+    fpc_result_t markDirty(void);
+    fpc_result_t reserve(uint64_t len);
+    fpc_result_t appendRecord(uint32_t sensor, uint16_t id, uint16_t flags, const uint8_t *data, uint32_t size);
+    fpc_result_t makeRoom(uint32_t sensor, uint16_t id);
+    void rebuildIndex(void);
+
+    sfDevFPC2534StoreSlot *findSlot(uint32_t sensor, uint16_t id, bool insert) const;
+    void setSlot(uint32_t sensor, uint16_t id, uint64_t offset, bool remove);
+
+    std::string _path;
+    int _fd;
+    uint8_t *_base;
+    uint64_t _mapSize;
+
+    // The in-memory header - written to the file on a commit
+    uint64_t _generation;
+    uint32_t _slotCount;
+    uint64_t _indexOffset;
+    uint64_t _dataOffset;
+    uint64_t _committedEnd; // end of the data in the last commit
+    uint64_t _dataEnd;      // end of the data, with the records since the last commit
+    uint32_t _templates;
+    uint32_t _slotsUsed; // used and deleted slots
+    uint64_t _liveBytes;
+    uint32_t _rebuilds;
+    bool _dirty; // the header in the file has the dirty flag
+    bool _batch;
+
+    // The open append
+    bool _appending;
+    uint64_t _appendOffset; // of the record
+};
+
+//--------------------------------------------------------------------------------------------
+// Template source for the templates of a sensor in the store - to provision (or re-sync) a sensor from the
+// store. The templates are listed when constructed - the store must not be changed while it is in use.
+class sfDevFPC2534StoreTemplates : public sfDevFPC2534TemplateSource
+{
+  public:
+    sfDevFPC2534StoreTemplates(const sfDevFPC2534TemplateStore &store, uint32_t sensor);
+
+    uint16_t templateCount(void)
+    {
+        return (uint16_t)_ids.size();
+    }
+
+    bool templateInfo(uint16_t index, uint16_t &id, uint32_t &size);
+    uint16_t readTemplate(uint16_t index, uint32_t offset, uint8_t *data, uint16_t len);
+
+  private:
+    const sfDevFPC2534TemplateStore &_store;
+    uint32_t _sensor;
+    std::vector<uint16_t> _ids;
+};
+
+#endif
@@ -12,15 +12,81 @@
 
 #include "sfDevFPC2534UART.h"
 
-sfDevFPC2534UART::sfDevFPC2534UART() : _theUART{nullptr}
+sfDevFPC2534UART::sfDevFPC2534UART() : _theUART{nullptr}, _baudRate{0}, _wakePin{kFPC2534NoWakePin}
 {
 }
 
 //--------------------------------------------------------------------------------------------
-bool sfDevFPC2534UART::initialize(HardwareSerial &theUART)
+bool sfDevFPC2534UART::initialize(HardwareSerial &theUART, uint32_t baudRate, uint32_t interruptPin)
 {
     _theUART = &theUART;
+    _baudRate = baudRate;
 
+    // With CFG_SYS_FLAG_UART_IRQ_BEFORE_TX set on the sensor, the IRQ pin is raised before the sensor sends -
+    // so the host can sleep until the IRQ.
+    if (interruptPin != kFPC2534NoIRQPin)
+        sfDevFPC2534IComm::initISRHandler(interruptPin);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534UART::setBaudRate(uint32_t baudRate)
+{
+    if (_theUART == nullptr || baudRate == 0)
+        return false;
+
+    // let any pending output go out at the old rate
+    _theUART->flush();
+#if defined(ESP32)
+    // keeps the pin assignment and buffer sizes
+    _theUART->updateBaudRate(baudRate);
+#else
+    _theUART->end();
+    _theUART->begin(baudRate);
+#endif
+    _baudRate = baudRate;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534UART::reinitialize(void)
+{
+    if (_theUART == nullptr)
+        return false;
+
+    // the rate is unknown - the UART was started by the application, leave it as is
+    if (_baudRate != 0)
+    {
+        _theUART->end();
+        _theUART->begin(_baudRate);
+    }
+    clearData();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+void sfDevFPC2534UART::setWakePin(uint32_t wakePin)
+{
+    _wakePin = wakePin;
+    if (_wakePin == kFPC2534NoWakePin)
+        return;
+
+    // idle high - the sensor wakes on the low pulse
+    pinMode(_wakePin, OUTPUT);
+    digitalWrite(_wakePin, HIGH);
+}
+
+//--------------------------------------------------------------------------------------------
+bool sfDevFPC2534UART::wakeSensor(void)
+{
+    if (_wakePin == kFPC2534NoWakePin)
+        return false;
+
+    digitalWrite(_wakePin, LOW);
+    delayMicroseconds(kFPC2534WakePulseUs);
+    digitalWrite(_wakePin, HIGH);
     return true;
 }
 
@@ -43,6 +109,8 @@ void sfDevFPC2534UART::clearData()
     // clear buffer
     while (_theUART->available() > 0)
         _theUART->read();
+
+    clearISRDataAvailable();
 }
 
 //--------------------------------------------------------------------------------------------
@@ -71,5 +139,9 @@ uint16_t sfDevFPC2534UART::read(uint8_t *data, size_t len)
     if (readBytes == 0 && len > 0)
         return FPC_RESULT_IO_NO_DATA;
 
+    // everything the IRQ announced has been read
+    if (_theUART->available() == 0)
+        clearISRDataAvailable();
+
     return FPC_RESULT_OK;
 }
\ No newline at end of file
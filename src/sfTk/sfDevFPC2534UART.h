@@ -23,12 +23,26 @@ class sfDevFPC2534UART : public sfDevFPC2534IComm
 {
   public:
     sfDevFPC2534UART();
-    bool initialize(HardwareSerial &theUART);
+    bool initialize(HardwareSerial &theUART, uint32_t baudRate = 0, uint32_t interruptPin = kFPC2534NoIRQPin);
     bool dataAvailable(void);
     void clearData(void);
     uint16_t write(const uint8_t *data, size_t len);
     uint16_t read(uint8_t *data, size_t len);
+    bool setBaudRate(uint32_t baudRate);
+    uint32_t getBaudRate(void)
+    {
+        return _baudRate;
+    }
+
+    // Set the pin connected to the wake-up pin (CS) of the sensor - needed to wake the sensor from stop mode
+    void setWakePin(uint32_t wakePin);
+    bool wakeSensor(void);
+
+    // Restart the UART at the current baud rate, and drop any data
+    bool reinitialize(void);
 
   private:
     HardwareSerial *_theUART;
+    uint32_t _baudRate; // 0 - unknown
+    uint32_t _wakePin;
 };
\ No newline at end of file